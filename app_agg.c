@@ -0,0 +1,1373 @@
+/*******************************************************************************
+* File Name: app_agg.c
+*
+* Description: This file contains the aggregator mode. It scans for other
+*              Environmental Sensing devices, listens to those that broadcast
+*              their temperature and connects to and reads the others, and
+*              serves the newest reading of each peer in batches over the
+*              uplink connection. Simulated peers exercise the same path
+*              without radios.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_agg.h"
+#include "app_bt_gatt_dispatch.h"
+#include "app_bt_gatt_tx.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_ess.h"
+#include "app_memory.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_l2c.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if APP_AGGREGATOR
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* Advertising data walked for the ESS elements */
+#define APP_AGG_ADV_MAX_LEN              (31u)
+
+/* Units of the Bluetooth specification */
+#define APP_AGG_CONN_UNIT_US             (1250u)
+#define APP_AGG_SCAN_UNIT_US             (625u)
+
+/* Handle range of the read by type of the temperature on a connected peer */
+#define APP_AGG_READ_START_HANDLE        (0x0001u)
+#define APP_AGG_READ_END_HANDLE          (0xFFFFu)
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef enum
+{
+    APP_AGG_PEER_FREE,
+    APP_AGG_PEER_SEEN,          /* Advertises ESS, nothing to listen to */
+    APP_AGG_PEER_LISTEN,        /* Broadcasts its temperature */
+    APP_AGG_PEER_CONNECTING,
+    APP_AGG_PEER_CONNECTED,
+} app_agg_peer_state_t;
+
+typedef struct
+{
+    wiced_bt_device_address_t   bd_addr;
+    uint8_t                     addr_type;
+    uint8_t                     state;
+    bool                        sim;
+    bool                        fresh;          /* Reading not batched yet */
+    bool                        read_busy;      /* Read in flight */
+    int8_t                      rssi;
+    int16_t                     temperature;
+    uint16_t                    conn_id;
+    uint64_t                    seen_ms;
+    uint64_t                    reading_ms;
+    uint32_t                    readings;
+    uint8_t                     read_buf[4];
+} app_agg_peer_t;
+
+/* ESS content of an advertisement */
+typedef struct
+{
+    bool        ess;
+    bool        has_temperature;
+    int16_t     temperature;
+} app_agg_adv_t;
+
+/* Connection and scan timing shared by all links, see APP_AGG_CONN_INTERVAL */
+typedef struct
+{
+    uint16_t    conn_interval;      /* 1.25 ms units */
+    uint16_t    scan_interval;      /* 0.625 ms units */
+    uint16_t    scan_window;        /* 0.625 ms units */
+} app_agg_plan_t;
+
+typedef struct
+{
+    uint32_t    adverts;
+    uint32_t    ess_adverts;
+    uint32_t    readings;
+    uint32_t    table_full;
+    uint32_t    connects;
+    uint32_t    connect_failures;
+    uint32_t    disconnects;
+    uint32_t    read_errors;
+    uint32_t    frames;
+    uint32_t    frames_unsent;
+} app_agg_stats_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static app_agg_peer_t           app_agg_peers[APP_AGG_MAX_PEERS];
+static app_agg_stats_t          app_agg_stats;
+static app_agg_plan_t           app_agg_plan;
+
+/* Peers connecting or connected */
+static uint32_t                 app_agg_num_conns;
+static volatile bool            app_agg_scanning;
+static uint8_t                  app_agg_seq;
+
+/* Simulated peers and the state of their readings */
+static uint32_t                 app_agg_sim_count;
+static int16_t                  app_agg_sim_temperature[APP_AGG_MAX_PEERS];
+static uint32_t                 app_agg_sim_random = 1u;
+
+/* Configuration handed to the stack, with the central and observer settings */
+static wiced_bt_cfg_settings_t          app_agg_cfg;
+static wiced_bt_cfg_ble_t               app_agg_ble_cfg;
+static wiced_bt_cfg_ble_scan_settings_t app_agg_scan_cfg;
+
+/* Attribute values of the aggregator service */
+static uint8_t                  app_agg_batch[APP_AGG_BATCH_LEN];
+static uint8_t                  app_agg_batch_cccd[2];
+static uint8_t                  app_agg_peers_value[APP_AGG_MAX_PEERS * APP_AGG_PEER_RECORD_LEN];
+
+static gatt_db_lookup_table_t   app_agg_attrs[] =
+{
+    { HDLC_APP_AGG_BATCH_VALUE, sizeof(app_agg_batch), 0, app_agg_batch },
+    { HDLD_APP_AGG_BATCH_CLIENT_CHAR_CONFIG, sizeof(app_agg_batch_cccd),
+      sizeof(app_agg_batch_cccd), app_agg_batch_cccd },
+    { HDLC_APP_AGG_PEERS_VALUE, sizeof(app_agg_peers_value), sizeof(app_agg_peers_value),
+      app_agg_peers_value },
+};
+
+#if APP_STATIC_MEMORY
+/* Task stack and control block in static memory mode */
+static StackType_t  app_agg_stack[APP_AGG_STACK_SIZE];
+static StaticTask_t app_agg_tcb;
+
+APP_MEMORY_FOOTPRINT(app_agg_ram_footprint,
+                     sizeof(app_agg_peers) + sizeof(app_agg_batch) +
+                     sizeof(app_agg_peers_value) + sizeof(app_agg_cfg) +
+                     sizeof(app_agg_ble_cfg) + sizeof(app_agg_scan_cfg) +
+                     sizeof(app_agg_stack) + sizeof(app_agg_tcb));
+#else
+APP_MEMORY_FOOTPRINT(app_agg_ram_footprint,
+                     sizeof(app_agg_peers) + sizeof(app_agg_batch) +
+                     sizeof(app_agg_peers_value) + sizeof(app_agg_cfg) +
+                     sizeof(app_agg_ble_cfg) + sizeof(app_agg_scan_cfg));
+#endif
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_agg_make_plan(app_agg_plan_t *p_plan, uint32_t links);
+
+static void app_agg_task(void *pvParam);
+
+static void app_agg_start_scan(void);
+
+static void app_agg_scan_result_cb(wiced_bt_ble_scan_results_t *p_scan_result,
+                                   uint8_t *p_adv_data);
+
+static bool app_agg_parse_adv(const uint8_t *p_adv_data, app_agg_adv_t *p_adv);
+
+static void app_agg_seen(const wiced_bt_ble_scan_results_t *p_scan_result,
+                         const app_agg_adv_t *p_adv, bool sim);
+
+static app_agg_peer_t *app_agg_peer_by_addr(const uint8_t *p_bd_addr, bool alloc);
+
+static app_agg_peer_t *app_agg_peer_by_conn(uint16_t conn_id);
+
+static void app_agg_reading(app_agg_peer_t *p_peer, int16_t temperature);
+
+static void app_agg_connect(app_agg_peer_t *p_peer);
+
+static void app_agg_poll(void);
+
+static void app_agg_expire(void);
+
+static void app_agg_flush(void);
+
+static void app_agg_uplink_status(const wiced_bt_gatt_connection_status_t *p_conn_status);
+
+static wiced_bt_gatt_status_t
+app_agg_op_complete_handler(wiced_bt_gatt_event_data_t *p_event_data);
+
+static void app_agg_sim_tick(void);
+
+static void app_agg_sim_addr(uint32_t index, wiced_bt_device_address_t bd_addr);
+
+static void app_agg_sim_conn(app_agg_peer_t *p_peer, bool connected);
+
+static void app_agg_sim_read(app_agg_peer_t *p_peer);
+
+static void app_agg_read_cb(uint16_t attr_handle);
+
+static wiced_bt_gatt_status_t app_agg_write_cb(uint16_t attr_handle, uint16_t offset,
+                                               const uint8_t *p_val, uint16_t len);
+
+static void app_agg_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const uint8_t app_agg_gatt_db[] =
+{
+    PRIMARY_SERVICE_UUID128(HDLS_APP_AGG, APP_AGG_UUID_SERVICE),
+        CHARACTERISTIC_UUID128(HDLC_APP_AGG_BATCH, HDLC_APP_AGG_BATCH_VALUE,
+                               APP_AGG_UUID_BATCH,
+                               GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_NOTIFY,
+                               GATTDB_PERM_READABLE),
+            CHAR_DESCRIPTOR_UUID16_WRITABLE(HDLD_APP_AGG_BATCH_CLIENT_CHAR_CONFIG,
+                                            UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+                                            GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+        CHARACTERISTIC_UUID128(HDLC_APP_AGG_PEERS, HDLC_APP_AGG_PEERS_VALUE,
+                               APP_AGG_UUID_PEERS, GATTDB_CHAR_PROP_READ,
+                               GATTDB_PERM_READABLE),
+};
+
+static const wiced_bt_uuid_t app_agg_types[] =
+{
+    { LEN_UUID_128, { .uuid128 = { APP_AGG_UUID_BATCH } } },
+    { LEN_UUID_16, { .uuid16 = UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION } },
+    { LEN_UUID_128, { .uuid128 = { APP_AGG_UUID_PEERS } } },
+};
+
+static const app_gatt_service_cbs_t app_agg_gatt_cbs =
+{
+    app_agg_read_cb, app_agg_write_cb
+};
+
+static const app_console_cmd_t app_agg_console_cmd =
+{
+    "agg", "Aggregator peers and schedule; 'agg sim <peers>' simulates peers",
+    app_agg_cmd
+};
+
+#else
+
+APP_MEMORY_FOOTPRINT(app_agg_ram_footprint, 0);
+
+#endif /* APP_AGGREGATOR */
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_agg_bt_cfg
+
+ Function Description:
+ @brief  Returns the stack configuration. In aggregator mode it is a copy of
+         the configured one with room for the peer links and the scan and
+         connection timing of the schedule, since design.cybt sets up a
+         peripheral only.
+
+ @param p_cfg  Configuration generated from design.cybt
+
+ @return const wiced_bt_cfg_settings_t*  Configuration for wiced_bt_stack_init()
+ */
+const wiced_bt_cfg_settings_t *app_agg_bt_cfg(const wiced_bt_cfg_settings_t *p_cfg)
+{
+#if APP_AGGREGATOR
+    app_agg_make_plan(&app_agg_plan, 1u + APP_AGG_MAX_CONNS);
+
+    app_agg_scan_cfg.scan_mode = BTM_BLE_SCAN_MODE_PASSIVE;
+    app_agg_scan_cfg.high_duty_scan_interval = app_agg_plan.scan_interval;
+    app_agg_scan_cfg.high_duty_scan_window = app_agg_plan.scan_window;
+    app_agg_scan_cfg.low_duty_scan_interval = app_agg_plan.scan_interval;
+    app_agg_scan_cfg.low_duty_scan_window = app_agg_plan.scan_window;
+    app_agg_scan_cfg.high_duty_conn_scan_interval = app_agg_plan.scan_interval;
+    app_agg_scan_cfg.high_duty_conn_scan_window = app_agg_plan.scan_window;
+    app_agg_scan_cfg.low_duty_conn_scan_interval = app_agg_plan.scan_interval;
+    app_agg_scan_cfg.low_duty_conn_scan_window = app_agg_plan.scan_window;
+    app_agg_scan_cfg.high_duty_conn_duration = 5u;
+    app_agg_scan_cfg.low_duty_conn_duration = 5u;
+    app_agg_scan_cfg.conn_min_interval = app_agg_plan.conn_interval;
+    app_agg_scan_cfg.conn_max_interval = app_agg_plan.conn_interval;
+    app_agg_scan_cfg.conn_latency = 0;
+    app_agg_scan_cfg.conn_supervision_timeout = APP_AGG_SUPERVISION_TIMEOUT;
+
+    app_agg_ble_cfg = *p_cfg->p_ble_cfg;
+    app_agg_ble_cfg.ble_max_simultaneous_links = 1u + APP_AGG_MAX_CONNS;
+    app_agg_ble_cfg.p_ble_scan_cfg = &app_agg_scan_cfg;
+
+    app_agg_cfg = *p_cfg;
+    app_agg_cfg.p_ble_cfg = &app_agg_ble_cfg;
+    return &app_agg_cfg;
+#else
+    return p_cfg;
+#endif
+}
+
+/*
+ Function Name:
+ app_agg_init
+
+ Function Description:
+ @brief  Adds the aggregator service to the GATT database and registers for
+         the GATT client completions. Must be called after
+         wiced_bt_gatt_db_init(). Does nothing unless built with
+         APP_AGGREGATOR=1.
+
+ @param void
+
+ @return void
+ */
+void app_agg_init(void)
+{
+#if APP_AGGREGATOR
+    wiced_bt_gatt_status_t gatt_status;
+
+    gatt_status = app_gatt_add_service(app_agg_gatt_db, sizeof(app_agg_gatt_db),
+                                       app_agg_attrs, app_agg_types,
+                                       sizeof(app_agg_attrs) / sizeof(app_agg_attrs[0]),
+                                       &app_agg_gatt_cbs);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Aggregator service not added, err 0x%x\n", gatt_status);
+    }
+
+    app_gatt_register_event_handler(GATT_OPERATION_CPLT_EVT, app_agg_op_complete_handler);
+#endif
+}
+
+/*
+ Function Name:
+ app_agg_start
+
+ Function Description:
+ @brief  Creates the aggregator task, which starts scanning, and registers
+         the agg console command. Does nothing unless built with
+         APP_AGGREGATOR=1.
+
+ @param void
+
+ @return void
+ */
+void app_agg_start(void)
+{
+#if APP_AGGREGATOR
+    BaseType_t rtos_result;
+
+#if APP_STATIC_MEMORY
+    rtos_result = (NULL != xTaskCreateStatic(app_agg_task, APP_AGG_TASK_NAME,
+                                             APP_AGG_STACK_SIZE, NULL, APP_AGG_PRIORITY,
+                                             app_agg_stack, &app_agg_tcb))
+                  ? pdPASS : pdFAIL;
+#else
+    rtos_result = xTaskCreate(app_agg_task, APP_AGG_TASK_NAME, APP_AGG_STACK_SIZE,
+                              NULL, APP_AGG_PRIORITY, NULL);
+#endif
+    if (pdPASS != rtos_result)
+    {
+        printf("Aggregator task creation failed\n");
+        return;
+    }
+
+    app_console_register_command(&app_agg_console_cmd);
+#endif
+}
+
+/*
+ Function Name:
+ app_agg_conn_status
+
+ Function Description:
+ @brief  Takes the connection events of the peer links, which the GATT
+         server must ignore. The uplink events are noted and left to the
+         server.
+
+ @param p_conn_status  Connection status event
+
+ @return bool  true if the event is for a peer link
+ */
+bool app_agg_conn_status(wiced_bt_gatt_connection_status_t *p_conn_status)
+{
+#if APP_AGGREGATOR
+    app_agg_peer_t *p_peer = app_agg_peer_by_addr(p_conn_status->bd_addr, false);
+    bool was_connected;
+
+    if ((NULL == p_peer) || ((APP_AGG_PEER_CONNECTING != p_peer->state) &&
+                             (APP_AGG_PEER_CONNECTED != p_peer->state)))
+    {
+        if (HCI_ROLE_CENTRAL == p_conn_status->link_role)
+        {
+            /* A link of ours to a peer that left the table */
+            if (p_conn_status->connected)
+            {
+                wiced_bt_gatt_disconnect(p_conn_status->conn_id);
+            }
+            return true;
+        }
+        app_agg_uplink_status(p_conn_status);
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    was_connected = (APP_AGG_PEER_CONNECTED == p_peer->state);
+    if (p_conn_status->connected)
+    {
+        p_peer->state = APP_AGG_PEER_CONNECTED;
+        p_peer->conn_id = p_conn_status->conn_id;
+        p_peer->read_busy = false;
+        p_peer->seen_ms = app_uptime_ms_get();
+        app_agg_stats.connects++;
+    }
+    else
+    {
+        p_peer->state = APP_AGG_PEER_SEEN;
+        p_peer->conn_id = 0;
+        app_agg_num_conns--;
+        if (was_connected)
+        {
+            app_agg_stats.disconnects++;
+        }
+        else
+        {
+            app_agg_stats.connect_failures++;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+ Function Name:
+ app_agg_scan_state
+
+ Function Description:
+ @brief  Notes a scan state change reported by the stack. A stopped scan is
+         restarted by the aggregator task.
+
+ @param scan_type  New scan state
+
+ @return void
+ */
+void app_agg_scan_state(wiced_bt_ble_scan_type_t scan_type)
+{
+#if APP_AGGREGATOR
+    app_agg_scanning = (BTM_BLE_SCAN_TYPE_NONE != scan_type);
+#endif
+}
+
+#if APP_AGGREGATOR
+
+/*
+ Function Name:
+ app_agg_make_plan
+
+ Function Description:
+ @brief  Computes the connection and scan timing of a number of links. The
+         connection events of the links take the start of each interval and
+         the scan window the rest, so scanning does not steal connection
+         events and the window stays the same from interval to interval.
+
+ @param p_plan  Timing computed
+ @param links   Links sharing the interval, uplink included
+
+ @return void
+ */
+static void app_agg_make_plan(app_agg_plan_t *p_plan, uint32_t links)
+{
+    uint32_t busy_us = (links * APP_AGG_CONN_EVENT_US) + APP_AGG_SCAN_GUARD_US;
+    uint32_t interval = (busy_us + APP_AGG_MIN_SCAN_WINDOW_US + APP_AGG_CONN_UNIT_US - 1u) /
+                        APP_AGG_CONN_UNIT_US;
+
+    if (APP_AGG_CONN_INTERVAL > interval)
+    {
+        interval = APP_AGG_CONN_INTERVAL;
+    }
+
+    p_plan->conn_interval = (uint16_t)interval;
+    p_plan->scan_interval = (uint16_t)((interval * APP_AGG_CONN_UNIT_US) / APP_AGG_SCAN_UNIT_US);
+    p_plan->scan_window = (uint16_t)(((interval * APP_AGG_CONN_UNIT_US) - busy_us) /
+                                     APP_AGG_SCAN_UNIT_US);
+}
+
+/*
+ Function Name:
+ app_agg_task
+
+ Function Description:
+ @brief  Aggregator task. Every APP_AGG_TICK_MS it restarts a stopped scan,
+         advances the simulated peers, reads the connected peers, drops the
+         silent ones and sends the batch of new readings on the uplink.
+
+ @param pvParam  Not used
+
+ @return void
+ */
+static void app_agg_task(void *pvParam)
+{
+    TickType_t wake = xTaskGetTickCount();
+
+    while (true)
+    {
+        if (!app_agg_scanning)
+        {
+            app_agg_start_scan();
+        }
+        app_agg_sim_tick();
+        app_agg_poll();
+        app_agg_expire();
+        app_agg_flush();
+
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(APP_AGG_TICK_MS));
+    }
+}
+
+/*
+ Function Name:
+ app_agg_start_scan
+
+ Function Description:
+ @brief  Starts a passive scan with the timing of the schedule, with the
+         duplicate filter off so that broadcast readings keep coming.
+
+ @param void
+
+ @return void
+ */
+static void app_agg_start_scan(void)
+{
+    wiced_result_t result;
+
+    result = wiced_bt_ble_scan(BTM_BLE_SCAN_TYPE_LOW_DUTY, WICED_FALSE,
+                               app_agg_scan_result_cb);
+    app_agg_scanning = (WICED_BT_SUCCESS == result) || (WICED_BT_PENDING == result);
+}
+
+/*
+ Function Name:
+ app_agg_scan_result_cb
+
+ Function Description:
+ @brief  Scan result callback, in the Bluetooth stack thread. Advertisements
+         without the Environmental Sensing Service are ignored.
+
+ @param p_scan_result  Advertiser, NULL when the scan ends
+ @param p_adv_data     Advertising data
+
+ @return void
+ */
+static void app_agg_scan_result_cb(wiced_bt_ble_scan_results_t *p_scan_result,
+                                   uint8_t *p_adv_data)
+{
+    app_agg_adv_t adv;
+
+    if (NULL == p_scan_result)
+    {
+        app_agg_scanning = false;
+        return;
+    }
+
+    app_agg_stats.adverts++;
+    if (app_agg_parse_adv(p_adv_data, &adv))
+    {
+        app_agg_stats.ess_adverts++;
+        app_agg_seen(p_scan_result, &adv, false);
+    }
+}
+
+/*
+ Function Name:
+ app_agg_parse_adv
+
+ Function Description:
+ @brief  Looks for the Environmental Sensing Service in the 16-bit service
+         UUID lists and for a temperature in the service data, as the
+         Temperature characteristic UUID followed by its value.
+
+ @param p_adv_data  Advertising data, up to APP_AGG_ADV_MAX_LEN bytes
+ @param p_adv       ESS content found
+
+ @return bool  true if the advertiser has the Environmental Sensing Service
+ */
+static bool app_agg_parse_adv(const uint8_t *p_adv_data, app_agg_adv_t *p_adv)
+{
+    const uint8_t *p_elem = p_adv_data;
+    const uint8_t *p_end = p_adv_data + APP_AGG_ADV_MAX_LEN;
+    uint16_t uuid;
+    uint8_t len;
+    uint8_t i;
+
+    memset(p_adv, 0, sizeof(*p_adv));
+
+    /* Elements are a length, the type and length - 1 data bytes */
+    while ((p_elem < p_end) && (0 != p_elem[0]) && ((p_elem + 1u + p_elem[0]) <= p_end))
+    {
+        len = p_elem[0] - 1u;
+        switch (p_elem[1])
+        {
+            case BTM_BLE_ADVERT_TYPE_16SRV_PARTIAL:
+            case BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE:
+                for (i = 0; (i + 1u) < len; i += 2u)
+                {
+                    uuid = (uint16_t)(p_elem[2 + i] | (p_elem[3 + i] << 8));
+                    p_adv->ess |= (APP_ESS_UUID_SERVICE == uuid);
+                }
+                break;
+
+            case BTM_BLE_ADVERT_TYPE_SERVICE_DATA:
+                uuid = (4u <= len) ? (uint16_t)(p_elem[2] | (p_elem[3] << 8)) : 0;
+                if (APP_ESS_UUID_TEMPERATURE == uuid)
+                {
+                    p_adv->has_temperature = true;
+                    p_adv->temperature = (int16_t)(p_elem[4] | (p_elem[5] << 8));
+                }
+                break;
+
+            default:
+                break;
+        }
+        p_elem += 1u + p_elem[0];
+    }
+
+    return p_adv->ess;
+}
+
+/*
+ Function Name:
+ app_agg_seen
+
+ Function Description:
+ @brief  Updates the peer of an ESS advertisement: takes its broadcast
+         reading, or connects to it if it is connectable, does not broadcast
+         and a link is free.
+
+ @param p_scan_result  Advertiser
+ @param p_adv          ESS content of the advertisement
+ @param sim            The advertiser is a simulated peer
+
+ @return void
+ */
+static void app_agg_seen(const wiced_bt_ble_scan_results_t *p_scan_result,
+                         const app_agg_adv_t *p_adv, bool sim)
+{
+    app_agg_peer_t *p_peer;
+    bool connect = false;
+
+    taskENTER_CRITICAL();
+    p_peer = app_agg_peer_by_addr(p_scan_result->remote_bd_addr, true);
+    if (NULL != p_peer)
+    {
+        if (APP_AGG_PEER_FREE == p_peer->state)
+        {
+            p_peer->state = APP_AGG_PEER_SEEN;
+            p_peer->addr_type = p_scan_result->ble_addr_type;
+            p_peer->sim = sim;
+        }
+        p_peer->rssi = p_scan_result->rssi;
+        p_peer->seen_ms = app_uptime_ms_get();
+
+        if (p_adv->has_temperature && (APP_AGG_PEER_SEEN <= p_peer->state) &&
+            (APP_AGG_PEER_LISTEN >= p_peer->state))
+        {
+            p_peer->state = APP_AGG_PEER_LISTEN;
+            app_agg_reading(p_peer, p_adv->temperature);
+        }
+        else if ((APP_AGG_PEER_SEEN == p_peer->state) &&
+                 (BTM_BLE_EVT_CONNECTABLE_ADVERTISEMENT == p_scan_result->ble_evt_type) &&
+                 (APP_AGG_MAX_CONNS > app_agg_num_conns))
+        {
+            p_peer->state = APP_AGG_PEER_CONNECTING;
+            app_agg_num_conns++;
+            connect = true;
+        }
+    }
+    else
+    {
+        app_agg_stats.table_full++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (connect)
+    {
+        app_agg_connect(p_peer);
+    }
+}
+
+/*
+ Function Name:
+ app_agg_peer_by_addr
+
+ Function Description:
+ @brief  Finds the peer of an address, or takes a free entry for it.
+
+ @param p_bd_addr  Peer address
+ @param alloc      Take a free entry if the address is not in the table
+
+ @return app_agg_peer_t*  Peer, NULL if none (and the table is full)
+ */
+static app_agg_peer_t *app_agg_peer_by_addr(const uint8_t *p_bd_addr, bool alloc)
+{
+    app_agg_peer_t *p_free = NULL;
+    uint32_t i;
+
+    for (i = 0; i < APP_AGG_MAX_PEERS; i++)
+    {
+        if (APP_AGG_PEER_FREE == app_agg_peers[i].state)
+        {
+            p_free = (NULL == p_free) ? &app_agg_peers[i] : p_free;
+        }
+        else if (0 == memcmp(app_agg_peers[i].bd_addr, p_bd_addr,
+                             sizeof(wiced_bt_device_address_t)))
+        {
+            return &app_agg_peers[i];
+        }
+    }
+
+    if (alloc && (NULL != p_free))
+    {
+        memset(p_free, 0, sizeof(*p_free));
+        memcpy(p_free->bd_addr, p_bd_addr, sizeof(wiced_bt_device_address_t));
+        return p_free;
+    }
+
+    return NULL;
+}
+
+/*
+ Function Name:
+ app_agg_peer_by_conn
+
+ Function Description:
+ @brief  Finds the connected peer of a connection ID.
+
+ @param conn_id  Connection ID
+
+ @return app_agg_peer_t*  Peer, NULL if none
+ */
+static app_agg_peer_t *app_agg_peer_by_conn(uint16_t conn_id)
+{
+    uint32_t i;
+
+    for (i = 0; i < APP_AGG_MAX_PEERS; i++)
+    {
+        if ((APP_AGG_PEER_CONNECTED == app_agg_peers[i].state) &&
+            (conn_id == app_agg_peers[i].conn_id))
+        {
+            return &app_agg_peers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ Function Name:
+ app_agg_reading
+
+ Function Description:
+ @brief  Stores a reading of a peer. Only the newest reading of each peer
+         goes into the next batch. Called in a critical section.
+
+ @param p_peer       Peer
+ @param temperature  Temperature in hundredths of a degree Celsius
+
+ @return void
+ */
+static void app_agg_reading(app_agg_peer_t *p_peer, int16_t temperature)
+{
+    p_peer->temperature = temperature;
+    p_peer->reading_ms = app_uptime_ms_get();
+    p_peer->fresh = true;
+    p_peer->readings++;
+    app_agg_stats.readings++;
+}
+
+/*
+ Function Name:
+ app_agg_connect
+
+ Function Description:
+ @brief  Connects to a peer, with the connection timing of the schedule.
+
+ @param p_peer  Peer in the connecting state
+
+ @return void
+ */
+static void app_agg_connect(app_agg_peer_t *p_peer)
+{
+    if (p_peer->sim)
+    {
+        app_agg_sim_conn(p_peer, true);
+        return;
+    }
+
+    if (!wiced_bt_gatt_le_connect(p_peer->bd_addr, p_peer->addr_type,
+                                  BLE_CONN_MODE_HIGH_DUTY, WICED_TRUE))
+    {
+        taskENTER_CRITICAL();
+        p_peer->state = APP_AGG_PEER_SEEN;
+        app_agg_num_conns--;
+        app_agg_stats.connect_failures++;
+        taskEXIT_CRITICAL();
+    }
+}
+
+/*
+ Function Name:
+ app_agg_poll
+
+ Function Description:
+ @brief  Reads the temperature of each connected peer with no read in
+         flight, by type so that no discovery is needed.
+
+ @param void
+
+ @return void
+ */
+static void app_agg_poll(void)
+{
+    static wiced_bt_uuid_t temperature_uuid =
+    {
+        LEN_UUID_16, { .uuid16 = APP_ESS_UUID_TEMPERATURE }
+    };
+    app_agg_peer_t *p_peer;
+    uint32_t i;
+
+    for (i = 0; i < APP_AGG_MAX_PEERS; i++)
+    {
+        p_peer = &app_agg_peers[i];
+        if ((APP_AGG_PEER_CONNECTED != p_peer->state) || p_peer->read_busy)
+        {
+            continue;
+        }
+
+        p_peer->read_busy = true;
+        if (p_peer->sim)
+        {
+            app_agg_sim_read(p_peer);
+        }
+        else if (WICED_BT_GATT_SUCCESS !=
+                 wiced_bt_gatt_client_send_read_by_type(p_peer->conn_id,
+                                                        APP_AGG_READ_START_HANDLE,
+                                                        APP_AGG_READ_END_HANDLE,
+                                                        &temperature_uuid,
+                                                        p_peer->read_buf,
+                                                        sizeof(p_peer->read_buf),
+                                                        GATT_AUTH_REQ_NONE))
+        {
+            p_peer->read_busy = false;
+            app_agg_stats.read_errors++;
+        }
+    }
+}
+
+/*
+ Function Name:
+ app_agg_op_complete_handler
+
+ Function Description:
+ @brief  Event handler for GATT_OPERATION_CPLT_EVT, the completion of a
+         read of a connected peer.
+
+ @param p_event_data  GATT event data
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_agg_op_complete_handler(wiced_bt_gatt_event_data_t *p_event_data)
+{
+    wiced_bt_gatt_operation_complete_t *p_op = &p_event_data->operation_complete;
+    wiced_bt_gatt_handle_value_t *p_value = &p_op->response_data.att_value;
+    app_agg_peer_t *p_peer;
+
+    if (GATTC_OPTYPE_READ_BY_TYPE != p_op->op)
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    taskENTER_CRITICAL();
+    p_peer = app_agg_peer_by_conn(p_op->conn_id);
+    if (NULL != p_peer)
+    {
+        p_peer->read_busy = false;
+        if ((WICED_BT_GATT_SUCCESS == p_op->status) && (2u <= p_value->len))
+        {
+            p_peer->seen_ms = app_uptime_ms_get();
+            app_agg_reading(p_peer, (int16_t)(p_value->p_data[0] | (p_value->p_data[1] << 8)));
+        }
+        else
+        {
+            app_agg_stats.read_errors++;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_agg_expire
+
+ Function Description:
+ @brief  Frees the entries of the peers not heard from for
+         APP_AGG_PEER_TIMEOUT_MS. Connected peers stay until their link drops.
+
+ @param void
+
+ @return void
+ */
+static void app_agg_expire(void)
+{
+    uint64_t now_ms = app_uptime_ms_get();
+    app_agg_peer_t *p_peer;
+    uint32_t i;
+
+    taskENTER_CRITICAL();
+    for (i = 0; i < APP_AGG_MAX_PEERS; i++)
+    {
+        p_peer = &app_agg_peers[i];
+        if (((APP_AGG_PEER_SEEN == p_peer->state) || (APP_AGG_PEER_LISTEN == p_peer->state)) &&
+            ((now_ms - p_peer->seen_ms) > APP_AGG_PEER_TIMEOUT_MS))
+        {
+            p_peer->state = APP_AGG_PEER_FREE;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_agg_flush
+
+ Function Description:
+ @brief  Builds the batch of the readings received since the last one and
+         notifies it frame by frame if the uplink client subscribed. The
+         batch characteristic keeps the last batch for reads.
+
+ @param void
+
+ @return void
+ */
+static void app_agg_flush(void)
+{
+    uint8_t *p_frame = app_agg_batch;
+    uint8_t *p_rec = app_agg_batch;
+    uint64_t now_ms = app_uptime_ms_get();
+    uint64_t age_s;
+    uint16_t frame_lens[APP_AGG_FRAMES];
+    uint16_t conn_id = app_bt_conn_id;
+    uint32_t frame_records;
+    uint32_t frames = 0;
+    uint32_t i;
+
+    /* Frames are split at the MTU of the uplink, the one a central that
+     * skips the MTU exchange keeps is the default */
+    frame_records = APP_AGG_FRAME_RECORDS_AT(app_gatt_tx_get_mtu(conn_id));
+    frame_records = (APP_AGG_FRAME_RECORDS < frame_records) ? APP_AGG_FRAME_RECORDS
+                                                            : frame_records;
+
+    taskENTER_CRITICAL();
+    for (i = 0; i < APP_AGG_MAX_PEERS; i++)
+    {
+        if (!app_agg_peers[i].fresh)
+        {
+            continue;
+        }
+
+        if ((p_rec == p_frame) || (frame_records == p_frame[1]))
+        {
+            /* Start a frame */
+            p_frame = p_rec;
+            p_frame[0] = app_agg_seq++;
+            p_frame[1] = 0;
+            p_rec += APP_AGG_FRAME_HEADER_LEN;
+            frames++;
+        }
+
+        age_s = (now_ms - app_agg_peers[i].reading_ms) / 1000u;
+        p_rec[0] = (uint8_t)i;
+        p_rec[1] = (uint8_t)((age_s > UINT8_MAX) ? UINT8_MAX : age_s);
+        p_rec[2] = (uint8_t)app_agg_peers[i].temperature;
+        p_rec[3] = (uint8_t)((uint16_t)app_agg_peers[i].temperature >> 8);
+        p_rec += APP_AGG_RECORD_LEN;
+        p_frame[1]++;
+        frame_lens[frames - 1u] = (uint16_t)(p_rec - p_frame);
+        app_agg_peers[i].fresh = false;
+    }
+    taskEXIT_CRITICAL();
+
+    if (0 == frames)
+    {
+        return;
+    }
+    app_agg_attrs[0].cur_len = (uint16_t)(p_rec - app_agg_batch);
+
+    if ((0 == conn_id) || (conn_id != app_bt_conn_id) ||
+        (0 == (app_agg_batch_cccd[0] & GATT_CLIENT_CONFIG_NOTIFICATION)))
+    {
+        app_agg_stats.frames_unsent += frames;
+        return;
+    }
+
+    p_frame = app_agg_batch;
+    for (i = 0; i < frames; i++)
+    {
+        if (WICED_BT_GATT_SUCCESS == app_gatt_tx_notification(conn_id,
+                                                              HDLC_APP_AGG_BATCH_VALUE,
+                                                              frame_lens[i], p_frame, NULL))
+        {
+            app_agg_stats.frames++;
+        }
+        else
+        {
+            app_agg_stats.frames_unsent++;
+        }
+        p_frame += frame_lens[i];
+    }
+}
+
+/*
+ Function Name:
+ app_agg_uplink_status
+
+ Function Description:
+ @brief  Puts a new uplink on the connection interval of the schedule and
+         clears its subscription when it drops.
+
+ @param p_conn_status  Connection status event of a peripheral link
+
+ @return void
+ */
+static void app_agg_uplink_status(const wiced_bt_gatt_connection_status_t *p_conn_status)
+{
+    if (p_conn_status->connected && (0 == app_bt_conn_id))
+    {
+        wiced_bt_l2cap_update_ble_conn_params(p_conn_status->bd_addr,
+                                              app_agg_plan.conn_interval,
+                                              app_agg_plan.conn_interval, 0,
+                                              APP_AGG_SUPERVISION_TIMEOUT);
+    }
+    else if (!p_conn_status->connected && (p_conn_status->conn_id == app_bt_conn_id))
+    {
+        app_agg_batch_cccd[0] = 0;
+        app_agg_batch_cccd[1] = 0;
+    }
+}
+
+/*
+ Function Name:
+ app_agg_sim_tick
+
+ Function Description:
+ @brief  Advertises for each simulated peer. Even peers broadcast a
+         temperature in a non connectable advertisement, odd ones advertise
+         connectable with the ESS UUID only and are read once connected.
+         The temperatures follow a random walk.
+
+ @param void
+
+ @return void
+ */
+static void app_agg_sim_tick(void)
+{
+    wiced_bt_ble_scan_results_t result;
+    app_agg_adv_t parsed;
+    uint8_t adv[APP_AGG_ADV_MAX_LEN];
+    uint8_t len;
+    uint32_t i;
+
+    for (i = 0; i < app_agg_sim_count; i++)
+    {
+        app_agg_sim_random = (app_agg_sim_random * 1103515245u) + 12345u;
+        app_agg_sim_temperature[i] += (int16_t)((int32_t)((app_agg_sim_random >> 16) % 21u) - 10);
+
+        memset(&result, 0, sizeof(result));
+        memset(adv, 0, sizeof(adv));
+        app_agg_sim_addr(i, result.remote_bd_addr);
+        result.ble_addr_type = BLE_ADDR_RANDOM;
+        result.rssi = (int8_t)(-50 - (int8_t)(4u * i));
+
+        len = 0;
+        adv[len++] = 2u;
+        adv[len++] = BTM_BLE_ADVERT_TYPE_FLAG;
+        adv[len++] = BTM_BLE_GENERAL_DISCOVERABLE_FLAG | BTM_BLE_BREDR_NOT_SUPPORTED;
+        adv[len++] = 3u;
+        adv[len++] = BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE;
+        adv[len++] = (uint8_t)APP_ESS_UUID_SERVICE;
+        adv[len++] = (uint8_t)(APP_ESS_UUID_SERVICE >> 8);
+        if (0 == (i % 2u))
+        {
+            result.ble_evt_type = BTM_BLE_EVT_NON_CONNECTABLE_ADVERTISEMENT;
+            adv[len++] = 5u;
+            adv[len++] = BTM_BLE_ADVERT_TYPE_SERVICE_DATA;
+            adv[len++] = (uint8_t)APP_ESS_UUID_TEMPERATURE;
+            adv[len++] = (uint8_t)(APP_ESS_UUID_TEMPERATURE >> 8);
+            adv[len++] = (uint8_t)app_agg_sim_temperature[i];
+            adv[len++] = (uint8_t)((uint16_t)app_agg_sim_temperature[i] >> 8);
+        }
+        else
+        {
+            result.ble_evt_type = BTM_BLE_EVT_CONNECTABLE_ADVERTISEMENT;
+        }
+
+        app_agg_stats.adverts++;
+        if (app_agg_parse_adv(adv, &parsed))
+        {
+            app_agg_stats.ess_adverts++;
+            app_agg_seen(&result, &parsed, true);
+        }
+    }
+}
+
+/*
+ Function Name:
+ app_agg_sim_addr
+
+ Function Description:
+ @brief  Returns the address of a simulated peer.
+
+ @param index    Simulated peer
+ @param bd_addr  Address
+
+ @return void
+ */
+static void app_agg_sim_addr(uint32_t index, wiced_bt_device_address_t bd_addr)
+{
+    static const uint8_t sim_oui[] = { 0x00, 0xA0, 0x50, 0x41, 0x47 };
+
+    memcpy(bd_addr, sim_oui, sizeof(sim_oui));
+    bd_addr[sizeof(sim_oui)] = (uint8_t)index;
+}
+
+/*
+ Function Name:
+ app_agg_sim_conn
+
+ Function Description:
+ @brief  Connects or disconnects a simulated peer, through the GATT event
+         callback like a link of the stack.
+
+ @param p_peer     Simulated peer
+ @param connected  Connection or disconnection
+
+ @return void
+ */
+static void app_agg_sim_conn(app_agg_peer_t *p_peer, bool connected)
+{
+    wiced_bt_gatt_event_data_t event_data;
+
+    memset(&event_data, 0, sizeof(event_data));
+    event_data.connection_status.bd_addr = p_peer->bd_addr;
+    event_data.connection_status.conn_id =
+        (uint16_t)(APP_AGG_SIM_CONN_ID_BASE + (p_peer - app_agg_peers));
+    event_data.connection_status.connected = connected ? WICED_TRUE : WICED_FALSE;
+    event_data.connection_status.reason = connected ? 0 : GATT_CONN_TERMINATE_LOCAL_HOST;
+    event_data.connection_status.link_role = HCI_ROLE_CENTRAL;
+
+    app_bt_gatt_event_callback(GATT_CONNECTION_STATUS_EVT, &event_data);
+}
+
+/*
+ Function Name:
+ app_agg_sim_read
+
+ Function Description:
+ @brief  Completes a read of a connected simulated peer, through the GATT
+         event callback like a response of the stack.
+
+ @param p_peer  Simulated peer
+
+ @return void
+ */
+static void app_agg_sim_read(app_agg_peer_t *p_peer)
+{
+    wiced_bt_gatt_event_data_t event_data;
+    int16_t temperature = app_agg_sim_temperature[p_peer - app_agg_peers];
+
+    p_peer->read_buf[0] = (uint8_t)temperature;
+    p_peer->read_buf[1] = (uint8_t)((uint16_t)temperature >> 8);
+
+    memset(&event_data, 0, sizeof(event_data));
+    event_data.operation_complete.conn_id = p_peer->conn_id;
+    event_data.operation_complete.op = GATTC_OPTYPE_READ_BY_TYPE;
+    event_data.operation_complete.status = WICED_BT_GATT_SUCCESS;
+    event_data.operation_complete.response_data.att_value.handle =
+        APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE;
+    event_data.operation_complete.response_data.att_value.len = 2u;
+    event_data.operation_complete.response_data.att_value.p_data = p_peer->read_buf;
+
+    app_bt_gatt_event_callback(GATT_OPERATION_CPLT_EVT, &event_data);
+}
+
+/*
+ Function Name:
+ app_agg_read_cb
+
+ Function Description:
+ @brief  Refreshes the peers characteristic before it is read.
+
+ @param attr_handle  GATT attribute handle
+
+ @return void
+ */
+static void app_agg_read_cb(uint16_t attr_handle)
+{
+    uint8_t *p_rec = app_agg_peers_value;
+    uint32_t i;
+
+    if (HDLC_APP_AGG_PEERS_VALUE != attr_handle)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    for (i = 0; i < APP_AGG_MAX_PEERS; i++)
+    {
+        memcpy(p_rec, app_agg_peers[i].bd_addr, sizeof(wiced_bt_device_address_t));
+        p_rec[6] = app_agg_peers[i].state;
+        p_rec[7] = (uint8_t)app_agg_peers[i].rssi;
+        p_rec += APP_AGG_PEER_RECORD_LEN;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_agg_write_cb
+
+ Function Description:
+ @brief  Accepts the writes of the batch CCCD only.
+
+ @param attr_handle  GATT attribute handle
+ @param offset       Offset of the write
+ @param p_val        Value written
+ @param len          Length of the value
+
+ @return wiced_bt_gatt_status_t  WICED_BT_GATT_WRITE_NOT_PERMIT for the
+                                 other attributes
+ */
+static wiced_bt_gatt_status_t app_agg_write_cb(uint16_t attr_handle, uint16_t offset,
+                                               const uint8_t *p_val, uint16_t len)
+{
+    return (HDLD_APP_AGG_BATCH_CLIENT_CHAR_CONFIG == attr_handle)
+           ? WICED_BT_GATT_SUCCESS : WICED_BT_GATT_WRITE_NOT_PERMIT;
+}
+
+/*
+ Function Name:
+ app_agg_cmd
+
+ Function Description:
+ @brief  "agg" console command. Prints the schedule, the counters and the
+         peers; "agg sim <peers>" sets the number of simulated peers, 0 to
+         stop them.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_agg_cmd(uint32_t argc, char *argv[])
+{
+    static const char * const state_names[] =
+    {
+        "free", "seen", "listen", "connecting", "connected"
+    };
+    uint64_t now_ms = app_uptime_ms_get();
+    wiced_bt_device_address_t bd_addr;
+    app_agg_peer_t *p_peer;
+    uint32_t count;
+    uint32_t i;
+
+    if ((3 <= argc) && (0 == strcmp(argv[1], "sim")))
+    {
+        count = strtoul(argv[2], NULL, 0);
+        count = (APP_AGG_MAX_PEERS < count) ? APP_AGG_MAX_PEERS : count;
+        for (i = count; i < app_agg_sim_count; i++)
+        {
+            /* Peers beyond the new count leave */
+            app_agg_sim_addr(i, bd_addr);
+            p_peer = app_agg_peer_by_addr(bd_addr, false);
+            if ((NULL != p_peer) && (APP_AGG_PEER_CONNECTED == p_peer->state))
+            {
+                app_agg_sim_conn(p_peer, false);
+            }
+            if (NULL != p_peer)
+            {
+                p_peer->state = APP_AGG_PEER_FREE;
+            }
+        }
+        for (i = app_agg_sim_count; i < count; i++)
+        {
+            app_agg_sim_temperature[i] = (int16_t)(2000 + (100 * (int32_t)i));
+        }
+        app_agg_sim_count = count;
+        return;
+    }
+
+    printf("Schedule: interval %u x 1.25 ms, scan window %u of %u x 0.625 ms, %u links\n",
+           app_agg_plan.conn_interval, app_agg_plan.scan_window, app_agg_plan.scan_interval,
+           (unsigned)(1u + APP_AGG_MAX_CONNS));
+    printf("Scanning %u, adverts %lu (ESS %lu), readings %lu, table full %lu\n",
+           app_agg_scanning, (unsigned long)app_agg_stats.adverts,
+           (unsigned long)app_agg_stats.ess_adverts, (unsigned long)app_agg_stats.readings,
+           (unsigned long)app_agg_stats.table_full);
+    printf("Links: connects %lu, failures %lu, disconnects %lu, read errors %lu\n",
+           (unsigned long)app_agg_stats.connects, (unsigned long)app_agg_stats.connect_failures,
+           (unsigned long)app_agg_stats.disconnects, (unsigned long)app_agg_stats.read_errors);
+    printf("Uplink: frames %lu, unsent %lu, MTU %u\n",
+           (unsigned long)app_agg_stats.frames, (unsigned long)app_agg_stats.frames_unsent,
+           (unsigned)app_gatt_tx_get_mtu(app_bt_conn_id));
+
+    for (i = 0; i < APP_AGG_MAX_PEERS; i++)
+    {
+        p_peer = &app_agg_peers[i];
+        if (APP_AGG_PEER_FREE == p_peer->state)
+        {
+            continue;
+        }
+        printf("  %lu %02X:%02X:%02X:%02X:%02X:%02X %-10s %4d dBm %6d (%lu s ago) %lu readings%s\n",
+               (unsigned long)i, p_peer->bd_addr[0], p_peer->bd_addr[1], p_peer->bd_addr[2],
+               p_peer->bd_addr[3], p_peer->bd_addr[4], p_peer->bd_addr[5],
+               state_names[p_peer->state], p_peer->rssi, p_peer->temperature,
+               (unsigned long)((now_ms - p_peer->reading_ms) / 1000u),
+               (unsigned long)p_peer->readings, p_peer->sim ? " sim" : "");
+    }
+}
+
+#endif /* APP_AGGREGATOR */
+
+/* [] END OF FILE */
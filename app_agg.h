@@ -0,0 +1,168 @@
+/*******************************************************************************
+* File Name: app_agg.h
+*
+* Description: This file contains the constants and API of the aggregator mode,
+*              which collects the readings of other Environmental Sensing
+*              devices into one uplink.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_AGG_H__
+#define __APP_AGG_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_handler.h"
+#include "app_bt_gatt_tx.h"
+#include "app_gatt_gen.h"
+#include "cycfg_bt_settings.h"
+#include "wiced_bt_gatt.h"
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_AGGREGATOR=1 in the Makefile to scan for other ESS
+ * devices and serve their readings in batches on the uplink connection.
+ */
+#ifndef APP_AGGREGATOR
+#define APP_AGGREGATOR                   (0u)
+#endif
+
+/* Peers tracked. A peer broadcasting its temperature in the advertising data
+ * is listened to; one that does not is connected to and read.
+ */
+#ifndef APP_AGG_MAX_PEERS
+#define APP_AGG_MAX_PEERS                (8u)
+#endif
+
+/* Peers connected at the same time, besides the uplink */
+#ifndef APP_AGG_MAX_CONNS
+#define APP_AGG_MAX_CONNS                (2u)
+#endif
+
+/* Period of the batches on the uplink and of the reads of connected peers */
+#ifndef APP_AGG_TICK_MS
+#define APP_AGG_TICK_MS                  (1000u)
+#endif
+
+/* A peer not heard from for this time is dropped from the table */
+#ifndef APP_AGG_PEER_TIMEOUT_MS
+#define APP_AGG_PEER_TIMEOUT_MS          (30000u)
+#endif
+
+/* Connection schedule. All links, uplink included, share one connection
+ * interval; the controller places their events back to back and the scan
+ * window, repeating with the same period, takes the rest of the interval.
+ * The interval is stretched until the window is at least
+ * APP_AGG_MIN_SCAN_WINDOW_US.
+ *   APP_AGG_CONN_INTERVAL       Shortest interval, in 1.25 ms units
+ *   APP_AGG_CONN_EVENT_US       Time reserved for each connection event
+ *   APP_AGG_SCAN_GUARD_US       Margin between the last event and the window
+ */
+#ifndef APP_AGG_CONN_INTERVAL
+#define APP_AGG_CONN_INTERVAL            (24u)
+#endif
+#define APP_AGG_CONN_EVENT_US            (2500u)
+#define APP_AGG_SCAN_GUARD_US            (1250u)
+#define APP_AGG_MIN_SCAN_WINDOW_US       (10000u)
+
+/* Supervision timeout of the links, in 10 ms units */
+#define APP_AGG_SUPERVISION_TIMEOUT      (500u)
+
+/* Connection ID of the first simulated peer, outside the range of the stack */
+#define APP_AGG_SIM_CONN_ID_BASE         (0x6000u)
+
+/* Batch characteristic. The value is a sequence of frames, one per
+ * notification: a sequence number and a record count, then the records.
+ * A record is the peer index, the age of the reading in seconds (255 for
+ * older) and the temperature in hundredths of a degree Celsius, little
+ * endian. A frame fits a notification at the MTU negotiated by the uplink,
+ * ATT_MTU - 3 bytes; the batch is sized for the default ATT_MTU of 23.
+ */
+#define APP_AGG_FRAME_HEADER_LEN         (2u)
+#define APP_AGG_RECORD_LEN               (4u)
+#define APP_AGG_FRAME_RECORDS_AT(mtu)    \
+    (((uint32_t)(mtu) - 3u - APP_AGG_FRAME_HEADER_LEN) / APP_AGG_RECORD_LEN)
+#define APP_AGG_FRAME_RECORDS            APP_AGG_FRAME_RECORDS_AT(APP_GATT_GEN_MTU)
+#define APP_AGG_MIN_FRAME_RECORDS        APP_AGG_FRAME_RECORDS_AT(APP_GATT_TX_DEFAULT_MTU)
+#define APP_AGG_FRAMES                   \
+    ((APP_AGG_MAX_PEERS + APP_AGG_MIN_FRAME_RECORDS - 1u) / APP_AGG_MIN_FRAME_RECORDS)
+#define APP_AGG_BATCH_LEN                \
+    ((APP_AGG_FRAMES * APP_AGG_FRAME_HEADER_LEN) + (APP_AGG_MAX_PEERS * APP_AGG_RECORD_LEN))
+
+/* Peers characteristic: per peer index its address, state and RSSI */
+#define APP_AGG_PEER_RECORD_LEN          (8u)
+
+/* Aggregator service, vendor specific */
+#define APP_AGG_UUID_SERVICE             0x10, 0x0e, 0x1d, 0x4c, 0x7f, 0x2b, 0x1f, 0x9c, \
+                                         0x2a, 0x4d, 0x6b, 0x8e, 0x03, 0x00, 0x3e, 0x5a
+#define APP_AGG_UUID_BATCH               0x10, 0x0e, 0x1d, 0x4c, 0x7f, 0x2b, 0x1f, 0x9c, \
+                                         0x2a, 0x4d, 0x6b, 0x8e, 0x04, 0x00, 0x3e, 0x5a
+#define APP_AGG_UUID_PEERS               0x10, 0x0e, 0x1d, 0x4c, 0x7f, 0x2b, 0x1f, 0x9c, \
+                                         0x2a, 0x4d, 0x6b, 0x8e, 0x05, 0x00, 0x3e, 0x5a
+
+#define HDLS_APP_AGG                     (APP_GATT_APP_HANDLE_BASE + 0x30u)
+#define HDLC_APP_AGG_BATCH               (HDLS_APP_AGG + 1u)
+#define HDLC_APP_AGG_BATCH_VALUE         (HDLS_APP_AGG + 2u)
+#define HDLD_APP_AGG_BATCH_CLIENT_CHAR_CONFIG (HDLS_APP_AGG + 3u)
+#define HDLC_APP_AGG_PEERS               (HDLS_APP_AGG + 4u)
+#define HDLC_APP_AGG_PEERS_VALUE         (HDLS_APP_AGG + 5u)
+
+#define APP_AGG_TASK_NAME                "Aggregator"
+#define APP_AGG_STACK_SIZE               (configMINIMAL_STACK_SIZE * 4)
+#define APP_AGG_PRIORITY                 (configMAX_PRIORITIES - 4)
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+const wiced_bt_cfg_settings_t *app_agg_bt_cfg(const wiced_bt_cfg_settings_t *p_cfg);
+
+void app_agg_init(void);
+
+void app_agg_start(void);
+
+bool app_agg_conn_status(wiced_bt_gatt_connection_status_t *p_conn_status);
+
+void app_agg_scan_state(wiced_bt_ble_scan_type_t scan_type);
+
+#endif      /* __APP_AGG_H__ */
+
+/* [] END OF FILE */
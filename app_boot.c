@@ -0,0 +1,244 @@
+/*******************************************************************************
+* File Name: app_boot.c
+*
+* Description: This file contains the boot milestones. The time of each startup
+*              step since the start of main() is taken from the CPU cycle
+*              counter and, once the scheduler runs, from the RTOS tick so that
+*              sleep periods are counted. The BOOT line with all milestones and
+*              the reset cause is the first line logged after power-on or a
+*              reset.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_boot.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "cyhal.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Cycle counter at the start of main() */
+static uint32_t                 app_boot_start_cycles;
+
+/* Microseconds since the start of main(), 0 if not reached */
+static uint32_t                 app_boot_us[APP_BOOT_MILESTONE_COUNT];
+
+static cyhal_reset_reason_t     app_boot_reset_reason;
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static uint32_t app_boot_now_us(void);
+
+static void app_boot_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const char * const app_boot_names[APP_BOOT_MILESTONE_COUNT] =
+{
+    "bsp", "retarget", "bt_platform", "stack_init", "scheduler", "bt_enabled",
+    "gatt_db", "adv_start", "adv_on", "deferred"
+};
+
+static const app_console_cmd_t app_boot_console_cmd =
+{
+    "boot", "Boot milestones in us since main() and the reset cause", app_boot_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_boot_init
+
+ Function Description:
+ @brief  Starts the boot clock and reads the reset cause. Must be the first
+         call of main(). The time spent in the startup code before main() is
+         not counted.
+
+ @param void
+
+ @return void
+ */
+void app_boot_init(void)
+{
+    app_cycle_counter_init();
+    app_boot_start_cycles = app_cycle_counter_get();
+
+    app_boot_reset_reason = cyhal_system_get_reset_reason();
+    cyhal_system_clear_reset_reason();
+}
+
+/*
+ Function Name:
+ app_boot_milestone
+
+ Function Description:
+ @brief  Records the time a milestone is reached, the first time only. The
+         BOOT report is printed when advertising is on.
+
+ @param milestone  Milestone reached
+
+ @return void
+ */
+void app_boot_milestone(app_boot_milestone_t milestone)
+{
+    if (0u != app_boot_us[milestone])
+    {
+        return;
+    }
+
+    /* 0 marks a milestone not reached */
+    app_boot_us[milestone] = app_boot_now_us() | 1u;
+
+    if (APP_BOOT_ADV_ON == milestone)
+    {
+        app_boot_print_report();
+    }
+    else if (APP_BOOT_DEFERRED == milestone)
+    {
+        printf("BOOT deferred init done at %lu us\n",
+               (unsigned long)app_boot_us[APP_BOOT_DEFERRED]);
+    }
+}
+
+/*
+ Function Name:
+ app_boot_register_console
+
+ Function Description:
+ @brief  Registers the boot console command.
+
+ @param void
+
+ @return void
+ */
+void app_boot_register_console(void)
+{
+    app_console_register_command(&app_boot_console_cmd);
+}
+
+/*
+ Function Name:
+ app_boot_print_report
+
+ Function Description:
+ @brief  Prints the BOOT line: the reset cause and the milestones reached, in
+         microseconds since the start of main().
+
+ @param void
+
+ @return void
+ */
+void app_boot_print_report(void)
+{
+    uint32_t i;
+
+    printf("BOOT reset=0x%lx%s%s", (unsigned long)app_boot_reset_reason,
+           (0 != (app_boot_reset_reason & CYHAL_SYSTEM_RESET_WDT)) ? "(watchdog)" : "",
+           (CYHAL_SYSTEM_RESET_NONE == app_boot_reset_reason) ? "(power-on)" : "");
+    for (i = 0; i < APP_BOOT_MILESTONE_COUNT; i++)
+    {
+        if (0u != app_boot_us[i])
+        {
+            printf(" %s=%lu", app_boot_names[i], (unsigned long)app_boot_us[i]);
+        }
+    }
+    printf("\n");
+}
+
+/*
+ Function Name:
+ app_boot_now_us
+
+ Function Description:
+ @brief  Returns the time since the start of main(). The cycle counter stops
+         while the CPU sleeps, so once the scheduler runs the RTOS tick since
+         the scheduler start is used when it is ahead.
+
+ @param void
+
+ @return uint32_t  Microseconds since the start of main()
+ */
+static uint32_t app_boot_now_us(void)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    uint32_t now_us = (app_cycle_counter_get() - app_boot_start_cycles) / cycles_per_us;
+    uint32_t tick_us;
+
+    if ((0u != app_boot_us[APP_BOOT_SCHEDULER]) &&
+        (taskSCHEDULER_NOT_STARTED != xTaskGetSchedulerState()))
+    {
+        tick_us = app_boot_us[APP_BOOT_SCHEDULER] +
+                  (uint32_t)(xTaskGetTickCount() * (1000000u / configTICK_RATE_HZ));
+        if (tick_us > now_us)
+        {
+            now_us = tick_us;
+        }
+    }
+
+    return now_us;
+}
+
+/*
+ Function Name:
+ app_boot_cmd
+
+ Function Description:
+ @brief  "boot" console command.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_boot_cmd(uint32_t argc, char *argv[])
+{
+    app_boot_print_report();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,84 @@
+/*******************************************************************************
+* File Name: app_boot.h
+*
+* Description: This file contains the boot milestone interface. The startup
+*              path records when each init step is reached, and the time to
+*              advertising is reported on the first log line.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BOOT_H__
+#define __APP_BOOT_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <stdint.h>
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Startup milestones, in the order they are reached */
+typedef enum
+{
+    APP_BOOT_BSP,           /* cybsp_init() done */
+    APP_BOOT_RETARGET,      /* Debug UART ready */
+    APP_BOOT_BT_PLATFORM,   /* HCI UART configured */
+    APP_BOOT_STACK_INIT,    /* wiced_bt_stack_init() returned */
+    APP_BOOT_SCHEDULER,     /* Scheduler about to start */
+    APP_BOOT_BT_ENABLED,    /* BTM_ENABLED_EVT received */
+    APP_BOOT_GATT_DB,       /* GATT database and services registered */
+    APP_BOOT_ADV_START,     /* Advertising requested */
+    APP_BOOT_ADV_ON,        /* Controller reports advertising */
+    APP_BOOT_DEFERRED,      /* Deferred peripheral init done */
+    APP_BOOT_MILESTONE_COUNT
+} app_boot_milestone_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_boot_init(void);
+
+void app_boot_milestone(app_boot_milestone_t milestone);
+
+void app_boot_register_console(void);
+
+void app_boot_print_report(void);
+
+#endif      /* __APP_BOOT_H__ */
+
+/* [] END OF FILE */
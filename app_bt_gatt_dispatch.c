@@ -0,0 +1,470 @@
+/*******************************************************************************
+* File Name: app_bt_gatt_dispatch.c
+*
+* Description: This file contains the table driven dispatcher for GATT events
+*              and ATT opcodes. Services register their handlers at init and
+*              every table entry keeps call, error and CPU cycle counters.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_dispatch.h"
+#include "app_bt_utils.h"
+#include "app_memory.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    wiced_bt_gatt_evt_t         event;
+    app_gatt_event_handler_t    p_handler;
+    app_gatt_dispatch_stats_t   stats;
+    app_gatt_dispatch_stats_t   deferred_stats;     /* Run in the GATT worker */
+} app_gatt_event_entry_t;
+
+typedef struct
+{
+    wiced_bt_gatt_opcode_t      opcode;
+    app_gatt_opcode_handler_t   p_handler;
+    app_gatt_dispatch_stats_t   stats;
+    app_gatt_dispatch_stats_t   deferred_stats;     /* Run in the GATT worker */
+} app_gatt_opcode_entry_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Registered handlers, in registration order */
+static app_gatt_event_entry_t   app_gatt_event_tbl[APP_GATT_MAX_EVENT_HANDLERS];
+static app_gatt_opcode_entry_t  app_gatt_opcode_tbl[APP_GATT_MAX_OPCODE_HANDLERS];
+static uint8_t                  app_gatt_event_tbl_used;
+static uint8_t                  app_gatt_opcode_tbl_used;
+
+/* Key to table slot maps; 0 means no handler, otherwise slot + 1 */
+static uint8_t                  app_gatt_event_map[APP_GATT_EVENT_MAP_SIZE];
+static uint8_t                  app_gatt_opcode_map[APP_GATT_OPCODE_MAP_SIZE];
+
+/* Events and opcodes that reached the dispatcher without a handler */
+static uint32_t                 app_gatt_unhandled_event_count;
+static uint32_t                 app_gatt_unhandled_opcode_count;
+
+APP_MEMORY_FOOTPRINT(app_gatt_dispatch_ram_footprint,
+                     sizeof(app_gatt_event_tbl) + sizeof(app_gatt_opcode_tbl) +
+                     sizeof(app_gatt_event_map) + sizeof(app_gatt_opcode_map));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_gatt_dispatch_account(app_gatt_dispatch_stats_t *p_stats,
+                                      uint32_t start_cycles,
+                                      wiced_bt_gatt_status_t gatt_status);
+
+static void app_gatt_dispatch_print_entry(char kind, uint32_t key,
+                                          const app_gatt_dispatch_stats_t *p_stats);
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_gatt_dispatch_init
+
+ Function Description:
+ @brief  Clears the dispatch tables and enables the cycle counter used for
+         profiling. Must be called before any handler is registered.
+
+ @param void
+
+ @return void
+ */
+void app_gatt_dispatch_init(void)
+{
+    memset(app_gatt_event_tbl, 0, sizeof(app_gatt_event_tbl));
+    memset(app_gatt_opcode_tbl, 0, sizeof(app_gatt_opcode_tbl));
+    memset(app_gatt_event_map, 0, sizeof(app_gatt_event_map));
+    memset(app_gatt_opcode_map, 0, sizeof(app_gatt_opcode_map));
+    app_gatt_event_tbl_used = 0;
+    app_gatt_opcode_tbl_used = 0;
+    app_gatt_unhandled_event_count = 0;
+    app_gatt_unhandled_opcode_count = 0;
+
+    app_cycle_counter_init();
+}
+
+/*
+ Function Name:
+ app_gatt_register_event_handler
+
+ Function Description:
+ @brief  Registers the handler of a GATT event. Registering an event again
+         replaces its handler and keeps its counters.
+
+ @param event      Bluetooth LE GATT event type
+ @param p_handler  Handler to be invoked for the event
+
+ @return wiced_bt_gatt_status_t  WICED_BT_GATT_SUCCESS, or
+                                 WICED_BT_GATT_NO_RESOURCES if the table is full
+ */
+wiced_bt_gatt_status_t
+app_gatt_register_event_handler(wiced_bt_gatt_evt_t event,
+                                app_gatt_event_handler_t p_handler)
+{
+    uint8_t slot;
+
+    if ((APP_GATT_EVENT_MAP_SIZE <= (uint32_t)event) || (NULL == p_handler))
+    {
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+    }
+
+    slot = app_gatt_event_map[event];
+    if (0 == slot)
+    {
+        if (APP_GATT_MAX_EVENT_HANDLERS <= app_gatt_event_tbl_used)
+        {
+            return WICED_BT_GATT_NO_RESOURCES;
+        }
+        slot = ++app_gatt_event_tbl_used;
+        app_gatt_event_map[event] = slot;
+    }
+
+    app_gatt_event_tbl[slot - 1].event = event;
+    app_gatt_event_tbl[slot - 1].p_handler = p_handler;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_gatt_register_opcode_handler
+
+ Function Description:
+ @brief  Registers the handler of an ATT opcode received in
+         GATT_ATTRIBUTE_REQUEST_EVT. Registering an opcode again replaces its
+         handler and keeps its counters.
+
+ @param opcode     ATT opcode
+ @param p_handler  Handler to be invoked for the opcode
+
+ @return wiced_bt_gatt_status_t  WICED_BT_GATT_SUCCESS, or
+                                 WICED_BT_GATT_NO_RESOURCES if the table is full
+ */
+wiced_bt_gatt_status_t
+app_gatt_register_opcode_handler(wiced_bt_gatt_opcode_t opcode,
+                                 app_gatt_opcode_handler_t p_handler)
+{
+    uint8_t slot;
+
+    if (NULL == p_handler)
+    {
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+    }
+
+    slot = app_gatt_opcode_map[opcode];
+    if (0 == slot)
+    {
+        if (APP_GATT_MAX_OPCODE_HANDLERS <= app_gatt_opcode_tbl_used)
+        {
+            return WICED_BT_GATT_NO_RESOURCES;
+        }
+        slot = ++app_gatt_opcode_tbl_used;
+        app_gatt_opcode_map[opcode] = slot;
+    }
+
+    app_gatt_opcode_tbl[slot - 1].opcode = opcode;
+    app_gatt_opcode_tbl[slot - 1].p_handler = p_handler;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_gatt_get_opcode_handler
+
+ Function Description:
+ @brief  Returns the handler registered for an ATT opcode, so that a module
+         taking over the opcode can pass on the requests it does not serve.
+
+ @param opcode  ATT opcode
+
+ @return app_gatt_opcode_handler_t  Handler, NULL if none is registered
+ */
+app_gatt_opcode_handler_t app_gatt_get_opcode_handler(wiced_bt_gatt_opcode_t opcode)
+{
+    uint8_t slot = app_gatt_opcode_map[opcode];
+
+    return (0 != slot) ? app_gatt_opcode_tbl[slot - 1].p_handler : NULL;
+}
+
+/*
+ Function Name:
+ app_gatt_dispatch_event
+
+ Function Description:
+ @brief  Invokes the handler registered for a GATT event and updates its
+         counters.
+
+ @param event            Bluetooth LE GATT event type
+ @param p_event_data     Pointer to Bluetooth LE GATT event data
+
+ @return wiced_bt_gatt_status_t  Status returned by the handler, or
+                                 WICED_BT_GATT_ERROR if there is none
+ */
+wiced_bt_gatt_status_t
+app_gatt_dispatch_event(wiced_bt_gatt_evt_t event,
+                        wiced_bt_gatt_event_data_t *p_event_data)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    app_gatt_event_entry_t *p_entry;
+    uint32_t start_cycles;
+
+    if ((APP_GATT_EVENT_MAP_SIZE <= (uint32_t)event) ||
+        (0 == app_gatt_event_map[event]))
+    {
+        app_gatt_unhandled_event_count++;
+        printf("Unhandled GATT Event %d", event);
+        return WICED_BT_GATT_ERROR;
+    }
+
+    p_entry = &app_gatt_event_tbl[app_gatt_event_map[event] - 1];
+
+    start_cycles = app_cycle_counter_get();
+    gatt_status = p_entry->p_handler(p_event_data);
+    app_gatt_dispatch_account(&p_entry->stats, start_cycles, gatt_status);
+
+    return gatt_status;
+}
+
+/*
+ Function Name:
+ app_gatt_dispatch_opcode
+
+ Function Description:
+ @brief  Invokes the handler registered for the opcode of an attribute request
+         and updates its counters.
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Status returned by the handler, or
+                                 WICED_BT_GATT_REQ_NOT_SUPPORTED if there is none
+ */
+wiced_bt_gatt_status_t
+app_gatt_dispatch_opcode(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                         uint16_t *p_error_handle)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    app_gatt_opcode_entry_t *p_entry;
+    uint32_t start_cycles;
+
+    if (0 == app_gatt_opcode_map[p_attr_req->opcode])
+    {
+        app_gatt_unhandled_opcode_count++;
+        printf("ERROR: Unhandled GATT Connection Request case: %d\n",
+               p_attr_req->opcode);
+        return WICED_BT_GATT_REQ_NOT_SUPPORTED;
+    }
+
+    p_entry = &app_gatt_opcode_tbl[app_gatt_opcode_map[p_attr_req->opcode] - 1];
+
+    start_cycles = app_cycle_counter_get();
+    gatt_status = p_entry->p_handler(p_attr_req, p_error_handle);
+    app_gatt_dispatch_account(&p_entry->stats, start_cycles, gatt_status);
+
+    return gatt_status;
+}
+
+/*
+ Function Name:
+ app_gatt_dispatch_account_deferred_event
+
+ Function Description:
+ @brief  Records a deferred event handler run by the GATT worker. The entry
+         keeps these counters apart from those of the stack thread, which
+         for a deferred event only cover the copy into the work item.
+
+ @param event         Bluetooth LE GATT event type
+ @param start_cycles  Cycle counter value sampled before the handler
+ @param gatt_status   Status returned by the handler
+
+ @return void
+ */
+void app_gatt_dispatch_account_deferred_event(wiced_bt_gatt_evt_t event,
+                                              uint32_t start_cycles,
+                                              wiced_bt_gatt_status_t gatt_status)
+{
+    if ((APP_GATT_EVENT_MAP_SIZE <= (uint32_t)event) || (0 == app_gatt_event_map[event]))
+    {
+        return;
+    }
+
+    app_gatt_dispatch_account(&app_gatt_event_tbl[app_gatt_event_map[event] - 1].deferred_stats,
+                              start_cycles, gatt_status);
+}
+
+/*
+ Function Name:
+ app_gatt_dispatch_account_deferred_opcode
+
+ Function Description:
+ @brief  Records a deferred opcode handler run by the GATT worker, see
+         app_gatt_dispatch_account_deferred_event().
+
+ @param opcode        ATT opcode
+ @param start_cycles  Cycle counter value sampled before the handler
+ @param gatt_status   Status returned by the handler
+
+ @return void
+ */
+void app_gatt_dispatch_account_deferred_opcode(wiced_bt_gatt_opcode_t opcode,
+                                               uint32_t start_cycles,
+                                               wiced_bt_gatt_status_t gatt_status)
+{
+    if (0 == app_gatt_opcode_map[opcode])
+    {
+        return;
+    }
+
+    app_gatt_dispatch_account(&app_gatt_opcode_tbl[app_gatt_opcode_map[opcode] - 1].deferred_stats,
+                              start_cycles, gatt_status);
+}
+
+/*
+ Function Name:
+ app_gatt_dispatch_print_stats
+
+ Function Description:
+ @brief  Prints the per event and per opcode profile of the GATT server:
+         number of calls, number of failed calls, and average and worst case
+         CPU cycles spent in the handler.
+
+ @param void
+
+ @return void
+ */
+void app_gatt_dispatch_print_stats(void)
+{
+    uint32_t i;
+
+    printf("\nGATT dispatch profile, deferred handlers on W lines\n");
+    printf("  key    calls   errors  avg_cyc  max_cyc\n");
+
+    for (i = 0; i < app_gatt_event_tbl_used; i++)
+    {
+        app_gatt_dispatch_print_entry('E', app_gatt_event_tbl[i].event,
+                                      &app_gatt_event_tbl[i].stats);
+        app_gatt_dispatch_print_entry('W', app_gatt_event_tbl[i].event,
+                                      &app_gatt_event_tbl[i].deferred_stats);
+    }
+
+    for (i = 0; i < app_gatt_opcode_tbl_used; i++)
+    {
+        app_gatt_dispatch_print_entry('O', app_gatt_opcode_tbl[i].opcode,
+                                      &app_gatt_opcode_tbl[i].stats);
+        app_gatt_dispatch_print_entry('W', app_gatt_opcode_tbl[i].opcode,
+                                      &app_gatt_opcode_tbl[i].deferred_stats);
+    }
+
+    printf("  unhandled events %lu, unhandled opcodes %lu\n",
+           (unsigned long)app_gatt_unhandled_event_count,
+           (unsigned long)app_gatt_unhandled_opcode_count);
+}
+
+/*******************************************************************************
+ * Function Name: app_gatt_dispatch_account
+ *******************************************************************************
+ * Summary:
+ *  Updates the counters of a dispatch table entry after its handler returned.
+ *
+ * Parameters:
+ *  app_gatt_dispatch_stats_t *p_stats: Counters of the entry
+ *  uint32_t start_cycles: Cycle counter value sampled before the handler
+ *  wiced_bt_gatt_status_t gatt_status: Status returned by the handler
+ *
+ ******************************************************************************/
+static void app_gatt_dispatch_account(app_gatt_dispatch_stats_t *p_stats,
+                                      uint32_t start_cycles,
+                                      wiced_bt_gatt_status_t gatt_status)
+{
+    uint32_t cycles = app_cycle_counter_get() - start_cycles;
+
+    p_stats->call_count++;
+    p_stats->total_cycles += cycles;
+    if (p_stats->max_cycles < cycles)
+    {
+        p_stats->max_cycles = cycles;
+    }
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        p_stats->error_count++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: app_gatt_dispatch_print_entry
+ *******************************************************************************
+ * Summary:
+ *  Prints the counters of a dispatch table entry. Deferred counters ('W')
+ *  are skipped for entries that never ran in the worker.
+ *
+ * Parameters:
+ *  char kind: 'E' event, 'O' opcode, 'W' deferred handler
+ *  uint32_t key: Event or opcode
+ *  const app_gatt_dispatch_stats_t *p_stats: Counters
+ *
+ ******************************************************************************/
+static void app_gatt_dispatch_print_entry(char kind, uint32_t key,
+                                          const app_gatt_dispatch_stats_t *p_stats)
+{
+    if (('W' == kind) && (0 == p_stats->call_count))
+    {
+        return;
+    }
+
+    printf("  %c0x%02lx %7lu  %7lu  %7lu  %7lu\n",
+           kind, (unsigned long)key,
+           (unsigned long)p_stats->call_count,
+           (unsigned long)p_stats->error_count,
+           (unsigned long)(p_stats->call_count ?
+                (p_stats->total_cycles / p_stats->call_count) : 0),
+           (unsigned long)p_stats->max_cycles);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,128 @@
+/*******************************************************************************
+* File Name: app_bt_gatt_dispatch.h
+*
+* Description: This file contains the types and function prototypes of the
+*              table driven GATT event and opcode dispatcher.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_GATT_DISPATCH_H__
+#define __APP_BT_GATT_DISPATCH_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "wiced_bt_gatt.h"
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Maximum number of GATT event handlers that can be registered */
+#ifndef APP_GATT_MAX_EVENT_HANDLERS
+#define APP_GATT_MAX_EVENT_HANDLERS      (8u)
+#endif
+
+/* Maximum number of GATT opcode handlers that can be registered */
+#ifndef APP_GATT_MAX_OPCODE_HANDLERS
+#define APP_GATT_MAX_OPCODE_HANDLERS     (16u)
+#endif
+
+/* Size of the event to slot map. GATT event codes must be below this value */
+#define APP_GATT_EVENT_MAP_SIZE          (32u)
+
+/* Size of the opcode to slot map, covers every 8-bit ATT opcode */
+#define APP_GATT_OPCODE_MAP_SIZE         (256u)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Handler for one wiced_bt_gatt_evt_t event */
+typedef wiced_bt_gatt_status_t
+(*app_gatt_event_handler_t)(wiced_bt_gatt_event_data_t *p_event_data);
+
+/* Handler for one ATT opcode of GATT_ATTRIBUTE_REQUEST_EVT */
+typedef wiced_bt_gatt_status_t
+(*app_gatt_opcode_handler_t)(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                             uint16_t *p_error_handle);
+
+/* Profiling counters kept for every dispatch table entry. For a handler
+ * deferred to the GATT worker, the entry has a second set for the handler
+ * run in the worker; the first set covers the copy in the stack thread. */
+typedef struct
+{
+    uint32_t    call_count;
+    uint32_t    error_count;
+    uint32_t    max_cycles;
+    uint64_t    total_cycles;
+} app_gatt_dispatch_stats_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_gatt_dispatch_init(void);
+
+wiced_bt_gatt_status_t
+app_gatt_register_event_handler(wiced_bt_gatt_evt_t event,
+                                app_gatt_event_handler_t p_handler);
+
+wiced_bt_gatt_status_t
+app_gatt_register_opcode_handler(wiced_bt_gatt_opcode_t opcode,
+                                 app_gatt_opcode_handler_t p_handler);
+
+app_gatt_opcode_handler_t app_gatt_get_opcode_handler(wiced_bt_gatt_opcode_t opcode);
+
+wiced_bt_gatt_status_t
+app_gatt_dispatch_event(wiced_bt_gatt_evt_t event,
+                        wiced_bt_gatt_event_data_t *p_event_data);
+
+wiced_bt_gatt_status_t
+app_gatt_dispatch_opcode(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                         uint16_t *p_error_handle);
+
+void app_gatt_dispatch_account_deferred_event(wiced_bt_gatt_evt_t event,
+                                              uint32_t start_cycles,
+                                              wiced_bt_gatt_status_t gatt_status);
+
+void app_gatt_dispatch_account_deferred_opcode(wiced_bt_gatt_opcode_t opcode,
+                                               uint32_t start_cycles,
+                                               wiced_bt_gatt_status_t gatt_status);
+
+void app_gatt_dispatch_print_stats(void);
+
+#endif      /* __APP_BT_GATT_DISPATCH_H__ */
+
+/* [] END OF FILE */
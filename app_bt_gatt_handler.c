@@ -44,8 +44,19 @@
 /* *****************************************************************************
  *                              INCLUDES
  * ****************************************************************************/
+#include "app_agg.h"
 #include "app_bt_gatt_handler.h"
+#include "app_bt_gatt_index.h"
+#include "app_bt_gatt_tx.h"
 #include "app_bt_utils.h"
+#include "app_bt_prep_write.h"
+#include "app_bt_gatt_dispatch.h"
+#include "app_bt_gatt_worker.h"
+#include "app_ess.h"
+#include "app_gatt_gen.h"
+#include "app_memory.h"
+#include "app_sample_sched.h"
+#include "app_trace.h"
 #include "GeneratedSource/cycfg_gatt_db.h"
 #include "cyhal_gpio.h"
 #include "cybt_platform_trace.h"
@@ -58,6 +69,36 @@
 #include <string.h>
 #include <timers.h>
 
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+/* Handlers registered with these run in the GATT worker task if it is enabled,
+ * otherwise inline in the Bluetooth stack thread.
+ */
+#if APP_GATT_WORKER_ENABLE
+#define APP_GATT_REGISTER_DEFERRED_EVENT(event, handler)    \
+            app_gatt_worker_defer_event((event), (handler))
+#define APP_GATT_REGISTER_DEFERRED_OPCODE(opcode, handler)  \
+            app_gatt_worker_defer_opcode((opcode), (handler))
+#else
+#define APP_GATT_REGISTER_DEFERRED_EVENT(event, handler)    \
+            app_gatt_register_event_handler((event), (handler))
+#define APP_GATT_REGISTER_DEFERRED_OPCODE(opcode, handler)  \
+            app_gatt_register_opcode_handler((opcode), (handler))
+#endif
+
+/* Length of the Service Changed value, the first and last handle changed */
+#define APP_GATT_SERVICE_CHANGED_LEN        (4u)
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Handle range changed and not indicated yet, none while the start is 0 */
+static uint16_t app_gatt_sc_start;
+static uint16_t app_gatt_sc_end;
+/* A Service Changed indication waits for its confirmation */
+static bool     app_gatt_sc_in_flight;
+
 /*******************************************************************************
  *                              FUNCTION DECLARATIONS
  ******************************************************************************/
@@ -68,6 +109,60 @@ static void app_free_buffer(uint8_t *p_event_data);
 
 typedef void (*pfn_free_buffer_t)(uint8_t *);
 
+static bool app_is_gatt_attr_writable(uint16_t attr_handle);
+
+static void app_refresh_attr(uint16_t attr_handle);
+
+static void app_gatt_service_changed(uint16_t start_handle, uint16_t end_handle);
+
+static void app_gatt_send_service_changed(void);
+
+/* GATT event handlers registered with the dispatcher */
+static wiced_bt_gatt_status_t
+app_gatt_conn_status_evt_handler(wiced_bt_gatt_event_data_t *p_event_data);
+
+static wiced_bt_gatt_status_t
+app_gatt_attr_req_evt_handler(wiced_bt_gatt_event_data_t *p_event_data);
+
+static wiced_bt_gatt_status_t
+app_gatt_get_rsp_buffer_evt_handler(wiced_bt_gatt_event_data_t *p_event_data);
+
+static wiced_bt_gatt_status_t
+app_gatt_buffer_xmitted_evt_handler(wiced_bt_gatt_event_data_t *p_event_data);
+
+/* ATT opcode handlers registered with the dispatcher */
+static wiced_bt_gatt_status_t
+app_gatt_read_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                          uint16_t *p_error_handle);
+
+static wiced_bt_gatt_status_t
+app_gatt_write_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                           uint16_t *p_error_handle);
+
+static wiced_bt_gatt_status_t
+app_gatt_prep_write_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                                uint16_t *p_error_handle);
+
+static wiced_bt_gatt_status_t
+app_gatt_exec_write_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                                uint16_t *p_error_handle);
+
+static wiced_bt_gatt_status_t
+app_gatt_mtu_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                         uint16_t *p_error_handle);
+
+static wiced_bt_gatt_status_t
+app_gatt_notif_cplt_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                            uint16_t *p_error_handle);
+
+static wiced_bt_gatt_status_t
+app_gatt_conf_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                      uint16_t *p_error_handle);
+
+static wiced_bt_gatt_status_t
+app_gatt_read_by_type_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                                  uint16_t *p_error_handle);
+
 wiced_bt_gatt_status_t
 app_gatt_read_by_type_handler(uint16_t conn_id,
                                 wiced_bt_gatt_opcode_t opcode,
@@ -78,12 +173,81 @@ app_gatt_read_by_type_handler(uint16_t conn_id,
 /* *****************************************************************************
  *                              FUNCTION DEFINITIONS
  * ****************************************************************************/
+/*
+ Function Name:
+ app_bt_gatt_handler_init
+
+ Function Description:
+ @brief  Builds the GATT dispatch tables. Every GATT event and ATT opcode that
+         the application serves is registered here; a service that needs more
+         registers its own handlers after this call.
+
+ @param void
+
+ @return void
+ */
+void app_bt_gatt_handler_init(void)
+{
+    uint32_t i;
+
+    /* The generated index must describe the configurator attribute table */
+    CY_ASSERT(APP_GATT_GEN_NUM_ATTRS == app_gatt_db_ext_attr_tbl_size);
+    for (i = 0; i < APP_GATT_GEN_NUM_ATTRS; i++)
+    {
+        CY_ASSERT(app_gatt_gen_attr_handles[i] == app_gatt_db_ext_attr_tbl[i].handle);
+    }
+
+    app_gatt_dispatch_init();
+    app_gatt_index_init();
+    app_prep_write_init();
+
+#if APP_GATT_WORKER_ENABLE
+    app_gatt_worker_init();
+#endif
+
+    /* Buffer management and MTU exchange are cheap and stay in the stack
+     * thread, everything else may be deferred to the worker task.
+     */
+    app_gatt_register_event_handler(GATT_ATTRIBUTE_REQUEST_EVT,
+                                    app_gatt_attr_req_evt_handler);
+    app_gatt_register_event_handler(GATT_GET_RESPONSE_BUFFER_EVT,
+                                    app_gatt_get_rsp_buffer_evt_handler);
+    app_gatt_register_event_handler(GATT_APP_BUFFER_TRANSMITTED_EVT,
+                                    app_gatt_buffer_xmitted_evt_handler);
+    app_gatt_register_opcode_handler(GATT_REQ_MTU, app_gatt_mtu_req_handler);
+
+    /* A confirmation frees the indication of its connection; the next one
+     * is sent from the stack thread so that it can leave in the same or the
+     * next connection event */
+    app_gatt_register_opcode_handler(GATT_HANDLE_VALUE_CONF, app_gatt_conf_handler);
+
+    APP_GATT_REGISTER_DEFERRED_EVENT(GATT_CONNECTION_STATUS_EVT,
+                                     app_gatt_conn_status_evt_handler);
+
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_REQ_READ, app_gatt_read_req_handler);
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_REQ_READ_BLOB, app_gatt_read_req_handler);
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_REQ_WRITE, app_gatt_write_req_handler);
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_CMD_WRITE, app_gatt_write_req_handler);
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_CMD_SIGNED_WRITE, app_gatt_write_req_handler);
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_REQ_PREPARE_WRITE,
+                                      app_gatt_prep_write_req_handler);
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_REQ_EXECUTE_WRITE,
+                                      app_gatt_exec_write_req_handler);
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_HANDLE_VALUE_NOTIF,
+                                      app_gatt_notif_cplt_handler);
+    APP_GATT_REGISTER_DEFERRED_OPCODE(GATT_REQ_READ_BY_TYPE,
+                                      app_gatt_read_by_type_req_handler);
+}
+
 /*
  Function Name:
  app_bt_gatt_event_callback
 
  Function Description:
- @brief  This Function handles the all the GATT events - GATT Event Handler
+ @brief  This Function handles the all the GATT events - GATT Event Handler.
+         The event is routed through the dispatch table built in
+         app_bt_gatt_handler_init(). The time spent here blocks the Bluetooth
+         stack thread and is recorded by the GATT worker.
 
  @param event            Bluetooth LE GATT event type
  @param p_event_data     Pointer to Bluetooth LE GATT event data
@@ -94,68 +258,117 @@ wiced_bt_gatt_status_t
 app_bt_gatt_event_callback(wiced_bt_gatt_evt_t event,
                            wiced_bt_gatt_event_data_t *p_event_data)
 {
+    wiced_bt_gatt_status_t gatt_status;
+    uint32_t start_cycles = app_cycle_counter_get();
 
-    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_ERROR;
-    wiced_bt_gatt_attribute_request_t *p_attr_req = NULL;
+    app_trace_span_begin(APP_TRACE_SPAN_GATT_CALLBACK);
+    gatt_status = app_gatt_dispatch_event(event, p_event_data);
+    app_trace_span_end(APP_TRACE_SPAN_GATT_CALLBACK);
 
-    uint16_t error_handle = 0;
+    app_gatt_worker_account_hold(app_cycle_counter_get() - start_cycles);
 
-    switch (event)
-    {
+    return gatt_status;
+}
 
-    case GATT_CONNECTION_STATUS_EVT:
-        gatt_status = app_gatt_connect_handler(&p_event_data->connection_status);
-        break;
+/*
+ Function Name:
+ app_gatt_conn_status_evt_handler
 
-    case GATT_ATTRIBUTE_REQUEST_EVT:
-        p_attr_req = &p_event_data->attribute_request;
-        gatt_status = app_gatts_attr_req_handler(p_attr_req,
-                                                 &error_handle);
+ Function Description:
+ @brief  Handles GATT_CONNECTION_STATUS_EVT
 
-        if(gatt_status != WICED_BT_GATT_SUCCESS)
-        {
-           wiced_bt_gatt_server_send_error_rsp(p_attr_req->conn_id,
-                                               p_attr_req->opcode,
-                                               error_handle,
-                                               gatt_status);
-        }
+ @param p_event_data     Pointer to Bluetooth LE GATT event data
 
-        break;
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_conn_status_evt_handler(wiced_bt_gatt_event_data_t *p_event_data)
+{
+    return app_gatt_connect_handler(&p_event_data->connection_status);
+}
 
-    case GATT_GET_RESPONSE_BUFFER_EVT:
-    {
-        wiced_bt_gatt_buffer_request_t *p_buf_req = &p_event_data->buffer_request;
-        printf("len_req %d \n", p_buf_req->len_requested);
-        p_buf_req->buffer.p_app_rsp_buffer = app_alloc_buffer(p_buf_req->len_requested);
-        p_buf_req->buffer.p_app_ctxt = (void *)app_free_buffer;
-        gatt_status = WICED_BT_GATT_SUCCESS;
-    }
-        break;
+/*
+ Function Name:
+ app_gatt_attr_req_evt_handler
 
-    case GATT_APP_BUFFER_TRANSMITTED_EVT:
-    {
-        pfn_free_buffer_t pfn_free;
-        pfn_free = (pfn_free_buffer_t)p_event_data->buffer_xmitted.p_app_ctxt;
-        /* If the buffer is dynamic, the context will point to a function to
-         * free it.
-         */
-        if (pfn_free)
-        {
-            pfn_free(p_event_data->buffer_xmitted.p_app_data);
-        }
-        gatt_status = WICED_BT_GATT_SUCCESS;
-    }
-       break;
+ Function Description:
+ @brief  Handles GATT_ATTRIBUTE_REQUEST_EVT and sends the error response if
+         the opcode handler failed.
+
+ @param p_event_data     Pointer to Bluetooth LE GATT event data
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_attr_req_evt_handler(wiced_bt_gatt_event_data_t *p_event_data)
+{
+    wiced_bt_gatt_attribute_request_t *p_attr_req = &p_event_data->attribute_request;
+    wiced_bt_gatt_status_t gatt_status;
+    uint16_t error_handle = 0;
 
-    default:
-        printf("Unhandled GATT Event %d", event);
-        break;
+    gatt_status = app_gatts_attr_req_handler(p_attr_req, &error_handle);
 
+    if(gatt_status != WICED_BT_GATT_SUCCESS)
+    {
+       app_gatt_tx_error_rsp(p_attr_req->conn_id,
+                             p_attr_req->opcode,
+                             error_handle,
+                             gatt_status);
     }
 
     return gatt_status;
 }
 
+/*
+ Function Name:
+ app_gatt_get_rsp_buffer_evt_handler
+
+ Function Description:
+ @brief  Handles GATT_GET_RESPONSE_BUFFER_EVT by allocating the buffer the
+         stack asked for
+
+ @param p_event_data     Pointer to Bluetooth LE GATT event data
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_get_rsp_buffer_evt_handler(wiced_bt_gatt_event_data_t *p_event_data)
+{
+    wiced_bt_gatt_buffer_request_t *p_buf_req = &p_event_data->buffer_request;
+
+    p_buf_req->buffer.p_app_rsp_buffer = app_alloc_buffer(p_buf_req->len_requested);
+    p_buf_req->buffer.p_app_ctxt = (void *)app_free_buffer;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_gatt_buffer_xmitted_evt_handler
+
+ Function Description:
+ @brief  Handles GATT_APP_BUFFER_TRANSMITTED_EVT by releasing the buffer if it
+         was allocated dynamically
+
+ @param p_event_data     Pointer to Bluetooth LE GATT event data
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_buffer_xmitted_evt_handler(wiced_bt_gatt_event_data_t *p_event_data)
+{
+    pfn_free_buffer_t pfn_free;
+    pfn_free = (pfn_free_buffer_t)p_event_data->buffer_xmitted.p_app_ctxt;
+    /* If the buffer is dynamic, the context will point to a function to
+     * free it.
+     */
+    if (pfn_free)
+    {
+        pfn_free(p_event_data->buffer_xmitted.p_app_data);
+    }
+
+    return WICED_BT_GATT_SUCCESS;
+}
 
 /*
  Function Name:
@@ -175,7 +388,32 @@ app_gatt_connect_handler(wiced_bt_gatt_connection_status_t *p_conn_status)
 
     wiced_result_t gatt_status = WICED_ERROR;
 
-    if ((p_conn_status->connected) && (0 == app_bt_conn_id))
+    /* A peer may have exchanged the MTU of any link */
+    if (!p_conn_status->connected)
+    {
+        app_gatt_tx_mtu_reset(p_conn_status->conn_id);
+    }
+
+    /* Links of the aggregator to its peers are not served */
+    if (app_agg_conn_status(p_conn_status))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    /* The server serves one central. Other connections are ignored, except
+     * that their prepared writes are released when they go down.
+     */
+    if ((p_conn_status->connected) && (0 != app_bt_conn_id))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+    if ((!p_conn_status->connected) && (p_conn_status->conn_id != app_bt_conn_id))
+    {
+        app_prep_write_flush(p_conn_status->conn_id);
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    if (p_conn_status->connected)
     {
         /* Device has connected */
         print_bd_address("\nConnected to BDA:", p_conn_status->bd_addr);
@@ -184,6 +422,7 @@ app_gatt_connect_handler(wiced_bt_gatt_connection_status_t *p_conn_status)
         cyhal_gpio_write(CONNECTION_LED, CYBSP_LED_STATE_ON);
 
         app_bt_conn_id  = p_conn_status->conn_id;
+        app_sample_sched_connected(p_conn_status->bd_addr);
         gatt_status     = wiced_bt_start_advertisements(BTM_BLE_ADVERT_OFF,
                                                         BLE_ADDR_PUBLIC,
                                                         NULL);
@@ -200,13 +439,26 @@ app_gatt_connect_handler(wiced_bt_gatt_connection_status_t *p_conn_status)
         cyhal_gpio_write(CONNECTION_LED, CYBSP_LED_STATE_OFF);
 
         /* Handle the disconnection */
+        app_prep_write_flush(p_conn_status->conn_id);
+        app_gatt_dispatch_print_stats();
+        app_gatt_worker_print_stats();
+        app_sample_sched_disconnected();
         app_bt_conn_id  = 0;
 
+        /* Without bonding a client discovers the database again on the next
+         * connection, so pending Service Changed ranges are dropped */
+        app_gatt_index_lock();
+        app_gatt_sc_start = 0;
+        app_gatt_sc_in_flight = false;
+        app_gatt_index_unlock();
+        app_gatt_tx_indication_reset(p_conn_status->conn_id);
+        app_get_attr_by_handle(HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG)->p_data[0] = 0;
+
         /*
          * Reset the CCCD value so that on a reconnect CCCD (notifications)
          * will be off
          */
-        app_ess_temperature_client_char_config[0] = 0;
+        app_ess_disconnected();
         gatt_status = wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH,
                                                     BLE_ADDR_PUBLIC,
                                                     NULL);
@@ -222,6 +474,7 @@ app_gatt_connect_handler(wiced_bt_gatt_connection_status_t *p_conn_status)
  Function Description:
  @brief  The callback function is invoked when GATT_ATTRIBUTE_REQUEST_EVT occurs
          in GATT Event handler function. GATT Server Event Callback function.
+         The request is routed to the handler registered for its opcode.
 
  @param type  Pointer to GATT Attribute request
 
@@ -231,66 +484,209 @@ wiced_bt_gatt_status_t
 app_gatts_attr_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req, 
                            uint16_t *p_error_handle)
 {
+    return app_gatt_dispatch_opcode(p_attr_req, p_error_handle);
+}
+
+/*
+ Function Name:
+ app_gatt_read_req_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_REQ_READ and GATT_REQ_READ_BLOB
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_read_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                          uint16_t *p_error_handle)
+{
+    return app_gatt_attr_read_handler(p_attr_req->conn_id,
+                                      p_attr_req->opcode,
+                                      &p_attr_req->data.read_req,
+                                      p_attr_req->len_requested,
+                                      p_error_handle);
+}
+
+/*
+ Function Name:
+ app_gatt_write_req_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_REQ_WRITE, GATT_CMD_WRITE and
+         GATT_CMD_SIGNED_WRITE. Only the write request is acknowledged.
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
 
-    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_ERROR;
-
-    switch (p_attr_req->opcode)
-    {
-
-        case GATT_REQ_READ:
-        case GATT_REQ_READ_BLOB:
-             gatt_status = app_gatt_attr_read_handler(p_attr_req->conn_id,
-                                                      p_attr_req->opcode,
-                                                     &p_attr_req->data.read_req,
-                                                      p_attr_req->len_requested,
-                                                      p_error_handle);
-             break;
-
-        case GATT_REQ_WRITE:
-        case GATT_CMD_WRITE:
-        case GATT_CMD_SIGNED_WRITE:
-             gatt_status = app_gatt_attr_write_handler(p_attr_req->opcode,
-                                                       &p_attr_req->data.write_req,
-                                                       p_attr_req->len_requested,
-                                                       p_error_handle);
-             if ((p_attr_req->opcode == GATT_REQ_WRITE) && (gatt_status == WICED_BT_GATT_SUCCESS))
-             {
-                 wiced_bt_gatt_write_req_t *p_write_request = &p_attr_req->data.write_req;
-                 wiced_bt_gatt_server_send_write_rsp(p_attr_req->conn_id, p_attr_req->opcode,
-                                                     p_write_request->handle);
-             }
-             break;
-
-        case GATT_REQ_MTU:
-            /* This is the response for GATT MTU exchange and MTU size is set
-             * in the BT-Configurator.
-             */
-            gatt_status = wiced_bt_gatt_server_send_mtu_rsp(p_attr_req->conn_id,
-                                                            p_attr_req->data.remote_mtu,
-                                                            CY_BT_MTU_SIZE);
-            break;
-
-        case GATT_HANDLE_VALUE_NOTIF:
-            printf("Notfication send complete\n");
-            break;
-
-        case GATT_REQ_READ_BY_TYPE:
-            gatt_status = app_gatt_read_by_type_handler(p_attr_req->conn_id,
-                                                               p_attr_req->opcode,
-                                                               &p_attr_req->data.read_by_type,
-                                                               p_attr_req->len_requested,
-                                                               p_error_handle);
-            break;
-
-        default:
-            printf("ERROR: Unhandled GATT Connection Request case: %d\n", p_attr_req->opcode);
-            break;
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_write_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                           uint16_t *p_error_handle)
+{
+    wiced_bt_gatt_status_t gatt_status;
 
+    gatt_status = app_gatt_attr_write_handler(p_attr_req->opcode,
+                                              &p_attr_req->data.write_req,
+                                              p_attr_req->len_requested,
+                                              p_error_handle);
+    if ((p_attr_req->opcode == GATT_REQ_WRITE) && (gatt_status == WICED_BT_GATT_SUCCESS))
+    {
+        wiced_bt_gatt_write_req_t *p_write_request = &p_attr_req->data.write_req;
+        app_gatt_tx_write_rsp(p_attr_req->conn_id, p_attr_req->opcode,
+                              p_write_request->handle);
     }
 
     return gatt_status;
 }
 
+/*
+ Function Name:
+ app_gatt_prep_write_req_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_REQ_PREPARE_WRITE
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_prep_write_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                                uint16_t *p_error_handle)
+{
+    return app_prep_write_handler(p_attr_req->conn_id,
+                                  p_attr_req->opcode,
+                                  &p_attr_req->data.write_req,
+                                  p_error_handle);
+}
+
+/*
+ Function Name:
+ app_gatt_exec_write_req_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_REQ_EXECUTE_WRITE
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_exec_write_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                                uint16_t *p_error_handle)
+{
+    return app_execute_write_handler(p_attr_req->conn_id,
+                                     p_attr_req->opcode,
+                                     p_attr_req->data.exec_write_req,
+                                     p_error_handle);
+}
+
+/*
+ Function Name:
+ app_gatt_mtu_req_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_REQ_MTU. This is the response for GATT MTU
+         exchange and MTU size is set in the BT-Configurator.
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_mtu_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                         uint16_t *p_error_handle)
+{
+    return app_gatt_tx_mtu_rsp(p_attr_req->conn_id,
+                               p_attr_req->data.remote_mtu,
+                               CY_BT_MTU_SIZE);
+}
+
+/*
+ Function Name:
+ app_gatt_notif_cplt_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_HANDLE_VALUE_NOTIF, reported by the stack
+         once a notification has been sent
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_notif_cplt_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                            uint16_t *p_error_handle)
+{
+    printf("Notfication send complete\n");
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_gatt_conf_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_HANDLE_VALUE_CONF, the client confirmation
+         of an indication. Hands the confirmation to the owner of the value
+         and sends the next indication: a pending Service Changed range
+         first, then the queued sensor readings.
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_conf_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                      uint16_t *p_error_handle)
+{
+    uint16_t handle = app_gatt_tx_indication_confirmed(p_attr_req->conn_id);
+
+    app_gatt_index_lock();
+    if (HDLC_GATT_SERVICE_CHANGED_VALUE == handle)
+    {
+        app_gatt_sc_in_flight = false;
+    }
+    app_gatt_send_service_changed();
+    app_gatt_index_unlock();
+    app_ess_indication_confirmed(p_attr_req->conn_id, handle);
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_gatt_read_by_type_req_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_REQ_READ_BY_TYPE
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_gatt_read_by_type_req_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                                  uint16_t *p_error_handle)
+{
+    return app_gatt_read_by_type_handler(p_attr_req->conn_id,
+                                         p_attr_req->opcode,
+                                         &p_attr_req->data.read_by_type,
+                                         p_attr_req->len_requested,
+                                         p_error_handle);
+}
+
 /*
  Function Name:
  app_gatt_attr_read_handler
@@ -315,19 +711,27 @@ app_gatt_attr_read_handler( uint16_t conn_id,
                             uint16_t *p_error_handle)
 {
     wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_INVALID_HANDLE;
-    int32_t index = 0;
+    gatt_db_lookup_table_t *p_attr;
     uint16_t len_to_send = 0;
     *p_error_handle = p_read_req->handle;
 
+    /* A read blob continues the value of the first read */
+    if (0 == p_read_req->offset)
+    {
+        app_refresh_attr(p_read_req->handle);
+    }
+
     /* Validate the length of the attribute and read from the attribute */
-    index = app_get_attr_index_by_handle((p_read_req->handle));
-    if (INVALID_ATT_TBL_INDEX != index)
+    p_attr = app_get_attr_by_handle(p_read_req->handle);
+    if (NULL != p_attr)
     {
-        len_to_send = app_gatt_db_ext_attr_tbl[index].cur_len - p_read_req->offset;
-        if(len_to_send <= 0)
+        /* A blob at the end of the value, or a read of an empty value,
+         * gets a zero-length response */
+        if (p_attr->cur_len < p_read_req->offset)
         {
-            return WICED_BT_GATT_INVALID_ATTR_LEN;
+            return WICED_BT_GATT_INVALID_OFFSET;
         }
+        len_to_send = p_attr->cur_len - p_read_req->offset;
 
         if(len_req < len_to_send)
         {
@@ -336,13 +740,13 @@ app_gatt_attr_read_handler( uint16_t conn_id,
 
         /*
          * Set the pv_app_context parameter to NULL, since we don't want to free
-         * app_gatt_db_ext_attr_tbl[index].p_data on transmit complete
+         * p_attr->p_data on transmit complete. Read blob continues at offset.
          */
-        gatt_status = wiced_bt_gatt_server_send_read_handle_rsp(conn_id,
-                                                                opcode,
-                                                                len_to_send,
-                                        app_gatt_db_ext_attr_tbl[index].p_data,
-                                                                NULL);
+        gatt_status = app_gatt_tx_read_handle_rsp(conn_id,
+                                                  opcode,
+                                                  len_to_send,
+                                                  p_attr->p_data + p_read_req->offset,
+                                                  NULL);
     }
     else
     {
@@ -375,14 +779,11 @@ app_gatt_attr_write_handler(wiced_bt_gatt_opcode_t opcode,
                             uint16_t *p_error_handle)
 {
     wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_INVALID_HANDLE;
-    int index = 0;
     *p_error_handle = p_write_req->handle;
 
-    /* Binary search of handles is done; Make sure the handles are sorted */
-    index = app_get_attr_index_by_handle(p_write_req->handle);
-    if(INVALID_ATT_TBL_INDEX == index)
+    if (NULL == app_get_attr_by_handle(p_write_req->handle))
     {
-        printf("Invalid ATT TBL Index : %d\n", index);
+        printf("Invalid attribute handle 0x%x\n", p_write_req->handle);
         return gatt_status;
     }
 
@@ -419,10 +820,11 @@ app_gatt_read_by_type_handler(uint16_t conn_id,
                                 uint16_t len_requested,
                                 uint16_t *p_error_handle)
 {
-    uint16_t    attr_handle = p_read_req->s_handle;
+    uint16_t    attr_handle;
     uint8_t     *p_rsp = app_alloc_buffer(len_requested);
     uint8_t     pair_len = 0;
-    int         index = 0;
+    gatt_db_lookup_table_t *p_attr;
+    app_gatt_index_iter_t iter;
     int         used = 0;
     int         filled = 0;
 
@@ -434,27 +836,26 @@ app_gatt_read_by_type_handler(uint16_t conn_id,
     }
 
     /* Read by type returns all attributes of the specified type,
-     * between the start and end handles */
-    while (TRUE)
+     * between the start and end handles. The type index starts at the first
+     * handle of the type in the range and holds only that type. */
+    *p_error_handle = p_read_req->s_handle;
+    app_gatt_index_find(&iter, &p_read_req->uuid, p_read_req->s_handle,
+                        p_read_req->e_handle);
+    while (0 != (attr_handle = app_gatt_index_next(&iter)))
     {
         *p_error_handle = attr_handle;
-        attr_handle = wiced_bt_gatt_find_handle_by_type(attr_handle,
-                                                        p_read_req->e_handle,
-                                                        &p_read_req->uuid);
 
-        if (attr_handle == 0)
-            break;
-
-        index = app_get_attr_index_by_handle(attr_handle);
-        if (INVALID_ATT_TBL_INDEX != index)
+        app_refresh_attr(attr_handle);
+        p_attr = app_get_attr_by_handle(attr_handle);
+        if (NULL != p_attr)
         {
             printf("attr_handle %x \n", attr_handle );
             filled = wiced_bt_gatt_put_read_by_type_rsp_in_stream( p_rsp + used,
                                                         len_requested - used,
                                                         &pair_len,
                                                         attr_handle,
-                                        app_gatt_db_ext_attr_tbl[index].cur_len,
-                                        app_gatt_db_ext_attr_tbl[index].p_data);
+                                                        p_attr->cur_len,
+                                                        p_attr->p_data);
             if (filled == 0)
             {
                 printf("No data is filled\n");
@@ -467,8 +868,6 @@ app_gatt_read_by_type_handler(uint16_t conn_id,
             app_free_buffer(p_rsp);
             return WICED_BT_GATT_ERR_UNLIKELY;
         }
-        /* Increment starting handle for next search to one past current */
-        attr_handle++;
     } // End of adding the data to the stream
 
     if (used == 0)
@@ -480,12 +879,12 @@ app_gatt_read_by_type_handler(uint16_t conn_id,
     }
 
     /* Send the response */
-    wiced_bt_gatt_server_send_read_by_type_rsp( conn_id,
-                                                opcode,
-                                                pair_len,
-                                                used,
-                                                p_rsp,
-                            (wiced_bt_gatt_app_context_t)app_free_buffer);
+    app_gatt_tx_read_by_type_rsp(conn_id,
+                                 opcode,
+                                 pair_len,
+                                 used,
+                                 p_rsp,
+                                 (wiced_bt_gatt_app_context_t)app_free_buffer);
 
     return WICED_BT_GATT_SUCCESS;
 }
@@ -507,34 +906,142 @@ wiced_bt_gatt_status_t app_set_gatt_attr_value(uint16_t attr_handle,
                                                uint8_t *p_val,
                                                uint16_t len)
 {
-    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_INVALID_HANDLE;
-      /* Check for a matching handle entry */
-      if (HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG == attr_handle)
-      {
-          /* Verify that size constraints have been met */
-          if (app_ess_temperature_client_char_config_len >= len)
-          {
-              /* Value fits within the supplied buffer; copy over the value */
-              memcpy(app_ess_temperature_client_char_config,
-                     p_val,
-                     len);
-
-              gatt_status = WICED_BT_GATT_SUCCESS;
-          }
-          else
-          {
-              /* Value to write does not meet size constraints */
-              gatt_status = WICED_BT_GATT_INVALID_ATTR_LEN;
-          }
-      }
-
-  return (gatt_status);
+    return app_write_gatt_attr_value(attr_handle, 0, p_val, len);
+}
+
+/*
+ Function Name:
+ app_check_gatt_attr_write
+
+ Function Description:
+ @brief  Validates a write of len bytes at offset to an attribute without
+         modifying it. Used by single writes and by the prepared write engine
+         to validate all queued fragments before any of them is committed.
+
+ @param attr_handle  GATT attribute handle
+ @param offset       Offset of the first byte to be written
+ @param len          Number of bytes to be written
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_check_gatt_attr_write(uint16_t attr_handle,
+                                                 uint16_t offset,
+                                                 uint16_t len)
+{
+    gatt_db_lookup_table_t *p_attr = app_get_attr_by_handle(attr_handle);
+
+    if (NULL == p_attr)
+    {
+        return WICED_BT_GATT_INVALID_HANDLE;
+    }
+
+    if (!app_is_gatt_attr_writable(attr_handle))
+    {
+        return WICED_BT_GATT_WRITE_NOT_PERMIT;
+    }
+
+    if (p_attr->max_len < offset)
+    {
+        return WICED_BT_GATT_INVALID_OFFSET;
+    }
+
+    /* Verify that size constraints have been met */
+    if (p_attr->max_len < (offset + len))
+    {
+        return WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_write_gatt_attr_value
+
+ Function Description:
+ @brief  Writes len bytes at offset into the value of a GATT DB attribute.
+         A write at offset 0, i.e. a Write Request or Command or the first
+         fragment of a long write, sets the current length of the attribute;
+         a later fragment grows it if the write extends it.
+
+ @param attr_handle  GATT attribute handle
+ @param offset       Offset of the first byte to be written
+ @param p_val        Pointer to the value to be written
+ @param len          Number of bytes to be written
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_write_gatt_attr_value(uint16_t attr_handle,
+                                                 uint16_t offset,
+                                                 uint8_t *p_val,
+                                                 uint16_t len)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    gatt_db_lookup_table_t *p_attr;
+    const app_gatt_segment_t *p_seg;
+
+    gatt_status = app_check_gatt_attr_write(attr_handle, offset, len);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        return gatt_status;
+    }
+
+    /* Let the module owning the attribute apply or reject the value; the
+     * write check passed, so the service has a write callback */
+    p_seg = app_gatt_index_segment(attr_handle);
+    if (NULL != p_seg)
+    {
+        gatt_status = p_seg->p_cbs->p_write_cb(attr_handle, offset, p_val, len);
+        if (WICED_BT_GATT_SUCCESS != gatt_status)
+        {
+            return gatt_status;
+        }
+    }
+
+    /* Value fits within the supplied buffer; copy over the value */
+    p_attr = app_get_attr_by_handle(attr_handle);
+    memcpy(p_attr->p_data + offset, p_val, len);
+
+    if ((0 == offset) || (p_attr->cur_len < (offset + len)))
+    {
+        p_attr->cur_len = offset + len;
+    }
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_is_gatt_attr_writable
+
+ Function Description:
+ @brief  Returns true for the attributes the client is allowed to write:
+         the sensor and Service Changed CCCDs and the attributes of the
+         application module services with a write callback, which checks the
+         handle.
+
+ @param attr_handle  GATT attribute handle
+
+ @return bool  true if the attribute is writable
+ */
+static bool app_is_gatt_attr_writable(uint16_t attr_handle)
+{
+    const app_gatt_segment_t *p_seg;
+
+    if (APP_GATT_APP_HANDLE_BASE > attr_handle)
+    {
+        return (HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG == attr_handle) ||
+               app_ess_is_cccd(attr_handle);
+    }
+
+    p_seg = app_gatt_index_segment(attr_handle);
+    return (NULL != p_seg) && (NULL != p_seg->p_cbs) && (NULL != p_seg->p_cbs->p_write_cb);
 }
 
 /**
  * @brief This function returns the corresponding index for the respective
- *        attribute handle from the attribute table. Please ensure that GATT DB
- *        is sorted.
+ *        attribute handle from the attribute table. The index is generated
+ *        from design.cybt by tools/gatt_db_gen.py, no search is done.
  *
  * @param attr_handle 16-bit attribute handle for the characteristics and descriptors
  * @return int32_t The index of the valid attribute handle otherwise
@@ -542,31 +1049,237 @@ wiced_bt_gatt_status_t app_set_gatt_attr_value(uint16_t attr_handle,
  */
 int32_t app_get_attr_index_by_handle(uint16_t attr_handle)
 {
+    uint8_t index;
 
-    uint16_t left = 0;
-    uint16_t right = app_gatt_db_ext_attr_tbl_size;
+    if (APP_GATT_GEN_MAX_HANDLE < attr_handle)
+    {
+        return INVALID_ATT_TBL_INDEX;
+    }
+
+    index = app_gatt_gen_attr_index[attr_handle];
+    return (APP_GATT_GEN_NO_ATTR != index) ? (int32_t)index : INVALID_ATT_TBL_INDEX;
+}
+
+/*
+ Function Name:
+ app_get_attr_by_handle
+
+ Function Description:
+ @brief  Finds the value of an attribute, in the generated database or in a
+         service added by an application module. Constant time, see
+         app_gatt_index_attr().
+
+ @param attr_handle  GATT attribute handle
+
+ @return gatt_db_lookup_table_t*  Attribute, NULL if the handle has no
+                                  application managed value
+ */
+gatt_db_lookup_table_t *app_get_attr_by_handle(uint16_t attr_handle)
+{
+    return app_gatt_index_attr(attr_handle);
+}
+
+/*
+ Function Name:
+ app_refresh_attr
+
+ Function Description:
+ @brief  Lets the module owning an attribute update its value before it is
+         read.
+
+ @param attr_handle  GATT attribute handle
+
+ @return void
+ */
+static void app_refresh_attr(uint16_t attr_handle)
+{
+    const app_gatt_segment_t *p_seg = app_gatt_index_segment(attr_handle);
 
-    while(left <= right)
+    if ((NULL != p_seg) && (NULL != p_seg->p_cbs) && (NULL != p_seg->p_cbs->p_read_cb))
     {
-        uint16_t mid = left + (right - left)/2;
+        p_seg->p_cbs->p_read_cb(attr_handle);
+    }
+}
 
-        if(app_gatt_db_ext_attr_tbl[mid].handle == attr_handle)
-        {
-            return mid;
-        }
+/*
+ Function Name:
+ app_gatt_add_service
+
+ Function Description:
+ @brief  Adds a service of an application module to the GATT database, after
+         wiced_bt_gatt_db_init(). The service can be added and removed at run
+         time. Its handles must lie in one segment of
+         APP_GATT_APP_SERVICE_HANDLES handles from APP_GATT_APP_HANDLE_BASE
+         on, which no other service uses; a connected client is told of the
+         change with a Service Changed indication over the segment. The
+         attribute table holds the values served by the read and write
+         handlers and must stay valid. The types give the attribute type
+         (UUID) of each value, for read by type requests. Any task may call
+         this, it takes the lock of the GATT database.
+
+ @param p_db        GATT database fragment of the service
+ @param db_len      Length of the fragment
+ @param p_attrs     Attribute values of the service
+ @param p_types     Attribute type of each value
+ @param num_attrs   Number of attribute values
+ @param p_cbs       Read and write callbacks, NULL for static read only values
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_add_service(const uint8_t *p_db, uint16_t db_len,
+                                            gatt_db_lookup_table_t *p_attrs,
+                                            const wiced_bt_uuid_t *p_types,
+                                            uint16_t num_attrs,
+                                            const app_gatt_service_cbs_t *p_cbs)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    uint16_t service_handle;
+    uint32_t segment;
+
+    app_gatt_index_lock();
 
-        if(app_gatt_db_ext_attr_tbl[mid].handle < attr_handle)
+    gatt_status = app_gatt_index_add(p_db, db_len, p_attrs, p_types, num_attrs, p_cbs);
+    if (WICED_BT_GATT_SUCCESS == gatt_status)
+    {
+        service_handle = APP_GATT_INDEX_SERVICE_HANDLE(p_db);
+        gatt_status = wiced_bt_gatt_add_services_to_db(p_db, db_len);
+        if (WICED_BT_GATT_SUCCESS == gatt_status)
         {
-            left = mid + 1;
+            segment = APP_GATT_INDEX_SEGMENT(service_handle);
+            app_gatt_service_changed(APP_GATT_INDEX_SEGMENT_START(segment),
+                                     APP_GATT_INDEX_SEGMENT_END(segment));
         }
         else
         {
-            right = mid - 1;
+            app_gatt_index_remove(service_handle);
         }
     }
 
-    return INVALID_ATT_TBL_INDEX;
+    app_gatt_index_unlock();
+
+    return gatt_status;
+}
+
+/*
+ Function Name:
+ app_gatt_remove_service
+
+ Function Description:
+ @brief  Removes a service added with app_gatt_add_service() from the GATT
+         database. Its segment is free for another service afterwards.
+
+ @param service_handle  Handle of the service declaration
 
+ @return wiced_bt_gatt_status_t  WICED_BT_GATT_INVALID_HANDLE if no added
+                                 service starts at the handle
+ */
+wiced_bt_gatt_status_t app_gatt_remove_service(uint16_t service_handle)
+{
+    const app_gatt_segment_t *p_seg;
+    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
+    uint32_t segment;
+
+    app_gatt_index_lock();
+
+    p_seg = app_gatt_index_segment(service_handle);
+    if ((NULL == p_seg) || (service_handle != APP_GATT_INDEX_SERVICE_HANDLE(p_seg->p_db)))
+    {
+        gatt_status = WICED_BT_GATT_INVALID_HANDLE;
+    }
+    else if (!wiced_bt_gatt_remove_services_from_db(p_seg->p_db))
+    {
+        gatt_status = WICED_BT_GATT_ERROR;
+    }
+    else
+    {
+        app_gatt_index_remove(service_handle);
+        segment = APP_GATT_INDEX_SEGMENT(service_handle);
+        app_gatt_service_changed(APP_GATT_INDEX_SEGMENT_START(segment),
+                                 APP_GATT_INDEX_SEGMENT_END(segment));
+    }
+
+    app_gatt_index_unlock();
+
+    return gatt_status;
+}
+
+/*
+ Function Name:
+ app_gatt_service_changed
+
+ Function Description:
+ @brief  Records a changed handle range for the connected client. Ranges
+         that come up while an indication is in flight are merged and sent
+         on its confirmation. Called with the GATT database lock held, like
+         every user of the Service Changed state.
+
+ @param start_handle  First handle changed
+ @param end_handle    Last handle changed
+
+ @return void
+ */
+static void app_gatt_service_changed(uint16_t start_handle, uint16_t end_handle)
+{
+    if (0 != app_gatt_sc_start)
+    {
+        start_handle = (app_gatt_sc_start < start_handle) ? app_gatt_sc_start : start_handle;
+        end_handle = (app_gatt_sc_end > end_handle) ? app_gatt_sc_end : end_handle;
+    }
+
+    app_gatt_sc_start = start_handle;
+    app_gatt_sc_end = end_handle;
+    app_gatt_send_service_changed();
+}
+
+/*
+ Function Name:
+ app_gatt_send_service_changed
+
+ Function Description:
+ @brief  Indicates the pending Service Changed range if the client enabled
+         the indication and none is in flight. Called with the GATT database
+         lock held. Without a client to tell the
+         range is dropped: the next client discovers the database anyway.
+
+ @param void
+
+ @return void
+ */
+static void app_gatt_send_service_changed(void)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    gatt_db_lookup_table_t *p_cccd;
+    gatt_db_lookup_table_t *p_value;
+
+    if (app_gatt_sc_in_flight || (0 == app_gatt_sc_start))
+    {
+        return;
+    }
+
+    p_cccd = app_get_attr_by_handle(HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG);
+    if ((0 == app_bt_conn_id) || (0 == (p_cccd->p_data[0] & GATT_CLIENT_CONFIG_INDICATION)))
+    {
+        app_gatt_sc_start = 0;
+        return;
+    }
+
+    p_value = app_get_attr_by_handle(HDLC_GATT_SERVICE_CHANGED_VALUE);
+    p_value->p_data[0] = (uint8_t)app_gatt_sc_start;
+    p_value->p_data[1] = (uint8_t)(app_gatt_sc_start >> 8);
+    p_value->p_data[2] = (uint8_t)app_gatt_sc_end;
+    p_value->p_data[3] = (uint8_t)(app_gatt_sc_end >> 8);
+    p_value->cur_len = APP_GATT_SERVICE_CHANGED_LEN;
+
+    gatt_status = app_gatt_tx_indication(app_bt_conn_id, HDLC_GATT_SERVICE_CHANGED_VALUE,
+                                         APP_GATT_SERVICE_CHANGED_LEN, p_value->p_data, NULL);
+    if (WICED_BT_GATT_BUSY == gatt_status)
+    {
+        /* A sensor indication is in flight, the range goes out on its
+         * confirmation */
+        return;
+    }
+    app_gatt_sc_start = 0;
+    app_gatt_sc_in_flight = (WICED_BT_GATT_SUCCESS == gatt_status);
 }
 
 /*******************************************************************************
@@ -582,7 +1295,7 @@ int32_t app_get_attr_index_by_handle(uint16_t attr_handle)
  ******************************************************************************/
 static void app_free_buffer(uint8_t *p_buf)
 {
-    vPortFree(p_buf);
+    app_memory_free_buffer(p_buf);
 }
 
 
@@ -590,7 +1303,8 @@ static void app_free_buffer(uint8_t *p_buf)
  * Function Name: app_alloc_buffer
  *******************************************************************************
  * Summary:
- *  This function allocates a memory buffer.
+ *  This function allocates a memory buffer. See app_memory_alloc_buffer()
+ *  for where the memory comes from.
  *
  *
  * Parameters:
@@ -599,7 +1313,7 @@ static void app_free_buffer(uint8_t *p_buf)
  ******************************************************************************/
 static void* app_alloc_buffer(int len)
 {
-    return pvPortMalloc(len);
+    return app_memory_alloc_buffer(len);
 }
 
 /* [] END OF FILE */
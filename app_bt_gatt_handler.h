@@ -60,6 +60,31 @@
 /* The error code for invalid  attribute index in attribute table */
 #define INVALID_ATT_TBL_INDEX            (0xFFFFFFFF)
 
+/* Services added by application modules with app_gatt_add_service() use
+ * handles from here on, above the database generated from design.cybt */
+#define APP_GATT_APP_HANDLE_BASE         (0x0100u)
+
+/* Each service added by an application module owns a segment of handles:
+ * segment n holds the handles from APP_GATT_APP_HANDLE_BASE + n * 16, and a
+ * service added or removed at run time changes only its own segment */
+#define APP_GATT_APP_SERVICE_HANDLES     (16u)
+
+/* Number of segments, i.e. services added by application modules */
+#define APP_GATT_MAX_APP_SERVICES        (8u)
+
+/* Callbacks of a service added by an application module. Both are optional.
+ *   p_read_cb   Called before a client read of an attribute, to refresh a
+ *               value computed on demand
+ *   p_write_cb  Called before a client write is stored. Returning a status
+ *               other than WICED_BT_GATT_SUCCESS rejects the write with that
+ *               status. Without it the attributes are read only. */
+typedef struct
+{
+    void                    (*p_read_cb)(uint16_t attr_handle);
+    wiced_bt_gatt_status_t  (*p_write_cb)(uint16_t attr_handle, uint16_t offset,
+                                          const uint8_t *p_val, uint16_t len);
+} app_gatt_service_cbs_t;
+
 /* *****************************************************************************
  *                              VARIABLES
  * ****************************************************************************/
@@ -71,6 +96,8 @@ extern uint16_t app_bt_conn_id;
 /* *****************************************************************************
  *                              FUNCTION DECLARATIONS
  * ****************************************************************************/
+void app_bt_gatt_handler_init(void);
+
 wiced_bt_gatt_status_t
 app_gatt_attr_write_handler(wiced_bt_gatt_opcode_t opcode,
                             wiced_bt_gatt_write_req_t *p_write_req,
@@ -98,8 +125,27 @@ wiced_bt_gatt_status_t app_set_gatt_attr_value(uint16_t attr_handle,
                                                uint8_t *p_val,
                                                uint16_t len);
 
+wiced_bt_gatt_status_t app_check_gatt_attr_write(uint16_t attr_handle,
+                                                 uint16_t offset,
+                                                 uint16_t len);
+
+wiced_bt_gatt_status_t app_write_gatt_attr_value(uint16_t attr_handle,
+                                                 uint16_t offset,
+                                                 uint8_t *p_val,
+                                                 uint16_t len);
+
 int32_t app_get_attr_index_by_handle(uint16_t attr_handle);
 
+gatt_db_lookup_table_t *app_get_attr_by_handle(uint16_t attr_handle);
+
+wiced_bt_gatt_status_t app_gatt_add_service(const uint8_t *p_db, uint16_t db_len,
+                                            gatt_db_lookup_table_t *p_attrs,
+                                            const wiced_bt_uuid_t *p_types,
+                                            uint16_t num_attrs,
+                                            const app_gatt_service_cbs_t *p_cbs);
+
+wiced_bt_gatt_status_t app_gatt_remove_service(uint16_t service_handle);
+
 
 #endif      /* __APP_BT_GATT_HANDLER_H__ */
 
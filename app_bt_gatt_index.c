@@ -0,0 +1,647 @@
+/*******************************************************************************
+* File Name: app_bt_gatt_index.c
+*
+* Description: This file contains the attribute index of the GATT database.
+*              Each service of an application module owns a segment of
+*              handles, so a lookup by handle is a table access and a read by
+*              type request walks only the matching handles of its range.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_index.h"
+#include "app_console.h"
+#include "app_gatt_gen.h"
+#include "app_memory.h"
+#include "GeneratedSource/cycfg_gatt_db.h"
+#include "cyhal.h"
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static app_gatt_segment_t   app_gatt_segments[APP_GATT_MAX_APP_SERVICES];
+
+/* Serializes adding and removing services with the GATT handlers, see
+ * app_gatt_index_lock() */
+static SemaphoreHandle_t    app_gatt_index_mutex;
+
+#if APP_STATIC_MEMORY
+static StaticSemaphore_t    app_gatt_index_mutex_cb;
+#endif
+
+APP_MEMORY_FOOTPRINT(app_gatt_index_ram_footprint, sizeof(app_gatt_segments));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static int32_t app_gatt_index_type_cmp(const wiced_bt_uuid_t *p_a,
+                                       const wiced_bt_uuid_t *p_b);
+
+static bool app_gatt_index_before(const app_gatt_segment_t *p_seg, uint8_t index,
+                                  const wiced_bt_uuid_t *p_type, uint16_t handle);
+
+static uint16_t app_gatt_index_lower_bound(const app_gatt_segment_t *p_seg,
+                                           const wiced_bt_uuid_t *p_type,
+                                           uint16_t handle);
+
+static const app_gatt_gen_uuid_t *app_gatt_index_gen_type(uint16_t uuid16);
+
+static void app_gatt_index_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_gatt_index_console_cmd =
+{
+    "gattdb", "List the services of the GATT database", app_gatt_index_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_gatt_index_init
+
+ Function Description:
+ @brief  Creates the lock of the index and registers its console command.
+
+ @param void
+
+ @return void
+ */
+void app_gatt_index_init(void)
+{
+#if APP_STATIC_MEMORY
+    app_gatt_index_mutex = xSemaphoreCreateRecursiveMutexStatic(&app_gatt_index_mutex_cb);
+#else
+    app_gatt_index_mutex = xSemaphoreCreateRecursiveMutex();
+#endif
+    CY_ASSERT(NULL != app_gatt_index_mutex);
+    vQueueAddToRegistry(app_gatt_index_mutex, "GATT index");
+
+    app_console_register_command(&app_gatt_index_console_cmd);
+}
+
+/*
+ Function Name:
+ app_gatt_index_lock
+
+ Function Description:
+ @brief  Takes the lock of the GATT database. It serializes adding and
+         removing services, and guards the Service Changed state, which the
+         stack thread updates on a confirmation. It is never held across a
+         whole GATT handler: the handlers look segments up without it and
+         rely on a segment being published last, see app_gatt_index_add().
+         The lock is recursive, so a module may add a service from a path
+         that already holds it.
+
+ @param void
+
+ @return void
+ */
+void app_gatt_index_lock(void)
+{
+    xSemaphoreTakeRecursive(app_gatt_index_mutex, portMAX_DELAY);
+}
+
+/*
+ Function Name:
+ app_gatt_index_unlock
+
+ Function Description:
+ @brief  Gives back the lock taken with app_gatt_index_lock().
+
+ @param void
+
+ @return void
+ */
+void app_gatt_index_unlock(void)
+{
+    xSemaphoreGiveRecursive(app_gatt_index_mutex);
+}
+
+/*
+ Function Name:
+ app_gatt_index_add
+
+ Function Description:
+ @brief  Adds a service to the segment of its handles. The service handle,
+         first in the database fragment, selects the segment and every
+         attribute value must be in it. The segment is filled before it is
+         published, so a concurrent lookup sees the whole service or none.
+         The cost depends on the size of the service only.
+
+ @param p_db       GATT database fragment of the service
+ @param db_len     Size of the fragment in bytes
+ @param p_attrs    Attribute values of the service
+ @param p_types    Attribute type of each value
+ @param num_attrs  Number of attribute values
+ @param p_cbs      Callbacks of the service, NULL if the values are static
+
+ @return wiced_bt_gatt_status_t  WICED_BT_GATT_INVALID_HANDLE if a handle is
+                                 outside the segment, WICED_BT_GATT_NO_RESOURCES
+                                 if the segment is in use
+ */
+wiced_bt_gatt_status_t app_gatt_index_add(const uint8_t *p_db, uint16_t db_len,
+                                          gatt_db_lookup_table_t *p_attrs,
+                                          const wiced_bt_uuid_t *p_types,
+                                          uint16_t num_attrs,
+                                          const app_gatt_service_cbs_t *p_cbs)
+{
+    app_gatt_segment_t *p_seg;
+    uint16_t service_handle;
+    uint32_t segment;
+    uint16_t pos;
+    uint16_t i;
+
+    if ((NULL == p_db) || (2u > db_len) || (APP_GATT_APP_SERVICE_HANDLES < num_attrs))
+    {
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+    }
+
+    service_handle = APP_GATT_INDEX_SERVICE_HANDLE(p_db);
+    segment = APP_GATT_INDEX_SEGMENT(service_handle);
+    if ((APP_GATT_APP_HANDLE_BASE > service_handle) ||
+        (APP_GATT_MAX_APP_SERVICES <= segment))
+    {
+        return WICED_BT_GATT_INVALID_HANDLE;
+    }
+
+    p_seg = &app_gatt_segments[segment];
+    if (NULL != p_seg->p_db)
+    {
+        return WICED_BT_GATT_NO_RESOURCES;
+    }
+
+    memset(p_seg->attr_index, APP_GATT_INDEX_NO_ATTR, sizeof(p_seg->attr_index));
+    p_seg->p_attrs = p_attrs;
+    p_seg->p_types = p_types;
+
+    for (i = 0; i < num_attrs; i++)
+    {
+        /* Handles below the base wrap to a segment far out of range */
+        if ((APP_GATT_INDEX_SEGMENT(p_attrs[i].handle) != segment) ||
+            (APP_GATT_INDEX_NO_ATTR !=
+             p_seg->attr_index[APP_GATT_INDEX_OFFSET(p_attrs[i].handle)]))
+        {
+            return WICED_BT_GATT_INVALID_HANDLE;
+        }
+        p_seg->attr_index[APP_GATT_INDEX_OFFSET(p_attrs[i].handle)] = (uint8_t)i;
+
+        /* Insertion sort, the services have a handful of values */
+        pos = i;
+        while ((0 < pos) &&
+               !app_gatt_index_before(p_seg, p_seg->type_order[pos - 1u],
+                                      &p_types[i], p_attrs[i].handle))
+        {
+            p_seg->type_order[pos] = p_seg->type_order[pos - 1u];
+            pos--;
+        }
+        p_seg->type_order[pos] = (uint8_t)i;
+    }
+
+    p_seg->p_cbs = p_cbs;
+    p_seg->db_len = db_len;
+    p_seg->num_attrs = num_attrs;
+
+    /* Readers that do not take the lock test p_db first: the segment must
+     * be complete in memory before it is published */
+    __DMB();
+    p_seg->p_db = p_db;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_gatt_index_remove
+
+ Function Description:
+ @brief  Frees the segment of a service.
+
+ @param service_handle  Handle of the service declaration
+
+ @return bool  false if no service starts at the handle
+ */
+bool app_gatt_index_remove(uint16_t service_handle)
+{
+    app_gatt_segment_t *p_seg =
+        (app_gatt_segment_t *)app_gatt_index_segment(service_handle);
+
+    if ((NULL == p_seg) || (service_handle != APP_GATT_INDEX_SERVICE_HANDLE(p_seg->p_db)))
+    {
+        return false;
+    }
+
+    p_seg->p_db = NULL;
+    return true;
+}
+
+/*
+ Function Name:
+ app_gatt_index_segment
+
+ Function Description:
+ @brief  Returns the service of the segment holding a handle.
+
+ @param handle  Attribute handle
+
+ @return const app_gatt_segment_t*  Segment, NULL if the handle is not in a
+                                    segment in use
+ */
+const app_gatt_segment_t *app_gatt_index_segment(uint16_t handle)
+{
+    uint32_t segment = APP_GATT_INDEX_SEGMENT(handle);
+
+    if ((APP_GATT_APP_HANDLE_BASE > handle) || (APP_GATT_MAX_APP_SERVICES <= segment) ||
+        (NULL == app_gatt_segments[segment].p_db))
+    {
+        return NULL;
+    }
+
+    return &app_gatt_segments[segment];
+}
+
+/*
+ Function Name:
+ app_gatt_index_attr
+
+ Function Description:
+ @brief  Returns the attribute value of a handle, from the generated index
+         below APP_GATT_APP_HANDLE_BASE and from the segment above it.
+
+ @param handle  Attribute handle
+
+ @return gatt_db_lookup_table_t*  Attribute value, NULL if the handle has none
+ */
+gatt_db_lookup_table_t *app_gatt_index_attr(uint16_t handle)
+{
+    const app_gatt_segment_t *p_seg;
+    uint8_t index;
+
+    if (APP_GATT_APP_HANDLE_BASE > handle)
+    {
+        if (APP_GATT_GEN_MAX_HANDLE < handle)
+        {
+            return NULL;
+        }
+        index = app_gatt_gen_attr_index[handle];
+        return (APP_GATT_GEN_NO_ATTR != index) ? &app_gatt_db_ext_attr_tbl[index] : NULL;
+    }
+
+    p_seg = app_gatt_index_segment(handle);
+    if (NULL == p_seg)
+    {
+        return NULL;
+    }
+
+    index = p_seg->attr_index[APP_GATT_INDEX_OFFSET(handle)];
+    return (APP_GATT_INDEX_NO_ATTR != index) ? &p_seg->p_attrs[index] : NULL;
+}
+
+/*
+ Function Name:
+ app_gatt_index_find
+
+ Function Description:
+ @brief  Starts a walk over the handles of a type in a handle range. The
+         handles of the generated database come first, then those of the
+         segments, which are all above them.
+
+ @param p_iter    Walk to start
+ @param p_type    Attribute type
+ @param s_handle  First handle of the range
+ @param e_handle  Last handle of the range
+
+ @return void
+ */
+void app_gatt_index_find(app_gatt_index_iter_t *p_iter, const wiced_bt_uuid_t *p_type,
+                         uint16_t s_handle, uint16_t e_handle)
+{
+    const app_gatt_gen_uuid_t *p_gen_type = NULL;
+    uint16_t left = 0;
+    uint16_t right;
+    uint16_t mid;
+
+    p_iter->p_type = p_type;
+    p_iter->s_handle = s_handle;
+    p_iter->e_handle = e_handle;
+    p_iter->p_gen = NULL;
+    p_iter->gen_left = 0;
+
+    /* The generated database has 16-bit types only */
+    if ((LEN_UUID_16 == p_type->len) && (APP_GATT_GEN_MAX_HANDLE >= s_handle))
+    {
+        p_gen_type = app_gatt_index_gen_type(p_type->uu.uuid16);
+    }
+
+    if (NULL != p_gen_type)
+    {
+        right = p_gen_type->count;
+        while (left < right)
+        {
+            mid = left + (right - left) / 2;
+            if (app_gatt_gen_uuid_handles[p_gen_type->first + mid] < s_handle)
+            {
+                left = mid + 1;
+            }
+            else
+            {
+                right = mid;
+            }
+        }
+        p_iter->p_gen = &app_gatt_gen_uuid_handles[p_gen_type->first + left];
+        p_iter->gen_left = p_gen_type->count - left;
+    }
+
+    if (APP_GATT_APP_HANDLE_BASE > s_handle)
+    {
+        p_iter->segment = 0;
+    }
+    else
+    {
+        p_iter->segment = (APP_GATT_MAX_APP_SERVICES > APP_GATT_INDEX_SEGMENT(s_handle))
+                          ? (uint16_t)APP_GATT_INDEX_SEGMENT(s_handle)
+                          : APP_GATT_MAX_APP_SERVICES;
+    }
+    p_iter->pos = (APP_GATT_MAX_APP_SERVICES > p_iter->segment)
+                  ? app_gatt_index_lower_bound(&app_gatt_segments[p_iter->segment],
+                                               p_type, s_handle)
+                  : 0;
+}
+
+/*
+ Function Name:
+ app_gatt_index_next
+
+ Function Description:
+ @brief  Returns the next handle of a walk started by app_gatt_index_find().
+         Segments freed during the walk are skipped.
+
+ @param p_iter  Walk
+
+ @return uint16_t  Handle, 0 at the end of the range
+ */
+uint16_t app_gatt_index_next(app_gatt_index_iter_t *p_iter)
+{
+    const app_gatt_segment_t *p_seg;
+    uint16_t handle;
+    uint8_t index;
+
+    if (0 < p_iter->gen_left)
+    {
+        if (*p_iter->p_gen > p_iter->e_handle)
+        {
+            /* The segments are further up */
+            p_iter->gen_left = 0;
+            p_iter->segment = APP_GATT_MAX_APP_SERVICES;
+            return 0;
+        }
+        p_iter->gen_left--;
+        return *p_iter->p_gen++;
+    }
+
+    while ((APP_GATT_MAX_APP_SERVICES > p_iter->segment) &&
+           (APP_GATT_INDEX_SEGMENT_START(p_iter->segment) <= p_iter->e_handle))
+    {
+        p_seg = &app_gatt_segments[p_iter->segment];
+        if ((NULL != p_seg->p_db) && (p_iter->pos < p_seg->num_attrs))
+        {
+            index = p_seg->type_order[p_iter->pos];
+            if (0 == app_gatt_index_type_cmp(&p_seg->p_types[index], p_iter->p_type))
+            {
+                handle = p_seg->p_attrs[index].handle;
+                if (handle > p_iter->e_handle)
+                {
+                    /* The next segments are further up */
+                    p_iter->segment = APP_GATT_MAX_APP_SERVICES;
+                    return 0;
+                }
+                p_iter->pos++;
+                return handle;
+            }
+        }
+
+        p_iter->segment++;
+        p_iter->pos = (APP_GATT_MAX_APP_SERVICES > p_iter->segment)
+                      ? app_gatt_index_lower_bound(&app_gatt_segments[p_iter->segment],
+                                                   p_iter->p_type, p_iter->s_handle)
+                      : 0;
+    }
+
+    return 0;
+}
+
+/*
+ Function Name:
+ app_gatt_index_type_cmp
+
+ Function Description:
+ @brief  Orders attribute types, by length then by value.
+
+ @param p_a  Type
+ @param p_b  Type
+
+ @return int32_t  Negative, 0 or positive as p_a is below, equal or above p_b
+ */
+static int32_t app_gatt_index_type_cmp(const wiced_bt_uuid_t *p_a,
+                                       const wiced_bt_uuid_t *p_b)
+{
+    if (p_a->len != p_b->len)
+    {
+        return (int32_t)p_a->len - (int32_t)p_b->len;
+    }
+
+    switch (p_a->len)
+    {
+        case LEN_UUID_16:
+            return (int32_t)p_a->uu.uuid16 - (int32_t)p_b->uu.uuid16;
+        case LEN_UUID_32:
+            return (p_a->uu.uuid32 > p_b->uu.uuid32) - (p_a->uu.uuid32 < p_b->uu.uuid32);
+        default:
+            return memcmp(p_a->uu.uuid128, p_b->uu.uuid128, LEN_UUID_128);
+    }
+}
+
+/*
+ Function Name:
+ app_gatt_index_before
+
+ Function Description:
+ @brief  Tells whether an attribute value of a segment sorts below a type
+         and handle.
+
+ @param p_seg   Segment
+ @param index   Position of the value in the attributes of the segment
+ @param p_type  Attribute type
+ @param handle  Handle
+
+ @return bool  true if the value sorts below
+ */
+static bool app_gatt_index_before(const app_gatt_segment_t *p_seg, uint8_t index,
+                                  const wiced_bt_uuid_t *p_type, uint16_t handle)
+{
+    int32_t cmp = app_gatt_index_type_cmp(&p_seg->p_types[index], p_type);
+
+    return (0 > cmp) || ((0 == cmp) && (p_seg->p_attrs[index].handle < handle));
+}
+
+/*
+ Function Name:
+ app_gatt_index_lower_bound
+
+ Function Description:
+ @brief  Binary search of the first value of a segment in type order that
+         is not below a type and handle.
+
+ @param p_seg   Segment
+ @param p_type  Attribute type
+ @param handle  Handle
+
+ @return uint16_t  Position in the type order, the number of values if none
+ */
+static uint16_t app_gatt_index_lower_bound(const app_gatt_segment_t *p_seg,
+                                           const wiced_bt_uuid_t *p_type,
+                                           uint16_t handle)
+{
+    uint16_t left = 0;
+    uint16_t right;
+    uint16_t mid;
+
+    if (NULL == p_seg->p_db)
+    {
+        return 0;
+    }
+
+    right = p_seg->num_attrs;
+    while (left < right)
+    {
+        mid = left + (right - left) / 2;
+        if (app_gatt_index_before(p_seg, p_seg->type_order[mid], p_type, handle))
+        {
+            left = mid + 1;
+        }
+        else
+        {
+            right = mid;
+        }
+    }
+
+    return left;
+}
+
+/*
+ Function Name:
+ app_gatt_index_gen_type
+
+ Function Description:
+ @brief  Binary search of a type in the generated index.
+
+ @param uuid16  16-bit attribute type
+
+ @return const app_gatt_gen_uuid_t*  Handles of the type, NULL if none
+ */
+static const app_gatt_gen_uuid_t *app_gatt_index_gen_type(uint16_t uuid16)
+{
+    uint16_t left = 0;
+    uint16_t right = APP_GATT_GEN_NUM_UUIDS;
+    uint16_t mid;
+
+    while (left < right)
+    {
+        mid = left + (right - left) / 2;
+        if (app_gatt_gen_uuids[mid].uuid == uuid16)
+        {
+            return &app_gatt_gen_uuids[mid];
+        }
+
+        if (app_gatt_gen_uuids[mid].uuid < uuid16)
+        {
+            left = mid + 1;
+        }
+        else
+        {
+            right = mid;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ Function Name:
+ app_gatt_index_cmd
+
+ Function Description:
+ @brief  Console command listing the generated database and the segments in
+         use.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_gatt_index_cmd(uint32_t argc, char *argv[])
+{
+    const app_gatt_segment_t *p_seg;
+    uint32_t segment;
+
+    printf("  0x%04X-0x%04X  generated, %u values, %u bytes\n", 1u,
+           APP_GATT_GEN_MAX_HANDLE, APP_GATT_GEN_NUM_ATTRS, gatt_database_len);
+
+    for (segment = 0; segment < APP_GATT_MAX_APP_SERVICES; segment++)
+    {
+        p_seg = &app_gatt_segments[segment];
+        if (NULL != p_seg->p_db)
+        {
+            printf("  0x%04X-0x%04X  service 0x%04X, %u values, %u bytes\n",
+                   (unsigned)APP_GATT_INDEX_SEGMENT_START(segment),
+                   (unsigned)APP_GATT_INDEX_SEGMENT_END(segment),
+                   APP_GATT_INDEX_SERVICE_HANDLE(p_seg->p_db),
+                   p_seg->num_attrs, p_seg->db_len);
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/*******************************************************************************
+* File Name: app_bt_gatt_index.h
+*
+* Description: This file contains the public interface of the attribute index:
+*              the generated index of the configured database and the handle
+*              segments of the services added at run time.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_GATT_INDEX_H__
+#define __APP_BT_GATT_INDEX_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_handler.h"
+#include "wiced_bt_gatt.h"
+#include "wiced_bt_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* No attribute value at a handle of a segment */
+#define APP_GATT_INDEX_NO_ATTR           (0xFFu)
+
+/* Segment of a handle at or above APP_GATT_APP_HANDLE_BASE */
+#define APP_GATT_INDEX_SEGMENT(handle)   \
+    (((uint32_t)(handle) - APP_GATT_APP_HANDLE_BASE) / APP_GATT_APP_SERVICE_HANDLES)
+
+/* Position of a handle in its segment */
+#define APP_GATT_INDEX_OFFSET(handle)    \
+    (((uint32_t)(handle) - APP_GATT_APP_HANDLE_BASE) % APP_GATT_APP_SERVICE_HANDLES)
+
+/* Handle of the service declaration, which starts a database fragment */
+#define APP_GATT_INDEX_SERVICE_HANDLE(p_db) \
+    ((uint16_t)((p_db)[0] | ((uint16_t)(p_db)[1] << 8)))
+
+/* First and last handle of a segment */
+#define APP_GATT_INDEX_SEGMENT_START(segment)   \
+    (APP_GATT_APP_HANDLE_BASE + (segment) * APP_GATT_APP_SERVICE_HANDLES)
+#define APP_GATT_INDEX_SEGMENT_END(segment)     \
+    (APP_GATT_INDEX_SEGMENT_START(segment) + APP_GATT_APP_SERVICE_HANDLES - 1u)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Service of an application module in the segment of its handles. The
+ * segment is free while p_db is NULL; p_db is written last when the
+ * segment is filled. */
+typedef struct
+{
+    const uint8_t * volatile        p_db;
+    gatt_db_lookup_table_t          *p_attrs;
+    const wiced_bt_uuid_t           *p_types;
+    const app_gatt_service_cbs_t    *p_cbs;
+    uint16_t                        db_len;
+    uint16_t                        num_attrs;
+    /* Position in p_attrs of each handle of the segment */
+    uint8_t                         attr_index[APP_GATT_APP_SERVICE_HANDLES];
+    /* Positions in p_attrs sorted by type, then by handle */
+    uint8_t                         type_order[APP_GATT_APP_SERVICE_HANDLES];
+} app_gatt_segment_t;
+
+/* Walk over the handles of one attribute type in a handle range, in
+ * ascending order. Filled by app_gatt_index_find(). */
+typedef struct
+{
+    const wiced_bt_uuid_t   *p_type;
+    uint16_t                s_handle;
+    uint16_t                e_handle;
+    const uint16_t          *p_gen;     /* Next handle of the generated index */
+    uint16_t                gen_left;
+    uint16_t                segment;    /* Segment walked */
+    uint16_t                pos;        /* Next position in its type order */
+} app_gatt_index_iter_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_gatt_index_init(void);
+
+void app_gatt_index_lock(void);
+
+void app_gatt_index_unlock(void);
+
+wiced_bt_gatt_status_t app_gatt_index_add(const uint8_t *p_db, uint16_t db_len,
+                                          gatt_db_lookup_table_t *p_attrs,
+                                          const wiced_bt_uuid_t *p_types,
+                                          uint16_t num_attrs,
+                                          const app_gatt_service_cbs_t *p_cbs);
+
+bool app_gatt_index_remove(uint16_t service_handle);
+
+const app_gatt_segment_t *app_gatt_index_segment(uint16_t handle);
+
+gatt_db_lookup_table_t *app_gatt_index_attr(uint16_t handle);
+
+void app_gatt_index_find(app_gatt_index_iter_t *p_iter, const wiced_bt_uuid_t *p_type,
+                         uint16_t s_handle, uint16_t e_handle);
+
+uint16_t app_gatt_index_next(app_gatt_index_iter_t *p_iter);
+
+#endif      /* __APP_BT_GATT_INDEX_H__ */
+
+/* [] END OF FILE */
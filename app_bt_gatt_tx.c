@@ -0,0 +1,676 @@
+/*******************************************************************************
+* File Name: app_bt_gatt_tx.c
+*
+* Description: This file contains the transmit side of the GATT server. Every
+*              response and notification of the application goes through it, so
+*              that a sink, e.g. the load generator, can complete the requests
+*              of its own connections without the Bluetooth stack.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_tx.h"
+#include "app_bt_utils.h"
+#include "app_memory.h"
+#include "app_trace.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef void (*app_gatt_tx_free_t)(uint8_t *p_buf);
+
+/* Indication waiting for its confirmation, the entry is free while the
+ * handle is 0 */
+typedef struct
+{
+    uint16_t    conn_id;
+    uint16_t    handle;
+    uint64_t    sent_ms;
+} app_gatt_tx_ind_t;
+
+/* ATT_MTU of a connection, the entry is free while conn_id is 0 */
+typedef struct
+{
+    uint16_t    conn_id;
+    uint16_t    mtu;
+} app_gatt_tx_mtu_t;
+
+/* Round trips from an indication to its confirmation, timed on the uptime
+ * since the cycle counter stops while the CPU sleeps waiting for the peer */
+typedef struct
+{
+    uint32_t    sent;
+    uint32_t    busy;
+    uint32_t    confirmed;
+    uint64_t    total_ms;
+    uint32_t    max_ms;
+} app_gatt_tx_ind_stats_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static const app_gatt_tx_sink_t * volatile p_app_gatt_tx_sink;
+
+static app_gatt_tx_ind_t        app_gatt_tx_inds[APP_GATT_TX_MAX_IND_CONNS];
+static app_gatt_tx_ind_stats_t  app_gatt_tx_ind_stats;
+static app_gatt_tx_mtu_t        app_gatt_tx_mtus[APP_GATT_TX_MAX_MTU_CONNS];
+
+APP_MEMORY_FOOTPRINT(app_gatt_tx_ram_footprint,
+                     sizeof(app_gatt_tx_inds) + sizeof(app_gatt_tx_ind_stats) +
+                     sizeof(app_gatt_tx_mtus));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static bool app_gatt_tx_to_sink(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                wiced_bt_gatt_status_t status, uint8_t *p_data,
+                                wiced_bt_gatt_app_context_t p_app_ctx);
+
+static app_gatt_tx_ind_t *app_gatt_tx_find_ind(uint16_t conn_id);
+
+static app_gatt_tx_mtu_t *app_gatt_tx_find_mtu(uint16_t conn_id);
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_gatt_tx_set_sink
+
+ Function Description:
+ @brief  Installs or, with NULL, removes the sink.
+
+ @param p_sink  Sink, must stay valid until removed
+
+ @return void
+ */
+void app_gatt_tx_set_sink(const app_gatt_tx_sink_t *p_sink)
+{
+    p_app_gatt_tx_sink = p_sink;
+}
+
+/*
+ Function Name:
+ app_gatt_tx_error_rsp
+
+ Function Description:
+ @brief  Sends an error response, see wiced_bt_gatt_server_send_error_rsp().
+
+ @param conn_id  Connection ID
+ @param opcode   Opcode of the failed request
+ @param handle   Handle reported in the error response
+ @param status   Error status
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_tx_error_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                             uint16_t handle, wiced_bt_gatt_status_t status)
+{
+    if (app_gatt_tx_to_sink(conn_id, opcode, status, NULL, NULL))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+    return wiced_bt_gatt_server_send_error_rsp(conn_id, opcode, handle, status);
+}
+
+/*
+ Function Name:
+ app_gatt_tx_write_rsp
+
+ Function Description:
+ @brief  Sends a write response, see wiced_bt_gatt_server_send_write_rsp().
+
+ @param conn_id  Connection ID
+ @param opcode   Opcode of the request
+ @param handle   Written handle
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_tx_write_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                             uint16_t handle)
+{
+    if (app_gatt_tx_to_sink(conn_id, opcode, WICED_BT_GATT_SUCCESS, NULL, NULL))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+    return wiced_bt_gatt_server_send_write_rsp(conn_id, opcode, handle);
+}
+
+/*
+ Function Name:
+ app_gatt_tx_mtu_rsp
+
+ Function Description:
+ @brief  Records the ATT_MTU of the connection, the smaller of both MTUs,
+         and sends an MTU exchange response, see
+         wiced_bt_gatt_server_send_mtu_rsp().
+
+ @param conn_id     Connection ID
+ @param remote_mtu  MTU of the client
+ @param local_mtu   MTU of the server
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_tx_mtu_rsp(uint16_t conn_id, uint16_t remote_mtu,
+                                           uint16_t local_mtu)
+{
+    app_gatt_tx_mtu_t *p_mtu;
+
+    taskENTER_CRITICAL();
+    p_mtu = app_gatt_tx_find_mtu(conn_id);
+    if (NULL != p_mtu)
+    {
+        p_mtu->conn_id = conn_id;
+        p_mtu->mtu = (remote_mtu < local_mtu) ? remote_mtu : local_mtu;
+        p_mtu->mtu = (APP_GATT_TX_DEFAULT_MTU > p_mtu->mtu) ? APP_GATT_TX_DEFAULT_MTU
+                                                            : p_mtu->mtu;
+    }
+    taskEXIT_CRITICAL();
+
+    if (app_gatt_tx_to_sink(conn_id, GATT_REQ_MTU, WICED_BT_GATT_SUCCESS, NULL, NULL))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+    return wiced_bt_gatt_server_send_mtu_rsp(conn_id, remote_mtu, local_mtu);
+}
+
+/*
+ Function Name:
+ app_gatt_tx_get_mtu
+
+ Function Description:
+ @brief  Returns the ATT_MTU of a connection: the one negotiated by its MTU
+         exchange, or APP_GATT_TX_DEFAULT_MTU. A notification carries at
+         most ATT_MTU - 3 bytes of value.
+
+ @param conn_id  Connection ID
+
+ @return uint16_t  ATT_MTU
+ */
+uint16_t app_gatt_tx_get_mtu(uint16_t conn_id)
+{
+    uint16_t mtu = APP_GATT_TX_DEFAULT_MTU;
+    uint32_t i;
+
+    taskENTER_CRITICAL();
+    for (i = 0; i < APP_GATT_TX_MAX_MTU_CONNS; i++)
+    {
+        if ((0 != conn_id) && (conn_id == app_gatt_tx_mtus[i].conn_id))
+        {
+            mtu = app_gatt_tx_mtus[i].mtu;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return mtu;
+}
+
+/*
+ Function Name:
+ app_gatt_tx_mtu_reset
+
+ Function Description:
+ @brief  Forgets the MTU of a connection that went down.
+
+ @param conn_id  Connection ID
+
+ @return void
+ */
+void app_gatt_tx_mtu_reset(uint16_t conn_id)
+{
+    uint32_t i;
+
+    taskENTER_CRITICAL();
+    for (i = 0; i < APP_GATT_TX_MAX_MTU_CONNS; i++)
+    {
+        if (conn_id == app_gatt_tx_mtus[i].conn_id)
+        {
+            app_gatt_tx_mtus[i].conn_id = 0;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_gatt_tx_read_handle_rsp
+
+ Function Description:
+ @brief  Sends a read response, see
+         wiced_bt_gatt_server_send_read_handle_rsp().
+
+ @param conn_id    Connection ID
+ @param opcode     Opcode of the request
+ @param len        Length of the value
+ @param p_data     Value
+ @param p_app_ctx  Free function of the value buffer, or NULL
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_tx_read_handle_rsp(uint16_t conn_id,
+                                                   wiced_bt_gatt_opcode_t opcode,
+                                                   uint16_t len, uint8_t *p_data,
+                                                   wiced_bt_gatt_app_context_t p_app_ctx)
+{
+    if (app_gatt_tx_to_sink(conn_id, opcode, WICED_BT_GATT_SUCCESS, p_data, p_app_ctx))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+    return wiced_bt_gatt_server_send_read_handle_rsp(conn_id, opcode, len, p_data, p_app_ctx);
+}
+
+/*
+ Function Name:
+ app_gatt_tx_read_by_type_rsp
+
+ Function Description:
+ @brief  Sends a read by type response, see
+         wiced_bt_gatt_server_send_read_by_type_rsp().
+
+ @param conn_id    Connection ID
+ @param opcode     Opcode of the request
+ @param type_len   Length of a handle-value pair
+ @param data_len   Length of the response data
+ @param p_data     Response data
+ @param p_app_ctx  Free function of the data buffer, or NULL
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_tx_read_by_type_rsp(uint16_t conn_id,
+                                                    wiced_bt_gatt_opcode_t opcode,
+                                                    uint8_t type_len, uint16_t data_len,
+                                                    uint8_t *p_data,
+                                                    wiced_bt_gatt_app_context_t p_app_ctx)
+{
+    if (app_gatt_tx_to_sink(conn_id, opcode, WICED_BT_GATT_SUCCESS, p_data, p_app_ctx))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+    return wiced_bt_gatt_server_send_read_by_type_rsp(conn_id, opcode, type_len, data_len,
+                                                      p_data, p_app_ctx);
+}
+
+/*
+ Function Name:
+ app_gatt_tx_prepare_write_rsp
+
+ Function Description:
+ @brief  Sends a prepare write response, see
+         wiced_bt_gatt_server_send_prepare_write_rsp().
+
+ @param conn_id    Connection ID
+ @param opcode     Opcode of the request
+ @param handle     Handle of the fragment
+ @param offset     Offset of the fragment
+ @param len        Length of the fragment
+ @param p_data     Fragment, echoed back
+ @param p_app_ctx  Free function of the fragment buffer, or NULL
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_tx_prepare_write_rsp(uint16_t conn_id,
+                                                     wiced_bt_gatt_opcode_t opcode,
+                                                     uint16_t handle, uint16_t offset,
+                                                     uint16_t len, uint8_t *p_data,
+                                                     wiced_bt_gatt_app_context_t p_app_ctx)
+{
+    if (app_gatt_tx_to_sink(conn_id, opcode, WICED_BT_GATT_SUCCESS, p_data, p_app_ctx))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+    return wiced_bt_gatt_server_send_prepare_write_rsp(conn_id, opcode, handle, offset, len,
+                                                       p_data, p_app_ctx);
+}
+
+/*
+ Function Name:
+ app_gatt_tx_execute_write_rsp
+
+ Function Description:
+ @brief  Sends an execute write response, see
+         wiced_bt_gatt_server_send_execute_write_rsp().
+
+ @param conn_id  Connection ID
+ @param opcode   Opcode of the request
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_tx_execute_write_rsp(uint16_t conn_id,
+                                                     wiced_bt_gatt_opcode_t opcode)
+{
+    if (app_gatt_tx_to_sink(conn_id, opcode, WICED_BT_GATT_SUCCESS, NULL, NULL))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+    return wiced_bt_gatt_server_send_execute_write_rsp(conn_id, opcode);
+}
+
+/*
+ Function Name:
+ app_gatt_tx_notification
+
+ Function Description:
+ @brief  Sends a notification, see wiced_bt_gatt_server_send_notification().
+
+ @param conn_id    Connection ID
+ @param handle     Handle of the value
+ @param len        Length of the value
+ @param p_data     Value
+ @param p_app_ctx  Free function of the value buffer, or NULL
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t app_gatt_tx_notification(uint16_t conn_id, uint16_t handle,
+                                                uint16_t len, uint8_t *p_data,
+                                                wiced_bt_gatt_app_context_t p_app_ctx)
+{
+    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
+
+    app_trace_span_begin(APP_TRACE_SPAN_NOTIFICATION);
+    if (!app_gatt_tx_to_sink(conn_id, GATT_HANDLE_VALUE_NOTIF, WICED_BT_GATT_SUCCESS,
+                             p_data, p_app_ctx))
+    {
+        gatt_status = wiced_bt_gatt_server_send_notification(conn_id, handle, len,
+                                                             p_data, p_app_ctx);
+    }
+    app_trace_span_end(APP_TRACE_SPAN_NOTIFICATION);
+
+    return gatt_status;
+}
+
+/*
+ Function Name:
+ app_gatt_tx_indication
+
+ Function Description:
+ @brief  Sends an indication, see wiced_bt_gatt_server_send_indication(). The
+         client confirms it with GATT_HANDLE_VALUE_CONF, which must be passed
+         to app_gatt_tx_indication_confirmed(); until then further
+         indications on the connection are refused. A sink completes it at
+         once with GATT_HANDLE_VALUE_IND.
+
+ @param conn_id    Connection ID
+ @param handle     Handle of the value
+ @param len        Length of the value
+ @param p_data     Value, must stay valid until confirmed
+ @param p_app_ctx  Free function of the value buffer, or NULL
+
+ @return wiced_bt_gatt_status_t  WICED_BT_GATT_BUSY while an indication of
+                                 the connection is not confirmed
+ */
+wiced_bt_gatt_status_t app_gatt_tx_indication(uint16_t conn_id, uint16_t handle,
+                                              uint16_t len, uint8_t *p_data,
+                                              wiced_bt_gatt_app_context_t p_app_ctx)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    app_gatt_tx_ind_t *p_ind;
+    uint64_t now;
+
+    if (app_gatt_tx_to_sink(conn_id, GATT_HANDLE_VALUE_IND, WICED_BT_GATT_SUCCESS,
+                            p_data, p_app_ctx))
+    {
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    now = app_uptime_ms_get();
+
+    /* Claim the connection before sending, the confirmation may arrive in
+     * the stack thread before the send returns */
+    taskENTER_CRITICAL();
+    p_ind = app_gatt_tx_find_ind(conn_id);
+    if ((NULL == p_ind) || (0 != p_ind->handle))
+    {
+        app_gatt_tx_ind_stats.busy++;
+        taskEXIT_CRITICAL();
+        return (NULL == p_ind) ? WICED_BT_GATT_NO_RESOURCES : WICED_BT_GATT_BUSY;
+    }
+    p_ind->conn_id = conn_id;
+    p_ind->handle = handle;
+    p_ind->sent_ms = now;
+    taskEXIT_CRITICAL();
+
+    gatt_status = wiced_bt_gatt_server_send_indication(conn_id, handle, len, p_data, p_app_ctx);
+    if (WICED_BT_GATT_SUCCESS == gatt_status)
+    {
+        app_gatt_tx_ind_stats.sent++;
+    }
+    else
+    {
+        p_ind->handle = 0;
+    }
+
+    return gatt_status;
+}
+
+/*
+ Function Name:
+ app_gatt_tx_indication_confirmed
+
+ Function Description:
+ @brief  Releases the indication of a connection on its confirmation. The
+         caller can send the next one right away.
+
+ @param conn_id  Connection ID
+
+ @return uint16_t  Handle of the confirmed value, 0 if none was in flight
+ */
+uint16_t app_gatt_tx_indication_confirmed(uint16_t conn_id)
+{
+    uint64_t now = app_uptime_ms_get();
+    app_gatt_tx_ind_t *p_ind;
+    uint16_t handle = 0;
+    uint32_t round_trip_ms;
+
+    taskENTER_CRITICAL();
+    p_ind = app_gatt_tx_find_ind(conn_id);
+    if ((NULL != p_ind) && (0 != p_ind->handle))
+    {
+        handle = p_ind->handle;
+        p_ind->handle = 0;
+
+        round_trip_ms = (uint32_t)(now - p_ind->sent_ms);
+        app_gatt_tx_ind_stats.confirmed++;
+        app_gatt_tx_ind_stats.total_ms += round_trip_ms;
+        if (app_gatt_tx_ind_stats.max_ms < round_trip_ms)
+        {
+            app_gatt_tx_ind_stats.max_ms = round_trip_ms;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return handle;
+}
+
+/*
+ Function Name:
+ app_gatt_tx_indication_reset
+
+ Function Description:
+ @brief  Drops the unconfirmed indication of a connection that went down.
+
+ @param conn_id  Connection ID
+
+ @return void
+ */
+void app_gatt_tx_indication_reset(uint16_t conn_id)
+{
+    app_gatt_tx_ind_t *p_ind;
+
+    taskENTER_CRITICAL();
+    p_ind = app_gatt_tx_find_ind(conn_id);
+    if (NULL != p_ind)
+    {
+        p_ind->handle = 0;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_gatt_tx_print_indication_stats
+
+ Function Description:
+ @brief  Prints the indication counters and the round trip from an
+         indication to its confirmation.
+
+ @param void
+
+ @return void
+ */
+void app_gatt_tx_print_indication_stats(void)
+{
+    app_gatt_tx_ind_stats_t stats;
+
+    taskENTER_CRITICAL();
+    stats = app_gatt_tx_ind_stats;
+    taskEXIT_CRITICAL();
+
+    printf("Indications: %lu sent, %lu confirmed, %lu busy, round trip avg %lu ms max %lu ms\n",
+           (unsigned long)stats.sent, (unsigned long)stats.confirmed,
+           (unsigned long)stats.busy,
+           (unsigned long)((0 != stats.confirmed)
+                           ? (stats.total_ms / stats.confirmed) : 0),
+           (unsigned long)stats.max_ms);
+}
+
+/*
+ Function Name:
+ app_gatt_tx_to_sink
+
+ Function Description:
+ @brief  Completes a response in the sink if the sink owns the connection,
+         then releases the buffer like the stack does after transmission.
+
+ @param conn_id    Connection ID
+ @param opcode     Opcode of the request
+ @param status     Status of the response
+ @param p_data     Buffer of the response, or NULL
+ @param p_app_ctx  Free function of the buffer, or NULL
+
+ @return bool  true if the sink took the response
+ */
+static bool app_gatt_tx_to_sink(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                wiced_bt_gatt_status_t status, uint8_t *p_data,
+                                wiced_bt_gatt_app_context_t p_app_ctx)
+{
+    const app_gatt_tx_sink_t *p_sink = p_app_gatt_tx_sink;
+
+    if ((NULL == p_sink) || !p_sink->p_owns(conn_id))
+    {
+        return false;
+    }
+
+    p_sink->p_complete(conn_id, opcode, status);
+    if (NULL != p_app_ctx)
+    {
+        ((app_gatt_tx_free_t)p_app_ctx)(p_data);
+    }
+
+    return true;
+}
+
+/*
+ Function Name:
+ app_gatt_tx_find_ind
+
+ Function Description:
+ @brief  Returns the indication entry of a connection, or a free entry if
+         the connection has none. Called in a critical section.
+
+ @param conn_id  Connection ID
+
+ @return app_gatt_tx_ind_t*  Entry, NULL if all are taken by other connections
+ */
+static app_gatt_tx_ind_t *app_gatt_tx_find_ind(uint16_t conn_id)
+{
+    app_gatt_tx_ind_t *p_free = NULL;
+    uint32_t i;
+
+    for (i = 0; i < APP_GATT_TX_MAX_IND_CONNS; i++)
+    {
+        if (0 == app_gatt_tx_inds[i].handle)
+        {
+            p_free = (NULL == p_free) ? &app_gatt_tx_inds[i] : p_free;
+        }
+        else if (conn_id == app_gatt_tx_inds[i].conn_id)
+        {
+            return &app_gatt_tx_inds[i];
+        }
+    }
+
+    return p_free;
+}
+
+/*
+ Function Name:
+ app_gatt_tx_find_mtu
+
+ Function Description:
+ @brief  Returns the MTU entry of a connection, or a free one. Called in a
+         critical section.
+
+ @param conn_id  Connection ID
+
+ @return app_gatt_tx_mtu_t*  Entry, NULL if all are taken by other connections
+ */
+static app_gatt_tx_mtu_t *app_gatt_tx_find_mtu(uint16_t conn_id)
+{
+    app_gatt_tx_mtu_t *p_free = NULL;
+    uint32_t i;
+
+    for (i = 0; i < APP_GATT_TX_MAX_MTU_CONNS; i++)
+    {
+        if (conn_id == app_gatt_tx_mtus[i].conn_id)
+        {
+            return &app_gatt_tx_mtus[i];
+        }
+        if ((0 == app_gatt_tx_mtus[i].conn_id) && (NULL == p_free))
+        {
+            p_free = &app_gatt_tx_mtus[i];
+        }
+    }
+
+    return p_free;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,140 @@
+/*******************************************************************************
+* File Name: app_bt_gatt_tx.h
+*
+* Description: This file contains the definitions of the transmit side of the
+*              GATT server. Responses and notifications are sent through these
+*              functions, which hand them to the Bluetooth stack or, for
+*              connections owned by a sink, to the sink.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_GATT_TX_H__
+#define __APP_BT_GATT_TX_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "wiced_bt_gatt.h"
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Connections tracked for indications. ATT allows one unconfirmed indication
+ * per connection, app_gatt_tx_indication() returns WICED_BT_GATT_BUSY while
+ * it waits for its confirmation. */
+#define APP_GATT_TX_MAX_IND_CONNS        (4u)
+
+/* Connections whose negotiated MTU is kept. A connection without an MTU
+ * exchange, or beyond this count, uses the default ATT_MTU. */
+#define APP_GATT_TX_MAX_MTU_CONNS        (4u)
+#define APP_GATT_TX_DEFAULT_MTU          (23u)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Receiver of the responses to connections that do not exist in the stack,
+ * e.g. the virtual connections of the load generator.
+ *   p_owns      Returns true for the connections of the sink
+ *   p_complete  Called instead of sending a response or notification, with
+ *               the opcode of the request (GATT_HANDLE_VALUE_NOTIF for a
+ *               notification, GATT_HANDLE_VALUE_IND for an indication)
+ *               and WICED_BT_GATT_SUCCESS or the error status.
+ * A buffer handed over with a free function as context is released after
+ * p_complete, as the stack would once it is transmitted. */
+typedef struct
+{
+    bool    (*p_owns)(uint16_t conn_id);
+    void    (*p_complete)(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                          wiced_bt_gatt_status_t status);
+} app_gatt_tx_sink_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_gatt_tx_set_sink(const app_gatt_tx_sink_t *p_sink);
+
+wiced_bt_gatt_status_t app_gatt_tx_error_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                             uint16_t handle, wiced_bt_gatt_status_t status);
+
+wiced_bt_gatt_status_t app_gatt_tx_write_rsp(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                             uint16_t handle);
+
+wiced_bt_gatt_status_t app_gatt_tx_mtu_rsp(uint16_t conn_id, uint16_t remote_mtu,
+                                           uint16_t local_mtu);
+
+uint16_t app_gatt_tx_get_mtu(uint16_t conn_id);
+
+void app_gatt_tx_mtu_reset(uint16_t conn_id);
+
+wiced_bt_gatt_status_t app_gatt_tx_read_handle_rsp(uint16_t conn_id,
+                                                   wiced_bt_gatt_opcode_t opcode,
+                                                   uint16_t len, uint8_t *p_data,
+                                                   wiced_bt_gatt_app_context_t p_app_ctx);
+
+wiced_bt_gatt_status_t app_gatt_tx_read_by_type_rsp(uint16_t conn_id,
+                                                    wiced_bt_gatt_opcode_t opcode,
+                                                    uint8_t type_len, uint16_t data_len,
+                                                    uint8_t *p_data,
+                                                    wiced_bt_gatt_app_context_t p_app_ctx);
+
+wiced_bt_gatt_status_t app_gatt_tx_prepare_write_rsp(uint16_t conn_id,
+                                                     wiced_bt_gatt_opcode_t opcode,
+                                                     uint16_t handle, uint16_t offset,
+                                                     uint16_t len, uint8_t *p_data,
+                                                     wiced_bt_gatt_app_context_t p_app_ctx);
+
+wiced_bt_gatt_status_t app_gatt_tx_execute_write_rsp(uint16_t conn_id,
+                                                     wiced_bt_gatt_opcode_t opcode);
+
+wiced_bt_gatt_status_t app_gatt_tx_notification(uint16_t conn_id, uint16_t handle,
+                                                uint16_t len, uint8_t *p_data,
+                                                wiced_bt_gatt_app_context_t p_app_ctx);
+
+wiced_bt_gatt_status_t app_gatt_tx_indication(uint16_t conn_id, uint16_t handle,
+                                              uint16_t len, uint8_t *p_data,
+                                              wiced_bt_gatt_app_context_t p_app_ctx);
+
+uint16_t app_gatt_tx_indication_confirmed(uint16_t conn_id);
+
+void app_gatt_tx_indication_reset(uint16_t conn_id);
+
+void app_gatt_tx_print_indication_stats(void);
+
+#endif      /* __APP_BT_GATT_TX_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,550 @@
+/*******************************************************************************
+* File Name: app_bt_gatt_worker.c
+*
+* Description: This file contains the GATT worker task. Deferred GATT events
+*              and requests are copied into work items by the Bluetooth stack
+*              callback and are processed, including sending the response, by
+*              the worker task.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_worker.h"
+#include "app_bt_gatt_tx.h"
+#include "app_bt_utils.h"
+#include "app_memory.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* A GATT event or attribute request copied out of the stack's event data */
+typedef struct
+{
+    bool                                is_request;
+    wiced_bt_gatt_evt_t                 event;
+    uint32_t                            enqueue_cycles;
+    union
+    {
+        wiced_bt_gatt_event_data_t      event_data;
+        wiced_bt_gatt_attribute_request_t attr_req;
+    } data;
+    /* Storage for the data the stack passed by reference */
+    wiced_bt_device_address_t           bd_addr;
+    uint8_t                             value[APP_GATT_WORKER_VALUE_SIZE];
+} app_gatt_work_item_t;
+
+/* Counters of the worker and of the stack thread hold time */
+typedef struct
+{
+    uint32_t    processed;
+    uint32_t    dropped;
+    uint32_t    max_pending;
+    uint32_t    max_queue_cycles;
+    uint32_t    max_process_cycles;
+    uint32_t    hold_count;
+    uint32_t    hold_max_cycles;
+    uint32_t    hold_over_budget;
+    uint64_t    hold_total_cycles;
+} app_gatt_worker_stats_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static app_gatt_work_item_t     app_gatt_work_items[APP_GATT_WORKER_QUEUE_LEN];
+
+/* Pending work items, in arrival order */
+static QueueHandle_t            app_gatt_work_queue;
+
+/* Free work items. Using a queue as free list makes allocation in the stack
+ * thread and release in the worker thread safe without a critical section.
+ */
+static QueueHandle_t            app_gatt_free_queue;
+
+static TaskHandle_t             app_gatt_worker_task_handle;
+
+#if APP_STATIC_MEMORY
+/* Queue storage, task stack and control blocks in static memory mode */
+static uint8_t      app_gatt_work_queue_storage[APP_GATT_WORKER_QUEUE_LEN *
+                                                sizeof(app_gatt_work_item_t *)];
+static uint8_t      app_gatt_free_queue_storage[APP_GATT_WORKER_QUEUE_LEN *
+                                                sizeof(app_gatt_work_item_t *)];
+static StaticQueue_t app_gatt_work_queue_cb;
+static StaticQueue_t app_gatt_free_queue_cb;
+static StackType_t  app_gatt_worker_stack[APP_GATT_WORKER_STACK_SIZE];
+static StaticTask_t app_gatt_worker_tcb;
+
+APP_MEMORY_FOOTPRINT(app_gatt_worker_ram_footprint,
+                     sizeof(app_gatt_work_items) +
+                     sizeof(app_gatt_work_queue_storage) +
+                     sizeof(app_gatt_free_queue_storage) +
+                     sizeof(app_gatt_work_queue_cb) + sizeof(app_gatt_free_queue_cb) +
+                     sizeof(app_gatt_worker_stack) + sizeof(app_gatt_worker_tcb));
+#else
+APP_MEMORY_FOOTPRINT(app_gatt_worker_ram_footprint, sizeof(app_gatt_work_items));
+#endif
+
+/* Handlers that run in the worker context */
+static app_gatt_event_handler_t  app_gatt_deferred_event_handlers[APP_GATT_EVENT_MAP_SIZE];
+static app_gatt_opcode_handler_t app_gatt_deferred_opcode_handlers[APP_GATT_OPCODE_MAP_SIZE];
+
+static app_gatt_worker_stats_t  app_gatt_worker_stats;
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_gatt_worker_task(void *pvParam);
+
+static app_gatt_work_item_t *app_gatt_worker_alloc(void);
+
+static void app_gatt_worker_submit(app_gatt_work_item_t *p_item);
+
+static wiced_bt_gatt_status_t
+app_gatt_worker_enqueue_event(wiced_bt_gatt_event_data_t *p_event_data);
+
+static wiced_bt_gatt_status_t
+app_gatt_worker_enqueue_request(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                                uint16_t *p_error_handle);
+
+static bool app_gatt_opcode_needs_rsp(wiced_bt_gatt_opcode_t opcode);
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_gatt_worker_init
+
+ Function Description:
+ @brief  Creates the work queues and the worker task.
+
+ @param void
+
+ @return void
+ */
+void app_gatt_worker_init(void)
+{
+    app_gatt_work_item_t *p_item;
+    BaseType_t rtos_result;
+    uint32_t i;
+
+    memset(&app_gatt_worker_stats, 0, sizeof(app_gatt_worker_stats));
+
+#if APP_STATIC_MEMORY
+    app_gatt_work_queue = xQueueCreateStatic(APP_GATT_WORKER_QUEUE_LEN,
+                                             sizeof(app_gatt_work_item_t *),
+                                             app_gatt_work_queue_storage,
+                                             &app_gatt_work_queue_cb);
+    app_gatt_free_queue = xQueueCreateStatic(APP_GATT_WORKER_QUEUE_LEN,
+                                             sizeof(app_gatt_work_item_t *),
+                                             app_gatt_free_queue_storage,
+                                             &app_gatt_free_queue_cb);
+#else
+    app_gatt_work_queue = xQueueCreate(APP_GATT_WORKER_QUEUE_LEN,
+                                       sizeof(app_gatt_work_item_t *));
+    app_gatt_free_queue = xQueueCreate(APP_GATT_WORKER_QUEUE_LEN,
+                                       sizeof(app_gatt_work_item_t *));
+#endif
+    if ((NULL == app_gatt_work_queue) || (NULL == app_gatt_free_queue))
+    {
+        printf("GATT worker queue creation failed\n");
+        return;
+    }
+    /* Named for debuggers and the trace recorder */
+    vQueueAddToRegistry(app_gatt_work_queue, "GATT work");
+    vQueueAddToRegistry(app_gatt_free_queue, "GATT free");
+
+    for (i = 0; i < APP_GATT_WORKER_QUEUE_LEN; i++)
+    {
+        p_item = &app_gatt_work_items[i];
+        xQueueSend(app_gatt_free_queue, &p_item, 0);
+    }
+
+#if APP_STATIC_MEMORY
+    app_gatt_worker_task_handle = xTaskCreateStatic(app_gatt_worker_task,
+                                                    APP_GATT_WORKER_TASK_NAME,
+                                                    APP_GATT_WORKER_STACK_SIZE, NULL,
+                                                    APP_GATT_WORKER_PRIORITY,
+                                                    app_gatt_worker_stack,
+                                                    &app_gatt_worker_tcb);
+    rtos_result = (NULL != app_gatt_worker_task_handle) ? pdPASS : pdFAIL;
+#else
+    rtos_result = xTaskCreate(app_gatt_worker_task, APP_GATT_WORKER_TASK_NAME,
+                              APP_GATT_WORKER_STACK_SIZE, NULL,
+                              APP_GATT_WORKER_PRIORITY,
+                              &app_gatt_worker_task_handle);
+#endif
+    if (pdPASS != rtos_result)
+    {
+        printf("GATT worker task creation failed\n");
+    }
+}
+
+/*
+ Function Name:
+ app_gatt_worker_defer_event
+
+ Function Description:
+ @brief  Registers a GATT event whose handler runs in the worker task. The
+         stack callback only copies the event data into a work item.
+
+ @param event      Bluetooth LE GATT event type
+ @param p_handler  Handler to be invoked in the worker task
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t
+app_gatt_worker_defer_event(wiced_bt_gatt_evt_t event,
+                            app_gatt_event_handler_t p_handler)
+{
+    /* Only events without further data by reference can be copied */
+    if (GATT_CONNECTION_STATUS_EVT != event)
+    {
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+    }
+
+    app_gatt_deferred_event_handlers[event] = p_handler;
+
+    return app_gatt_register_event_handler(event, app_gatt_worker_enqueue_event);
+}
+
+/*
+ Function Name:
+ app_gatt_worker_defer_opcode
+
+ Function Description:
+ @brief  Registers an ATT opcode whose handler runs in the worker task. The
+         stack callback only copies the request into a work item; the
+         response, or the error response, is sent by the worker.
+
+ @param opcode     ATT opcode
+ @param p_handler  Handler to be invoked in the worker task
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t
+app_gatt_worker_defer_opcode(wiced_bt_gatt_opcode_t opcode,
+                             app_gatt_opcode_handler_t p_handler)
+{
+    app_gatt_deferred_opcode_handlers[opcode] = p_handler;
+
+    return app_gatt_register_opcode_handler(opcode, app_gatt_worker_enqueue_request);
+}
+
+/*
+ Function Name:
+ app_gatt_worker_account_hold
+
+ Function Description:
+ @brief  Records the time the Bluetooth stack thread spent in the GATT
+         callback.
+
+ @param hold_cycles  CPU cycles spent in the callback
+
+ @return void
+ */
+void app_gatt_worker_account_hold(uint32_t hold_cycles)
+{
+    uint32_t budget_cycles = APP_GATT_WORKER_HOLD_BUDGET_US *
+                             (SystemCoreClock / 1000000u);
+
+    app_gatt_worker_stats.hold_count++;
+    app_gatt_worker_stats.hold_total_cycles += hold_cycles;
+    if (app_gatt_worker_stats.hold_max_cycles < hold_cycles)
+    {
+        app_gatt_worker_stats.hold_max_cycles = hold_cycles;
+    }
+    if (budget_cycles < hold_cycles)
+    {
+        app_gatt_worker_stats.hold_over_budget++;
+    }
+}
+
+/*
+ Function Name:
+ app_gatt_worker_print_stats
+
+ Function Description:
+ @brief  Prints the stack thread hold time and the worker counters.
+
+ @param void
+
+ @return void
+ */
+void app_gatt_worker_print_stats(void)
+{
+    const app_gatt_worker_stats_t *p_stats = &app_gatt_worker_stats;
+
+    printf("\nGATT stack callback hold: count %lu avg %lu max %lu cycles, "
+           "%lu over %u us budget\n",
+           (unsigned long)p_stats->hold_count,
+           (unsigned long)(p_stats->hold_count ?
+                (p_stats->hold_total_cycles / p_stats->hold_count) : 0),
+           (unsigned long)p_stats->hold_max_cycles,
+           (unsigned long)p_stats->hold_over_budget,
+           (unsigned int)APP_GATT_WORKER_HOLD_BUDGET_US);
+    printf("GATT worker: processed %lu dropped %lu max pending %lu "
+           "max queued %lu max process %lu cycles\n",
+           (unsigned long)p_stats->processed,
+           (unsigned long)p_stats->dropped,
+           (unsigned long)p_stats->max_pending,
+           (unsigned long)p_stats->max_queue_cycles,
+           (unsigned long)p_stats->max_process_cycles);
+}
+
+/*******************************************************************************
+ * Function Name: app_gatt_worker_enqueue_event
+ *******************************************************************************
+ * Summary:
+ *  Runs in the stack thread. Copies a deferred GATT event into a work item.
+ *
+ * Parameters:
+ *  wiced_bt_gatt_event_data_t *p_event_data: Pointer to GATT event data
+ *
+ ******************************************************************************/
+static wiced_bt_gatt_status_t
+app_gatt_worker_enqueue_event(wiced_bt_gatt_event_data_t *p_event_data)
+{
+    app_gatt_work_item_t *p_item = app_gatt_worker_alloc();
+
+    if (NULL == p_item)
+    {
+        /* A connection state change must not be lost, handle it inline */
+        return app_gatt_deferred_event_handlers[GATT_CONNECTION_STATUS_EVT](p_event_data);
+    }
+
+    p_item->is_request = false;
+    p_item->event = GATT_CONNECTION_STATUS_EVT;
+    p_item->data.event_data.connection_status = p_event_data->connection_status;
+    memcpy(p_item->bd_addr, p_event_data->connection_status.bd_addr,
+           sizeof(wiced_bt_device_address_t));
+    p_item->data.event_data.connection_status.bd_addr = p_item->bd_addr;
+
+    app_gatt_worker_submit(p_item);
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: app_gatt_worker_enqueue_request
+ *******************************************************************************
+ * Summary:
+ *  Runs in the stack thread. Copies a deferred attribute request, including a
+ *  write value, into a work item. Only the size is validated here.
+ *
+ * Parameters:
+ *  wiced_bt_gatt_attribute_request_t *p_attr_req: Pointer to GATT request
+ *  uint16_t *p_error_handle: Handle to be reported in the error response
+ *
+ ******************************************************************************/
+static wiced_bt_gatt_status_t
+app_gatt_worker_enqueue_request(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                                uint16_t *p_error_handle)
+{
+    app_gatt_work_item_t *p_item;
+    bool has_value = ((GATT_REQ_WRITE == p_attr_req->opcode) ||
+                      (GATT_CMD_WRITE == p_attr_req->opcode) ||
+                      (GATT_CMD_SIGNED_WRITE == p_attr_req->opcode) ||
+                      (GATT_REQ_PREPARE_WRITE == p_attr_req->opcode));
+
+    if (has_value)
+    {
+        *p_error_handle = p_attr_req->data.write_req.handle;
+        if (APP_GATT_WORKER_VALUE_SIZE < p_attr_req->data.write_req.val_len)
+        {
+            return WICED_BT_GATT_INVALID_ATTR_LEN;
+        }
+    }
+
+    p_item = app_gatt_worker_alloc();
+    if (NULL == p_item)
+    {
+        return WICED_BT_GATT_INSUF_RESOURCE;
+    }
+
+    p_item->is_request = true;
+    p_item->event = GATT_ATTRIBUTE_REQUEST_EVT;
+    p_item->data.attr_req = *p_attr_req;
+    if (has_value)
+    {
+        memcpy(p_item->value, p_attr_req->data.write_req.p_val,
+               p_attr_req->data.write_req.val_len);
+        p_item->data.attr_req.data.write_req.p_val = p_item->value;
+    }
+
+    app_gatt_worker_submit(p_item);
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: app_gatt_worker_task
+ *******************************************************************************
+ * Summary:
+ *  Processes work items in arrival order and sends error responses for
+ *  failed requests.
+ *
+ * Parameters:
+ *  void *pvParam: unused
+ *
+ ******************************************************************************/
+static void app_gatt_worker_task(void *pvParam)
+{
+    app_gatt_work_item_t *p_item;
+    app_gatt_opcode_handler_t p_opcode_handler;
+    wiced_bt_gatt_attribute_request_t *p_attr_req;
+    wiced_bt_gatt_status_t gatt_status;
+    uint16_t error_handle;
+    uint32_t start_cycles;
+    uint32_t cycles;
+
+    while (true)
+    {
+        xQueueReceive(app_gatt_work_queue, &p_item, portMAX_DELAY);
+
+        start_cycles = app_cycle_counter_get();
+        cycles = start_cycles - p_item->enqueue_cycles;
+        if (app_gatt_worker_stats.max_queue_cycles < cycles)
+        {
+            app_gatt_worker_stats.max_queue_cycles = cycles;
+        }
+
+        if (p_item->is_request)
+        {
+            p_attr_req = &p_item->data.attr_req;
+            p_opcode_handler = app_gatt_deferred_opcode_handlers[p_attr_req->opcode];
+            error_handle = 0;
+
+            gatt_status = p_opcode_handler(p_attr_req, &error_handle);
+            app_gatt_dispatch_account_deferred_opcode(p_attr_req->opcode, start_cycles,
+                                                      gatt_status);
+            if ((WICED_BT_GATT_SUCCESS != gatt_status) &&
+                app_gatt_opcode_needs_rsp(p_attr_req->opcode))
+            {
+                app_gatt_tx_error_rsp(p_attr_req->conn_id,
+                                      p_attr_req->opcode,
+                                      error_handle,
+                                      gatt_status);
+            }
+        }
+        else
+        {
+            gatt_status = app_gatt_deferred_event_handlers[p_item->event](&p_item->data.event_data);
+            app_gatt_dispatch_account_deferred_event(p_item->event, start_cycles, gatt_status);
+        }
+
+        cycles = app_cycle_counter_get() - start_cycles;
+        if (app_gatt_worker_stats.max_process_cycles < cycles)
+        {
+            app_gatt_worker_stats.max_process_cycles = cycles;
+        }
+        app_gatt_worker_stats.processed++;
+
+        xQueueSend(app_gatt_free_queue, &p_item, 0);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: app_gatt_worker_alloc
+ *******************************************************************************
+ * Summary:
+ *  Takes a free work item without blocking the stack thread.
+ *
+ ******************************************************************************/
+static app_gatt_work_item_t *app_gatt_worker_alloc(void)
+{
+    app_gatt_work_item_t *p_item = NULL;
+
+    if (pdPASS != xQueueReceive(app_gatt_free_queue, &p_item, 0))
+    {
+        app_gatt_worker_stats.dropped++;
+        return NULL;
+    }
+
+    return p_item;
+}
+
+/*******************************************************************************
+ * Function Name: app_gatt_worker_submit
+ *******************************************************************************
+ * Summary:
+ *  Hands a filled work item to the worker task. This can't fail since there
+ *  are never more items than queue entries.
+ *
+ * Parameters:
+ *  app_gatt_work_item_t *p_item: Work item to be processed
+ *
+ ******************************************************************************/
+static void app_gatt_worker_submit(app_gatt_work_item_t *p_item)
+{
+    uint32_t pending;
+
+    p_item->enqueue_cycles = app_cycle_counter_get();
+    xQueueSend(app_gatt_work_queue, &p_item, 0);
+
+    pending = uxQueueMessagesWaiting(app_gatt_work_queue);
+    if (app_gatt_worker_stats.max_pending < pending)
+    {
+        app_gatt_worker_stats.max_pending = pending;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: app_gatt_opcode_needs_rsp
+ *******************************************************************************
+ * Summary:
+ *  Returns false for ATT commands and stack notifications, for which no
+ *  (error) response may be sent to the peer.
+ *
+ * Parameters:
+ *  wiced_bt_gatt_opcode_t opcode: ATT opcode
+ *
+ ******************************************************************************/
+static bool app_gatt_opcode_needs_rsp(wiced_bt_gatt_opcode_t opcode)
+{
+    return ((GATT_CMD_WRITE != opcode) &&
+            (GATT_CMD_SIGNED_WRITE != opcode) &&
+            (GATT_HANDLE_VALUE_NOTIF != opcode));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,102 @@
+/*******************************************************************************
+* File Name: app_bt_gatt_worker.h
+*
+* Description: This file contains the macros and function prototypes of the
+*              GATT worker task which processes GATT requests outside the
+*              Bluetooth stack thread.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_GATT_WORKER_H__
+#define __APP_BT_GATT_WORKER_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_dispatch.h"
+#include "GeneratedSource/cycfg_gap.h"
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Set to 0 to handle all GATT requests inline in the Bluetooth stack thread */
+#ifndef APP_GATT_WORKER_ENABLE
+#define APP_GATT_WORKER_ENABLE           (1u)
+#endif
+
+/* Number of work items, i.e. requests that can be pending at the same time */
+#ifndef APP_GATT_WORKER_QUEUE_LEN
+#define APP_GATT_WORKER_QUEUE_LEN        (8u)
+#endif
+
+/* Largest write value copied into a work item; a write PDU can't exceed MTU */
+#define APP_GATT_WORKER_VALUE_SIZE       (CY_BT_MTU_SIZE)
+
+/* Worker task configuration. The worker runs above the ESS task so that
+ * responses are not delayed by sensor processing.
+ */
+#define APP_GATT_WORKER_TASK_NAME        "GATT Worker"
+#define APP_GATT_WORKER_STACK_SIZE       (configMINIMAL_STACK_SIZE * 4)
+#define APP_GATT_WORKER_PRIORITY         (configMAX_PRIORITIES - 2)
+
+/* Time the Bluetooth stack thread may spend in the GATT callback. Longer
+ * callbacks are counted as budget overruns.
+ */
+#ifndef APP_GATT_WORKER_HOLD_BUDGET_US
+#define APP_GATT_WORKER_HOLD_BUDGET_US   (50u)
+#endif
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_gatt_worker_init(void);
+
+wiced_bt_gatt_status_t
+app_gatt_worker_defer_event(wiced_bt_gatt_evt_t event,
+                            app_gatt_event_handler_t p_handler);
+
+wiced_bt_gatt_status_t
+app_gatt_worker_defer_opcode(wiced_bt_gatt_opcode_t opcode,
+                             app_gatt_opcode_handler_t p_handler);
+
+void app_gatt_worker_account_hold(uint32_t hold_cycles);
+
+void app_gatt_worker_print_stats(void);
+
+#endif      /* __APP_BT_GATT_WORKER_H__ */
+
+/* [] END OF FILE */
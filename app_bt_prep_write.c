@@ -0,0 +1,388 @@
+/*******************************************************************************
+* File Name: app_bt_prep_write.c
+*
+* Description: This file contains the prepared (queued) write engine. Prepare
+*              Write Requests are staged in fragments taken from a static pool
+*              and are committed to the GATT DB atomically on Execute Write
+*              Request.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_prep_write.h"
+#include "app_bt_gatt_handler.h"
+#include "app_bt_gatt_tx.h"
+#include "app_memory.h"
+#include <FreeRTOS.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* One staged Prepare Write Request */
+typedef struct app_prep_write_frag
+{
+    struct app_prep_write_frag  *p_next;
+    uint16_t                    handle;
+    uint16_t                    offset;
+    uint16_t                    len;
+    uint8_t                     data[APP_PREP_WRITE_FRAG_SIZE];
+} app_prep_write_frag_t;
+
+/* Prepare queue of one connection, fragments are kept in arrival order */
+typedef struct
+{
+    uint16_t                    conn_id;
+    uint16_t                    queued_bytes;
+    app_prep_write_frag_t       *p_head;
+    app_prep_write_frag_t       *p_tail;
+} app_prep_write_queue_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static app_prep_write_frag_t    app_prep_write_pool[APP_PREP_WRITE_POOL_FRAGS];
+static app_prep_write_frag_t    *p_app_prep_write_free_list;
+static app_prep_write_queue_t   app_prep_write_queues[APP_PREP_WRITE_MAX_CONN];
+
+APP_MEMORY_FOOTPRINT(app_prep_write_ram_footprint,
+                     sizeof(app_prep_write_pool) + sizeof(app_prep_write_queues));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static app_prep_write_queue_t *app_prep_write_get_queue(uint16_t conn_id,
+                                                        bool create);
+
+static app_prep_write_frag_t *app_prep_write_frag_alloc(void);
+
+static void app_prep_write_frag_free(app_prep_write_frag_t *p_frag);
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_prep_write_init
+
+ Function Description:
+ @brief  Builds the free list of the staging fragment pool and clears all
+         prepare queues. Must be called before the GATT callback is registered.
+
+ @param void
+
+ @return void
+ */
+void app_prep_write_init(void)
+{
+    uint32_t i;
+
+    memset(app_prep_write_queues, 0, sizeof(app_prep_write_queues));
+
+    p_app_prep_write_free_list = NULL;
+    for (i = 0; i < APP_PREP_WRITE_POOL_FRAGS; i++)
+    {
+        app_prep_write_pool[i].p_next = p_app_prep_write_free_list;
+        p_app_prep_write_free_list = &app_prep_write_pool[i];
+    }
+}
+
+/*
+ Function Name:
+ app_prep_write_handler
+
+ Function Description:
+ @brief  The function is invoked when GATT_REQ_PREPARE_WRITE is received from
+         the client device. The value is staged in a pooled fragment and echoed
+         back in the Prepare Write Response. Nothing is written to the GATT DB
+         until the client sends an Execute Write Request.
+
+ @param conn_id         Connection ID
+ @param opcode          Bluetooth LE GATT request type opcode
+ @param p_write_req     Pointer to the prepare write request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t
+app_prep_write_handler(uint16_t conn_id,
+                       wiced_bt_gatt_opcode_t opcode,
+                       wiced_bt_gatt_write_req_t *p_write_req,
+                       uint16_t *p_error_handle)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    app_prep_write_queue_t *p_queue;
+    app_prep_write_frag_t *p_frag;
+
+    *p_error_handle = p_write_req->handle;
+
+    /* Permissions are checked now; offset and length only on execute */
+    gatt_status = app_check_gatt_attr_write(p_write_req->handle, 0, 0);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        return gatt_status;
+    }
+
+    if (APP_PREP_WRITE_FRAG_SIZE < p_write_req->val_len)
+    {
+        return WICED_BT_GATT_INVALID_PDU;
+    }
+
+    p_queue = app_prep_write_get_queue(conn_id, true);
+    if ((NULL == p_queue) ||
+        (APP_PREP_WRITE_MAX_BYTES < (p_queue->queued_bytes + p_write_req->val_len)))
+    {
+        return WICED_BT_GATT_PREPARE_Q_FULL;
+    }
+
+    p_frag = app_prep_write_frag_alloc();
+    if (NULL == p_frag)
+    {
+        return WICED_BT_GATT_PREPARE_Q_FULL;
+    }
+
+    p_frag->handle  = p_write_req->handle;
+    p_frag->offset  = p_write_req->offset;
+    p_frag->len     = p_write_req->val_len;
+    memcpy(p_frag->data, p_write_req->p_val, p_write_req->val_len);
+
+    if (NULL == p_queue->p_tail)
+    {
+        p_queue->p_head = p_frag;
+    }
+    else
+    {
+        p_queue->p_tail->p_next = p_frag;
+    }
+    p_queue->p_tail = p_frag;
+    p_queue->queued_bytes += p_frag->len;
+
+    /*
+     * The fragment stays queued until the execute request, which the client
+     * can send only after this response, so it is safe to send from it.
+     */
+    return app_gatt_tx_prepare_write_rsp(conn_id,
+                                         opcode,
+                                         p_frag->handle,
+                                         p_frag->offset,
+                                         p_frag->len,
+                                         p_frag->data,
+                                         NULL);
+}
+
+/*
+ Function Name:
+ app_execute_write_handler
+
+ Function Description:
+ @brief  The function is invoked when GATT_REQ_EXECUTE_WRITE is received from
+         the client device. On execute, every queued fragment is validated
+         first and only then written, so the GATT DB is either updated with all
+         of the queued values or left untouched. On cancel, the queue is
+         dropped.
+
+ @param conn_id         Connection ID
+ @param opcode          Bluetooth LE GATT request type opcode
+ @param exec_flag       Execute or cancel the queued writes
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+wiced_bt_gatt_status_t
+app_execute_write_handler(uint16_t conn_id,
+                          wiced_bt_gatt_opcode_t opcode,
+                          wiced_bt_gatt_execute_flag_t exec_flag,
+                          uint16_t *p_error_handle)
+{
+    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
+    app_prep_write_queue_t *p_queue = app_prep_write_get_queue(conn_id, false);
+    app_prep_write_frag_t *p_frag;
+
+    *p_error_handle = 0;
+
+    if ((NULL != p_queue) && (GATT_PREPARE_WRITE_EXEC == exec_flag))
+    {
+        /* First pass: validate all fragments against the attribute table */
+        for (p_frag = p_queue->p_head; NULL != p_frag; p_frag = p_frag->p_next)
+        {
+            gatt_status = app_check_gatt_attr_write(p_frag->handle,
+                                                    p_frag->offset,
+                                                    p_frag->len);
+            if (WICED_BT_GATT_SUCCESS != gatt_status)
+            {
+                *p_error_handle = p_frag->handle;
+                break;
+            }
+        }
+
+        /* Second pass: commit, which cannot fail after validation */
+        if (WICED_BT_GATT_SUCCESS == gatt_status)
+        {
+            for (p_frag = p_queue->p_head; NULL != p_frag; p_frag = p_frag->p_next)
+            {
+                app_write_gatt_attr_value(p_frag->handle,
+                                          p_frag->offset,
+                                          p_frag->data,
+                                          p_frag->len);
+            }
+        }
+    }
+
+    /* The queue is consumed whether the writes succeeded or not */
+    app_prep_write_flush(conn_id);
+
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Execute write failed, handle 0x%x status 0x%x\n",
+               *p_error_handle, gatt_status);
+        return gatt_status;
+    }
+
+    return app_gatt_tx_execute_write_rsp(conn_id, opcode);
+}
+
+/*
+ Function Name:
+ app_prep_write_flush
+
+ Function Description:
+ @brief  Returns all fragments queued for the connection to the pool. This is
+         called on execute/cancel and when the connection goes down.
+
+ @param conn_id  Connection ID
+
+ @return void
+ */
+void app_prep_write_flush(uint16_t conn_id)
+{
+    app_prep_write_queue_t *p_queue = app_prep_write_get_queue(conn_id, false);
+    app_prep_write_frag_t *p_frag;
+
+    if (NULL == p_queue)
+    {
+        return;
+    }
+
+    while (NULL != p_queue->p_head)
+    {
+        p_frag = p_queue->p_head;
+        p_queue->p_head = p_frag->p_next;
+        app_prep_write_frag_free(p_frag);
+    }
+
+    memset(p_queue, 0, sizeof(app_prep_write_queue_t));
+}
+
+/*******************************************************************************
+ * Function Name: app_prep_write_get_queue
+ *******************************************************************************
+ * Summary:
+ *  Returns the prepare queue of a connection, optionally claiming a free slot
+ *  if the connection has none yet.
+ *
+ * Parameters:
+ *  uint16_t conn_id: Connection ID
+ *  bool create: Claim a free slot if no queue exists for conn_id
+ *
+ ******************************************************************************/
+static app_prep_write_queue_t *app_prep_write_get_queue(uint16_t conn_id,
+                                                        bool create)
+{
+    app_prep_write_queue_t *p_free = NULL;
+    uint32_t i;
+
+    for (i = 0; i < APP_PREP_WRITE_MAX_CONN; i++)
+    {
+        if (conn_id == app_prep_write_queues[i].conn_id)
+        {
+            return &app_prep_write_queues[i];
+        }
+        if ((NULL == p_free) && (0 == app_prep_write_queues[i].conn_id))
+        {
+            p_free = &app_prep_write_queues[i];
+        }
+    }
+
+    if ((!create) || (NULL == p_free))
+    {
+        return NULL;
+    }
+
+    p_free->conn_id = conn_id;
+    return p_free;
+}
+
+/*******************************************************************************
+ * Function Name: app_prep_write_frag_alloc
+ *******************************************************************************
+ * Summary:
+ *  Takes a fragment from the staging pool.
+ *
+ ******************************************************************************/
+static app_prep_write_frag_t *app_prep_write_frag_alloc(void)
+{
+    app_prep_write_frag_t *p_frag = p_app_prep_write_free_list;
+
+    if (NULL != p_frag)
+    {
+        p_app_prep_write_free_list = p_frag->p_next;
+        p_frag->p_next = NULL;
+    }
+
+    return p_frag;
+}
+
+/*******************************************************************************
+ * Function Name: app_prep_write_frag_free
+ *******************************************************************************
+ * Summary:
+ *  Returns a fragment to the staging pool.
+ *
+ * Parameters:
+ *  app_prep_write_frag_t *p_frag: Fragment to be released
+ *
+ ******************************************************************************/
+static void app_prep_write_frag_free(app_prep_write_frag_t *p_frag)
+{
+    p_frag->p_next = p_app_prep_write_free_list;
+    p_app_prep_write_free_list = p_frag;
+}
+
+/* [] END OF FILE */
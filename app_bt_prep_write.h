@@ -0,0 +1,101 @@
+/*******************************************************************************
+* File Name: app_bt_prep_write.h
+*
+* Description: This file contains the macros and function prototypes of the
+*              prepared (queued) write engine used for long writes from the
+*              GATT client.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_BT_PREP_WRITE_H__
+#define __APP_BT_PREP_WRITE_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "wiced_bt_gatt.h"
+#include "GeneratedSource/cycfg_gap.h"
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Number of connections that can hold a prepare queue at the same time. This
+ * matches the "MaxClientsConnections" setting in the BT Configurator.
+ */
+#ifndef APP_PREP_WRITE_MAX_CONN
+#define APP_PREP_WRITE_MAX_CONN          (1u)
+#endif
+
+/* Payload size of one staging fragment. A Prepare Write Request carries at
+ * most (ATT_MTU - 5) bytes of value, so one fragment holds one request.
+ */
+#ifndef APP_PREP_WRITE_FRAG_SIZE
+#define APP_PREP_WRITE_FRAG_SIZE         (CY_BT_MTU_SIZE - 5u)
+#endif
+
+/* Number of fragments in the staging pool shared by all connections */
+#ifndef APP_PREP_WRITE_POOL_FRAGS
+#define APP_PREP_WRITE_POOL_FRAGS        (16u)
+#endif
+
+/* Maximum number of value bytes a single connection may have queued */
+#ifndef APP_PREP_WRITE_MAX_BYTES
+#define APP_PREP_WRITE_MAX_BYTES         (512u)
+#endif
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_prep_write_init(void);
+
+wiced_bt_gatt_status_t
+app_prep_write_handler(uint16_t conn_id,
+                       wiced_bt_gatt_opcode_t opcode,
+                       wiced_bt_gatt_write_req_t *p_write_req,
+                       uint16_t *p_error_handle);
+
+wiced_bt_gatt_status_t
+app_execute_write_handler(uint16_t conn_id,
+                          wiced_bt_gatt_opcode_t opcode,
+                          wiced_bt_gatt_execute_flag_t exec_flag,
+                          uint16_t *p_error_handle);
+
+void app_prep_write_flush(uint16_t conn_id);
+
+#endif      /* __APP_BT_PREP_WRITE_H__ */
+
+/* [] END OF FILE */
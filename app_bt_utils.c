@@ -47,6 +47,27 @@
 #include "app_bt_utils.h"
 #include "wiced_bt_dev.h"
 #include "cybt_platform_trace.h"
+#include "cyhal.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+
+/******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Observers of the HCI trace. The stack accepts a single trace callback */
+static wiced_bt_hci_trace_cback_t *app_bt_hci_trace_cbacks[APP_BT_HCI_TRACE_MAX_CBACKS];
+/* Published after its slot, the stack thread may walk the table meanwhile */
+static volatile uint32_t app_bt_hci_trace_cback_count;
+
+/* Time base of app_uptime_ms_get(), NULL for the RTOS tick */
+static app_uptime_source_t * volatile app_uptime_source;
+
+/******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_bt_hci_trace_cback(wiced_bt_hci_trace_type_t type,
+                                   uint16_t length, uint8_t *p_data);
 
 /****************************************************************************
  *                              FUNCTION DEFINITIONS
@@ -282,5 +303,147 @@ void print_local_bd_address(void)
     print_bd_address("\nMy Bluetooth Device Address: ", local_device_bd_addr);
 }
 
+/*
+* Function Name: app_cycle_counter_init()
+*
+* @brief This utility function enables the DWT cycle counter of the CPU. The
+*        counter is used to measure the cost of code sections in CPU cycles.
+*        It is not reset, so calling it again keeps the boot milestones valid.
+*
+* @return void
+*
+*/
+void app_cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#if defined(__CM7_REV)
+    /* The DWT registers of CM7 are locked out of reset */
+    DWT->LAR = 0xC5ACCE55u;
+#endif
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*
+* Function Name: app_cycle_counter_get()
+*
+* @brief This utility function returns the free running CPU cycle counter.
+*        Differences of two readings are valid across a single wrap-around.
+*
+* @return uint32_t Current value of the cycle counter
+*
+*/
+uint32_t app_cycle_counter_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*
+* Function Name: app_uptime_ms_get()
+*
+* @brief This utility function returns the time since the scheduler started.
+*        The RTOS tick overflow count extends the tick to 64 bits, so the
+*        value does not wrap like xTaskGetTickCount(). Task context only.
+*        See app_uptime_set_source() for other time bases.
+*
+* @return uint64_t Uptime in milliseconds
+*
+*/
+uint64_t app_uptime_ms_get(void)
+{
+    app_uptime_source_t *p_source = app_uptime_source;
+    TimeOut_t time_state;
+    uint64_t ticks;
+
+    if (NULL != p_source)
+    {
+        return p_source();
+    }
+
+    vTaskSetTimeOutState(&time_state);
+    ticks = ((uint64_t)(uint32_t)time_state.xOverflowCount << 32) |
+            (uint32_t)time_state.xTimeOnEntering;
+
+    return (ticks * 1000u) / configTICK_RATE_HZ;
+}
+
+/*
+* Function Name: app_uptime_set_source()
+*
+* @brief This utility function replaces the time base of app_uptime_ms_get(),
+*        e.g. with the virtual clock of a soak run, so that every module
+*        timestamping with it follows that clock.
+*
+* @param p_source  Time source in milliseconds, NULL to return to the RTOS
+*                  tick
+*
+* @return void
+*
+*/
+void app_uptime_set_source(app_uptime_source_t *p_source)
+{
+    app_uptime_source = p_source;
+}
+
+/*
+* Function Name: app_bt_hci_trace_register()
+*
+* @brief This utility function adds an observer of the HCI trace. The stack
+*        trace callback is registered with the first observer and calls all
+*        observers in registration order, in the Bluetooth stack thread. An
+*        observer can be added from any task while the stack thread runs.
+*
+* @param p_cback  HCI trace callback
+*
+* @return void
+*
+*/
+void app_bt_hci_trace_register(wiced_bt_hci_trace_cback_t *p_cback)
+{
+    uint32_t count;
+
+    taskENTER_CRITICAL();
+    count = app_bt_hci_trace_cback_count;
+    if (APP_BT_HCI_TRACE_MAX_CBACKS > count)
+    {
+        app_bt_hci_trace_cbacks[count] = p_cback;
+        __DMB();
+        app_bt_hci_trace_cback_count = count + 1u;
+    }
+    taskEXIT_CRITICAL();
+
+    if (APP_BT_HCI_TRACE_MAX_CBACKS <= count)
+    {
+        printf("HCI trace observer table full\n");
+        return;
+    }
+
+    if (0u == count)
+    {
+        wiced_bt_dev_register_hci_trace(app_bt_hci_trace_cback);
+    }
+}
+
+/*
+* Function Name: app_bt_hci_trace_cback()
+*
+* @brief HCI trace callback of the stack, forwards the packet to the observers.
+*
+* @param type    HCI packet type
+* @param length  Packet length
+* @param p_data  Packet
+*
+* @return void
+*
+*/
+static void app_bt_hci_trace_cback(wiced_bt_hci_trace_type_t type,
+                                   uint16_t length, uint8_t *p_data)
+{
+    uint32_t i;
+
+    for (i = 0; i < app_bt_hci_trace_cback_count; i++)
+    {
+        app_bt_hci_trace_cbacks[i](type, length, p_data);
+    }
+}
 
 /* [] END OF FILE */
@@ -56,6 +56,15 @@
 
 #define FROM_BIT16_TO_8(val)            ( (uint8_t)( ( (val) >> 8 ) & 0xff) )
 
+/* Number of modules that can observe the HCI trace at the same time */
+#define APP_BT_HCI_TRACE_MAX_CBACKS     (4u)
+
+/*******************************************************************************
+ *                                Typedefs
+ ******************************************************************************/
+/* Replacement of the RTOS tick as time base of app_uptime_ms_get() */
+typedef uint64_t (app_uptime_source_t)(void);
+
 /*******************************************************************************
  *                              FUNCTION DECLARATIONS
  ******************************************************************************/
@@ -71,6 +80,16 @@ void print_bd_address(char * msg, wiced_bt_device_address_t bdaddr);
 
 void print_local_bd_address(void);
 
+void app_cycle_counter_init(void);
+
+uint32_t app_cycle_counter_get(void);
+
+uint64_t app_uptime_ms_get(void);
+
+void app_uptime_set_source(app_uptime_source_t *p_source);
+
+void app_bt_hci_trace_register(wiced_bt_hci_trace_cback_t *p_cback);
+
 
 #endif      /* __APP_BT_UTIS_H__ */
 
@@ -0,0 +1,364 @@
+/*******************************************************************************
+* File Name: app_console.c
+*
+* Description: This file contains a line based command console on the debug
+*              UART. Modules register commands to dump their state on demand.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_console.h"
+#include "app_memory.h"
+#include "app_power.h"
+#include "app_trace.h"
+#include "cy_retarget_io.h"
+#include "cyhal.h"
+#include <task.h>
+#include <queue.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Characters received by the UART interrupt */
+static QueueHandle_t            app_console_rx_queue;
+
+static const app_console_cmd_t  *app_console_cmds[APP_CONSOLE_MAX_COMMANDS];
+static uint32_t                 app_console_cmd_count;
+
+/* Commands that did not fit in the table. Most modules register before the
+ * UART is up, so "help" reports them again. */
+static uint32_t                 app_console_cmd_dropped;
+
+#if APP_STATIC_MEMORY
+/* Queue storage, task stack and control blocks in static memory mode */
+static uint8_t      app_console_rx_queue_storage[APP_CONSOLE_RX_QUEUE_LEN];
+static StaticQueue_t app_console_rx_queue_cb;
+static StackType_t  app_console_stack[APP_CONSOLE_STACK_SIZE];
+static StaticTask_t app_console_tcb;
+
+APP_MEMORY_FOOTPRINT(app_console_ram_footprint,
+                     sizeof(app_console_cmds) +
+                     sizeof(app_console_rx_queue_storage) +
+                     sizeof(app_console_rx_queue_cb) +
+                     sizeof(app_console_stack) + sizeof(app_console_tcb));
+#else
+APP_MEMORY_FOOTPRINT(app_console_ram_footprint, sizeof(app_console_cmds));
+#endif
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_console_task(void *pvParam);
+
+static void app_console_uart_callback(void *callback_arg, cyhal_uart_event_t event);
+
+static void app_console_execute(char *p_line);
+
+static void app_console_help_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_console_help =
+{
+    "help", "List the console commands", app_console_help_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_console_init
+
+ Function Description:
+ @brief  Creates the console task and enables the receive interrupt of the
+         debug UART. Must be called after retarget-io is initialized.
+
+ @param void
+
+ @return void
+ */
+void app_console_init(void)
+{
+    BaseType_t rtos_result;
+
+    app_console_register_command(&app_console_help);
+
+#if APP_STATIC_MEMORY
+    app_console_rx_queue = xQueueCreateStatic(APP_CONSOLE_RX_QUEUE_LEN, sizeof(uint8_t),
+                                              app_console_rx_queue_storage,
+                                              &app_console_rx_queue_cb);
+#else
+    app_console_rx_queue = xQueueCreate(APP_CONSOLE_RX_QUEUE_LEN, sizeof(uint8_t));
+#endif
+    if (NULL == app_console_rx_queue)
+    {
+        printf("Console queue creation failed\n");
+        return;
+    }
+    vQueueAddToRegistry(app_console_rx_queue, "Console RX");
+
+#if APP_STATIC_MEMORY
+    rtos_result = (NULL != xTaskCreateStatic(app_console_task, APP_CONSOLE_TASK_NAME,
+                                             APP_CONSOLE_STACK_SIZE, NULL,
+                                             APP_CONSOLE_PRIORITY,
+                                             app_console_stack, &app_console_tcb))
+                  ? pdPASS : pdFAIL;
+#else
+    rtos_result = xTaskCreate(app_console_task, APP_CONSOLE_TASK_NAME,
+                              APP_CONSOLE_STACK_SIZE, NULL,
+                              APP_CONSOLE_PRIORITY, NULL);
+#endif
+    if (pdPASS != rtos_result)
+    {
+        printf("Console task creation failed\n");
+        return;
+    }
+
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj,
+                                 app_console_uart_callback, NULL);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY,
+                            7, true);
+}
+
+/*
+ Function Name:
+ app_console_register_command
+
+ Function Description:
+ @brief  Adds a command to the console. The command descriptor must stay
+         valid for the lifetime of the application. Can be called before
+         app_console_init().
+
+ @param p_cmd  Command descriptor
+
+ @return bool  false if the command table is full; debug builds assert,
+               raise APP_CONSOLE_MAX_COMMANDS
+ */
+bool app_console_register_command(const app_console_cmd_t *p_cmd)
+{
+    if (APP_CONSOLE_MAX_COMMANDS <= app_console_cmd_count)
+    {
+        printf("Console command table full, %s not registered\n", p_cmd->p_name);
+        app_console_cmd_dropped++;
+        CY_ASSERT(0);
+        return false;
+    }
+
+    app_console_cmds[app_console_cmd_count++] = p_cmd;
+    return true;
+}
+
+/*
+ Function Name:
+ app_console_uart_callback
+
+ Function Description:
+ @brief  UART receive interrupt. Moves the received characters to the
+         console task.
+
+ @param callback_arg  Not used
+ @param event         UART event
+
+ @return void
+ */
+static void app_console_uart_callback(void *callback_arg, cyhal_uart_event_t event)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    uint8_t rx_char;
+
+    if (0 == (event & CYHAL_UART_IRQ_RX_NOT_EMPTY))
+    {
+        return;
+    }
+
+    app_power_wake_claim(APP_POWER_WAKE_UART);
+    app_trace_isr_enter(APP_TRACE_ISR_UART);
+
+    while (0 < cyhal_uart_readable(&cy_retarget_io_uart_obj))
+    {
+        if (CY_RSLT_SUCCESS != cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_char, 0))
+        {
+            break;
+        }
+        /* Characters are dropped when the console task falls behind */
+        xQueueSendFromISR(app_console_rx_queue, &rx_char, &higher_priority_task_woken);
+    }
+
+    app_trace_isr_exit(APP_TRACE_ISR_UART);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/*
+ Function Name:
+ app_console_task
+
+ Function Description:
+ @brief  Collects characters into a line and executes it on carriage return
+         or line feed. Characters are echoed back.
+
+ @param pvParam  Not used
+
+ @return void
+ */
+static void app_console_task(void *pvParam)
+{
+    char line[APP_CONSOLE_LINE_SIZE];
+    uint32_t len = 0;
+    uint8_t rx_char;
+
+    while (true)
+    {
+        xQueueReceive(app_console_rx_queue, &rx_char, portMAX_DELAY);
+
+        if (('\r' == rx_char) || ('\n' == rx_char))
+        {
+            if (0 < len)
+            {
+                printf("\n");
+                line[len] = '\0';
+                app_console_execute(line);
+                len = 0;
+            }
+        }
+        else if (('\b' == rx_char) || (0x7F == rx_char))
+        {
+            if (0 < len)
+            {
+                len--;
+                printf("\b \b");
+            }
+        }
+        else if ((len < (APP_CONSOLE_LINE_SIZE - 1)) && (' ' <= rx_char))
+        {
+            line[len++] = (char)rx_char;
+            printf("%c", rx_char);
+        }
+        fflush(stdout);
+    }
+}
+
+/*
+ Function Name:
+ app_console_execute
+
+ Function Description:
+ @brief  Splits a line into words and runs the matching command.
+
+ @param p_line  Null terminated command line, modified in place
+
+ @return void
+ */
+static void app_console_execute(char *p_line)
+{
+    char *argv[APP_CONSOLE_MAX_ARGS];
+    uint32_t argc = 0;
+    uint32_t i;
+
+    while (('\0' != *p_line) && (APP_CONSOLE_MAX_ARGS > argc))
+    {
+        while (' ' == *p_line)
+        {
+            *p_line++ = '\0';
+        }
+        if ('\0' == *p_line)
+        {
+            break;
+        }
+        argv[argc++] = p_line;
+        while (('\0' != *p_line) && (' ' != *p_line))
+        {
+            p_line++;
+        }
+        if (' ' == *p_line)
+        {
+            *p_line++ = '\0';
+        }
+    }
+
+    if (0 == argc)
+    {
+        return;
+    }
+
+    for (i = 0; i < app_console_cmd_count; i++)
+    {
+        if (0 == strcmp(argv[0], app_console_cmds[i]->p_name))
+        {
+            app_console_cmds[i]->p_handler(argc, argv);
+            return;
+        }
+    }
+
+    printf("Unknown command '%s', type help\n", argv[0]);
+}
+
+/*
+ Function Name:
+ app_console_help_cmd
+
+ Function Description:
+ @brief  Console command listing the registered commands, and the number
+         of commands that did not fit in the table.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_console_help_cmd(uint32_t argc, char *argv[])
+{
+    uint32_t i;
+
+    for (i = 0; i < app_console_cmd_count; i++)
+    {
+        printf("  %-12s %s\n", app_console_cmds[i]->p_name, app_console_cmds[i]->p_help);
+    }
+
+    if (0 != app_console_cmd_dropped)
+    {
+        printf("  %lu commands not registered, raise APP_CONSOLE_MAX_COMMANDS\n",
+               (unsigned long)app_console_cmd_dropped);
+    }
+}
+
+/* [] END OF FILE */
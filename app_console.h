@@ -0,0 +1,102 @@
+/*******************************************************************************
+* File Name: app_console.h
+*
+* Description: This file contains the interface of the debug UART console:
+*              command registration and the console task.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_CONSOLE_H__
+#define __APP_CONSOLE_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Maximum number of commands that can be registered. 18 are registered with
+ * every build option enabled; the rest is room for new modules. A command
+ * that does not fit asserts in debug builds and is reported by "help".
+ */
+#ifndef APP_CONSOLE_MAX_COMMANDS
+#define APP_CONSOLE_MAX_COMMANDS         (24u)
+#endif
+
+/* Longest command line, including the terminator */
+#define APP_CONSOLE_LINE_SIZE            (64u)
+
+/* Maximum number of words in a command line, command name included */
+#define APP_CONSOLE_MAX_ARGS             (6u)
+
+/* Characters buffered between the UART interrupt and the console task */
+#define APP_CONSOLE_RX_QUEUE_LEN         (32u)
+
+/* Console task configuration. The console only runs on user input, so it
+ * has the lowest application priority.
+ */
+#define APP_CONSOLE_TASK_NAME            "Console"
+#define APP_CONSOLE_STACK_SIZE           (configMINIMAL_STACK_SIZE * 4)
+#define APP_CONSOLE_PRIORITY             (configMAX_PRIORITIES - 4)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Command handler. argv[0] is the command name. */
+typedef void (*app_console_handler_t)(uint32_t argc, char *argv[]);
+
+typedef struct
+{
+    const char              *p_name;
+    const char              *p_help;
+    app_console_handler_t   p_handler;
+} app_console_cmd_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_console_init(void);
+
+bool app_console_register_command(const app_console_cmd_t *p_cmd);
+
+#endif      /* __APP_CONSOLE_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,516 @@
+/*******************************************************************************
+* File Name: app_ess.c
+*
+* Description: This file contains the Environmental Sensing sensor registry.
+*              The ESS task calls app_ess_sample() every sample period; each
+*              registered sensor due in that period is sampled, encoded into
+*              its characteristic value and notified to the client if it
+*              enabled notifications.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_ess.h"
+#include "app_bt_gatt_tx.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include "wiced_bt_gatt.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* Run time state of a sensor */
+typedef struct
+{
+    int32_t     last_reading;
+    uint32_t    samples;
+    uint32_t    notifications;
+    uint32_t    indications;        /* Confirmed */
+    uint32_t    failures;
+} app_ess_sensor_state_t;
+
+/* Reading waiting to be indicated or confirmed */
+typedef struct
+{
+    uint8_t     sensor;
+    uint8_t     len;
+    uint8_t     value[APP_ESS_IND_VALUE_LEN];
+} app_ess_ind_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static const app_ess_sensor_t   *p_app_ess_sensors;
+static uint32_t                 app_ess_num_sensors;
+static app_ess_sensor_state_t   app_ess_state[APP_ESS_MAX_SENSORS];
+
+/* Sample periods since app_ess_init() */
+static uint32_t                 app_ess_period_count;
+
+/* Indication queue of the connection. The head is in flight once sent and
+ * stays in the queue, as the value sent, until it is confirmed. */
+static app_ess_ind_t            app_ess_ind_queue[APP_ESS_IND_QUEUE_LEN];
+static uint32_t                 app_ess_ind_head;
+static uint32_t                 app_ess_ind_count;
+static bool                     app_ess_ind_in_flight;
+static uint32_t                 app_ess_ind_overflows;
+
+APP_MEMORY_FOOTPRINT(app_ess_ram_footprint, sizeof(app_ess_state) + sizeof(app_ess_ind_queue));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static wiced_bt_gatt_status_t app_ess_write_cb(uint16_t attr_handle, uint16_t offset,
+                                               const uint8_t *p_val, uint16_t len);
+
+static void app_ess_queue_indication(uint32_t sensor);
+
+static void app_ess_indicate(uint16_t conn_id);
+
+static void app_ess_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+const app_gatt_service_cbs_t app_ess_gatt_cbs =
+{
+    NULL, app_ess_write_cb
+};
+
+static const app_console_cmd_t app_ess_console_cmd =
+{
+    "sensors", "Registered sensors, last readings and notifications",
+    app_ess_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_ess_init
+
+ Function Description:
+ @brief  Registers the sensor table. The table must stay valid; entries with
+         a period of 0 are sampled every period.
+
+ @param p_sensors    Sensor table
+ @param num_sensors  Number of sensors, up to APP_ESS_MAX_SENSORS
+
+ @return void
+ */
+void app_ess_init(const app_ess_sensor_t *p_sensors, uint32_t num_sensors)
+{
+    if (APP_ESS_MAX_SENSORS < num_sensors)
+    {
+        printf("Sensor table too large, %lu sensors not registered\n",
+               (unsigned long)(num_sensors - APP_ESS_MAX_SENSORS));
+        num_sensors = APP_ESS_MAX_SENSORS;
+    }
+
+    p_app_ess_sensors = p_sensors;
+    app_ess_num_sensors = num_sensors;
+    app_ess_period_count = 0;
+    memset(app_ess_state, 0, sizeof(app_ess_state));
+
+    app_console_register_command(&app_ess_console_cmd);
+}
+
+/*
+ Function Name:
+ app_ess_sample
+
+ Function Description:
+ @brief  Samples the sensors due in this sample period, updates their
+         characteristic values and sends the enabled notifications and
+         indications. A sensor with both enabled is indicated.
+
+ @param conn_id  Connection ID, 0 if not connected
+
+ @return void
+ */
+void app_ess_sample(uint16_t conn_id)
+{
+    const app_ess_sensor_t *p_sensor;
+    app_ess_sensor_state_t *p_state;
+    wiced_bt_gatt_status_t gatt_status;
+    int32_t reading;
+    uint32_t i;
+
+    for (i = 0; i < app_ess_num_sensors; i++)
+    {
+        p_sensor = &p_app_ess_sensors[i];
+        p_state = &app_ess_state[i];
+
+        if ((1u < p_sensor->period) && (0 != (app_ess_period_count % p_sensor->period)))
+        {
+            continue;
+        }
+        if (!p_sensor->p_sample(&reading))
+        {
+            continue;
+        }
+        p_state->last_reading = reading;
+        p_state->samples++;
+
+        /* The value is set both for read operations and for notifications */
+        if (NULL != p_sensor->p_encode)
+        {
+            p_sensor->p_encode(reading, p_sensor->p_value, p_sensor->value_len);
+        }
+        else
+        {
+            app_ess_encode_le(reading, p_sensor->p_value, p_sensor->value_len);
+        }
+
+        if (0 == conn_id)
+        {
+            continue;
+        }
+        if (0 != (p_sensor->p_cccd[0] & GATT_CLIENT_CONFIG_INDICATION))
+        {
+            app_ess_queue_indication(i);
+            continue;
+        }
+        if (0 == (p_sensor->p_cccd[0] & GATT_CLIENT_CONFIG_NOTIFICATION))
+        {
+            continue;
+        }
+
+        /* The value buffer is in the GATT DB, it is not freed */
+        gatt_status = app_gatt_tx_notification(conn_id, p_sensor->value_handle,
+                                               p_sensor->value_len,
+                                               p_sensor->p_value, NULL);
+        if (WICED_BT_GATT_SUCCESS == gatt_status)
+        {
+            p_state->notifications++;
+        }
+        else
+        {
+            p_state->failures++;
+            printf("%s notification failed, status 0x%x\n", p_sensor->p_name, gatt_status);
+        }
+    }
+
+    if (0 != conn_id)
+    {
+        app_ess_indicate(conn_id);
+    }
+    app_ess_period_count++;
+}
+
+/*
+ Function Name:
+ app_ess_is_cccd
+
+ Function Description:
+ @brief  Returns true for the CCCD of a registered sensor.
+
+ @param attr_handle  GATT attribute handle
+
+ @return bool  true if the handle is a sensor CCCD
+ */
+bool app_ess_is_cccd(uint16_t attr_handle)
+{
+    uint32_t i;
+
+    for (i = 0; i < app_ess_num_sensors; i++)
+    {
+        if (p_app_ess_sensors[i].cccd_handle == attr_handle)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ Function Name:
+ app_ess_disconnected
+
+ Function Description:
+ @brief  Clears the CCCDs of the sensors, so that notifications and
+         indications are off on a reconnect, and drops the queued
+         indications.
+
+ @param void
+
+ @return void
+ */
+void app_ess_disconnected(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < app_ess_num_sensors; i++)
+    {
+        p_app_ess_sensors[i].p_cccd[0] = 0;
+        p_app_ess_sensors[i].p_cccd[1] = 0;
+    }
+
+    taskENTER_CRITICAL();
+    app_ess_ind_head = 0;
+    app_ess_ind_count = 0;
+    app_ess_ind_in_flight = false;
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_ess_indication_confirmed
+
+ Function Description:
+ @brief  Takes the confirmation of a sensor indication and sends the next
+         queued reading at once, so that it leaves in the connection event
+         that carried the confirmation or the one after. Called from the
+         GATT_HANDLE_VALUE_CONF handler in the Bluetooth stack thread.
+
+ @param conn_id  Connection ID
+ @param handle   Handle of the confirmed value
+
+ @return void
+ */
+void app_ess_indication_confirmed(uint16_t conn_id, uint16_t handle)
+{
+    app_ess_ind_t *p_ind;
+
+    taskENTER_CRITICAL();
+    p_ind = &app_ess_ind_queue[app_ess_ind_head];
+    if (app_ess_ind_in_flight && (0 != app_ess_ind_count) &&
+        (p_app_ess_sensors[p_ind->sensor].value_handle == handle))
+    {
+        app_ess_state[p_ind->sensor].indications++;
+        app_ess_ind_head = (app_ess_ind_head + 1u) % APP_ESS_IND_QUEUE_LEN;
+        app_ess_ind_count--;
+        app_ess_ind_in_flight = false;
+    }
+    taskEXIT_CRITICAL();
+
+    app_ess_indicate(conn_id);
+}
+
+/*
+ Function Name:
+ app_ess_queue_indication
+
+ Function Description:
+ @brief  Queues the current value of a sensor for indication. The value is
+         copied, later samples do not change a reading in the queue.
+
+ @param sensor  Index of the sensor
+
+ @return void
+ */
+static void app_ess_queue_indication(uint32_t sensor)
+{
+    const app_ess_sensor_t *p_sensor = &p_app_ess_sensors[sensor];
+    app_ess_ind_t *p_ind;
+
+    if (APP_ESS_IND_VALUE_LEN < p_sensor->value_len)
+    {
+        app_ess_state[sensor].failures++;
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    if (APP_ESS_IND_QUEUE_LEN <= app_ess_ind_count)
+    {
+        app_ess_ind_overflows++;
+        app_ess_state[sensor].failures++;
+    }
+    else
+    {
+        p_ind = &app_ess_ind_queue[(app_ess_ind_head + app_ess_ind_count) %
+                                   APP_ESS_IND_QUEUE_LEN];
+        p_ind->sensor = (uint8_t)sensor;
+        p_ind->len = p_sensor->value_len;
+        memcpy(p_ind->value, p_sensor->p_value, p_sensor->value_len);
+        app_ess_ind_count++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_ess_indicate
+
+ Function Description:
+ @brief  Sends the reading at the head of the queue if no indication is in
+         flight. Runs in the ESS task after sampling and in the Bluetooth
+         stack thread on a confirmation. While another module holds the
+         indication of the connection, e.g. for Service Changed, the reading
+         waits for the confirmation of that one.
+
+ @param conn_id  Connection ID
+
+ @return void
+ */
+static void app_ess_indicate(uint16_t conn_id)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    app_ess_ind_t *p_ind;
+
+    taskENTER_CRITICAL();
+    if (app_ess_ind_in_flight || (0 == app_ess_ind_count))
+    {
+        taskEXIT_CRITICAL();
+        return;
+    }
+    app_ess_ind_in_flight = true;
+    p_ind = &app_ess_ind_queue[app_ess_ind_head];
+    taskEXIT_CRITICAL();
+
+    /* The queue entry is the value buffer, it is not freed */
+    gatt_status = app_gatt_tx_indication(conn_id, p_app_ess_sensors[p_ind->sensor].value_handle,
+                                         p_ind->len, p_ind->value, NULL);
+    if (WICED_BT_GATT_SUCCESS == gatt_status)
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    if (WICED_BT_GATT_BUSY != gatt_status)
+    {
+        /* Dropped, the next reading goes out on the next sample */
+        app_ess_state[p_ind->sensor].failures++;
+        app_ess_ind_head = (app_ess_ind_head + 1u) % APP_ESS_IND_QUEUE_LEN;
+        app_ess_ind_count--;
+    }
+    app_ess_ind_in_flight = false;
+    taskEXIT_CRITICAL();
+
+    if (WICED_BT_GATT_BUSY != gatt_status)
+    {
+        printf("%s indication failed, status 0x%x\n",
+               p_app_ess_sensors[p_ind->sensor].p_name, gatt_status);
+    }
+}
+
+/*
+ Function Name:
+ app_ess_encode_le
+
+ Function Description:
+ @brief  Encodes a reading as a little endian integer of len bytes, the
+         format of the Environmental Sensing characteristics.
+
+ @param reading  Reading
+ @param p_value  Characteristic value
+ @param len      Length of the value, 1 to 4 bytes
+
+ @return void
+ */
+void app_ess_encode_le(int32_t reading, uint8_t *p_value, uint8_t len)
+{
+    uint32_t bits = (uint32_t)reading;
+    uint8_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        p_value[i] = (uint8_t)bits;
+        bits >>= 8;
+    }
+}
+
+/*
+ Function Name:
+ app_ess_write_cb
+
+ Function Description:
+ @brief  Write callback of the services added for sensors: only the CCCDs of
+         the registered sensors are writable.
+
+ @param attr_handle  GATT attribute handle
+ @param offset       Offset of the first byte
+ @param p_val        Value
+ @param len          Length of the value
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t app_ess_write_cb(uint16_t attr_handle, uint16_t offset,
+                                               const uint8_t *p_val, uint16_t len)
+{
+    return app_ess_is_cccd(attr_handle) ? WICED_BT_GATT_SUCCESS : WICED_BT_GATT_WRITE_NOT_PERMIT;
+}
+
+/*
+ Function Name:
+ app_ess_cmd
+
+ Function Description:
+ @brief  "sensors" console command. Prints the registered sensors with their
+         last reading, notification and indication counts, then the
+         indication queue and round trip.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_ess_cmd(uint32_t argc, char *argv[])
+{
+    const app_ess_sensor_t *p_sensor;
+    uint32_t i;
+
+    for (i = 0; i < app_ess_num_sensors; i++)
+    {
+        p_sensor = &p_app_ess_sensors[i];
+        printf("  %-14s handle 0x%04x every %u periods, last %ld, %lu samples, "
+               "%lu notifications, %lu indications, %lu failed, notify %s, indicate %s\n",
+               p_sensor->p_name, p_sensor->value_handle,
+               (unsigned)((0 != p_sensor->period) ? p_sensor->period : 1u),
+               (long)app_ess_state[i].last_reading, (unsigned long)app_ess_state[i].samples,
+               (unsigned long)app_ess_state[i].notifications,
+               (unsigned long)app_ess_state[i].indications,
+               (unsigned long)app_ess_state[i].failures,
+               (0 != (p_sensor->p_cccd[0] & GATT_CLIENT_CONFIG_NOTIFICATION)) ? "on" : "off",
+               (0 != (p_sensor->p_cccd[0] & GATT_CLIENT_CONFIG_INDICATION)) ? "on" : "off");
+    }
+
+    printf("Indication queue: %lu of %u, %s, %lu overflows\n",
+           (unsigned long)app_ess_ind_count, (unsigned)APP_ESS_IND_QUEUE_LEN,
+           app_ess_ind_in_flight ? "in flight" : "idle", (unsigned long)app_ess_ind_overflows);
+    app_gatt_tx_print_indication_stats();
+}
+
+/* [] END OF FILE */
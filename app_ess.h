@@ -0,0 +1,153 @@
+/*******************************************************************************
+* File Name: app_ess.h
+*
+* Description: This file contains the definitions of the Environmental Sensing
+*              sensor registry. Every sensor is described by an entry of a
+*              constant table: its GATT value and CCCD, its sampling period and
+*              its sampling and encoding functions.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_ESS_H__
+#define __APP_ESS_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_handler.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_ESS_EXTRA_SENSORS=1 in the Makefile to add the
+ * simulated humidity, pressure and outdoor temperature sensors */
+#ifndef APP_ESS_EXTRA_SENSORS
+#define APP_ESS_EXTRA_SENSORS            (0u)
+#endif
+
+/* Maximum number of registered sensors */
+#define APP_ESS_MAX_SENSORS              (8u)
+
+/* Readings queued for indication while the previous one is not confirmed,
+ * and the longest value that can be indicated */
+#define APP_ESS_IND_QUEUE_LEN            (8u)
+#define APP_ESS_IND_VALUE_LEN            (4u)
+
+/* Environmental Sensing characteristics, see the GATT Specification
+ * Supplement for the formats */
+#define APP_ESS_UUID_SERVICE             (0x181Au)
+#define APP_ESS_UUID_TEMPERATURE         (0x2A6Eu)  /* sint16, 0.01 degree Celsius */
+#define APP_ESS_UUID_HUMIDITY            (0x2A6Fu)  /* uint16, 0.01 % */
+#define APP_ESS_UUID_PRESSURE            (0x2A6Du)  /* uint32, 0.1 Pa */
+#define APP_ESS_UUID_USER_DESCRIPTION    (0x2901u)
+
+/* Characteristic of a sensor in a service added by the application: the
+ * declaration at handle h, the value at h + 1, the CCCD at h + 2 and a user
+ * description, which tells instances of the same characteristic apart, at
+ * h + 3 */
+#define APP_ESS_SENSOR_HANDLES           (4u)
+
+#define APP_ESS_SENSOR_GATT_DB(h, uuid) \
+    CHARACTERISTIC_UUID16((h), (h) + 1u, (uuid), \
+                          GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_NOTIFY | \
+                          GATTDB_CHAR_PROP_INDICATE, \
+                          GATTDB_PERM_READABLE), \
+    CHAR_DESCRIPTOR_UUID16_WRITABLE((h) + 2u, \
+                                    UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION, \
+                                    GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ), \
+    CHAR_DESCRIPTOR_UUID16((h) + 3u, APP_ESS_UUID_USER_DESCRIPTION, GATTDB_PERM_READABLE)
+
+/* Attribute values of APP_ESS_SENSOR_GATT_DB(h, uuid). value and cccd are
+ * arrays, desc a string array. */
+#define APP_ESS_SENSOR_ATTRS(h, value, cccd, desc) \
+    { (h) + 1u, sizeof(value), sizeof(value), (value) }, \
+    { (h) + 2u, sizeof(cccd), sizeof(cccd), (cccd) }, \
+    { (h) + 3u, sizeof(desc) - 1u, sizeof(desc) - 1u, (uint8_t *)(desc) }
+
+/* Attribute types of APP_ESS_SENSOR_ATTRS(), for app_gatt_add_service() */
+#define APP_ESS_SENSOR_TYPES(uuid) \
+    { LEN_UUID_16, { .uuid16 = (uuid) } }, \
+    { LEN_UUID_16, { .uuid16 = UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION } }, \
+    { LEN_UUID_16, { .uuid16 = APP_ESS_UUID_USER_DESCRIPTION } }
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* A sensor. p_sample returns the reading in the unit of the characteristic,
+ * or false if there is nothing to publish this period. p_encode writes it
+ * into the characteristic value; app_ess_encode_le() suits the integer
+ * formats of the Environmental Sensing characteristics. */
+typedef struct
+{
+    const char  *p_name;
+    uint16_t    value_handle;
+    uint16_t    cccd_handle;
+    uint8_t     *p_value;           /* Characteristic value in the GATT DB */
+    uint8_t     *p_cccd;            /* CCCD value in the GATT DB */
+    uint8_t     value_len;
+    uint8_t     period;             /* In sample periods of the ESS task */
+    bool        (*p_sample)(int32_t *p_reading);
+    void        (*p_encode)(int32_t reading, uint8_t *p_value, uint8_t len);
+} app_ess_sensor_t;
+
+/* *****************************************************************************
+ *                              VARIABLES
+ * ****************************************************************************/
+/* Callbacks of a service added with app_gatt_add_service() for sensors, to
+ * accept the CCCD writes */
+extern const app_gatt_service_cbs_t app_ess_gatt_cbs;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_ess_init(const app_ess_sensor_t *p_sensors, uint32_t num_sensors);
+
+void app_ess_sample(uint16_t conn_id);
+
+bool app_ess_is_cccd(uint16_t attr_handle);
+
+void app_ess_disconnected(void);
+
+void app_ess_indication_confirmed(uint16_t conn_id, uint16_t handle);
+
+void app_ess_encode_le(int32_t reading, uint8_t *p_value, uint8_t len);
+
+#endif      /* __APP_ESS_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,571 @@
+/*******************************************************************************
+* File Name: app_filter.c
+*
+* Description: This file contains the fixed-point sample filter pipeline placed
+*              between the sensor acquisition and the publication of the
+*              temperature.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_filter.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include <stdio.h>
+#include <string.h>
+#if APP_FILTER_USE_DSP
+#include "cmsis_compiler.h"
+#endif
+
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+/* Fraction bits of the IIR state, keeps the small steps of a long time
+ * constant from being lost to truncation */
+#define APP_FILTER_IIR_FRAC_BITS         (8u)
+#define APP_FILTER_IIR_MAX_SHIFT         (8u)
+
+/* Benchmark input: length and seed of the pseudo random noise */
+#define APP_FILTER_BENCH_LEN             (256u)
+#define APP_FILTER_BENCH_SEED            (0x12345678u)
+
+/* Saturating arithmetic. The DSP instructions and the scalar versions give
+ * the same results for all inputs. */
+#if APP_FILTER_USE_DSP
+#define APP_FILTER_SAT16(x)              ((int16_t)__SSAT((x), 16))
+#define APP_FILTER_QADD(a, b)            __QADD((a), (b))
+#define APP_FILTER_QSUB(a, b)            __QSUB((a), (b))
+#else
+#define APP_FILTER_SAT16(x)              app_filter_sat16(x)
+#define APP_FILTER_QADD(a, b)            app_filter_qadd((a), (b))
+#define APP_FILTER_QSUB(a, b)            app_filter_qsub((a), (b))
+#endif
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    const char                  *p_name;
+    uint32_t                    num_stages;
+    app_filter_stage_cfg_t      stages[APP_FILTER_MAX_STAGES];
+} app_filter_bench_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Benchmark input and filter, static to keep them off the console stack */
+static int16_t          app_filter_bench_input[APP_FILTER_BENCH_LEN];
+static app_filter_t     app_filter_bench_filter;
+
+APP_MEMORY_FOOTPRINT(app_filter_ram_footprint,
+                     sizeof(app_filter_bench_input) + sizeof(app_filter_bench_filter));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static bool app_filter_stage_process(app_filter_stage_t *p_stage, int16_t in,
+                                     int16_t *p_out);
+
+static int16_t app_filter_median(const app_filter_stage_t *p_stage);
+
+static void app_filter_bench_run(void);
+
+static void app_filter_cmd(uint32_t argc, char *argv[]);
+
+#if !APP_FILTER_USE_DSP
+/*
+ Function Name:
+ app_filter_sat16
+
+ Function Description:
+ @brief  Saturates to the int16_t range, scalar version of __SSAT(x, 16).
+
+ @param x  Value
+
+ @return int16_t  Saturated value
+ */
+static inline int16_t app_filter_sat16(int32_t x)
+{
+    return (int16_t)((x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : x));
+}
+
+/*
+ Function Name:
+ app_filter_qadd
+
+ Function Description:
+ @brief  Saturating 32-bit addition, scalar version of __QADD.
+
+ @param a  First operand
+ @param b  Second operand
+
+ @return int32_t  Saturated sum
+ */
+static inline int32_t app_filter_qadd(int32_t a, int32_t b)
+{
+    int64_t sum = (int64_t)a + b;
+
+    return (int32_t)((sum > INT32_MAX) ? INT32_MAX : ((sum < INT32_MIN) ? INT32_MIN : sum));
+}
+
+/*
+ Function Name:
+ app_filter_qsub
+
+ Function Description:
+ @brief  Saturating 32-bit subtraction, scalar version of __QSUB.
+
+ @param a  First operand
+ @param b  Second operand
+
+ @return int32_t  Saturated difference
+ */
+static inline int32_t app_filter_qsub(int32_t a, int32_t b)
+{
+    int64_t diff = (int64_t)a - b;
+
+    return (int32_t)((diff > INT32_MAX) ? INT32_MAX : ((diff < INT32_MIN) ? INT32_MIN : diff));
+}
+#endif
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_filter_console_cmd =
+{
+    "filter", "Filter benchmark, cycles per sample and output checksums",
+    app_filter_cmd
+};
+
+/* Benchmarked filters. tools/filter_ref.py holds the same list. */
+static const app_filter_bench_t app_filter_benches[] =
+{
+    { "avg8",     1, { { APP_FILTER_MOVING_AVG, 8 } } },
+    { "iir3",     1, { { APP_FILTER_IIR,        3 } } },
+    { "median3",  1, { { APP_FILTER_MEDIAN,     3 } } },
+    { "median7",  1, { { APP_FILTER_MEDIAN,     7 } } },
+    { "decim4",   1, { { APP_FILTER_DECIMATE,   4 } } },
+    { "pipeline", 3, { { APP_FILTER_MEDIAN,     5 },
+                       { APP_FILTER_MOVING_AVG, 4 },
+                       { APP_FILTER_DECIMATE,   2 } } },
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_filter_init
+
+ Function Description:
+ @brief  Checks and applies a pipeline configuration. Stages run in the
+         order given.
+
+ @param p_filter    Filter to initialize
+ @param p_cfg       Stage configurations
+ @param num_stages  Number of stages, 0 passes the samples through
+
+ @return bool  false if the configuration is invalid
+ */
+bool app_filter_init(app_filter_t *p_filter, const app_filter_stage_cfg_t *p_cfg,
+                     uint32_t num_stages)
+{
+    uint32_t i;
+    uint8_t param;
+
+    memset(p_filter, 0, sizeof(*p_filter));
+    if (APP_FILTER_MAX_STAGES < num_stages)
+    {
+        return false;
+    }
+
+    for (i = 0; i < num_stages; i++)
+    {
+        param = p_cfg[i].param;
+        switch (p_cfg[i].type)
+        {
+        case APP_FILTER_MOVING_AVG:
+            /* Power of two, the average is a shift */
+            if ((0 == param) || (APP_FILTER_MAX_WINDOW < param) ||
+                (0 != (param & (param - 1u))))
+            {
+                return false;
+            }
+            while ((1u << p_filter->stages[i].shift) < param)
+            {
+                p_filter->stages[i].shift++;
+            }
+            break;
+
+        case APP_FILTER_IIR:
+            if ((0 == param) || (APP_FILTER_IIR_MAX_SHIFT < param))
+            {
+                return false;
+            }
+            p_filter->stages[i].shift = param;
+            break;
+
+        case APP_FILTER_MEDIAN:
+            if ((0 == (param & 1u)) || (APP_FILTER_MAX_WINDOW <= param))
+            {
+                return false;
+            }
+            break;
+
+        case APP_FILTER_DECIMATE:
+            if (0 == param)
+            {
+                return false;
+            }
+            break;
+
+        default:
+            return false;
+        }
+        p_filter->stages[i].cfg = p_cfg[i];
+    }
+    p_filter->num_stages = (uint8_t)num_stages;
+
+    return true;
+}
+
+/*
+ Function Name:
+ app_filter_reset
+
+ Function Description:
+ @brief  Clears the filter history, the next sample primes all stages.
+
+ @param p_filter  Filter
+
+ @return void
+ */
+void app_filter_reset(app_filter_t *p_filter)
+{
+    uint32_t i;
+
+    for (i = 0; i < p_filter->num_stages; i++)
+    {
+        p_filter->stages[i].primed = false;
+    }
+}
+
+/*
+ Function Name:
+ app_filter_process
+
+ Function Description:
+ @brief  Runs one sample through the pipeline.
+
+ @param p_filter  Filter
+ @param in        Input sample
+ @param p_out     Filtered sample, written when true is returned
+
+ @return bool  false if a decimation stage dropped the sample
+ */
+bool app_filter_process(app_filter_t *p_filter, int16_t in, int16_t *p_out)
+{
+    uint32_t i;
+
+    for (i = 0; i < p_filter->num_stages; i++)
+    {
+        if (!app_filter_stage_process(&p_filter->stages[i], in, &in))
+        {
+            return false;
+        }
+    }
+
+    *p_out = in;
+    return true;
+}
+
+/*
+ Function Name:
+ app_filter_stage_process
+
+ Function Description:
+ @brief  Runs one sample through a stage. The first sample after a reset
+         fills the history of the stage, so that the output starts at the
+         input value instead of ramping up from zero.
+
+ @param p_stage  Stage
+ @param in       Input sample
+ @param p_out    Output sample
+
+ @return bool  false if the sample is dropped
+ */
+static bool app_filter_stage_process(app_filter_stage_t *p_stage, int16_t in,
+                                     int16_t *p_out)
+{
+    uint32_t window = p_stage->cfg.param;
+    uint32_t i;
+    int32_t round;
+
+    switch (p_stage->cfg.type)
+    {
+    case APP_FILTER_MOVING_AVG:
+        if (!p_stage->primed)
+        {
+            for (i = 0; i < window; i++)
+            {
+                p_stage->window[i] = in;
+            }
+            p_stage->state = (int32_t)in * (int32_t)window;
+            p_stage->index = 0;
+            p_stage->primed = true;
+        }
+        /* Running sum: add the new sample, drop the oldest */
+        p_stage->state = APP_FILTER_QADD(p_stage->state,
+                                         APP_FILTER_QSUB(in, p_stage->window[p_stage->index]));
+        p_stage->window[p_stage->index] = in;
+        p_stage->index = (uint8_t)((p_stage->index + 1u) & (window - 1u));
+        round = (int32_t)((1u << p_stage->shift) >> 1);
+        *p_out = APP_FILTER_SAT16(APP_FILTER_QADD(p_stage->state, round) >> p_stage->shift);
+        return true;
+
+    case APP_FILTER_IIR:
+        /* y += (x - y) / 2^k with APP_FILTER_IIR_FRAC_BITS fraction bits */
+        if (!p_stage->primed)
+        {
+            p_stage->state = (int32_t)in << APP_FILTER_IIR_FRAC_BITS;
+            p_stage->primed = true;
+        }
+        p_stage->state = APP_FILTER_QADD(p_stage->state,
+                                         APP_FILTER_QSUB((int32_t)in << APP_FILTER_IIR_FRAC_BITS,
+                                                         p_stage->state) >> p_stage->shift);
+        round = (int32_t)(1u << (APP_FILTER_IIR_FRAC_BITS - 1u));
+        *p_out = APP_FILTER_SAT16(APP_FILTER_QADD(p_stage->state, round) >>
+                                  APP_FILTER_IIR_FRAC_BITS);
+        return true;
+
+    case APP_FILTER_MEDIAN:
+        if (!p_stage->primed)
+        {
+            for (i = 0; i < window; i++)
+            {
+                p_stage->window[i] = in;
+            }
+            p_stage->index = 0;
+            p_stage->primed = true;
+        }
+        p_stage->window[p_stage->index] = in;
+        p_stage->index = (uint8_t)((p_stage->index + 1u < window) ? (p_stage->index + 1u) : 0u);
+        *p_out = app_filter_median(p_stage);
+        return true;
+
+    case APP_FILTER_DECIMATE:
+        /* Keeps the first sample of every group of param samples */
+        if (!p_stage->primed)
+        {
+            p_stage->state = 0;
+            p_stage->primed = true;
+        }
+        if (0 != p_stage->state)
+        {
+            p_stage->state = ((uint32_t)p_stage->state + 1u < window) ? (p_stage->state + 1) : 0;
+            return false;
+        }
+        p_stage->state = (1u < window) ? 1 : 0;
+        *p_out = in;
+        return true;
+
+    default:
+        *p_out = in;
+        return true;
+    }
+}
+
+/*
+ Function Name:
+ app_filter_median
+
+ Function Description:
+ @brief  Median of the window of a stage. The windows are small, an
+         insertion sort of a copy is cheaper than keeping a sorted list.
+         The median of 3 has a shortcut without the copy.
+
+ @param p_stage  Median stage
+
+ @return int16_t  Median
+ */
+static int16_t app_filter_median(const app_filter_stage_t *p_stage)
+{
+    int16_t sorted[APP_FILTER_MAX_WINDOW];
+    uint32_t window = p_stage->cfg.param;
+    int16_t a, b, c;
+    int16_t value;
+    uint32_t i, j;
+
+    if (3u == window)
+    {
+        a = p_stage->window[0];
+        b = p_stage->window[1];
+        c = p_stage->window[2];
+        if (a > b)
+        {
+            value = a;
+            a = b;
+            b = value;
+        }
+        /* a <= b, the median is b clamped to [a, c] or c clamped to [a, b] */
+        return (c > b) ? b : ((c < a) ? a : c);
+    }
+
+    for (i = 0; i < window; i++)
+    {
+        value = p_stage->window[i];
+        for (j = i; (0 < j) && (sorted[j - 1u] > value); j--)
+        {
+            sorted[j] = sorted[j - 1u];
+        }
+        sorted[j] = value;
+    }
+
+    return sorted[window / 2u];
+}
+
+/*
+ Function Name:
+ app_filter_bench_run
+
+ Function Description:
+ @brief  Runs every benchmark filter over the same input and prints the
+         cycles per input sample and a FNV-1a checksum of the output. The
+         input is a noisy step with glitches, generated by a linear
+         congruential generator that tools/filter_ref.py reproduces. The
+         checksums must match the reference: this checks that the DSP path
+         is bit-exact with the scalar code.
+
+ @param void
+
+ @return void
+ */
+static void app_filter_bench_run(void)
+{
+    const app_filter_bench_t *p_bench;
+    uint32_t seed = APP_FILTER_BENCH_SEED;
+    uint32_t start_cycles;
+    uint32_t cycles;
+    uint32_t outputs;
+    uint32_t crc;
+    uint32_t i, n;
+    int16_t out;
+
+    for (i = 0; i < APP_FILTER_BENCH_LEN; i++)
+    {
+        seed = (seed * 1664525u) + 1013904223u;
+        app_filter_bench_input[i] = (int16_t)(((i < (APP_FILTER_BENCH_LEN / 2u)) ? 2000 : 2500) +
+                                              (int32_t)((seed >> 24) & 0x3Fu) - 32 +
+                                              ((0u == (i % 37u)) ? 3000 : 0));
+    }
+
+    printf("FILTER BEGIN dsp=%u samples=%u\n", (unsigned)APP_FILTER_USE_DSP,
+           (unsigned)APP_FILTER_BENCH_LEN);
+    for (n = 0; n < (sizeof(app_filter_benches) / sizeof(app_filter_benches[0])); n++)
+    {
+        p_bench = &app_filter_benches[n];
+        app_filter_init(&app_filter_bench_filter, p_bench->stages, p_bench->num_stages);
+
+        /* Timing run */
+        start_cycles = app_cycle_counter_get();
+        for (i = 0; i < APP_FILTER_BENCH_LEN; i++)
+        {
+            (void)app_filter_process(&app_filter_bench_filter, app_filter_bench_input[i], &out);
+        }
+        cycles = app_cycle_counter_get() - start_cycles;
+
+        /* Checksum run */
+        app_filter_reset(&app_filter_bench_filter);
+        crc = 2166136261u;
+        outputs = 0;
+        for (i = 0; i < APP_FILTER_BENCH_LEN; i++)
+        {
+            if (app_filter_process(&app_filter_bench_filter, app_filter_bench_input[i], &out))
+            {
+                crc = (crc ^ ((uint16_t)out & 0xFFu)) * 16777619u;
+                crc = (crc ^ ((uint16_t)out >> 8)) * 16777619u;
+                outputs++;
+            }
+        }
+
+        printf("FILTER %s cycles_per_sample=%lu.%02lu outputs=%lu crc=0x%08lx\n",
+               p_bench->p_name, (unsigned long)(cycles / APP_FILTER_BENCH_LEN),
+               (unsigned long)(((cycles % APP_FILTER_BENCH_LEN) * 100u) / APP_FILTER_BENCH_LEN),
+               (unsigned long)outputs, (unsigned long)crc);
+    }
+    printf("FILTER END\n");
+}
+
+/*
+ Function Name:
+ app_filter_register_console
+
+ Function Description:
+ @brief  Adds the "filter" console command. The benchmark reads the cycle
+         counter enabled by app_gatt_dispatch_init().
+
+ @param void
+
+ @return void
+ */
+void app_filter_register_console(void)
+{
+    app_console_register_command(&app_filter_console_cmd);
+}
+
+/*
+ Function Name:
+ app_filter_cmd
+
+ Function Description:
+ @brief  "filter" console command, runs the benchmark.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_filter_cmd(uint32_t argc, char *argv[])
+{
+    app_filter_bench_run();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,120 @@
+/*******************************************************************************
+* File Name: app_filter.h
+*
+* Description: This file contains the interface of the fixed-point sample
+*              filter pipeline: moving average, single-pole IIR, median glitch
+*              rejection and decimation stages.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_FILTER_H__
+#define __APP_FILTER_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Maximum number of stages in a pipeline */
+#define APP_FILTER_MAX_STAGES            (4u)
+
+/* Largest moving average or median window */
+#define APP_FILTER_MAX_WINDOW            (16u)
+
+/* Use the saturating DSP instructions of the core when available. The
+ * scalar fallback gives bit-exact results, see tools/filter_ref.py.
+ */
+#ifndef APP_FILTER_USE_DSP
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define APP_FILTER_USE_DSP               (1u)
+#else
+#define APP_FILTER_USE_DSP               (0u)
+#endif
+#endif
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+typedef enum
+{
+    APP_FILTER_MOVING_AVG,      /* param: window, power of 2 up to 16 */
+    APP_FILTER_IIR,             /* param: shift k, y += (x - y) / 2^k, 1..8 */
+    APP_FILTER_MEDIAN,          /* param: window, odd, up to 15 */
+    APP_FILTER_DECIMATE,        /* param: factor, keeps one sample in factor */
+} app_filter_type_t;
+
+typedef struct
+{
+    app_filter_type_t   type;
+    uint8_t             param;
+} app_filter_stage_cfg_t;
+
+typedef struct
+{
+    app_filter_stage_cfg_t  cfg;
+    uint8_t                 shift;
+    uint8_t                 index;
+    bool                    primed;
+    int32_t                 state;
+    int16_t                 window[APP_FILTER_MAX_WINDOW];
+} app_filter_stage_t;
+
+typedef struct
+{
+    app_filter_stage_t  stages[APP_FILTER_MAX_STAGES];
+    uint8_t             num_stages;
+} app_filter_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+bool app_filter_init(app_filter_t *p_filter, const app_filter_stage_cfg_t *p_cfg,
+                     uint32_t num_stages);
+
+void app_filter_reset(app_filter_t *p_filter);
+
+bool app_filter_process(app_filter_t *p_filter, int16_t in, int16_t *p_out);
+
+void app_filter_register_console(void);
+
+#endif      /* __APP_FILTER_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,266 @@
+/*******************************************************************************
+* File Name: app_flash.c
+*
+* Description: This file contains the flash backends of the persistent log: the
+*              on-chip flash through the HAL and a RAM emulation.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_flash.h"
+#include "app_memory.h"
+#include "cyhal.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+#if (APP_FLASH_LOG_BACKEND == APP_FLASH_BACKEND_HAL) && \
+    defined(CYHAL_DRIVER_AVAILABLE_FLASH) && (CYHAL_DRIVER_AVAILABLE_FLASH)
+#define APP_FLASH_USE_HAL                (1u)
+#else
+#define APP_FLASH_USE_HAL                (0u)
+#endif
+
+#if APP_FLASH_USE_HAL
+static cyhal_flash_t    app_flash_obj;
+static uint32_t         app_flash_base;
+
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+/* End of the code in flash and the initialized data copied from behind it,
+ * from the GCC linker scripts of the BSPs */
+extern const uint8_t    __etext[];
+extern uint8_t          __data_start__[];
+extern uint8_t          __data_end__[];
+#endif
+
+APP_MEMORY_FOOTPRINT(app_flash_ram_footprint, sizeof(app_flash_obj));
+#else
+/* Emulated flash, word aligned like a programmed page */
+static uint32_t         app_flash_ram[(APP_FLASH_LOG_SECTORS * APP_FLASH_RAM_SECTOR_SIZE) /
+                                      sizeof(uint32_t)];
+
+APP_MEMORY_FOOTPRINT(app_flash_ram_footprint, sizeof(app_flash_ram));
+#endif
+
+static app_flash_t      app_flash;
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static cy_rslt_t app_flash_read(uint32_t offset, uint8_t *p_data, uint32_t len);
+
+static cy_rslt_t app_flash_program(uint32_t offset, const uint32_t *p_page);
+
+static cy_rslt_t app_flash_erase(uint32_t offset);
+
+#if APP_FLASH_USE_HAL
+static uint32_t app_flash_image_end(void);
+#endif
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_flash_open
+
+ Function Description:
+ @brief  Opens the flash region reserved for the log. The HAL backend takes
+         the geometry of the flash block holding the region and fails if the
+         region starts below the end of the application image; without a
+         HAL flash driver the RAM emulation is used.
+
+ @param void
+
+ @return const app_flash_t*  Flash region, NULL on failure
+ */
+const app_flash_t *app_flash_open(void)
+{
+#if APP_FLASH_USE_HAL
+    const cyhal_flash_block_info_t *p_block;
+    cyhal_flash_info_t info;
+
+    if (CY_RSLT_SUCCESS != cyhal_flash_init(&app_flash_obj))
+    {
+        printf("Flash init failed\n");
+        return NULL;
+    }
+    cyhal_flash_get_info(&app_flash_obj, &info);
+    if (0 == info.block_count)
+    {
+        return NULL;
+    }
+
+    p_block = &info.blocks[info.block_count - 1u];
+    if ((APP_FLASH_MAX_PAGE_SIZE < p_block->page_size) ||
+        (p_block->size < (APP_FLASH_LOG_SECTORS * p_block->sector_size)))
+    {
+        printf("Flash geometry not supported by the log\n");
+        return NULL;
+    }
+    app_flash_base = (0u != APP_FLASH_LOG_ADDR)
+                     ? APP_FLASH_LOG_ADDR
+                     : (p_block->start_address + p_block->size -
+                        (APP_FLASH_LOG_SECTORS * p_block->sector_size));
+
+    /* Nothing reserves the region in the linker script: refuse to erase the
+     * application when it grew into the region */
+    if (app_flash_base < app_flash_image_end())
+    {
+        printf("Flash log region 0x%08lx overlaps the application image up to 0x%08lx\n",
+               (unsigned long)app_flash_base, (unsigned long)app_flash_image_end());
+        return NULL;
+    }
+
+    app_flash.page_size = p_block->page_size;
+    app_flash.sector_size = p_block->sector_size;
+    app_flash.erase_value = p_block->erase_value;
+#else
+    app_flash.page_size = APP_FLASH_RAM_PAGE_SIZE;
+    app_flash.sector_size = APP_FLASH_RAM_SECTOR_SIZE;
+    app_flash.erase_value = 0xFFu;
+#endif
+
+    app_flash.num_sectors = APP_FLASH_LOG_SECTORS;
+    app_flash.p_read = app_flash_read;
+    app_flash.p_program = app_flash_program;
+    app_flash.p_erase = app_flash_erase;
+
+    return &app_flash;
+}
+
+#if APP_FLASH_USE_HAL
+/*
+ Function Name:
+ app_flash_image_end
+
+ Function Description:
+ @brief  Returns the first flash address after the application image: the
+         code, followed by the load image of the initialized data. Only the
+         GCC linker scripts are known, other toolchains return 0 and the
+         region is not checked.
+
+ @param void
+
+ @return uint32_t  End address of the image, 0 if unknown
+ */
+static uint32_t app_flash_image_end(void)
+{
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+    return (uint32_t)(uintptr_t)__etext + (uint32_t)(__data_end__ - __data_start__);
+#else
+    return 0u;
+#endif
+}
+#endif
+
+/*
+ Function Name:
+ app_flash_read
+
+ Function Description:
+ @brief  Reads from the region.
+
+ @param offset  Offset in the region
+ @param p_data  Output
+ @param len     Number of bytes
+
+ @return cy_rslt_t  CY_RSLT_SUCCESS or the HAL error
+ */
+static cy_rslt_t app_flash_read(uint32_t offset, uint8_t *p_data, uint32_t len)
+{
+#if APP_FLASH_USE_HAL
+    return cyhal_flash_read(&app_flash_obj, app_flash_base + offset, p_data, len);
+#else
+    memcpy(p_data, (const uint8_t *)app_flash_ram + offset, len);
+    return CY_RSLT_SUCCESS;
+#endif
+}
+
+/*
+ Function Name:
+ app_flash_program
+
+ Function Description:
+ @brief  Programs one page. The RAM emulation clears bits only, like flash.
+
+ @param offset  Page aligned offset in the region
+ @param p_page  Page data
+
+ @return cy_rslt_t  CY_RSLT_SUCCESS or the HAL error
+ */
+static cy_rslt_t app_flash_program(uint32_t offset, const uint32_t *p_page)
+{
+#if APP_FLASH_USE_HAL
+    return cyhal_flash_program(&app_flash_obj, app_flash_base + offset, p_page);
+#else
+    uint32_t i;
+
+    for (i = 0; i < (APP_FLASH_RAM_PAGE_SIZE / sizeof(uint32_t)); i++)
+    {
+        app_flash_ram[(offset / sizeof(uint32_t)) + i] &= p_page[i];
+    }
+    return CY_RSLT_SUCCESS;
+#endif
+}
+
+/*
+ Function Name:
+ app_flash_erase
+
+ Function Description:
+ @brief  Erases one sector.
+
+ @param offset  Sector aligned offset in the region
+
+ @return cy_rslt_t  CY_RSLT_SUCCESS or the HAL error
+ */
+static cy_rslt_t app_flash_erase(uint32_t offset)
+{
+#if APP_FLASH_USE_HAL
+    return cyhal_flash_erase(&app_flash_obj, app_flash_base + offset);
+#else
+    memset((uint8_t *)app_flash_ram + offset, 0xFF, APP_FLASH_RAM_SECTOR_SIZE);
+    return CY_RSLT_SUCCESS;
+#endif
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name: app_flash.h
+*
+* Description: This file contains the flash access interface used by the
+*              persistent log, with a HAL flash backend and a RAM emulation.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_FLASH_H__
+#define __APP_FLASH_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "cy_result.h"
+#include <stdint.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Flash backend of the persistent log: 0 on-chip flash through the HAL,
+ * 1 RAM emulation for testing without wearing the flash */
+#define APP_FLASH_BACKEND_HAL            (0u)
+#define APP_FLASH_BACKEND_RAM            (1u)
+
+#ifndef APP_FLASH_LOG_BACKEND
+#define APP_FLASH_LOG_BACKEND            APP_FLASH_BACKEND_HAL
+#endif
+
+/* Number of erase sectors reserved for the log */
+#ifndef APP_FLASH_LOG_SECTORS
+#define APP_FLASH_LOG_SECTORS            (8u)
+#endif
+
+/* Start address of the reserved region. 0 places it in the last sectors of
+ * the last flash block. The linker script does not reserve the region, so
+ * app_flash_open() fails when it starts below the end of the application
+ * image (GCC builds); reserve it in a custom linker script to be sure. */
+#ifndef APP_FLASH_LOG_ADDR
+#define APP_FLASH_LOG_ADDR               (0u)
+#endif
+
+/* Geometry of the RAM emulation */
+#define APP_FLASH_RAM_SECTOR_SIZE        (1024u)
+#define APP_FLASH_RAM_PAGE_SIZE          (256u)
+
+/* Largest page supported by the log page buffer */
+#define APP_FLASH_MAX_PAGE_SIZE          (512u)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Flash region and its operations. Addresses are offsets in the region.
+ * Programming writes one whole page, erasing clears one whole sector to
+ * erase_value. Another backend, e.g. a file for a host test, only has to
+ * fill this structure. */
+typedef struct
+{
+    cy_rslt_t   (*p_read)(uint32_t offset, uint8_t *p_data, uint32_t len);
+    cy_rslt_t   (*p_program)(uint32_t offset, const uint32_t *p_page);
+    cy_rslt_t   (*p_erase)(uint32_t offset);
+    uint32_t    page_size;
+    uint32_t    sector_size;
+    uint32_t    num_sectors;
+    uint8_t     erase_value;
+} app_flash_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+const app_flash_t *app_flash_open(void);
+
+#endif      /* __APP_FLASH_H__ */
+
+/* [] END OF FILE */
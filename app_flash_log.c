@@ -0,0 +1,746 @@
+/*******************************************************************************
+* File Name: app_flash_log.c
+*
+* Description: This file contains the persistent reading log. Records are
+*              batched in a page buffer and appended to a circular log of flash
+*              sectors; the sector headers are enough to recover the log after
+*              a reset.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_flash_log.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* Start of every sector, written with its first page. Stored in CPU (little
+ * endian) byte order. */
+typedef struct
+{
+    uint32_t    magic;
+    uint32_t    seq;            /* Increases by one per opened sector */
+    uint32_t    erase_count;    /* Erase cycles of this sector */
+    uint16_t    boot_count;     /* Boot during which the sector was opened */
+    uint16_t    crc;            /* CRC of the fields above */
+} app_flash_log_sector_hdr_t;
+
+/* Called for every record by app_flash_log_scan() */
+typedef void (*app_flash_log_record_cb_t)(uint8_t type, const uint8_t *p_payload,
+                                          uint8_t len);
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static const app_flash_t *p_app_flash;
+
+/* Page being filled, programmed once the next record does not fit */
+static uint32_t     app_flash_log_page_buf[APP_FLASH_MAX_PAGE_SIZE / sizeof(uint32_t)];
+static uint32_t     app_flash_log_fill;     /* Bytes in the buffer, 0 if no page is open */
+
+/* Write position: page app_flash_log_page of sector app_flash_log_head */
+static uint32_t     app_flash_log_head;
+static uint32_t     app_flash_log_seq;      /* Sequence number of the head, 0 if empty */
+static uint32_t     app_flash_log_page;
+static uint32_t     app_flash_log_pages_per_sector;
+
+static uint16_t     app_flash_log_boot;
+static bool         app_flash_log_have_last;
+static int16_t      app_flash_log_last_value;
+
+/* Statistics */
+static uint32_t     app_flash_log_records;
+static uint32_t     app_flash_log_programs;
+static uint32_t     app_flash_log_erases;
+static uint32_t     app_flash_log_errors;
+static uint32_t     app_flash_log_erase_min;
+static uint32_t     app_flash_log_erase_max;
+
+/* Boot number of the records printed by "flog dump" */
+static uint16_t     app_flash_log_dump_boot;
+
+APP_MEMORY_FOOTPRINT(app_flash_log_ram_footprint, sizeof(app_flash_log_page_buf));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static uint16_t app_flash_log_crc16(uint16_t crc, const uint8_t *p_data, uint32_t len);
+
+static bool app_flash_log_read_sector_hdr(uint32_t sector, app_flash_log_sector_hdr_t *p_hdr);
+
+static bool app_flash_log_append(uint8_t type, const uint8_t *p_payload, uint8_t len);
+
+static bool app_flash_log_open_sector(void);
+
+static bool app_flash_log_program_page(void);
+
+static void app_flash_log_parse(const uint8_t *p_page, uint32_t start, uint32_t end,
+                                app_flash_log_record_cb_t p_cb);
+
+static void app_flash_log_scan_page(uint32_t sector, uint32_t page,
+                                    app_flash_log_record_cb_t p_cb);
+
+static void app_flash_log_scan(app_flash_log_record_cb_t p_cb);
+
+static void app_flash_log_recover_cb(uint8_t type, const uint8_t *p_payload, uint8_t len);
+
+static void app_flash_log_dump_cb(uint8_t type, const uint8_t *p_payload, uint8_t len);
+
+static void app_flash_log_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_flash_log_console_cmd =
+{
+    "flog", "Persistent log state and wear; 'flog dump' prints the readings",
+    app_flash_log_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_flash_log_init
+
+ Function Description:
+ @brief  Recovers the log. Only the sector headers are read to find the
+         newest sector, then the pages of that sector are checked to find
+         the write position and the last reading. A sector whose header was
+         never programmed, e.g. after a reset during its first page, is
+         treated as empty. A boot record is appended.
+
+ @param void
+
+ @return void
+ */
+void app_flash_log_init(void)
+{
+    app_flash_log_sector_hdr_t hdr;
+    uint32_t first_offset;
+    uint8_t type;
+    uint32_t s, p;
+
+    app_console_register_command(&app_flash_log_console_cmd);
+
+    p_app_flash = app_flash_open();
+    if ((NULL == p_app_flash) || (APP_FLASH_MAX_PAGE_SIZE < p_app_flash->page_size))
+    {
+        printf("Persistent log disabled\n");
+        p_app_flash = NULL;
+        return;
+    }
+    app_flash_log_pages_per_sector = p_app_flash->sector_size / p_app_flash->page_size;
+
+    app_flash_log_seq = 0;
+    app_flash_log_erase_min = UINT32_MAX;
+    app_flash_log_erase_max = 0;
+    for (s = 0; s < p_app_flash->num_sectors; s++)
+    {
+        if (!app_flash_log_read_sector_hdr(s, &hdr))
+        {
+            continue;
+        }
+        if (hdr.seq > app_flash_log_seq)
+        {
+            app_flash_log_seq = hdr.seq;
+            app_flash_log_head = s;
+            app_flash_log_boot = hdr.boot_count;
+        }
+        app_flash_log_erase_min = (hdr.erase_count < app_flash_log_erase_min)
+                                  ? hdr.erase_count : app_flash_log_erase_min;
+        app_flash_log_erase_max = (hdr.erase_count > app_flash_log_erase_max)
+                                  ? hdr.erase_count : app_flash_log_erase_max;
+    }
+
+    /* Pages of the head sector are programmed in order: the first page
+     * without records is the write position */
+    app_flash_log_page = 0;
+    app_flash_log_fill = 0;
+    if (0 != app_flash_log_seq)
+    {
+        for (p = 0; p < app_flash_log_pages_per_sector; p++)
+        {
+            first_offset = (0 == p) ? APP_FLASH_LOG_SECTOR_HDR_SIZE : 0;
+            p_app_flash->p_read((app_flash_log_head * p_app_flash->sector_size) +
+                                (p * p_app_flash->page_size) + first_offset, &type, 1);
+            if (p_app_flash->erase_value == type)
+            {
+                break;
+            }
+            app_flash_log_scan_page(app_flash_log_head, p, app_flash_log_recover_cb);
+        }
+        app_flash_log_page = p;
+    }
+
+    printf("Persistent log: %lu sectors of %lu bytes, head %lu seq %lu page %lu, boot %u\n",
+           (unsigned long)p_app_flash->num_sectors, (unsigned long)p_app_flash->sector_size,
+           (unsigned long)app_flash_log_head, (unsigned long)app_flash_log_seq,
+           (unsigned long)app_flash_log_page, (unsigned)(app_flash_log_boot + 1u));
+
+    app_flash_log_boot++;
+    app_flash_log_append(APP_FLASH_LOG_REC_BOOT, (const uint8_t *)&app_flash_log_boot,
+                         sizeof(app_flash_log_boot));
+}
+
+/*
+ Function Name:
+ app_flash_log_append_reading
+
+ Function Description:
+ @brief  Logs a reading. It reaches the flash when its page is full.
+
+ @param time_s  Seconds since boot
+ @param value   Reading
+
+ @return bool  false if the log is disabled or the flash failed
+ */
+bool app_flash_log_append_reading(uint32_t time_s, int16_t value)
+{
+    uint8_t payload[6];
+
+    memcpy(&payload[0], &time_s, sizeof(time_s));
+    memcpy(&payload[4], &value, sizeof(value));
+
+    app_flash_log_have_last = true;
+    app_flash_log_last_value = value;
+
+    return app_flash_log_append(APP_FLASH_LOG_REC_READING, payload, sizeof(payload));
+}
+
+/*
+ Function Name:
+ app_flash_log_flush
+
+ Function Description:
+ @brief  Programs the partly filled page, e.g. before a planned reset. The
+         rest of the page stays unused.
+
+ @param void
+
+ @return bool  false if the flash failed
+ */
+bool app_flash_log_flush(void)
+{
+    if ((NULL == p_app_flash) || (0 == app_flash_log_fill))
+    {
+        return true;
+    }
+    return app_flash_log_program_page();
+}
+
+/*
+ Function Name:
+ app_flash_log_last_reading
+
+ Function Description:
+ @brief  Returns the last logged reading, after a reset the last one found
+         in flash.
+
+ @param p_value  Reading
+
+ @return bool  false if the log holds no reading
+ */
+bool app_flash_log_last_reading(int16_t *p_value)
+{
+    if (app_flash_log_have_last)
+    {
+        *p_value = app_flash_log_last_value;
+    }
+    return app_flash_log_have_last;
+}
+
+/*
+ Function Name:
+ app_flash_log_append
+
+ Function Description:
+ @brief  Adds a record to the page buffer. The buffered page is programmed
+         first if the record does not fit, and a new sector is opened when
+         the head sector is full.
+
+ @param type       Record type
+ @param p_payload  Payload
+ @param len        Payload length, up to APP_FLASH_LOG_MAX_PAYLOAD
+
+ @return bool  false if the log is disabled or the flash failed
+ */
+static bool app_flash_log_append(uint8_t type, const uint8_t *p_payload, uint8_t len)
+{
+    uint8_t *p_buf = (uint8_t *)app_flash_log_page_buf;
+    uint32_t rec_len = APP_FLASH_LOG_REC_HDR_SIZE + len;
+    uint16_t crc;
+
+    if ((NULL == p_app_flash) || (APP_FLASH_LOG_MAX_PAYLOAD < len))
+    {
+        return false;
+    }
+
+    if ((0 != app_flash_log_fill) && (p_app_flash->page_size < (app_flash_log_fill + rec_len)))
+    {
+        if (!app_flash_log_program_page())
+        {
+            return false;
+        }
+    }
+
+    if (0 == app_flash_log_fill)
+    {
+        if ((0 == app_flash_log_seq) || (app_flash_log_pages_per_sector <= app_flash_log_page))
+        {
+            if (!app_flash_log_open_sector())
+            {
+                return false;
+            }
+        }
+        else
+        {
+            memset(p_buf, p_app_flash->erase_value, p_app_flash->page_size);
+        }
+    }
+
+    crc = app_flash_log_crc16(0xFFFFu, &type, 1);
+    crc = app_flash_log_crc16(crc, &len, 1);
+    crc = app_flash_log_crc16(crc, p_payload, len);
+
+    p_buf[app_flash_log_fill] = type;
+    p_buf[app_flash_log_fill + 1u] = len;
+    p_buf[app_flash_log_fill + 2u] = (uint8_t)crc;
+    p_buf[app_flash_log_fill + 3u] = (uint8_t)(crc >> 8);
+    memcpy(&p_buf[app_flash_log_fill + APP_FLASH_LOG_REC_HDR_SIZE], p_payload, len);
+    app_flash_log_fill += rec_len;
+    app_flash_log_records++;
+
+    return true;
+}
+
+/*
+ Function Name:
+ app_flash_log_open_sector
+
+ Function Description:
+ @brief  Erases the sector after the head, the oldest one, and starts its
+         first page with the sector header. Writing the sectors in a ring
+         spreads the erase cycles evenly; the erase count is carried over
+         from the previous header of the sector.
+
+ @param void
+
+ @return bool  false if the erase failed
+ */
+static bool app_flash_log_open_sector(void)
+{
+    app_flash_log_sector_hdr_t hdr;
+    uint32_t next = (0 == app_flash_log_seq)
+                    ? 0 : ((app_flash_log_head + 1u) % p_app_flash->num_sectors);
+    /* A sector without a valid header is assumed to be as worn as the
+     * most worn sector */
+    uint32_t erase_count = app_flash_log_read_sector_hdr(next, &hdr)
+                           ? (hdr.erase_count + 1u)
+                           : ((0 != app_flash_log_erase_max) ? app_flash_log_erase_max : 1u);
+
+    if (CY_RSLT_SUCCESS != p_app_flash->p_erase(next * p_app_flash->sector_size))
+    {
+        app_flash_log_errors++;
+        return false;
+    }
+    app_flash_log_erases++;
+    app_flash_log_erase_max = (erase_count > app_flash_log_erase_max)
+                              ? erase_count : app_flash_log_erase_max;
+
+    app_flash_log_head = next;
+    app_flash_log_seq++;
+    app_flash_log_page = 0;
+
+    hdr.magic = APP_FLASH_LOG_MAGIC;
+    hdr.seq = app_flash_log_seq;
+    hdr.erase_count = erase_count;
+    hdr.boot_count = app_flash_log_boot;
+    hdr.crc = app_flash_log_crc16(0xFFFFu, (const uint8_t *)&hdr,
+                                  offsetof(app_flash_log_sector_hdr_t, crc));
+
+    memset(app_flash_log_page_buf, p_app_flash->erase_value, p_app_flash->page_size);
+    memcpy(app_flash_log_page_buf, &hdr, sizeof(hdr));
+    app_flash_log_fill = APP_FLASH_LOG_SECTOR_HDR_SIZE;
+
+    return true;
+}
+
+/*
+ Function Name:
+ app_flash_log_program_page
+
+ Function Description:
+ @brief  Programs the page buffer at the write position. A page lost to a
+         reset during programming fails its record CRCs and is skipped by
+         the readers.
+
+ @param void
+
+ @return bool  false if programming failed
+ */
+static bool app_flash_log_program_page(void)
+{
+    cy_rslt_t rslt;
+
+    rslt = p_app_flash->p_program((app_flash_log_head * p_app_flash->sector_size) +
+                                  (app_flash_log_page * p_app_flash->page_size),
+                                  app_flash_log_page_buf);
+    app_flash_log_page++;
+    app_flash_log_fill = 0;
+    if (CY_RSLT_SUCCESS != rslt)
+    {
+        app_flash_log_errors++;
+        return false;
+    }
+    app_flash_log_programs++;
+
+    return true;
+}
+
+/*
+ Function Name:
+ app_flash_log_read_sector_hdr
+
+ Function Description:
+ @brief  Reads and checks the header of a sector.
+
+ @param sector  Sector index
+ @param p_hdr   Header
+
+ @return bool  true if the header is valid
+ */
+static bool app_flash_log_read_sector_hdr(uint32_t sector, app_flash_log_sector_hdr_t *p_hdr)
+{
+    if (CY_RSLT_SUCCESS != p_app_flash->p_read(sector * p_app_flash->sector_size,
+                                               (uint8_t *)p_hdr, sizeof(*p_hdr)))
+    {
+        return false;
+    }
+
+    return (APP_FLASH_LOG_MAGIC == p_hdr->magic) &&
+           (p_hdr->crc == app_flash_log_crc16(0xFFFFu, (const uint8_t *)p_hdr,
+                                              offsetof(app_flash_log_sector_hdr_t, crc)));
+}
+
+/*
+ Function Name:
+ app_flash_log_parse
+
+ Function Description:
+ @brief  Calls p_cb for the valid records of a page image. Parsing stops at
+         an erased record header or at the first record with a bad CRC.
+
+ @param p_page  Page image
+ @param start   Offset of the first record
+ @param end     End of the records
+ @param p_cb    Record callback
+
+ @return void
+ */
+static void app_flash_log_parse(const uint8_t *p_page, uint32_t start, uint32_t end,
+                                app_flash_log_record_cb_t p_cb)
+{
+    uint16_t crc;
+    uint8_t len;
+
+    while ((start + APP_FLASH_LOG_REC_HDR_SIZE) <= end)
+    {
+        len = p_page[start + 1u];
+        if ((p_app_flash->erase_value == p_page[start]) ||
+            (APP_FLASH_LOG_MAX_PAYLOAD < len) ||
+            (end < (start + APP_FLASH_LOG_REC_HDR_SIZE + len)))
+        {
+            return;
+        }
+        crc = app_flash_log_crc16(0xFFFFu, &p_page[start], 2);
+        crc = app_flash_log_crc16(crc, &p_page[start + APP_FLASH_LOG_REC_HDR_SIZE], len);
+        if ((p_page[start + 2u] != (uint8_t)crc) || (p_page[start + 3u] != (uint8_t)(crc >> 8)))
+        {
+            return;
+        }
+        p_cb(p_page[start], &p_page[start + APP_FLASH_LOG_REC_HDR_SIZE], len);
+        start += APP_FLASH_LOG_REC_HDR_SIZE + len;
+    }
+}
+
+/*
+ Function Name:
+ app_flash_log_scan_page
+
+ Function Description:
+ @brief  Calls p_cb for the valid records of a programmed page. The page is
+         read record by record to keep the stack use small.
+
+ @param sector  Sector index
+ @param page    Page index in the sector
+ @param p_cb    Record callback
+
+ @return void
+ */
+static void app_flash_log_scan_page(uint32_t sector, uint32_t page,
+                                    app_flash_log_record_cb_t p_cb)
+{
+    uint8_t record[APP_FLASH_LOG_REC_HDR_SIZE + APP_FLASH_LOG_MAX_PAYLOAD];
+    uint32_t base = (sector * p_app_flash->sector_size) + (page * p_app_flash->page_size);
+    uint32_t pos = (0 == page) ? APP_FLASH_LOG_SECTOR_HDR_SIZE : 0;
+    uint32_t len;
+
+    while ((pos + APP_FLASH_LOG_REC_HDR_SIZE) <= p_app_flash->page_size)
+    {
+        if (CY_RSLT_SUCCESS != p_app_flash->p_read(base + pos, record,
+                                                   APP_FLASH_LOG_REC_HDR_SIZE))
+        {
+            return;
+        }
+        len = record[1];
+        if ((p_app_flash->erase_value == record[0]) || (APP_FLASH_LOG_MAX_PAYLOAD < len) ||
+            (p_app_flash->page_size < (pos + APP_FLASH_LOG_REC_HDR_SIZE + len)) ||
+            (CY_RSLT_SUCCESS != p_app_flash->p_read(base + pos + APP_FLASH_LOG_REC_HDR_SIZE,
+                                                    &record[APP_FLASH_LOG_REC_HDR_SIZE], len)))
+        {
+            return;
+        }
+        app_flash_log_parse(record, 0, APP_FLASH_LOG_REC_HDR_SIZE + len, p_cb);
+        pos += APP_FLASH_LOG_REC_HDR_SIZE + len;
+    }
+}
+
+/*
+ Function Name:
+ app_flash_log_scan
+
+ Function Description:
+ @brief  Calls p_cb for every valid record, oldest first: the sectors after
+         the head in ring order, then the page buffer.
+
+ @param p_cb  Record callback
+
+ @return void
+ */
+static void app_flash_log_scan(app_flash_log_record_cb_t p_cb)
+{
+    app_flash_log_sector_hdr_t hdr;
+    uint32_t sector;
+    uint32_t i, p;
+    uint8_t type;
+
+    if (0 == app_flash_log_seq)
+    {
+        return;
+    }
+
+    for (i = 1; i <= p_app_flash->num_sectors; i++)
+    {
+        sector = (app_flash_log_head + i) % p_app_flash->num_sectors;
+        if (!app_flash_log_read_sector_hdr(sector, &hdr) || (hdr.seq > app_flash_log_seq))
+        {
+            continue;
+        }
+        for (p = 0; p < app_flash_log_pages_per_sector; p++)
+        {
+            if ((sector == app_flash_log_head) && (p >= app_flash_log_page))
+            {
+                break;
+            }
+            p_app_flash->p_read((sector * p_app_flash->sector_size) +
+                                (p * p_app_flash->page_size) +
+                                ((0 == p) ? APP_FLASH_LOG_SECTOR_HDR_SIZE : 0), &type, 1);
+            if (p_app_flash->erase_value == type)
+            {
+                break;
+            }
+            app_flash_log_scan_page(sector, p, p_cb);
+        }
+    }
+
+    if (0 != app_flash_log_fill)
+    {
+        app_flash_log_parse((const uint8_t *)app_flash_log_page_buf,
+                            (0 == app_flash_log_page) ? APP_FLASH_LOG_SECTOR_HDR_SIZE : 0,
+                            app_flash_log_fill, p_cb);
+    }
+}
+
+/*
+ Function Name:
+ app_flash_log_recover_cb
+
+ Function Description:
+ @brief  Record callback of the recovery, keeps the last reading and the
+         last boot count.
+
+ @param type       Record type
+ @param p_payload  Payload
+ @param len        Payload length
+
+ @return void
+ */
+static void app_flash_log_recover_cb(uint8_t type, const uint8_t *p_payload, uint8_t len)
+{
+    uint16_t boot;
+
+    if ((APP_FLASH_LOG_REC_READING == type) && (6u == len))
+    {
+        memcpy(&app_flash_log_last_value, &p_payload[4], sizeof(app_flash_log_last_value));
+        app_flash_log_have_last = true;
+    }
+    else if ((APP_FLASH_LOG_REC_BOOT == type) && (sizeof(boot) == len))
+    {
+        memcpy(&boot, p_payload, sizeof(boot));
+        app_flash_log_boot = boot;
+    }
+}
+
+/*
+ Function Name:
+ app_flash_log_dump_cb
+
+ Function Description:
+ @brief  Record callback of "flog dump", prints "FLOG <boot> <time_s> <value>"
+         per reading.
+
+ @param type       Record type
+ @param p_payload  Payload
+ @param len        Payload length
+
+ @return void
+ */
+static void app_flash_log_dump_cb(uint8_t type, const uint8_t *p_payload, uint8_t len)
+{
+    uint32_t time_s;
+    int16_t value;
+
+    if ((APP_FLASH_LOG_REC_READING == type) && (6u == len))
+    {
+        memcpy(&time_s, p_payload, sizeof(time_s));
+        memcpy(&value, &p_payload[4], sizeof(value));
+        printf("FLOG %u %lu %d\n", (unsigned)app_flash_log_dump_boot,
+               (unsigned long)time_s, value);
+    }
+    else if ((APP_FLASH_LOG_REC_BOOT == type) && (sizeof(app_flash_log_dump_boot) == len))
+    {
+        memcpy(&app_flash_log_dump_boot, p_payload, sizeof(app_flash_log_dump_boot));
+    }
+}
+
+/*
+ Function Name:
+ app_flash_log_crc16
+
+ Function Description:
+ @brief  CRC-16/CCITT, bitwise: the records are short.
+
+ @param crc     Initial value or CRC of the previous data
+ @param p_data  Data
+ @param len     Length
+
+ @return uint16_t  CRC
+ */
+static uint16_t app_flash_log_crc16(uint16_t crc, const uint8_t *p_data, uint32_t len)
+{
+    uint32_t i;
+
+    while (0 != len--)
+    {
+        crc ^= (uint16_t)(*p_data++) << 8;
+        for (i = 0; i < 8u; i++)
+        {
+            crc = (0 != (crc & 0x8000u)) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/*
+ Function Name:
+ app_flash_log_cmd
+
+ Function Description:
+ @brief  "flog" console command. Prints the write position and the wear of
+         the sectors, or with "dump" the logged readings. The dump reads the
+         flash while the ESS task may append; a record caught in the middle
+         of an update fails its CRC and is not printed.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_flash_log_cmd(uint32_t argc, char *argv[])
+{
+    if (NULL == p_app_flash)
+    {
+        printf("Persistent log disabled\n");
+        return;
+    }
+
+    if ((1 < argc) && (0 == strcmp(argv[1], "dump")))
+    {
+        app_flash_log_dump_boot = 0;
+        app_flash_log_scan(app_flash_log_dump_cb);
+        return;
+    }
+
+    printf("Persistent log (%s): %lu sectors of %lu bytes, %lu byte pages\n",
+           (APP_FLASH_BACKEND_RAM == APP_FLASH_LOG_BACKEND) ? "RAM emulation" : "flash",
+           (unsigned long)p_app_flash->num_sectors, (unsigned long)p_app_flash->sector_size,
+           (unsigned long)p_app_flash->page_size);
+    printf("  boot %u, head sector %lu seq %lu page %lu, %lu bytes buffered\n",
+           (unsigned)app_flash_log_boot, (unsigned long)app_flash_log_head,
+           (unsigned long)app_flash_log_seq, (unsigned long)app_flash_log_page,
+           (unsigned long)app_flash_log_fill);
+    printf("  %lu records, %lu page programs, %lu erases, %lu errors this boot\n",
+           (unsigned long)app_flash_log_records, (unsigned long)app_flash_log_programs,
+           (unsigned long)app_flash_log_erases, (unsigned long)app_flash_log_errors);
+    if (UINT32_MAX != app_flash_log_erase_min)
+    {
+        printf("  sector erase count min %lu max %lu\n",
+               (unsigned long)app_flash_log_erase_min, (unsigned long)app_flash_log_erase_max);
+    }
+}
+
+/* [] END OF FILE */
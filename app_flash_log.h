@@ -0,0 +1,83 @@
+/*******************************************************************************
+* File Name: app_flash_log.h
+*
+* Description: This file contains the interface of the persistent reading log,
+*              a wear-levelled circular log in a reserved flash region.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_FLASH_LOG_H__
+#define __APP_FLASH_LOG_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_flash.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Sector header: magic, sequence number, erase count, boot count, CRC */
+#define APP_FLASH_LOG_MAGIC              (0x474F4C46u)
+#define APP_FLASH_LOG_SECTOR_HDR_SIZE    (16u)
+
+/* Record header: type, payload length, CRC of type, length and payload.
+ * Records do not cross pages; a type equal to the erase value ends the
+ * records of a page. */
+#define APP_FLASH_LOG_REC_HDR_SIZE       (4u)
+#define APP_FLASH_LOG_MAX_PAYLOAD        (16u)
+
+/* Record types */
+#define APP_FLASH_LOG_REC_READING        (0x01u)    /* uint32 time_s, sint16 value */
+#define APP_FLASH_LOG_REC_BOOT           (0x02u)    /* uint16 boot count */
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_flash_log_init(void);
+
+bool app_flash_log_append_reading(uint32_t time_s, int16_t value);
+
+bool app_flash_log_flush(void);
+
+bool app_flash_log_last_reading(int16_t *p_value);
+
+#endif      /* __APP_FLASH_LOG_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,245 @@
+/*******************************************************************************
+* File Name: app_gatt_gen.c
+*
+* Description: This file contains the GATT handle index and the
+*              advertising payload built from the Bluetooth configuration.
+*              Generated by tools/gatt_db_gen.py from design.cybt, do not edit.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_gatt_gen.h"
+#include "app_bt_gatt_handler.h"
+#include "GeneratedSource/cycfg_gatt_db.h"
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* The configurator output must match design.cybt as seen by the generator */
+_Static_assert(HDLS_GAP == APP_GATT_GEN_HDLS_GAP,
+               "HDLS_GAP differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLC_GAP_DEVICE_NAME == APP_GATT_GEN_HDLC_GAP_DEVICE_NAME,
+               "HDLC_GAP_DEVICE_NAME differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLC_GAP_DEVICE_NAME_VALUE == APP_GATT_GEN_HDLC_GAP_DEVICE_NAME_VALUE,
+               "HDLC_GAP_DEVICE_NAME_VALUE differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLC_GAP_APPEARANCE == APP_GATT_GEN_HDLC_GAP_APPEARANCE,
+               "HDLC_GAP_APPEARANCE differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLC_GAP_APPEARANCE_VALUE == APP_GATT_GEN_HDLC_GAP_APPEARANCE_VALUE,
+               "HDLC_GAP_APPEARANCE_VALUE differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLS_GATT == APP_GATT_GEN_HDLS_GATT,
+               "HDLS_GATT differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLC_GATT_SERVICE_CHANGED == APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED,
+               "HDLC_GATT_SERVICE_CHANGED differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLC_GATT_SERVICE_CHANGED_VALUE == APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE,
+               "HDLC_GATT_SERVICE_CHANGED_VALUE differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG == APP_GATT_GEN_HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG,
+               "HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLS_ESS == APP_GATT_GEN_HDLS_ESS,
+               "HDLS_ESS differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLC_ESS_TEMPERATURE == APP_GATT_GEN_HDLC_ESS_TEMPERATURE,
+               "HDLC_ESS_TEMPERATURE differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLC_ESS_TEMPERATURE_VALUE == APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE,
+               "HDLC_ESS_TEMPERATURE_VALUE differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG == APP_GATT_GEN_HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG,
+               "HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLD_ESS_TEMPERATURE_ES_MEASUREMENT == APP_GATT_GEN_HDLD_ESS_TEMPERATURE_ES_MEASUREMENT,
+               "HDLD_ESS_TEMPERATURE_ES_MEASUREMENT differs from design.cybt, run make gatt_gen");
+_Static_assert(HDLD_ESS_TEMPERATURE_VALID_RANGE == APP_GATT_GEN_HDLD_ESS_TEMPERATURE_VALID_RANGE,
+               "HDLD_ESS_TEMPERATURE_VALID_RANGE differs from design.cybt, run make gatt_gen");
+
+/* Handles are ascending and below the services added at run time */
+_Static_assert(APP_GATT_GEN_HDLS_GAP < APP_GATT_GEN_HDLC_GAP_DEVICE_NAME, "handle order");
+_Static_assert(APP_GATT_GEN_HDLC_GAP_DEVICE_NAME < APP_GATT_GEN_HDLC_GAP_DEVICE_NAME_VALUE, "handle order");
+_Static_assert(APP_GATT_GEN_HDLC_GAP_DEVICE_NAME_VALUE < APP_GATT_GEN_HDLC_GAP_APPEARANCE, "handle order");
+_Static_assert(APP_GATT_GEN_HDLC_GAP_APPEARANCE < APP_GATT_GEN_HDLC_GAP_APPEARANCE_VALUE, "handle order");
+_Static_assert(APP_GATT_GEN_HDLC_GAP_APPEARANCE_VALUE < APP_GATT_GEN_HDLS_GATT, "handle order");
+_Static_assert(APP_GATT_GEN_HDLS_GATT < APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED, "handle order");
+_Static_assert(APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED < APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE, "handle order");
+_Static_assert(APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE < APP_GATT_GEN_HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG, "handle order");
+_Static_assert(APP_GATT_GEN_HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG < APP_GATT_GEN_HDLS_ESS, "handle order");
+_Static_assert(APP_GATT_GEN_HDLS_ESS < APP_GATT_GEN_HDLC_ESS_TEMPERATURE, "handle order");
+_Static_assert(APP_GATT_GEN_HDLC_ESS_TEMPERATURE < APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE, "handle order");
+_Static_assert(APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE < APP_GATT_GEN_HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG, "handle order");
+_Static_assert(APP_GATT_GEN_HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG < APP_GATT_GEN_HDLD_ESS_TEMPERATURE_ES_MEASUREMENT, "handle order");
+_Static_assert(APP_GATT_GEN_HDLD_ESS_TEMPERATURE_ES_MEASUREMENT < APP_GATT_GEN_HDLD_ESS_TEMPERATURE_VALID_RANGE, "handle order");
+_Static_assert(APP_GATT_APP_HANDLE_BASE > APP_GATT_GEN_MAX_HANDLE,
+               "configured handles overlap APP_GATT_APP_HANDLE_BASE");
+_Static_assert(APP_GATT_GEN_NO_ATTR > APP_GATT_GEN_NUM_ATTRS,
+               "attribute index does not fit in 8 bits");
+_Static_assert(0xFFu >= APP_GATT_GEN_NUM_HANDLES, "handle list index does not fit in 8 bits");
+
+/* Values fit the attribute length limit, notified values fit the MTU */
+_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_HDLC_GAP_DEVICE_NAME_VALUE_LEN,
+               "HDLC_GAP_DEVICE_NAME_VALUE longer than MaxAttrLength");
+_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_HDLC_GAP_APPEARANCE_VALUE_LEN,
+               "HDLC_GAP_APPEARANCE_VALUE longer than MaxAttrLength");
+_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE_LEN,
+               "HDLC_GATT_SERVICE_CHANGED_VALUE longer than MaxAttrLength");
+_Static_assert((APP_GATT_GEN_MTU - 3u) >= APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE_LEN,
+               "HDLC_GATT_SERVICE_CHANGED_VALUE does not fit a notification");
+_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG_LEN,
+               "HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG longer than MaxAttrLength");
+_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE_LEN,
+               "HDLC_ESS_TEMPERATURE_VALUE longer than MaxAttrLength");
+_Static_assert((APP_GATT_GEN_MTU - 3u) >= APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE_LEN,
+               "HDLC_ESS_TEMPERATURE_VALUE does not fit a notification");
+_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG_LEN,
+               "HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG longer than MaxAttrLength");
+_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_HDLD_ESS_TEMPERATURE_ES_MEASUREMENT_LEN,
+               "HDLD_ESS_TEMPERATURE_ES_MEASUREMENT longer than MaxAttrLength");
+_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_HDLD_ESS_TEMPERATURE_VALID_RANGE_LEN,
+               "HDLD_ESS_TEMPERATURE_VALID_RANGE longer than MaxAttrLength");
+
+/* The payload fits a legacy advertising PDU */
+_Static_assert(31u >= APP_GATT_GEN_ADV_LEN, "advertising data longer than 31 bytes");
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+const uint8_t app_gatt_gen_attr_index[APP_GATT_GEN_MAX_HANDLE + 1u] =
+{
+    APP_GATT_GEN_NO_ATTR,
+    APP_GATT_GEN_NO_ATTR,  /* HDLS_GAP */
+    APP_GATT_GEN_NO_ATTR,  /* HDLC_GAP_DEVICE_NAME */
+    0,                     /* HDLC_GAP_DEVICE_NAME_VALUE */
+    APP_GATT_GEN_NO_ATTR,  /* HDLC_GAP_APPEARANCE */
+    1,                     /* HDLC_GAP_APPEARANCE_VALUE */
+    APP_GATT_GEN_NO_ATTR,  /* HDLS_GATT */
+    APP_GATT_GEN_NO_ATTR,  /* HDLC_GATT_SERVICE_CHANGED */
+    2,                     /* HDLC_GATT_SERVICE_CHANGED_VALUE */
+    3,                     /* HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG */
+    APP_GATT_GEN_NO_ATTR,  /* HDLS_ESS */
+    APP_GATT_GEN_NO_ATTR,  /* HDLC_ESS_TEMPERATURE */
+    4,                     /* HDLC_ESS_TEMPERATURE_VALUE */
+    5,                     /* HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG */
+    6,                     /* HDLD_ESS_TEMPERATURE_ES_MEASUREMENT */
+    7,                     /* HDLD_ESS_TEMPERATURE_VALID_RANGE */
+};
+
+const uint16_t app_gatt_gen_attr_handles[APP_GATT_GEN_NUM_ATTRS] =
+{
+    APP_GATT_GEN_HDLC_GAP_DEVICE_NAME_VALUE,
+    APP_GATT_GEN_HDLC_GAP_APPEARANCE_VALUE,
+    APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE,
+    APP_GATT_GEN_HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG,
+    APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE,
+    APP_GATT_GEN_HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG,
+    APP_GATT_GEN_HDLD_ESS_TEMPERATURE_ES_MEASUREMENT,
+    APP_GATT_GEN_HDLD_ESS_TEMPERATURE_VALID_RANGE,
+};
+
+const app_gatt_gen_uuid_t app_gatt_gen_uuids[APP_GATT_GEN_NUM_UUIDS] =
+{
+    { 0x2800,  0,  3 },
+    { 0x2803,  3,  4 },
+    { 0x2902,  7,  2 },
+    { 0x2906,  9,  1 },
+    { 0x290C, 10,  1 },
+    { 0x2A00, 11,  1 },
+    { 0x2A01, 12,  1 },
+    { 0x2A05, 13,  1 },
+    { 0x2A6E, 14,  1 },
+};
+
+const uint16_t app_gatt_gen_uuid_handles[APP_GATT_GEN_NUM_HANDLES] =
+{
+    /* 0x2800 */
+    APP_GATT_GEN_HDLS_GAP,
+    APP_GATT_GEN_HDLS_GATT,
+    APP_GATT_GEN_HDLS_ESS,
+    /* 0x2803 */
+    APP_GATT_GEN_HDLC_GAP_DEVICE_NAME,
+    APP_GATT_GEN_HDLC_GAP_APPEARANCE,
+    APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED,
+    APP_GATT_GEN_HDLC_ESS_TEMPERATURE,
+    /* 0x2902 */
+    APP_GATT_GEN_HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG,
+    APP_GATT_GEN_HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG,
+    /* 0x2906 */
+    APP_GATT_GEN_HDLD_ESS_TEMPERATURE_VALID_RANGE,
+    /* 0x290C */
+    APP_GATT_GEN_HDLD_ESS_TEMPERATURE_ES_MEASUREMENT,
+    /* 0x2A00 */
+    APP_GATT_GEN_HDLC_GAP_DEVICE_NAME_VALUE,
+    /* 0x2A01 */
+    APP_GATT_GEN_HDLC_GAP_APPEARANCE_VALUE,
+    /* 0x2A05 */
+    APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE,
+    /* 0x2A6E */
+    APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE,
+};
+
+const uint8_t app_gatt_gen_adv_payload[APP_GATT_GEN_ADV_LEN] =
+{
+    /* BTM_BLE_ADVERT_TYPE_FLAG */
+    0x02, 0x01, 0x06,
+    /* BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE */
+    0x03, 0x03, 0x1A, 0x18,
+    /* BTM_BLE_ADVERT_TYPE_NAME_COMPLETE */
+    0x0B, 0x09, 0x54, 0x68, 0x65, 0x72, 0x6D, 0x69, 0x73, 0x74, 0x6F, 0x72,
+    /* BTM_BLE_ADVERT_TYPE_APPEARANCE */
+    0x03, 0x19, 0x00, 0x03,
+};
+
+/* The stack copies the elements into its own buffer, the data stays in flash */
+const wiced_bt_ble_advert_elem_t app_gatt_gen_adv_elems[APP_GATT_GEN_ADV_NUM_ELEMS] =
+{
+    {
+        .advert_type = BTM_BLE_ADVERT_TYPE_FLAG,
+        .len         = 1,
+        .p_data      = (uint8_t *)&app_gatt_gen_adv_payload[2],
+    },
+    {
+        .advert_type = BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE,
+        .len         = 2,
+        .p_data      = (uint8_t *)&app_gatt_gen_adv_payload[5],
+    },
+    {
+        .advert_type = BTM_BLE_ADVERT_TYPE_NAME_COMPLETE,
+        .len         = 10,
+        .p_data      = (uint8_t *)&app_gatt_gen_adv_payload[9],
+    },
+    {
+        .advert_type = BTM_BLE_ADVERT_TYPE_APPEARANCE,
+        .len         = 2,
+        .p_data      = (uint8_t *)&app_gatt_gen_adv_payload[21],
+    },
+};
+
+/* [] END OF FILE */
@@ -0,0 +1,134 @@
+/*******************************************************************************
+* File Name: app_gatt_gen.h
+*
+* Description: This file contains the GATT handle index and the
+*              advertising payload built from the Bluetooth configuration.
+*              Generated by tools/gatt_db_gen.py from design.cybt, do not edit.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_GATT_GEN_H__
+#define __APP_GATT_GEN_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "wiced_bt_ble.h"
+#include <stdint.h>
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* Attribute handles, checked against GeneratedSource/cycfg_gatt_db.h */
+#define APP_GATT_GEN_HDLS_GAP                                          (0x0001u)
+#define APP_GATT_GEN_HDLC_GAP_DEVICE_NAME                              (0x0002u)
+#define APP_GATT_GEN_HDLC_GAP_DEVICE_NAME_VALUE                        (0x0003u)
+#define APP_GATT_GEN_HDLC_GAP_APPEARANCE                               (0x0004u)
+#define APP_GATT_GEN_HDLC_GAP_APPEARANCE_VALUE                         (0x0005u)
+#define APP_GATT_GEN_HDLS_GATT                                         (0x0006u)
+#define APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED                         (0x0007u)
+#define APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE                   (0x0008u)
+#define APP_GATT_GEN_HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG      (0x0009u)
+#define APP_GATT_GEN_HDLS_ESS                                          (0x000Au)
+#define APP_GATT_GEN_HDLC_ESS_TEMPERATURE                              (0x000Bu)
+#define APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE                        (0x000Cu)
+#define APP_GATT_GEN_HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG           (0x000Du)
+#define APP_GATT_GEN_HDLD_ESS_TEMPERATURE_ES_MEASUREMENT               (0x000Eu)
+#define APP_GATT_GEN_HDLD_ESS_TEMPERATURE_VALID_RANGE                  (0x000Fu)
+
+/* Highest handle of the configured database */
+#define APP_GATT_GEN_MAX_HANDLE                                        (0x000Fu)
+
+/* Attributes with a value in app_gatt_db_ext_attr_tbl */
+#define APP_GATT_GEN_NUM_ATTRS                                         (8u)
+
+/* Index of a handle without an application managed value */
+#define APP_GATT_GEN_NO_ATTR                                           (0xFFu)
+
+/* Attribute types and handles in the per-UUID lists */
+#define APP_GATT_GEN_NUM_UUIDS                                         (9u)
+#define APP_GATT_GEN_NUM_HANDLES                                       (15u)
+
+/* Configured ATT MTU and attribute length limit */
+#define APP_GATT_GEN_MTU                                               (23u)
+#define APP_GATT_GEN_MAX_ATTR_LEN                                      (512u)
+
+/* Advertising elements and encoded length of the payload */
+#define APP_GATT_GEN_ADV_NUM_ELEMS                                     (4u)
+#define APP_GATT_GEN_ADV_LEN                                           (23u)
+
+/* Length of the attribute values */
+#define APP_GATT_GEN_HDLC_GAP_DEVICE_NAME_VALUE_LEN                    (10u)
+#define APP_GATT_GEN_HDLC_GAP_APPEARANCE_VALUE_LEN                     (2u)
+#define APP_GATT_GEN_HDLC_GATT_SERVICE_CHANGED_VALUE_LEN               (4u)
+#define APP_GATT_GEN_HDLD_GATT_SERVICE_CHANGED_CLIENT_CHAR_CONFIG_LEN  (2u)
+#define APP_GATT_GEN_HDLC_ESS_TEMPERATURE_VALUE_LEN                    (2u)
+#define APP_GATT_GEN_HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG_LEN       (2u)
+#define APP_GATT_GEN_HDLD_ESS_TEMPERATURE_ES_MEASUREMENT_LEN           (11u)
+#define APP_GATT_GEN_HDLD_ESS_TEMPERATURE_VALID_RANGE_LEN              (4u)
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* Handles of one attribute type, app_gatt_gen_uuid_handles[first..first+count) */
+typedef struct
+{
+    uint16_t    uuid;
+    uint8_t     first;
+    uint8_t     count;
+} app_gatt_gen_uuid_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Index in app_gatt_db_ext_attr_tbl of each handle, APP_GATT_GEN_NO_ATTR if none */
+extern const uint8_t app_gatt_gen_attr_index[APP_GATT_GEN_MAX_HANDLE + 1u];
+
+/* Handle of each entry of app_gatt_db_ext_attr_tbl */
+extern const uint16_t app_gatt_gen_attr_handles[APP_GATT_GEN_NUM_ATTRS];
+
+/* Attribute types sorted by UUID and their handles in ascending order */
+extern const app_gatt_gen_uuid_t app_gatt_gen_uuids[APP_GATT_GEN_NUM_UUIDS];
+extern const uint16_t app_gatt_gen_uuid_handles[APP_GATT_GEN_NUM_HANDLES];
+
+/* Advertising payload, as sent over the air, and its elements */
+extern const uint8_t app_gatt_gen_adv_payload[APP_GATT_GEN_ADV_LEN];
+extern const wiced_bt_ble_advert_elem_t app_gatt_gen_adv_elems[APP_GATT_GEN_ADV_NUM_ELEMS];
+
+#endif      /* __APP_GATT_GEN_H__ */
+
+/* [] END OF FILE */
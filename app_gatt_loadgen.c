@@ -0,0 +1,857 @@
+/*******************************************************************************
+* File Name: app_gatt_loadgen.c
+*
+* Description: This file contains the GATT load generator. The gattload console
+*              command simulates many centrals that connect, exchange the MTU,
+*              discover, read, subscribe and disconnect at a target rate, by
+*              injecting the events into the GATT event callback. Responses to
+*              the virtual connections are completed by the transmit layer
+*              instead of the stack, which gives the latency of every request.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_gatt_loadgen.h"
+#include "app_bt_gatt_handler.h"
+#include "app_bt_gatt_tx.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_heap_trace.h"
+#include "app_memory.h"
+#include "GeneratedSource/cycfg_gatt_db.h"
+#include "cyhal.h"
+#include "wiced_bt_gatt.h"
+#include <task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if APP_GATT_LOADGEN
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* UUID of the characteristic discovered with Read By Type, Temperature */
+#define APP_GATT_LOADGEN_READ_TYPE_UUID  (0x2A6Eu)
+
+/* MTU requested by the virtual centrals */
+#define APP_GATT_LOADGEN_REMOTE_MTU      (247u)
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef enum
+{
+    APP_GATT_LOADGEN_CONNECT,
+    APP_GATT_LOADGEN_MTU,
+    APP_GATT_LOADGEN_READ_BY_TYPE,
+    APP_GATT_LOADGEN_READ,
+    APP_GATT_LOADGEN_WRITE,
+    APP_GATT_LOADGEN_DISCONNECT,
+    APP_GATT_LOADGEN_OP_COUNT
+} app_gatt_loadgen_op_t;
+
+/* A virtual connection has at most one request outstanding, like an ATT
+ * bearer.
+ */
+typedef struct
+{
+    bool        connected;
+    bool        busy;
+    uint8_t     op;
+    uint32_t    start_cycles;
+    TickType_t  start_tick;
+} app_gatt_loadgen_conn_t;
+
+typedef struct
+{
+    uint32_t    issued;
+    uint32_t    completed;
+    uint32_t    failed;
+    uint32_t    max_cycles;
+    uint32_t    sample_count;
+    uint32_t    samples[APP_GATT_LOADGEN_LATENCY_SAMPLES];
+} app_gatt_loadgen_op_stats_t;
+
+typedef struct
+{
+    uint32_t    conns;
+    uint32_t    rate;
+    uint32_t    seconds;
+    uint8_t     weights[APP_GATT_LOADGEN_OP_COUNT];
+    uint32_t    weight_total;
+} app_gatt_loadgen_cfg_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static app_gatt_loadgen_cfg_t       app_gatt_loadgen_cfg;
+static app_gatt_loadgen_conn_t      app_gatt_loadgen_conns[APP_GATT_LOADGEN_MAX_CONNS];
+static app_gatt_loadgen_op_stats_t  app_gatt_loadgen_ops[APP_GATT_LOADGEN_OP_COUNT];
+
+/* Scratch copy of the latencies of one operation for sorting */
+static uint32_t                     app_gatt_loadgen_sorted[APP_GATT_LOADGEN_LATENCY_SAMPLES];
+
+static volatile bool                app_gatt_loadgen_running;
+static uint32_t                     app_gatt_loadgen_skipped;
+static uint32_t                     app_gatt_loadgen_timeouts;
+static uint32_t                     app_gatt_loadgen_late;
+static uint32_t                     app_gatt_loadgen_notifications;
+static uint32_t                     app_gatt_loadgen_random;
+
+static TaskHandle_t                 app_gatt_loadgen_task_handle;
+
+static const char * const app_gatt_loadgen_op_names[APP_GATT_LOADGEN_OP_COUNT] =
+{
+    "connect", "mtu", "read-by-type", "read", "cccd-write", "disconnect"
+};
+
+/* Mix letters, in app_gatt_loadgen_op_t order. Connections are opened when
+ * a disconnected connection is picked, so connect has no letter.
+ */
+static const char app_gatt_loadgen_op_letters[APP_GATT_LOADGEN_OP_COUNT] =
+{
+    '\0', 'm', 't', 'r', 'w', 'd'
+};
+
+/* Value of the CCCD writes, enables notifications */
+static uint8_t app_gatt_loadgen_cccd_value[] = { 0x01, 0x00 };
+
+#if APP_STATIC_MEMORY
+/* Task stack and control block in static memory mode */
+static StackType_t  app_gatt_loadgen_stack[APP_GATT_LOADGEN_STACK_SIZE];
+static StaticTask_t app_gatt_loadgen_tcb;
+
+APP_MEMORY_FOOTPRINT(app_gatt_loadgen_ram_footprint,
+                     sizeof(app_gatt_loadgen_conns) + sizeof(app_gatt_loadgen_ops) +
+                     sizeof(app_gatt_loadgen_sorted) +
+                     sizeof(app_gatt_loadgen_stack) + sizeof(app_gatt_loadgen_tcb));
+#else
+APP_MEMORY_FOOTPRINT(app_gatt_loadgen_ram_footprint,
+                     sizeof(app_gatt_loadgen_conns) + sizeof(app_gatt_loadgen_ops) +
+                     sizeof(app_gatt_loadgen_sorted));
+#endif
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_gatt_loadgen_task(void *pvParam);
+
+static void app_gatt_loadgen_run(void);
+
+static void app_gatt_loadgen_issue(void);
+
+static void app_gatt_loadgen_inject_conn(uint32_t index, bool connected);
+
+static void app_gatt_loadgen_inject_req(uint32_t index, app_gatt_loadgen_op_t op);
+
+static void app_gatt_loadgen_record(uint32_t index, bool success);
+
+static void app_gatt_loadgen_expire(TickType_t now);
+
+static bool app_gatt_loadgen_owns(uint16_t conn_id);
+
+static void app_gatt_loadgen_complete(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                      wiced_bt_gatt_status_t status);
+
+static int app_gatt_loadgen_compare(const void *p_a, const void *p_b);
+
+static void app_gatt_loadgen_report(uint32_t elapsed_ms);
+
+static bool app_gatt_loadgen_parse_mix(const char *p_mix);
+
+static void app_gatt_loadgen_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_gatt_tx_sink_t app_gatt_loadgen_sink =
+{
+    app_gatt_loadgen_owns, app_gatt_loadgen_complete
+};
+
+static const app_console_cmd_t app_gatt_loadgen_console_cmd =
+{
+    "gattload", "GATT load: gattload <conns> <req/s> <seconds> [mix, e.g. "
+    APP_GATT_LOADGEN_DEFAULT_MIX "]", app_gatt_loadgen_cmd
+};
+
+#else
+
+APP_MEMORY_FOOTPRINT(app_gatt_loadgen_ram_footprint, 0);
+
+#endif /* APP_GATT_LOADGEN */
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_gatt_loadgen_init
+
+ Function Description:
+ @brief  Creates the load generator task and registers the gattload console
+         command. Does nothing unless built with APP_GATT_LOADGEN=1.
+
+ @param void
+
+ @return void
+ */
+void app_gatt_loadgen_init(void)
+{
+#if APP_GATT_LOADGEN
+#if APP_STATIC_MEMORY
+    app_gatt_loadgen_task_handle = xTaskCreateStatic(app_gatt_loadgen_task,
+                                                     APP_GATT_LOADGEN_TASK_NAME,
+                                                     APP_GATT_LOADGEN_STACK_SIZE, NULL,
+                                                     APP_GATT_LOADGEN_PRIORITY,
+                                                     app_gatt_loadgen_stack,
+                                                     &app_gatt_loadgen_tcb);
+#else
+    if (pdPASS != xTaskCreate(app_gatt_loadgen_task, APP_GATT_LOADGEN_TASK_NAME,
+                              APP_GATT_LOADGEN_STACK_SIZE, NULL,
+                              APP_GATT_LOADGEN_PRIORITY, &app_gatt_loadgen_task_handle))
+    {
+        app_gatt_loadgen_task_handle = NULL;
+    }
+#endif
+    if (NULL == app_gatt_loadgen_task_handle)
+    {
+        printf("GATT load generator task creation failed\n");
+        return;
+    }
+
+    app_console_register_command(&app_gatt_loadgen_console_cmd);
+#endif
+}
+
+#if APP_GATT_LOADGEN
+
+/*
+ Function Name:
+ app_gatt_loadgen_task
+
+ Function Description:
+ @brief  Waits for the gattload command and runs the load.
+
+ @param pvParam  Not used
+
+ @return void
+ */
+static void app_gatt_loadgen_task(void *pvParam)
+{
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        app_gatt_loadgen_run();
+    }
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_run
+
+ Function Description:
+ @brief  Issues the configured rate of operations for the configured time,
+         waits for the outstanding requests, disconnects the virtual
+         connections and prints the report. Advertising restarts when the
+         last virtual connection the server accepted goes down.
+
+ @param void
+
+ @return void
+ */
+static void app_gatt_loadgen_run(void)
+{
+    app_memory_buffer_stats_t buffer_stats;
+    TickType_t duration = pdMS_TO_TICKS(app_gatt_loadgen_cfg.seconds * 1000u);
+    TickType_t start;
+    TickType_t wake;
+    TickType_t elapsed;
+    uint32_t issued = 0;
+    uint32_t due;
+    uint32_t i;
+
+    memset(app_gatt_loadgen_conns, 0, sizeof(app_gatt_loadgen_conns));
+    memset(app_gatt_loadgen_ops, 0, sizeof(app_gatt_loadgen_ops));
+    app_gatt_loadgen_skipped = 0;
+    app_gatt_loadgen_timeouts = 0;
+    app_gatt_loadgen_late = 0;
+    app_gatt_loadgen_notifications = 0;
+    app_gatt_loadgen_random = 0x2545F491u;
+
+    app_memory_get_buffer_stats(&buffer_stats, true);
+    app_heap_trace_reset_peak();
+    app_gatt_tx_set_sink(&app_gatt_loadgen_sink);
+
+    start = xTaskGetTickCount();
+    wake = start;
+    do
+    {
+        vTaskDelayUntil(&wake, 1);
+        elapsed = wake - start;
+
+        due = (uint32_t)(((uint64_t)app_gatt_loadgen_cfg.rate * elapsed) /
+                         configTICK_RATE_HZ);
+        while (issued < due)
+        {
+            app_gatt_loadgen_issue();
+            issued++;
+        }
+        app_gatt_loadgen_expire(wake);
+    } while (elapsed < duration);
+
+    /* Let the outstanding requests complete or time out */
+    for (i = 0; i < APP_GATT_LOADGEN_TIMEOUT_MS; i++)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1));
+        app_gatt_loadgen_expire(xTaskGetTickCount());
+    }
+
+    for (i = 0; i < app_gatt_loadgen_cfg.conns; i++)
+    {
+        if (app_gatt_loadgen_conns[i].connected)
+        {
+            app_gatt_loadgen_inject_conn(i, false);
+        }
+    }
+    /* The worker processes the disconnections before the sink goes away */
+    vTaskDelay(pdMS_TO_TICKS(100));
+    app_gatt_loadgen_running = false;
+    app_gatt_tx_set_sink(NULL);
+
+    app_gatt_loadgen_report((uint32_t)((elapsed * 1000u) / configTICK_RATE_HZ));
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_issue
+
+ Function Description:
+ @brief  Picks a random virtual connection and issues its next operation:
+         a connection if it is down, otherwise an operation of the mix. A
+         connection waiting for a response is skipped.
+
+ @param void
+
+ @return void
+ */
+static void app_gatt_loadgen_issue(void)
+{
+    uint32_t index;
+    uint32_t pick;
+    uint32_t op;
+
+    /* xorshift32, fixed seed for repeatable runs */
+    app_gatt_loadgen_random ^= app_gatt_loadgen_random << 13;
+    app_gatt_loadgen_random ^= app_gatt_loadgen_random >> 17;
+    app_gatt_loadgen_random ^= app_gatt_loadgen_random << 5;
+
+    index = app_gatt_loadgen_random % app_gatt_loadgen_cfg.conns;
+    if (app_gatt_loadgen_conns[index].busy)
+    {
+        app_gatt_loadgen_skipped++;
+        return;
+    }
+
+    if (!app_gatt_loadgen_conns[index].connected)
+    {
+        app_gatt_loadgen_inject_conn(index, true);
+        return;
+    }
+
+    pick = (app_gatt_loadgen_random >> 8) % app_gatt_loadgen_cfg.weight_total;
+    for (op = APP_GATT_LOADGEN_MTU; op < APP_GATT_LOADGEN_DISCONNECT; op++)
+    {
+        if (pick < app_gatt_loadgen_cfg.weights[op])
+        {
+            break;
+        }
+        pick -= app_gatt_loadgen_cfg.weights[op];
+    }
+
+    if (APP_GATT_LOADGEN_DISCONNECT == op)
+    {
+        app_gatt_loadgen_inject_conn(index, false);
+    }
+    else
+    {
+        app_gatt_loadgen_inject_req(index, (app_gatt_loadgen_op_t)op);
+    }
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_inject_conn
+
+ Function Description:
+ @brief  Injects the connection or disconnection of a virtual connection.
+         Neither has a response, so the latency is the time spent in the
+         GATT event callback.
+
+ @param index      Index of the virtual connection
+ @param connected  Connection or disconnection
+
+ @return void
+ */
+static void app_gatt_loadgen_inject_conn(uint32_t index, bool connected)
+{
+    app_gatt_loadgen_conn_t *p_conn = &app_gatt_loadgen_conns[index];
+    wiced_bt_gatt_event_data_t event_data;
+    wiced_bt_device_address_t bd_addr = { 0x00, 0xA0, 0x50, 0x4C, 0x47, (uint8_t)index };
+
+    memset(&event_data, 0, sizeof(event_data));
+    event_data.connection_status.bd_addr = bd_addr;
+    event_data.connection_status.conn_id = (uint16_t)(APP_GATT_LOADGEN_CONN_ID_BASE + index);
+    event_data.connection_status.connected = connected ? WICED_TRUE : WICED_FALSE;
+    event_data.connection_status.reason = connected ? 0 : GATT_CONN_TERMINATE_PEER_USER;
+
+    taskENTER_CRITICAL();
+    p_conn->op = connected ? APP_GATT_LOADGEN_CONNECT : APP_GATT_LOADGEN_DISCONNECT;
+    p_conn->busy = true;
+    p_conn->start_tick = xTaskGetTickCount();
+    p_conn->start_cycles = app_cycle_counter_get();
+    taskEXIT_CRITICAL();
+    app_gatt_loadgen_ops[p_conn->op].issued++;
+
+    app_bt_gatt_event_callback(GATT_CONNECTION_STATUS_EVT, &event_data);
+
+    taskENTER_CRITICAL();
+    p_conn->connected = connected;
+    app_gatt_loadgen_record(index, true);
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_inject_req
+
+ Function Description:
+ @brief  Injects an attribute request of a virtual connection. The request
+         completes when the transmit layer hands its response to the sink.
+
+ @param index  Index of the virtual connection
+ @param op     Operation
+
+ @return void
+ */
+static void app_gatt_loadgen_inject_req(uint32_t index, app_gatt_loadgen_op_t op)
+{
+    app_gatt_loadgen_conn_t *p_conn = &app_gatt_loadgen_conns[index];
+    wiced_bt_gatt_event_data_t event_data;
+    wiced_bt_gatt_attribute_request_t *p_attr_req = &event_data.attribute_request;
+
+    memset(&event_data, 0, sizeof(event_data));
+    p_attr_req->conn_id = (uint16_t)(APP_GATT_LOADGEN_CONN_ID_BASE + index);
+    p_attr_req->len_requested = CY_BT_MTU_SIZE;
+
+    switch (op)
+    {
+    case APP_GATT_LOADGEN_MTU:
+        p_attr_req->opcode = GATT_REQ_MTU;
+        p_attr_req->data.remote_mtu = APP_GATT_LOADGEN_REMOTE_MTU;
+        break;
+
+    case APP_GATT_LOADGEN_READ_BY_TYPE:
+        p_attr_req->opcode = GATT_REQ_READ_BY_TYPE;
+        p_attr_req->data.read_by_type.s_handle = 0x0001;
+        p_attr_req->data.read_by_type.e_handle = 0xFFFF;
+        p_attr_req->data.read_by_type.uuid.len = LEN_UUID_16;
+        p_attr_req->data.read_by_type.uuid.uu.uuid16 = APP_GATT_LOADGEN_READ_TYPE_UUID;
+        break;
+
+    case APP_GATT_LOADGEN_READ:
+        p_attr_req->opcode = GATT_REQ_READ;
+        p_attr_req->data.read_req.handle = HDLC_ESS_TEMPERATURE_VALUE;
+        break;
+
+    default:
+        p_attr_req->opcode = GATT_REQ_WRITE;
+        p_attr_req->data.write_req.handle = HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG;
+        p_attr_req->data.write_req.val_len = sizeof(app_gatt_loadgen_cccd_value);
+        p_attr_req->data.write_req.p_val = app_gatt_loadgen_cccd_value;
+        break;
+    }
+
+    taskENTER_CRITICAL();
+    p_conn->op = (uint8_t)op;
+    p_conn->busy = true;
+    p_conn->start_tick = xTaskGetTickCount();
+    p_conn->start_cycles = app_cycle_counter_get();
+    taskEXIT_CRITICAL();
+    app_gatt_loadgen_ops[op].issued++;
+
+    app_bt_gatt_event_callback(GATT_ATTRIBUTE_REQUEST_EVT, &event_data);
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_record
+
+ Function Description:
+ @brief  Completes the outstanding operation of a virtual connection and
+         records its latency. Called in a critical section.
+
+ @param index    Index of the virtual connection
+ @param success  The operation succeeded
+
+ @return void
+ */
+static void app_gatt_loadgen_record(uint32_t index, bool success)
+{
+    app_gatt_loadgen_conn_t *p_conn = &app_gatt_loadgen_conns[index];
+    app_gatt_loadgen_op_stats_t *p_op = &app_gatt_loadgen_ops[p_conn->op];
+    uint32_t cycles = app_cycle_counter_get() - p_conn->start_cycles;
+
+    p_conn->busy = false;
+    if (!success)
+    {
+        p_op->failed++;
+        return;
+    }
+
+    p_op->completed++;
+    if (p_op->max_cycles < cycles)
+    {
+        p_op->max_cycles = cycles;
+    }
+    p_op->samples[p_op->sample_count % APP_GATT_LOADGEN_LATENCY_SAMPLES] = cycles;
+    p_op->sample_count++;
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_expire
+
+ Function Description:
+ @brief  Fails the requests that have not been answered in time, so that a
+         lost response does not stall its connection.
+
+ @param now  Current tick count
+
+ @return void
+ */
+static void app_gatt_loadgen_expire(TickType_t now)
+{
+    uint32_t i;
+
+    for (i = 0; i < app_gatt_loadgen_cfg.conns; i++)
+    {
+        taskENTER_CRITICAL();
+        if ((app_gatt_loadgen_conns[i].busy) &&
+            (pdMS_TO_TICKS(APP_GATT_LOADGEN_TIMEOUT_MS) <
+             (TickType_t)(now - app_gatt_loadgen_conns[i].start_tick)))
+        {
+            app_gatt_loadgen_timeouts++;
+            app_gatt_loadgen_record(i, false);
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_owns
+
+ Function Description:
+ @brief  Sink callback, claims the virtual connections of the running load.
+
+ @param conn_id  Connection ID
+
+ @return bool  true for a virtual connection
+ */
+static bool app_gatt_loadgen_owns(uint16_t conn_id)
+{
+    return (app_gatt_loadgen_running) &&
+           (APP_GATT_LOADGEN_CONN_ID_BASE <= conn_id) &&
+           ((uint32_t)(conn_id - APP_GATT_LOADGEN_CONN_ID_BASE) < app_gatt_loadgen_cfg.conns);
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_complete
+
+ Function Description:
+ @brief  Sink callback, runs in the context that sends the response: the
+         generator task when requests are handled inline, the GATT worker
+         otherwise. Notifications are only counted.
+
+ @param conn_id  Connection ID
+ @param opcode   Opcode of the request, GATT_HANDLE_VALUE_NOTIF for a
+                 notification
+ @param status   Status of the response
+
+ @return void
+ */
+static void app_gatt_loadgen_complete(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                                      wiced_bt_gatt_status_t status)
+{
+    uint32_t index = conn_id - APP_GATT_LOADGEN_CONN_ID_BASE;
+
+    taskENTER_CRITICAL();
+    if (GATT_HANDLE_VALUE_NOTIF == opcode)
+    {
+        app_gatt_loadgen_notifications++;
+    }
+    else if (!app_gatt_loadgen_conns[index].busy)
+    {
+        /* Response after the timeout */
+        app_gatt_loadgen_late++;
+    }
+    else
+    {
+        app_gatt_loadgen_record(index, WICED_BT_GATT_SUCCESS == status);
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_compare
+
+ Function Description:
+ @brief  qsort() comparison of two latencies.
+
+ @param p_a  First latency
+ @param p_b  Second latency
+
+ @return int  Order of the latencies
+ */
+static int app_gatt_loadgen_compare(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_report
+
+ Function Description:
+ @brief  Prints the throughput, the failures, the latency percentiles of
+         each operation over its last APP_GATT_LOADGEN_LATENCY_SAMPLES
+         completions, and the buffer and heap peaks of the run.
+
+ @param elapsed_ms  Duration of the load, without waiting for the last
+                    responses
+
+ @return void
+ */
+static void app_gatt_loadgen_report(uint32_t elapsed_ms)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    app_memory_buffer_stats_t buffer_stats;
+    uint32_t completed = 0;
+    uint32_t failed = 0;
+    uint32_t issued = 0;
+    uint32_t count;
+    uint32_t op;
+
+    for (op = 0; op < APP_GATT_LOADGEN_OP_COUNT; op++)
+    {
+        issued += app_gatt_loadgen_ops[op].issued;
+        completed += app_gatt_loadgen_ops[op].completed;
+        failed += app_gatt_loadgen_ops[op].failed;
+    }
+    elapsed_ms = (0 == elapsed_ms) ? 1 : elapsed_ms;
+
+    printf("GATT load: %lu connections, %lu req/s for %lu s\n",
+           (unsigned long)app_gatt_loadgen_cfg.conns,
+           (unsigned long)app_gatt_loadgen_cfg.rate,
+           (unsigned long)app_gatt_loadgen_cfg.seconds);
+    printf("  issued %lu, completed %lu (%lu.%lu/s), failed %lu (%lu timed out, "
+           "%lu late), skipped busy %lu, notifications %lu\n",
+           (unsigned long)issued, (unsigned long)completed,
+           (unsigned long)((completed * 1000ull) / elapsed_ms),
+           (unsigned long)(((completed * 10000ull) / elapsed_ms) % 10u),
+           (unsigned long)failed, (unsigned long)app_gatt_loadgen_timeouts,
+           (unsigned long)app_gatt_loadgen_late, (unsigned long)app_gatt_loadgen_skipped,
+           (unsigned long)app_gatt_loadgen_notifications);
+
+    printf("  %-12s %7s %7s %6s %8s %8s %8s %8s\n", "operation", "issued", "done",
+           "failed", "p50 us", "p90 us", "p99 us", "max us");
+    for (op = 0; op < APP_GATT_LOADGEN_OP_COUNT; op++)
+    {
+        const app_gatt_loadgen_op_stats_t *p_op = &app_gatt_loadgen_ops[op];
+
+        count = (APP_GATT_LOADGEN_LATENCY_SAMPLES < p_op->sample_count)
+                ? APP_GATT_LOADGEN_LATENCY_SAMPLES : p_op->sample_count;
+        if (0 == count)
+        {
+            printf("  %-12s %7lu %7lu %6lu\n", app_gatt_loadgen_op_names[op],
+                   (unsigned long)p_op->issued, (unsigned long)p_op->completed,
+                   (unsigned long)p_op->failed);
+            continue;
+        }
+
+        memcpy(app_gatt_loadgen_sorted, p_op->samples, count * sizeof(uint32_t));
+        qsort(app_gatt_loadgen_sorted, count, sizeof(uint32_t), app_gatt_loadgen_compare);
+        printf("  %-12s %7lu %7lu %6lu %8lu %8lu %8lu %8lu\n", app_gatt_loadgen_op_names[op],
+               (unsigned long)p_op->issued, (unsigned long)p_op->completed,
+               (unsigned long)p_op->failed,
+               (unsigned long)(app_gatt_loadgen_sorted[(count * 50u) / 100u] / cycles_per_us),
+               (unsigned long)(app_gatt_loadgen_sorted[(count * 90u) / 100u] / cycles_per_us),
+               (unsigned long)(app_gatt_loadgen_sorted[(count * 99u) / 100u] / cycles_per_us),
+               (unsigned long)(p_op->max_cycles / cycles_per_us));
+    }
+
+    app_memory_get_buffer_stats(&buffer_stats, false);
+    printf("  response buffers: peak %lu in use, %lu allocation failures\n",
+           (unsigned long)buffer_stats.peak, (unsigned long)buffer_stats.fails);
+#if APP_HEAP_TRACE
+    {
+        app_heap_trace_stats_t heap_stats;
+
+        app_heap_trace_get_stats(&heap_stats);
+        printf("  heap: peak %lu bytes in %lu blocks, %lu failed allocations\n",
+               (unsigned long)heap_stats.peak_bytes, (unsigned long)heap_stats.peak_blocks,
+               (unsigned long)heap_stats.fail_count);
+    }
+#elif (configHEAP_ALLOCATION_SCHEME != HEAP_ALLOCATION_TYPE3)
+    printf("  heap: %lu bytes free, minimum ever %lu\n",
+           (unsigned long)xPortGetFreeHeapSize(),
+           (unsigned long)xPortGetMinimumEverFreeHeapSize());
+#else
+    printf("  heap: build with APP_HEAP_TRACE=1 for the heap peak\n");
+#endif
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_parse_mix
+
+ Function Description:
+ @brief  Parses an operation mix, letters followed by weights, e.g. "r8w1".
+         m MTU exchange, t read by type, r read, w CCCD write, d disconnect.
+         Operations not listed have weight 0.
+
+ @param p_mix  Mix string
+
+ @return bool  false if the mix is invalid or empty
+ */
+static bool app_gatt_loadgen_parse_mix(const char *p_mix)
+{
+    app_gatt_loadgen_cfg_t *p_cfg = &app_gatt_loadgen_cfg;
+    char *p_end;
+    uint32_t weight;
+    uint32_t op;
+
+    memset(p_cfg->weights, 0, sizeof(p_cfg->weights));
+    p_cfg->weight_total = 0;
+
+    while ('\0' != *p_mix)
+    {
+        for (op = APP_GATT_LOADGEN_MTU; op < APP_GATT_LOADGEN_OP_COUNT; op++)
+        {
+            if (app_gatt_loadgen_op_letters[op] == *p_mix)
+            {
+                break;
+            }
+        }
+        weight = strtoul(p_mix + 1, &p_end, 10);
+        if ((APP_GATT_LOADGEN_OP_COUNT == op) || (p_end == (p_mix + 1)) || (255u < weight))
+        {
+            return false;
+        }
+        p_cfg->weight_total += weight - p_cfg->weights[op];
+        p_cfg->weights[op] = (uint8_t)weight;
+        p_mix = p_end;
+    }
+
+    return (0 < p_cfg->weight_total);
+}
+
+/*
+ Function Name:
+ app_gatt_loadgen_cmd
+
+ Function Description:
+ @brief  Console command starting a load run. The run needs the server to
+         be idle, so it is refused while a central is connected.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_gatt_loadgen_cmd(uint32_t argc, char *argv[])
+{
+    app_gatt_loadgen_cfg_t *p_cfg = &app_gatt_loadgen_cfg;
+
+    if (app_gatt_loadgen_running)
+    {
+        printf("GATT load already running\n");
+        return;
+    }
+    if (0 != app_bt_conn_id)
+    {
+        printf("Disconnect the central first\n");
+        return;
+    }
+    if (4 > argc)
+    {
+        printf("Usage: gattload <conns> <req/s> <seconds> [mix]\n");
+        return;
+    }
+
+    p_cfg->conns = strtoul(argv[1], NULL, 0);
+    p_cfg->rate = strtoul(argv[2], NULL, 0);
+    p_cfg->seconds = strtoul(argv[3], NULL, 0);
+    if ((0 == p_cfg->conns) || (APP_GATT_LOADGEN_MAX_CONNS < p_cfg->conns) ||
+        (0 == p_cfg->rate) || (0 == p_cfg->seconds) || (3600u < p_cfg->seconds))
+    {
+        printf("Connections 1..%u, rate and seconds 1..3600\n",
+               (unsigned)APP_GATT_LOADGEN_MAX_CONNS);
+        return;
+    }
+    if (!app_gatt_loadgen_parse_mix((4 < argc) ? argv[4] : APP_GATT_LOADGEN_DEFAULT_MIX))
+    {
+        printf("Invalid mix, e.g. %s\n", APP_GATT_LOADGEN_DEFAULT_MIX);
+        return;
+    }
+
+    app_gatt_loadgen_running = true;
+    xTaskNotifyGive(app_gatt_loadgen_task_handle);
+}
+
+#endif /* APP_GATT_LOADGEN */
+
+/* [] END OF FILE */
@@ -0,0 +1,103 @@
+/*******************************************************************************
+* File Name: app_gatt_loadgen.h
+*
+* Description: This file contains the definitions of the GATT load generator,
+*              which drives the GATT server with the traffic of many simulated
+*              centrals.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_GATT_LOADGEN_H__
+#define __APP_GATT_LOADGEN_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_GATT_LOADGEN=1 in the Makefile to add the gattload
+ * console command.
+ */
+#ifndef APP_GATT_LOADGEN
+#define APP_GATT_LOADGEN                 (0u)
+#endif
+
+/* Number of virtual connections a run can use */
+#ifndef APP_GATT_LOADGEN_MAX_CONNS
+#define APP_GATT_LOADGEN_MAX_CONNS       (16u)
+#endif
+
+/* Connection ID of the first virtual connection. The stack hands out small
+ * IDs, so the virtual ones never collide with a real connection.
+ */
+#define APP_GATT_LOADGEN_CONN_ID_BASE    (0x4000u)
+
+/* Latencies kept per operation for the percentiles */
+#ifndef APP_GATT_LOADGEN_LATENCY_SAMPLES
+#define APP_GATT_LOADGEN_LATENCY_SAMPLES (64u)
+#endif
+
+/* A request not answered within this time counts as a failure */
+#define APP_GATT_LOADGEN_TIMEOUT_MS      (1000u)
+
+/* Operation mix when none is given: weights of MTU exchange, read by type,
+ * read, CCCD write and disconnect.
+ */
+#define APP_GATT_LOADGEN_DEFAULT_MIX     "m1t2r5w1d1"
+
+/* The generator task runs below the GATT worker so that deferred requests
+ * are processed while it injects. Raise the priority above the worker to
+ * fill the work queue the way a busy stack thread does.
+ */
+#define APP_GATT_LOADGEN_TASK_NAME       "GATT Load"
+#define APP_GATT_LOADGEN_STACK_SIZE      (configMINIMAL_STACK_SIZE * 4)
+#ifndef APP_GATT_LOADGEN_PRIORITY
+#define APP_GATT_LOADGEN_PRIORITY        (configMAX_PRIORITIES - 3)
+#endif
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_gatt_loadgen_init(void);
+
+#endif      /* __APP_GATT_LOADGEN_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,468 @@
+/*******************************************************************************
+* File Name: app_hci_snoop.c
+*
+* Description: This file contains the HCI snoop capture. HCI packets seen by
+*              the HCI trace are copied, truncated to a snap length, into a RAM
+*              ring with a timestamp. The cost of each capture is bounded by
+*              the snap length and measured. The snoop console command dumps
+*              the ring for tools/btsnoop_export.py, which writes a btsnoop
+*              file for standard analyzers.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_hci_snoop.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include "app_time.h"
+#include "cyhal.h"
+#include "wiced_bt_dev.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* Packet types of the H4 transport, as used by btsnoop datalink 1002 */
+#define APP_HCI_SNOOP_H4_COMMAND         (0x01u)
+#define APP_HCI_SNOOP_H4_ACL             (0x02u)
+#define APP_HCI_SNOOP_H4_EVENT           (0x04u)
+#define APP_HCI_SNOOP_H4_ISO             (0x05u)
+
+#define APP_HCI_SNOOP_ALIGN(len)         (((len) + 3u) & ~3u)
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+#if APP_HCI_SNOOP
+/* Record header in the ring, followed by the captured bytes padded to a
+ * multiple of 4.
+ */
+typedef struct
+{
+    uint32_t    time_ms;
+    uint16_t    orig_len;
+    uint8_t     h4_type;
+    uint8_t     cap_len : 7;
+    uint8_t     received : 1;
+} app_hci_snoop_rec_t;
+
+typedef struct
+{
+    uint32_t    packets;
+    uint32_t    truncated;
+    uint32_t    overwritten;
+    uint32_t    missed;
+    uint32_t    over_budget;
+    uint32_t    max_cycles;
+    uint64_t    total_cycles;
+} app_hci_snoop_stats_t;
+#endif
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+#if APP_HCI_SNOOP
+static uint8_t                  app_hci_snoop_ring[APP_HCI_SNOOP_RING_SIZE]
+                                __attribute__((aligned(4)));
+
+/* Free running byte offsets of the newest and the oldest record */
+static uint32_t                 app_hci_snoop_head;
+static uint32_t                 app_hci_snoop_tail;
+
+static app_hci_snoop_stats_t    app_hci_snoop_stats;
+
+static volatile bool            app_hci_snoop_enabled = true;
+
+/* Set while the ring is dumped; packets are then counted as missed */
+static volatile bool            app_hci_snoop_frozen;
+
+APP_MEMORY_FOOTPRINT(app_hci_snoop_ram_footprint,
+                     sizeof(app_hci_snoop_ring) + sizeof(app_hci_snoop_stats));
+#else
+APP_MEMORY_FOOTPRINT(app_hci_snoop_ram_footprint, 0);
+#endif
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+#if APP_HCI_SNOOP
+static void app_hci_snoop_trace(wiced_bt_hci_trace_type_t type,
+                                uint16_t length, uint8_t *p_data);
+
+static void app_hci_snoop_copy_in(uint32_t offset, const void *p_src, uint32_t len);
+
+static void app_hci_snoop_copy_out(uint32_t offset, void *p_dst, uint32_t len);
+#endif
+
+static void app_hci_snoop_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_hci_snoop_console_cmd =
+{
+    "snoop", "HCI capture; 'snoop dump' for the packets, 'snoop on|off|clear'",
+    app_hci_snoop_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_hci_snoop_init
+
+ Function Description:
+ @brief  Registers the snoop console command and, when built with
+         APP_HCI_SNOOP=1, starts capturing. Must be called once the
+         Bluetooth stack is enabled.
+
+ @param void
+
+ @return void
+ */
+void app_hci_snoop_init(void)
+{
+#if APP_HCI_SNOOP
+    CY_ASSERT(0 == (APP_HCI_SNOOP_RING_SIZE & (APP_HCI_SNOOP_RING_SIZE - 1u)));
+    CY_ASSERT(127u >= APP_HCI_SNOOP_SNAP_LEN);
+
+    app_bt_hci_trace_register(app_hci_snoop_trace);
+#endif
+    app_console_register_command(&app_hci_snoop_console_cmd);
+}
+
+#if APP_HCI_SNOOP
+/*
+ Function Name:
+ app_hci_snoop_trace
+
+ Function Description:
+ @brief  HCI trace observer, runs in the Bluetooth stack thread. Appends the
+         packet to the ring, overwriting the oldest packets if needed. The
+         work is bounded: at most APP_HCI_SNOOP_SNAP_LEN bytes are copied and
+         a record evicts at most a few older ones.
+
+ @param type    HCI packet type
+ @param length  Packet length
+ @param p_data  Packet
+
+ @return void
+ */
+static void app_hci_snoop_trace(wiced_bt_hci_trace_type_t type,
+                                uint16_t length, uint8_t *p_data)
+{
+    uint32_t start_cycles = app_cycle_counter_get();
+    uint32_t budget_cycles = APP_HCI_SNOOP_BUDGET_US * (SystemCoreClock / 1000000u);
+    app_hci_snoop_rec_t rec;
+    app_hci_snoop_rec_t old;
+    uint32_t rec_size;
+    uint32_t saved_intr;
+    uint32_t cycles;
+
+    if ((!app_hci_snoop_enabled) || (app_hci_snoop_frozen))
+    {
+        app_hci_snoop_stats.missed++;
+        return;
+    }
+
+    switch (type)
+    {
+    case HCI_TRACE_COMMAND:
+        rec.h4_type = APP_HCI_SNOOP_H4_COMMAND;
+        rec.received = 0;
+        break;
+    case HCI_TRACE_EVENT:
+        rec.h4_type = APP_HCI_SNOOP_H4_EVENT;
+        rec.received = 1;
+        break;
+    case HCI_TRACE_INCOMING_ACL_DATA:
+    case HCI_TRACE_OUTGOING_ACL_DATA:
+        rec.h4_type = APP_HCI_SNOOP_H4_ACL;
+        rec.received = (HCI_TRACE_INCOMING_ACL_DATA == type) ? 1 : 0;
+        break;
+    default:
+        rec.h4_type = APP_HCI_SNOOP_H4_ISO;
+        rec.received = (HCI_TRACE_INCOMING_ISO_DATA == type) ? 1 : 0;
+        break;
+    }
+    rec.time_ms = (uint32_t)app_uptime_ms_get();
+    rec.orig_len = length;
+    rec.cap_len = (APP_HCI_SNOOP_SNAP_LEN < length) ? APP_HCI_SNOOP_SNAP_LEN : length;
+    rec_size = sizeof(rec) + APP_HCI_SNOOP_ALIGN(rec.cap_len);
+
+    saved_intr = cyhal_system_critical_section_enter();
+    while ((APP_HCI_SNOOP_RING_SIZE - (app_hci_snoop_head - app_hci_snoop_tail)) < rec_size)
+    {
+        app_hci_snoop_copy_out(app_hci_snoop_tail, &old, sizeof(old));
+        app_hci_snoop_tail += sizeof(old) + APP_HCI_SNOOP_ALIGN(old.cap_len);
+        app_hci_snoop_stats.overwritten++;
+    }
+    app_hci_snoop_copy_in(app_hci_snoop_head, &rec, sizeof(rec));
+    app_hci_snoop_copy_in(app_hci_snoop_head + sizeof(rec), p_data, rec.cap_len);
+    app_hci_snoop_head += rec_size;
+    cyhal_system_critical_section_exit(saved_intr);
+
+    app_hci_snoop_stats.packets++;
+    if (rec.cap_len < length)
+    {
+        app_hci_snoop_stats.truncated++;
+    }
+
+    cycles = app_cycle_counter_get() - start_cycles;
+    app_hci_snoop_stats.total_cycles += cycles;
+    if (app_hci_snoop_stats.max_cycles < cycles)
+    {
+        app_hci_snoop_stats.max_cycles = cycles;
+    }
+    if (budget_cycles < cycles)
+    {
+        app_hci_snoop_stats.over_budget++;
+    }
+}
+
+/*
+ Function Name:
+ app_hci_snoop_copy_in
+
+ Function Description:
+ @brief  Copies bytes into the ring at a free running offset, wrapping at
+         the end of the ring.
+
+ @param offset  Free running offset
+ @param p_src   Bytes to copy
+ @param len     Number of bytes
+
+ @return void
+ */
+static void app_hci_snoop_copy_in(uint32_t offset, const void *p_src, uint32_t len)
+{
+    uint32_t pos = offset & (APP_HCI_SNOOP_RING_SIZE - 1u);
+    uint32_t first = APP_HCI_SNOOP_RING_SIZE - pos;
+
+    if (first >= len)
+    {
+        memcpy(&app_hci_snoop_ring[pos], p_src, len);
+    }
+    else
+    {
+        memcpy(&app_hci_snoop_ring[pos], p_src, first);
+        memcpy(app_hci_snoop_ring, (const uint8_t *)p_src + first, len - first);
+    }
+}
+
+/*
+ Function Name:
+ app_hci_snoop_copy_out
+
+ Function Description:
+ @brief  Copies bytes out of the ring from a free running offset, wrapping
+         at the end of the ring.
+
+ @param offset  Free running offset
+ @param p_dst   Destination
+ @param len     Number of bytes
+
+ @return void
+ */
+static void app_hci_snoop_copy_out(uint32_t offset, void *p_dst, uint32_t len)
+{
+    uint32_t pos = offset & (APP_HCI_SNOOP_RING_SIZE - 1u);
+    uint32_t first = APP_HCI_SNOOP_RING_SIZE - pos;
+
+    if (first >= len)
+    {
+        memcpy(p_dst, &app_hci_snoop_ring[pos], len);
+    }
+    else
+    {
+        memcpy(p_dst, &app_hci_snoop_ring[pos], first);
+        memcpy((uint8_t *)p_dst + first, app_hci_snoop_ring, len - first);
+    }
+}
+#endif /* APP_HCI_SNOOP */
+
+/*
+ Function Name:
+ app_hci_snoop_print_stats
+
+ Function Description:
+ @brief  Prints the capture counters and the cost of a capture.
+
+ @param void
+
+ @return void
+ */
+void app_hci_snoop_print_stats(void)
+{
+#if APP_HCI_SNOOP
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    app_hci_snoop_stats_t stats;
+    uint32_t used;
+    uint32_t saved_intr;
+
+    saved_intr = cyhal_system_critical_section_enter();
+    stats = app_hci_snoop_stats;
+    used = app_hci_snoop_head - app_hci_snoop_tail;
+    cyhal_system_critical_section_exit(saved_intr);
+
+    printf("HCI snoop %s: %lu packets, %lu truncated to %u bytes, %lu overwritten, "
+           "%lu missed\n", app_hci_snoop_enabled ? "on" : "off",
+           (unsigned long)stats.packets, (unsigned long)stats.truncated,
+           (unsigned)APP_HCI_SNOOP_SNAP_LEN, (unsigned long)stats.overwritten,
+           (unsigned long)stats.missed);
+    printf("  ring %lu of %u bytes used\n", (unsigned long)used,
+           (unsigned)APP_HCI_SNOOP_RING_SIZE);
+    if (0 != stats.packets)
+    {
+        printf("  capture: avg %lu cycles, max %lu cycles (%lu us), %lu over %u us\n",
+               (unsigned long)(stats.total_cycles / stats.packets),
+               (unsigned long)stats.max_cycles,
+               (unsigned long)(stats.max_cycles / cycles_per_us),
+               (unsigned long)stats.over_budget, (unsigned)APP_HCI_SNOOP_BUDGET_US);
+    }
+#else
+    printf("HCI snoop is disabled, build with APP_HCI_SNOOP=1\n");
+#endif
+}
+
+/*
+ Function Name:
+ app_hci_snoop_dump
+
+ Function Description:
+ @brief  Prints the captured packets, oldest first, one SNOOP P line each:
+         time in ms since boot, H4 packet type, direction (1 received from
+         the controller), original length and the captured bytes in hex.
+         The BEGIN line gives the time of the dump since boot and, if the
+         time is set, since 1970, to convert the timestamps. Capture is
+         paused during the dump.
+
+ @param void
+
+ @return void
+ */
+void app_hci_snoop_dump(void)
+{
+#if APP_HCI_SNOOP
+    uint8_t data[APP_HCI_SNOOP_SNAP_LEN];
+    app_hci_snoop_rec_t rec;
+    uint32_t saved_intr;
+    uint32_t offset;
+    uint32_t i;
+
+    app_hci_snoop_frozen = true;
+    /* The capture runs in a critical section, so none is in progress after
+     * this one */
+    saved_intr = cyhal_system_critical_section_enter();
+    cyhal_system_critical_section_exit(saved_intr);
+
+    printf("SNOOP BEGIN now_ms=%lu epoch_ms=%llu snap=%u packets=%lu overwritten=%lu\n",
+           (unsigned long)app_uptime_ms_get(),
+           (unsigned long long)(app_time_is_set() ? app_time_now_ms() : 0u),
+           (unsigned)APP_HCI_SNOOP_SNAP_LEN, (unsigned long)app_hci_snoop_stats.packets,
+           (unsigned long)app_hci_snoop_stats.overwritten);
+
+    for (offset = app_hci_snoop_tail; offset != app_hci_snoop_head;
+         offset += sizeof(rec) + APP_HCI_SNOOP_ALIGN(rec.cap_len))
+    {
+        app_hci_snoop_copy_out(offset, &rec, sizeof(rec));
+        app_hci_snoop_copy_out(offset + sizeof(rec), data, rec.cap_len);
+
+        printf("SNOOP P %lu %u %u %u ", (unsigned long)rec.time_ms, rec.h4_type,
+               rec.received, rec.orig_len);
+        for (i = 0; i < rec.cap_len; i++)
+        {
+            printf("%02x", data[i]);
+        }
+        printf("\n");
+    }
+
+    printf("SNOOP END missed=%lu\n", (unsigned long)app_hci_snoop_stats.missed);
+    app_hci_snoop_frozen = false;
+#else
+    printf("HCI snoop is disabled, build with APP_HCI_SNOOP=1\n");
+#endif
+}
+
+/*
+ Function Name:
+ app_hci_snoop_cmd
+
+ Function Description:
+ @brief  "snoop" console command.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_hci_snoop_cmd(uint32_t argc, char *argv[])
+{
+#if APP_HCI_SNOOP
+    uint32_t saved_intr;
+
+    if ((2 <= argc) && (0 == strcmp(argv[1], "on")))
+    {
+        app_hci_snoop_enabled = true;
+    }
+    else if ((2 <= argc) && (0 == strcmp(argv[1], "off")))
+    {
+        app_hci_snoop_enabled = false;
+    }
+    else if ((2 <= argc) && (0 == strcmp(argv[1], "clear")))
+    {
+        saved_intr = cyhal_system_critical_section_enter();
+        app_hci_snoop_tail = app_hci_snoop_head;
+        memset(&app_hci_snoop_stats, 0, sizeof(app_hci_snoop_stats));
+        cyhal_system_critical_section_exit(saved_intr);
+    }
+    else if ((2 <= argc) && (0 == strcmp(argv[1], "dump")))
+    {
+        app_hci_snoop_dump();
+        return;
+    }
+#endif
+
+    app_hci_snoop_print_stats();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,94 @@
+/*******************************************************************************
+* File Name: app_hci_snoop.h
+*
+* Description: This file contains the definitions of the HCI snoop capture, a
+*              RAM ring of timestamped HCI packets that is exported in the
+*              btsnoop format.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_HCI_SNOOP_H__
+#define __APP_HCI_SNOOP_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_HCI_SNOOP=1 in the Makefile to capture the HCI
+ * traffic. The snoop console command prints the capture and its cost, and
+ * 'snoop dump' the packets for tools/btsnoop_export.py.
+ */
+#ifndef APP_HCI_SNOOP
+#define APP_HCI_SNOOP                    (0u)
+#endif
+
+/* Size of the capture ring in bytes, a power of two. The oldest packets are
+ * overwritten when it is full.
+ */
+#ifndef APP_HCI_SNOOP_RING_SIZE
+#define APP_HCI_SNOOP_RING_SIZE          (4096u)
+#endif
+
+/* Bytes kept of each packet. The default keeps the HCI and L2CAP headers
+ * and the start of the ATT PDU; up to 127.
+ */
+#ifndef APP_HCI_SNOOP_SNAP_LEN
+#define APP_HCI_SNOOP_SNAP_LEN           (32u)
+#endif
+
+/* Capture time per packet above which it is counted as over budget */
+#ifndef APP_HCI_SNOOP_BUDGET_US
+#define APP_HCI_SNOOP_BUDGET_US          (5u)
+#endif
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_hci_snoop_init(void);
+
+void app_hci_snoop_print_stats(void);
+
+void app_hci_snoop_dump(void);
+
+#endif      /* __APP_HCI_SNOOP_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,539 @@
+/*******************************************************************************
+* File Name: app_heap_trace.c
+*
+* Description: This file contains the heap instrumentation layer.
+*              pvPortMalloc() and vPortFree() are wrapped at link time to
+*              record call site, size and lifetime of every block.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_heap_trace.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include "cyhal.h"
+#include <task.h>
+#include <stdio.h>
+#include <string.h>
+#if (configHEAP_ALLOCATION_SCHEME == HEAP_ALLOCATION_TYPE3)
+#include <malloc.h>
+
+/* glibc 2.33 deprecates mallinfo() for mallinfo2(), whose counters do not
+ * wrap at 2 GiB; newlib of the Arm toolchain only has mallinfo() */
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+#define APP_HEAP_TRACE_MALLINFO_T        struct mallinfo2
+#define APP_HEAP_TRACE_MALLINFO()        mallinfo2()
+#else
+#define APP_HEAP_TRACE_MALLINFO_T        struct mallinfo
+#define APP_HEAP_TRACE_MALLINFO()        mallinfo()
+#endif
+#endif
+
+#if APP_HEAP_TRACE
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* A block that is currently allocated */
+typedef struct
+{
+    uint32_t    addr;
+    uint32_t    site;
+    uint32_t    tick;
+    uint32_t    size;
+} app_heap_trace_live_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* All state is zero initialized so that allocations made before
+ * app_heap_trace_init(), e.g. by wiced_bt_stack_init(), are recorded too.
+ */
+static app_heap_trace_rec_t     app_heap_trace_ring[APP_HEAP_TRACE_RING_SIZE];
+static uint32_t                 app_heap_trace_ring_count;
+
+static app_heap_trace_live_t    app_heap_trace_live[APP_HEAP_TRACE_LIVE_SIZE];
+
+static app_heap_trace_stats_t   app_heap_trace_stats;
+
+APP_MEMORY_FOOTPRINT(app_heap_trace_ram_footprint,
+                     sizeof(app_heap_trace_ring) + sizeof(app_heap_trace_live) +
+                     sizeof(app_heap_trace_stats));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+void *__real_pvPortMalloc(size_t size);
+void __real_vPortFree(void *pv);
+
+void *__wrap_pvPortMalloc(size_t size);
+void __wrap_vPortFree(void *pv);
+
+static void app_heap_trace_record(uint32_t kind, uint32_t site, uint32_t addr,
+                                  uint32_t size, uint32_t tick);
+
+static TickType_t app_heap_trace_now(void);
+#else
+APP_MEMORY_FOOTPRINT(app_heap_trace_ram_footprint, 0);
+#endif
+
+static void app_heap_trace_print_heap(void);
+
+static void app_heap_trace_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_heap_trace_console_cmd =
+{
+    "heap", "Heap statistics; 'heap dump' for the trace, 'heap reset' for peaks",
+    app_heap_trace_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_heap_trace_init
+
+ Function Description:
+ @brief  Registers the heap console command. Tracing itself starts with the
+         first allocation and needs no initialization.
+
+ @param void
+
+ @return void
+ */
+void app_heap_trace_init(void)
+{
+    app_console_register_command(&app_heap_trace_console_cmd);
+}
+
+#if APP_HEAP_TRACE
+/*
+ Function Name:
+ __wrap_pvPortMalloc
+
+ Function Description:
+ @brief  Replaces pvPortMalloc() at link time. Calls the allocator of the
+         selected heap scheme and records the block.
+
+ @param size  Number of bytes requested
+
+ @return void*  Block returned by the allocator
+ */
+void *__wrap_pvPortMalloc(size_t size)
+{
+    uint32_t site = (uint32_t)(uintptr_t)__builtin_return_address(0);
+    void *p_block = __real_pvPortMalloc(size);
+    uint32_t tick = app_heap_trace_now();
+    uint32_t saved_intr;
+    uint32_t i;
+
+    saved_intr = cyhal_system_critical_section_enter();
+
+    if (NULL == p_block)
+    {
+        app_heap_trace_stats.fail_count++;
+        app_heap_trace_record(APP_HEAP_TRACE_FAIL, site, 0, size, tick);
+        cyhal_system_critical_section_exit(saved_intr);
+        return NULL;
+    }
+
+    app_heap_trace_stats.alloc_count++;
+    app_heap_trace_stats.live_blocks++;
+    app_heap_trace_stats.live_bytes += size;
+    if (app_heap_trace_stats.live_bytes > app_heap_trace_stats.peak_bytes)
+    {
+        app_heap_trace_stats.peak_bytes = app_heap_trace_stats.live_bytes;
+    }
+    if (app_heap_trace_stats.live_blocks > app_heap_trace_stats.peak_blocks)
+    {
+        app_heap_trace_stats.peak_blocks = app_heap_trace_stats.live_blocks;
+    }
+
+    for (i = 0; i < APP_HEAP_TRACE_LIVE_SIZE; i++)
+    {
+        if (0 == app_heap_trace_live[i].addr)
+        {
+            app_heap_trace_live[i].addr = (uint32_t)(uintptr_t)p_block;
+            app_heap_trace_live[i].site = site;
+            app_heap_trace_live[i].tick = tick;
+            app_heap_trace_live[i].size = size;
+            break;
+        }
+    }
+
+    app_heap_trace_record(APP_HEAP_TRACE_ALLOC, site, (uint32_t)(uintptr_t)p_block,
+                          size, tick);
+
+    cyhal_system_critical_section_exit(saved_intr);
+
+    return p_block;
+}
+
+/*
+ Function Name:
+ __wrap_vPortFree
+
+ Function Description:
+ @brief  Replaces vPortFree() at link time. Records the free with the
+         lifetime of the block and releases it.
+
+ @param pv  Block to free
+
+ @return void
+ */
+void __wrap_vPortFree(void *pv)
+{
+    uint32_t site = (uint32_t)(uintptr_t)__builtin_return_address(0);
+    uint32_t addr = (uint32_t)(uintptr_t)pv;
+    uint32_t tick = app_heap_trace_now();
+    uint32_t saved_intr;
+    uint32_t i;
+
+    if (NULL == pv)
+    {
+        return;
+    }
+
+    saved_intr = cyhal_system_critical_section_enter();
+
+    app_heap_trace_stats.free_count++;
+
+    for (i = 0; i < APP_HEAP_TRACE_LIVE_SIZE; i++)
+    {
+        if (addr == app_heap_trace_live[i].addr)
+        {
+            break;
+        }
+    }
+
+    if (APP_HEAP_TRACE_LIVE_SIZE > i)
+    {
+        app_heap_trace_stats.live_blocks--;
+        app_heap_trace_stats.live_bytes -= app_heap_trace_live[i].size;
+        app_heap_trace_record(APP_HEAP_TRACE_FREE, site, addr,
+                              app_heap_trace_live[i].size,
+                              tick - app_heap_trace_live[i].tick);
+        app_heap_trace_live[i].addr = 0;
+    }
+    else
+    {
+        /* The size of the block is unknown, the live counters drift until
+         * the peak is reset. Increase APP_HEAP_TRACE_LIVE_SIZE if this happens.
+         */
+        app_heap_trace_stats.untracked_count++;
+        app_heap_trace_record(APP_HEAP_TRACE_FREE, site, addr, 0, 0);
+    }
+
+    cyhal_system_critical_section_exit(saved_intr);
+
+    __real_vPortFree(pv);
+}
+
+/*
+ Function Name:
+ app_heap_trace_record
+
+ Function Description:
+ @brief  Appends a record to the trace ring. Called with interrupts disabled.
+
+ @param kind  APP_HEAP_TRACE_ALLOC, APP_HEAP_TRACE_FREE or APP_HEAP_TRACE_FAIL
+ @param site  Return address of the caller
+ @param addr  Block address
+ @param size  Block size
+ @param tick  Allocation tick, or lifetime in ticks for a free
+
+ @return void
+ */
+static void app_heap_trace_record(uint32_t kind, uint32_t site, uint32_t addr,
+                                  uint32_t size, uint32_t tick)
+{
+    app_heap_trace_rec_t *p_rec;
+
+    p_rec = &app_heap_trace_ring[app_heap_trace_ring_count % APP_HEAP_TRACE_RING_SIZE];
+    p_rec->site = site;
+    p_rec->addr = addr;
+    p_rec->tick = tick;
+    p_rec->size = (0xFFFFu < size) ? 0xFFFFu : (uint16_t)size;
+    p_rec->kind = (uint16_t)kind;
+
+    app_heap_trace_ring_count++;
+}
+
+/*
+ Function Name:
+ app_heap_trace_now
+
+ Function Description:
+ @brief  Returns the tick count, or 0 before the scheduler is started.
+
+ @param void
+
+ @return TickType_t  Current tick count
+ */
+static TickType_t app_heap_trace_now(void)
+{
+    if (taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState())
+    {
+        return 0;
+    }
+
+    return (0 != __get_IPSR()) ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+}
+#endif /* APP_HEAP_TRACE */
+
+/*
+ Function Name:
+ app_heap_trace_get_stats
+
+ Function Description:
+ @brief  Returns a consistent copy of the heap counters.
+
+ @param p_stats  Destination of the counters
+
+ @return void
+ */
+void app_heap_trace_get_stats(app_heap_trace_stats_t *p_stats)
+{
+#if APP_HEAP_TRACE
+    uint32_t saved_intr = cyhal_system_critical_section_enter();
+
+    *p_stats = app_heap_trace_stats;
+    cyhal_system_critical_section_exit(saved_intr);
+#else
+    memset(p_stats, 0, sizeof(*p_stats));
+#endif
+}
+
+/*
+ Function Name:
+ app_heap_trace_reset_peak
+
+ Function Description:
+ @brief  Restarts the peak measurement from the current live values, e.g.
+         to measure the peak of one workload.
+
+ @param void
+
+ @return void
+ */
+void app_heap_trace_reset_peak(void)
+{
+#if APP_HEAP_TRACE
+    uint32_t saved_intr = cyhal_system_critical_section_enter();
+
+    app_heap_trace_stats.peak_bytes = app_heap_trace_stats.live_bytes;
+    app_heap_trace_stats.peak_blocks = app_heap_trace_stats.live_blocks;
+    cyhal_system_critical_section_exit(saved_intr);
+#endif
+}
+
+/*
+ Function Name:
+ app_heap_trace_print_heap
+
+ Function Description:
+ @brief  Prints the state of the heap as reported by the selected heap
+         scheme, in the dump format. heap_3 can't report the largest free
+         block, it is printed as 0.
+
+ @param void
+
+ @return void
+ */
+static void app_heap_trace_print_heap(void)
+{
+#if (configHEAP_ALLOCATION_SCHEME == HEAP_ALLOCATION_TYPE4) || \
+    (configHEAP_ALLOCATION_SCHEME == HEAP_ALLOCATION_TYPE5)
+    HeapStats_t heap_stats;
+
+    vPortGetHeapStats(&heap_stats);
+    printf("HEAP H free=%lu largest=%lu free_blocks=%lu min_free=%lu\n",
+           (unsigned long)heap_stats.xAvailableHeapSpaceInBytes,
+           (unsigned long)heap_stats.xSizeOfLargestFreeBlockInBytes,
+           (unsigned long)heap_stats.xNumberOfFreeBlocks,
+           (unsigned long)heap_stats.xMinimumEverFreeBytesRemaining);
+#elif (configHEAP_ALLOCATION_SCHEME == HEAP_ALLOCATION_TYPE3)
+    APP_HEAP_TRACE_MALLINFO_T heap_info = APP_HEAP_TRACE_MALLINFO();
+
+    printf("HEAP H free=%lu largest=0 free_blocks=%lu min_free=0\n",
+           (unsigned long)heap_info.fordblks, (unsigned long)heap_info.ordblks);
+#endif
+}
+
+/*
+ Function Name:
+ app_heap_trace_print_stats
+
+ Function Description:
+ @brief  Prints the heap counters and the fragmentation of the free space.
+
+ @param void
+
+ @return void
+ */
+void app_heap_trace_print_stats(void)
+{
+    app_heap_trace_stats_t stats;
+
+    app_heap_trace_get_stats(&stats);
+
+    printf("Heap scheme heap_%d, tracing %s\n", configHEAP_ALLOCATION_SCHEME,
+           APP_HEAP_TRACE ? "on" : "off");
+    printf("  live %lu bytes in %lu blocks, peak %lu bytes in %lu blocks\n",
+           (unsigned long)stats.live_bytes, (unsigned long)stats.live_blocks,
+           (unsigned long)stats.peak_bytes, (unsigned long)stats.peak_blocks);
+    printf("  allocs %lu, frees %lu, failed %lu, untracked frees %lu\n",
+           (unsigned long)stats.alloc_count, (unsigned long)stats.free_count,
+           (unsigned long)stats.fail_count, (unsigned long)stats.untracked_count);
+    app_heap_trace_print_heap();
+    app_memory_print_post_boot_allocs();
+}
+
+/*
+ Function Name:
+ app_heap_trace_dump
+
+ Function Description:
+ @brief  Prints the counters, the trace ring from oldest to newest and the
+         live blocks. The output is parsed by tools/heap_report.py; all lines
+         start with "HEAP " so the dump can be cut from a full UART log.
+
+ @param void
+
+ @return void
+ */
+void app_heap_trace_dump(void)
+{
+#if APP_HEAP_TRACE
+    static const char kind_tag[] = { 'A', 'F', 'X' };
+    app_heap_trace_stats_t stats;
+    app_heap_trace_rec_t rec;
+    app_heap_trace_live_t live;
+    uint32_t saved_intr;
+    uint32_t count;
+    uint32_t first;
+    uint32_t i;
+
+    app_heap_trace_get_stats(&stats);
+
+    /* Records keep being added while the dump is printed; the newest ones
+     * may overwrite the oldest, which only shortens the dumped history.
+     */
+    count = app_heap_trace_ring_count;
+    first = (APP_HEAP_TRACE_RING_SIZE < count) ? (count - APP_HEAP_TRACE_RING_SIZE) : 0;
+
+    printf("HEAP BEGIN scheme=%d tick_hz=%lu ring=%u records=%lu\n",
+           configHEAP_ALLOCATION_SCHEME, (unsigned long)configTICK_RATE_HZ,
+           (unsigned)APP_HEAP_TRACE_RING_SIZE, (unsigned long)count);
+    printf("HEAP S live=%lu peak=%lu live_blocks=%lu peak_blocks=%lu "
+           "allocs=%lu frees=%lu fails=%lu untracked=%lu\n",
+           (unsigned long)stats.live_bytes, (unsigned long)stats.peak_bytes,
+           (unsigned long)stats.live_blocks, (unsigned long)stats.peak_blocks,
+           (unsigned long)stats.alloc_count, (unsigned long)stats.free_count,
+           (unsigned long)stats.fail_count, (unsigned long)stats.untracked_count);
+    app_heap_trace_print_heap();
+
+    for (i = first; i < count; i++)
+    {
+        saved_intr = cyhal_system_critical_section_enter();
+        rec = app_heap_trace_ring[i % APP_HEAP_TRACE_RING_SIZE];
+        cyhal_system_critical_section_exit(saved_intr);
+
+        printf("HEAP %c %lu %08lx %08lx %u %lu\n", kind_tag[rec.kind],
+               (unsigned long)i, (unsigned long)rec.site, (unsigned long)rec.addr,
+               rec.size, (unsigned long)rec.tick);
+    }
+
+    for (i = 0; i < APP_HEAP_TRACE_LIVE_SIZE; i++)
+    {
+        saved_intr = cyhal_system_critical_section_enter();
+        live = app_heap_trace_live[i];
+        cyhal_system_critical_section_exit(saved_intr);
+
+        if (0 != live.addr)
+        {
+            printf("HEAP L %08lx %08lx %lu %lu\n", (unsigned long)live.site,
+                   (unsigned long)live.addr, (unsigned long)live.size,
+                   (unsigned long)live.tick);
+        }
+    }
+
+    printf("HEAP END now=%lu\n", (unsigned long)xTaskGetTickCount());
+#else
+    printf("Heap tracing is disabled, build with APP_HEAP_TRACE=1\n");
+#endif
+}
+
+/*
+ Function Name:
+ app_heap_trace_cmd
+
+ Function Description:
+ @brief  "heap" console command.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_heap_trace_cmd(uint32_t argc, char *argv[])
+{
+    if (1 == argc)
+    {
+        app_heap_trace_print_stats();
+    }
+    else if (0 == strcmp(argv[1], "dump"))
+    {
+        app_heap_trace_dump();
+    }
+    else if (0 == strcmp(argv[1], "reset"))
+    {
+        app_heap_trace_reset_peak();
+        printf("Heap peak reset\n");
+    }
+    else
+    {
+        printf("Usage: heap [dump|reset]\n");
+    }
+}
+
+/* [] END OF FILE */
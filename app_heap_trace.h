@@ -0,0 +1,126 @@
+/*******************************************************************************
+* File Name: app_heap_trace.h
+*
+* Description: This file contains the interface of the heap instrumentation
+*              layer: allocation trace ring, live and peak byte counters and
+*              the heap statistics dump.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_HEAP_TRACE_H__
+#define __APP_HEAP_TRACE_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_HEAP_TRACE=1 in the Makefile. The Makefile then links
+ * with --wrap=pvPortMalloc,--wrap=vPortFree so that every heap call of the
+ * application, the RTOS and the Bluetooth porting layer goes through this
+ * module.
+ */
+#ifndef APP_HEAP_TRACE
+#define APP_HEAP_TRACE                   (0u)
+#endif
+
+/* Number of allocation and free records kept. Older records are overwritten */
+#ifndef APP_HEAP_TRACE_RING_SIZE
+#define APP_HEAP_TRACE_RING_SIZE         (128u)
+#endif
+
+/* Number of live allocations whose size, call site and age are tracked.
+ * Frees of allocations that did not fit are counted as untracked.
+ */
+#ifndef APP_HEAP_TRACE_LIVE_SIZE
+#define APP_HEAP_TRACE_LIVE_SIZE         (64u)
+#endif
+
+/* Record kinds */
+#define APP_HEAP_TRACE_ALLOC             (0u)
+#define APP_HEAP_TRACE_FREE              (1u)
+#define APP_HEAP_TRACE_FAIL              (2u)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* One heap event. For a free, site is the caller of vPortFree() and tick
+ * holds the lifetime of the block in ticks.
+ */
+typedef struct
+{
+    uint32_t    site;
+    uint32_t    addr;
+    uint32_t    tick;
+    uint16_t    size;
+    uint8_t     kind;
+    uint8_t     seq;
+} app_heap_trace_rec_t;
+
+typedef struct
+{
+    uint32_t    live_bytes;
+    uint32_t    peak_bytes;
+    uint32_t    live_blocks;
+    uint32_t    peak_blocks;
+    uint32_t    alloc_count;
+    uint32_t    free_count;
+    uint32_t    fail_count;
+    uint32_t    untracked_count;
+} app_heap_trace_stats_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_heap_trace_init(void);
+
+void app_heap_trace_get_stats(app_heap_trace_stats_t *p_stats);
+
+void app_heap_trace_print_stats(void);
+
+void app_heap_trace_dump(void);
+
+void app_heap_trace_reset_peak(void);
+
+#endif      /* __APP_HEAP_TRACE_H__ */
+
+/* [] END OF FILE */
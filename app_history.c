@@ -0,0 +1,569 @@
+/*******************************************************************************
+* File Name: app_history.c
+*
+* Description: This file contains the compressed temperature history. Readings
+*              are stored as zig-zag varint deltas and timestamps as delta-of-
+*              delta in a ring of fixed-size blocks.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_history.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include "cyhal.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+#define APP_HISTORY_SLOT(seq)            ((seq) % APP_HISTORY_BLOCKS)
+
+/* Size of a reading without compression: sint16 value and uint32 time */
+#define APP_HISTORY_RAW_RECORD           (6u)
+
+/* Self-test of the reader: readings read before the open block grows,
+ * and readings in all, enough to fill more than two blocks */
+#define APP_HISTORY_CHECK_FIRST          (3u)
+#define APP_HISTORY_CHECK_READINGS       (63u)
+#define APP_HISTORY_CHECK_TIME_S(i)      (1000u + 5u * (i))
+#define APP_HISTORY_CHECK_VALUE(i)       ((int16_t)(2000 + (int32_t)((i) % 7u) - 3))
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static app_history_block_t  app_history_blocks[APP_HISTORY_BLOCKS];
+
+/* Blocks first_seq .. next_seq - 1 hold readings, the last one is open */
+static uint32_t             app_history_first_seq;
+static uint32_t             app_history_next_seq;
+
+/* Encoder state of the open block */
+static uint32_t             app_history_last_time_s;
+static int32_t              app_history_last_delta_s;
+static int16_t              app_history_last_value;
+
+/* Statistics */
+static uint32_t             app_history_readings;
+static uint32_t             app_history_dropped_blocks;
+static uint64_t             app_history_encode_cycles;
+
+APP_MEMORY_FOOTPRINT(app_history_ram_footprint, sizeof(app_history_blocks));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static uint32_t app_history_put_varint(uint8_t *p_buf, uint32_t value);
+
+static bool app_history_get_varint(const app_history_block_t *p_block, uint32_t *p_pos,
+                                   uint32_t *p_value);
+
+#if APP_HISTORY_SELFTEST
+static bool app_history_check(void);
+#endif
+
+static void app_history_print_stats(void);
+
+static void app_history_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_history_console_cmd =
+{
+    "history", "Temperature history usage, compression and codec cost; 'history dump'",
+    app_history_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_history_zigzag
+
+ Function Description:
+ @brief  Maps signed to unsigned values so that small magnitudes of both
+         signs get short varints: 0, -1, 1, -2, ... become 0, 1, 2, 3, ...
+
+ @param value  Signed value
+
+ @return uint32_t  Zig-zag encoded value
+ */
+static inline uint32_t app_history_zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/*
+ Function Name:
+ app_history_unzigzag
+
+ Function Description:
+ @brief  Inverse of app_history_zigzag().
+
+ @param value  Zig-zag encoded value
+
+ @return int32_t  Signed value
+ */
+static inline int32_t app_history_unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1u);
+}
+
+/*
+ Function Name:
+ app_history_init
+
+ Function Description:
+ @brief  Adds the "history" console command. The history is empty after
+         reset. With APP_HISTORY_SELFTEST the reader is checked first, on
+         the empty history, before the first reading is appended.
+
+ @param void
+
+ @return void
+ */
+void app_history_init(void)
+{
+#if APP_HISTORY_SELFTEST
+    if (!app_history_check())
+    {
+        CY_ASSERT(0);
+    }
+#endif
+    app_console_register_command(&app_history_console_cmd);
+}
+
+/*
+ Function Name:
+ app_history_append
+
+ Function Description:
+ @brief  Appends a reading. A new block is started when the encoded reading
+         does not fit in the open block; when all blocks are in use the
+         oldest one is dropped.
+
+ @param time_s  Time of the reading
+ @param value   Reading
+
+ @return void
+ */
+void app_history_append(uint32_t time_s, int16_t value)
+{
+    uint32_t start_cycles = app_cycle_counter_get();
+    uint8_t record[APP_HISTORY_MAX_RECORD];
+    app_history_block_t *p_block = NULL;
+    int32_t delta_s = 0;
+    uint32_t len = 0;
+
+    if (app_history_next_seq != app_history_first_seq)
+    {
+        p_block = &app_history_blocks[APP_HISTORY_SLOT(app_history_next_seq - 1u)];
+        delta_s = (int32_t)(time_s - app_history_last_time_s);
+        len = app_history_put_varint(record,
+                                     app_history_zigzag(delta_s - app_history_last_delta_s));
+        len += app_history_put_varint(&record[len],
+                                      app_history_zigzag((int32_t)value -
+                                                         app_history_last_value));
+        if ((APP_HISTORY_PAYLOAD_SIZE < (p_block->used + len)) || (UINT8_MAX == p_block->count) ||
+            (APP_HISTORY_MAX_STEP_S < delta_s) || (-APP_HISTORY_MAX_STEP_S > delta_s))
+        {
+            p_block = NULL;
+        }
+    }
+
+    /* Readers copy blocks in critical sections too */
+    taskENTER_CRITICAL();
+    if (NULL != p_block)
+    {
+        memcpy(&p_block->data[p_block->used], record, len);
+        p_block->used += (uint8_t)len;
+        p_block->count++;
+        app_history_last_delta_s = delta_s;
+    }
+    else
+    {
+        if (APP_HISTORY_BLOCKS == (app_history_next_seq - app_history_first_seq))
+        {
+            app_history_first_seq++;
+            app_history_dropped_blocks++;
+        }
+        p_block = &app_history_blocks[APP_HISTORY_SLOT(app_history_next_seq)];
+        p_block->time_s = time_s;
+        p_block->value = value;
+        p_block->count = 1;
+        p_block->used = 0;
+        app_history_next_seq++;
+        app_history_last_delta_s = 0;
+    }
+    app_history_last_time_s = time_s;
+    app_history_last_value = value;
+    app_history_readings++;
+    taskEXIT_CRITICAL();
+
+    app_history_encode_cycles += app_cycle_counter_get() - start_cycles;
+}
+
+/*
+ Function Name:
+ app_history_reader_start
+
+ Function Description:
+ @brief  Positions a reader at the oldest reading.
+
+ @param p_reader  Reader
+
+ @return void
+ */
+void app_history_reader_start(app_history_reader_t *p_reader)
+{
+    memset(p_reader, 0, sizeof(*p_reader));
+    p_reader->seq = app_history_first_seq;
+}
+
+/*
+ Function Name:
+ app_history_read
+
+ Function Description:
+ @brief  Returns the next reading in time order. Readings appended while
+         reading are returned too, including those added to the open block
+         after it was copied.
+
+ @param p_reader  Reader
+ @param p_time_s  Time of the reading
+ @param p_value   Reading
+
+ @return bool  false when all readings were returned
+ */
+bool app_history_read(app_history_reader_t *p_reader, uint32_t *p_time_s, int16_t *p_value)
+{
+    const app_history_block_t *p_stored;
+    uint32_t dod, delta;
+
+    while (!p_reader->valid || (p_reader->index == p_reader->block.count))
+    {
+        taskENTER_CRITICAL();
+        if (p_reader->seq < app_history_first_seq)
+        {
+            /* Dropped while reading, continue with the oldest block */
+            p_reader->seq = app_history_first_seq;
+            p_reader->valid = false;
+        }
+        else if (p_reader->valid && ((p_reader->seq + 1u) < app_history_next_seq) &&
+                 (app_history_blocks[APP_HISTORY_SLOT(p_reader->seq)].count ==
+                  p_reader->block.count))
+        {
+            /* The copied block was complete, readings appended to it after
+             * the copy are read before the next block */
+            p_reader->seq++;
+            p_reader->valid = false;
+        }
+        if (p_reader->seq >= app_history_next_seq)
+        {
+            taskEXIT_CRITICAL();
+            return false;
+        }
+        p_stored = &app_history_blocks[APP_HISTORY_SLOT(p_reader->seq)];
+        if (p_reader->valid && (p_stored->count == p_reader->block.count))
+        {
+            /* The open block did not grow */
+            taskEXIT_CRITICAL();
+            return false;
+        }
+        /* Blocks only grow at the end, the decoder state stays valid when
+         * the open block is copied again */
+        memcpy(&p_reader->block, p_stored, sizeof(p_reader->block));
+        taskEXIT_CRITICAL();
+
+        if (!p_reader->valid)
+        {
+            p_reader->index = 0;
+            p_reader->pos = 0;
+            p_reader->valid = true;
+        }
+    }
+
+    if (0 == p_reader->index)
+    {
+        p_reader->time_s = p_reader->block.time_s;
+        p_reader->value = p_reader->block.value;
+        p_reader->delta_s = 0;
+    }
+    else
+    {
+        if (!app_history_get_varint(&p_reader->block, &p_reader->pos, &dod) ||
+            !app_history_get_varint(&p_reader->block, &p_reader->pos, &delta))
+        {
+            /* Corrupt block, skip the rest of it */
+            p_reader->index = p_reader->block.count;
+            return app_history_read(p_reader, p_time_s, p_value);
+        }
+        p_reader->delta_s += app_history_unzigzag(dod);
+        p_reader->time_s += (uint32_t)p_reader->delta_s;
+        p_reader->value = (int16_t)(p_reader->value + app_history_unzigzag(delta));
+    }
+    p_reader->index++;
+
+    *p_time_s = p_reader->time_s;
+    *p_value = p_reader->value;
+    return true;
+}
+
+/*
+ Function Name:
+ app_history_put_varint
+
+ Function Description:
+ @brief  Writes a varint: 7 bits per byte, least significant group first,
+         bit 7 set on all bytes but the last.
+
+ @param p_buf  Output, at least 5 bytes
+ @param value  Value
+
+ @return uint32_t  Number of bytes written
+ */
+static uint32_t app_history_put_varint(uint8_t *p_buf, uint32_t value)
+{
+    uint32_t len = 0;
+
+    while (0x80u <= value)
+    {
+        p_buf[len++] = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    p_buf[len++] = (uint8_t)value;
+
+    return len;
+}
+
+/*
+ Function Name:
+ app_history_get_varint
+
+ Function Description:
+ @brief  Reads a varint from the payload of a block.
+
+ @param p_block  Block
+ @param p_pos    Read position, advanced past the varint
+ @param p_value  Value
+
+ @return bool  false if the varint runs past the used payload
+ */
+static bool app_history_get_varint(const app_history_block_t *p_block, uint32_t *p_pos,
+                                   uint32_t *p_value)
+{
+    uint32_t value = 0;
+    uint32_t shift = 0;
+    uint8_t byte;
+
+    do
+    {
+        if ((*p_pos >= p_block->used) || (28u < shift))
+        {
+            return false;
+        }
+        byte = p_block->data[(*p_pos)++];
+        value |= (uint32_t)(byte & 0x7Fu) << shift;
+        shift += 7u;
+    } while (0 != (byte & 0x80u));
+
+    *p_value = value;
+    return true;
+}
+
+/*
+ Function Name:
+ app_history_check
+
+ Function Description:
+ @brief  Checks the reader against a known series: a part of it is read
+         while the first block is open, the rest is appended across block
+         boundaries and must come back complete and in order. Runs on the
+         empty history and empties it again.
+
+ @param void
+
+ @return bool  false if a reading is missing or wrong
+ */
+#if APP_HISTORY_SELFTEST
+static bool app_history_check(void)
+{
+    app_history_reader_t reader;
+    uint32_t time_s;
+    int16_t value;
+    uint32_t read = 0;
+    uint32_t i;
+    bool ok = true;
+
+    for (i = 0; i < APP_HISTORY_CHECK_FIRST; i++)
+    {
+        app_history_append(APP_HISTORY_CHECK_TIME_S(i), APP_HISTORY_CHECK_VALUE(i));
+    }
+
+    app_history_reader_start(&reader);
+    while (ok && app_history_read(&reader, &time_s, &value))
+    {
+        ok = (APP_HISTORY_CHECK_TIME_S(read) == time_s) &&
+             (APP_HISTORY_CHECK_VALUE(read) == value);
+        read++;
+    }
+
+    for (; i < APP_HISTORY_CHECK_READINGS; i++)
+    {
+        app_history_append(APP_HISTORY_CHECK_TIME_S(i), APP_HISTORY_CHECK_VALUE(i));
+    }
+
+    while (ok && app_history_read(&reader, &time_s, &value))
+    {
+        ok = (APP_HISTORY_CHECK_TIME_S(read) == time_s) &&
+             (APP_HISTORY_CHECK_VALUE(read) == value);
+        read++;
+    }
+
+    if (!ok || (APP_HISTORY_CHECK_READINGS != read) || (2u > app_history_next_seq))
+    {
+        printf("History check failed at reading %lu of %u\n",
+               (unsigned long)read, (unsigned)APP_HISTORY_CHECK_READINGS);
+        ok = false;
+    }
+
+    app_history_first_seq = 0;
+    app_history_next_seq = 0;
+    app_history_readings = 0;
+    app_history_encode_cycles = 0;
+
+    return ok;
+}
+#endif
+
+/*
+ Function Name:
+ app_history_print_stats
+
+ Function Description:
+ @brief  Prints the history usage, the compression ratio against 6 byte
+         raw readings, and the encode and decode cost. The decode cost is
+         measured by reading the whole history.
+
+ @param void
+
+ @return void
+ */
+static void app_history_print_stats(void)
+{
+    app_history_reader_t reader;
+    uint32_t blocks = app_history_next_seq - app_history_first_seq;
+    uint32_t stored = 0;
+    uint32_t used = 0;
+    uint32_t start_cycles, decode_cycles;
+    uint32_t time_s;
+    int16_t value;
+    uint32_t i;
+
+    for (i = 0; i < blocks; i++)
+    {
+        used += APP_HISTORY_HEADER_SIZE +
+                app_history_blocks[APP_HISTORY_SLOT(app_history_first_seq + i)].used;
+    }
+
+    start_cycles = app_cycle_counter_get();
+    app_history_reader_start(&reader);
+    while (app_history_read(&reader, &time_s, &value))
+    {
+        stored++;
+    }
+    decode_cycles = app_cycle_counter_get() - start_cycles;
+
+    printf("History: %lu readings stored of %lu appended, %lu/%u blocks, %lu dropped\n",
+           (unsigned long)stored, (unsigned long)app_history_readings,
+           (unsigned long)blocks, (unsigned)APP_HISTORY_BLOCKS,
+           (unsigned long)app_history_dropped_blocks);
+    if (0 == stored)
+    {
+        return;
+    }
+    printf("  %lu bytes for %lu raw, ratio %lu.%02lu, %lu.%02lu bytes per reading\n",
+           (unsigned long)used, (unsigned long)(stored * APP_HISTORY_RAW_RECORD),
+           (unsigned long)((stored * APP_HISTORY_RAW_RECORD) / used),
+           (unsigned long)(((stored * APP_HISTORY_RAW_RECORD * 100u) / used) % 100u),
+           (unsigned long)(used / stored), (unsigned long)(((used * 100u) / stored) % 100u));
+    printf("  encode %lu cycles per reading, decode %lu cycles per reading\n",
+           (unsigned long)(app_history_encode_cycles / app_history_readings),
+           (unsigned long)(decode_cycles / stored));
+}
+
+/*
+ Function Name:
+ app_history_cmd
+
+ Function Description:
+ @brief  "history" console command. "history dump" prints the readings, one
+         "HIST <time_s> <value>" line each, for tools/history_bench.py.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_history_cmd(uint32_t argc, char *argv[])
+{
+    app_history_reader_t reader;
+    uint32_t time_s;
+    int16_t value;
+
+    if ((1 < argc) && (0 == strcmp(argv[1], "dump")))
+    {
+        app_history_reader_start(&reader);
+        while (app_history_read(&reader, &time_s, &value))
+        {
+            printf("HIST %lu %d\n", (unsigned long)time_s, value);
+        }
+        return;
+    }
+
+    app_history_print_stats();
+}
+
+/* [] END OF FILE */
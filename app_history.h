@@ -0,0 +1,121 @@
+/*******************************************************************************
+* File Name: app_history.h
+*
+* Description: This file contains the interface of the compressed temperature
+*              history, a ring of fixed-size blocks holding delta encoded
+*              readings and timestamps.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_HISTORY_H__
+#define __APP_HISTORY_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Block size and number of blocks. The oldest block is dropped when all
+ * blocks are full. tools/history_bench.py uses the same block format. */
+#define APP_HISTORY_BLOCK_SIZE           (64u)
+#define APP_HISTORY_BLOCKS               (32u)
+
+/* Block header: uint32 time, sint16 value, uint8 count, uint8 used */
+#define APP_HISTORY_HEADER_SIZE          (8u)
+#define APP_HISTORY_PAYLOAD_SIZE         (APP_HISTORY_BLOCK_SIZE - APP_HISTORY_HEADER_SIZE)
+
+/* A larger time step between readings, e.g. when the clock is set, starts
+ * a new block instead of being delta encoded */
+#define APP_HISTORY_MAX_STEP_S           (65535)
+
+/* Longest encoded reading: two 32-bit varints */
+#define APP_HISTORY_MAX_RECORD           (10u)
+
+/* Set to 1 to check the reader at boot, see app_history_init() */
+#ifndef APP_HISTORY_SELFTEST
+#define APP_HISTORY_SELFTEST             (0u)
+#endif
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* The first reading of a block is stored in the header. Every further
+ * reading is the varint of the zig-zag encoded delta-of-delta of the time,
+ * followed by the varint of the zig-zag encoded delta of the value. The
+ * time delta before the second reading of a block counts as 0. */
+typedef struct
+{
+    uint32_t    time_s;
+    int16_t     value;
+    uint8_t     count;
+    uint8_t     used;
+    uint8_t     data[APP_HISTORY_PAYLOAD_SIZE];
+} app_history_block_t;
+
+/* Sequential reader. It works on a copy of one block at a time, so the
+ * history can grow while it is read. Blocks dropped before the reader gets
+ * to them are skipped. */
+typedef struct
+{
+    app_history_block_t block;
+    uint32_t            seq;        /* Sequence number of the copied block */
+    uint32_t            index;      /* Readings of the block already returned */
+    uint32_t            pos;        /* Read position in the payload */
+    uint32_t            time_s;
+    int32_t             delta_s;
+    int16_t             value;
+    bool                valid;      /* A block is copied */
+} app_history_reader_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_history_init(void);
+
+void app_history_append(uint32_t time_s, int16_t value);
+
+void app_history_reader_start(app_history_reader_t *p_reader);
+
+bool app_history_read(app_history_reader_t *p_reader, uint32_t *p_time_s, int16_t *p_value);
+
+#endif      /* __APP_HISTORY_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,452 @@
+/*******************************************************************************
+* File Name: app_memory.c
+*
+* Description: This file contains the GATT buffer allocator, the static memory
+*              mode checks and the RAM footprint report of the application.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_memory.h"
+#include "cyhal.h"
+#include <task.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* Heap allocation after boot */
+typedef struct
+{
+    char        task_name[configMAX_TASK_NAME_LEN];
+    uint32_t    size;
+    TickType_t  tick;
+} app_memory_alloc_rec_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+#if APP_STATIC_MEMORY
+/* GATT response buffers, used instead of the heap in static memory mode */
+static uint8_t  app_gatt_buf_pool[APP_GATT_BUF_COUNT][APP_GATT_BUF_SIZE];
+static uint32_t app_gatt_buf_used_mask;
+
+APP_MEMORY_FOOTPRINT(app_memory_ram_footprint, sizeof(app_gatt_buf_pool));
+#endif
+
+#if (configHEAP_ALLOCATION_SCHEME == HEAP_ALLOCATION_TYPE5)
+/* heap_5 has no built-in heap array, the application provides the regions */
+static uint8_t app_heap_region[configTOTAL_HEAP_SIZE] __attribute__((aligned(8)));
+
+static const HeapRegion_t app_heap_regions[] =
+{
+    { app_heap_region, sizeof(app_heap_region) },
+    { NULL, 0 }
+};
+#endif
+
+/* Set once the application is initialized and advertising */
+static volatile bool     app_memory_boot_complete;
+
+/* GATT response buffer usage, updated in a critical section */
+static app_memory_buffer_stats_t app_memory_buffer_stats;
+
+/* Heap allocations seen after boot, the last ones in a ring */
+static volatile uint32_t app_memory_post_boot_allocs;
+static volatile uint32_t app_memory_post_boot_bytes;
+static app_memory_alloc_rec_t app_memory_post_boot_log[APP_MEMORY_POST_BOOT_LOG];
+
+APP_MEMORY_FOOTPRINT(app_memory_log_ram_footprint, sizeof(app_memory_post_boot_log));
+
+/* Footprint entries of the modules, see APP_MEMORY_FOOTPRINT */
+extern const app_memory_footprint_t app_ess_task_ram_footprint;
+extern const app_memory_footprint_t app_agg_ram_footprint;
+extern const app_memory_footprint_t app_console_ram_footprint;
+extern const app_memory_footprint_t app_ess_ram_footprint;
+extern const app_memory_footprint_t app_filter_ram_footprint;
+extern const app_memory_footprint_t app_flash_ram_footprint;
+extern const app_memory_footprint_t app_flash_log_ram_footprint;
+extern const app_memory_footprint_t app_gatt_dispatch_ram_footprint;
+extern const app_memory_footprint_t app_gatt_index_ram_footprint;
+extern const app_memory_footprint_t app_gatt_loadgen_ram_footprint;
+extern const app_memory_footprint_t app_gatt_tx_ram_footprint;
+extern const app_memory_footprint_t app_gatt_worker_ram_footprint;
+extern const app_memory_footprint_t app_hci_snoop_ram_footprint;
+extern const app_memory_footprint_t app_heap_trace_ram_footprint;
+extern const app_memory_footprint_t app_history_ram_footprint;
+extern const app_memory_footprint_t app_prep_write_ram_footprint;
+extern const app_memory_footprint_t app_soak_ram_footprint;
+extern const app_memory_footprint_t app_stats_ram_footprint;
+extern const app_memory_footprint_t app_stream_ram_footprint;
+extern const app_memory_footprint_t app_thermistor_ram_footprint;
+extern const app_memory_footprint_t app_time_ram_footprint;
+extern const app_memory_footprint_t app_trace_ram_footprint;
+
+static const app_memory_footprint_t * const app_memory_footprints[] =
+{
+    &app_ess_task_ram_footprint,
+    &app_agg_ram_footprint,
+    &app_console_ram_footprint,
+    &app_ess_ram_footprint,
+    &app_filter_ram_footprint,
+    &app_flash_ram_footprint,
+    &app_flash_log_ram_footprint,
+    &app_gatt_dispatch_ram_footprint,
+    &app_gatt_index_ram_footprint,
+    &app_gatt_loadgen_ram_footprint,
+    &app_gatt_tx_ram_footprint,
+    &app_gatt_worker_ram_footprint,
+    &app_hci_snoop_ram_footprint,
+    &app_heap_trace_ram_footprint,
+    &app_history_ram_footprint,
+    &app_prep_write_ram_footprint,
+    &app_soak_ram_footprint,
+    &app_stats_ram_footprint,
+    &app_stream_ram_footprint,
+    &app_thermistor_ram_footprint,
+    &app_time_ram_footprint,
+    &app_trace_ram_footprint,
+    &app_memory_log_ram_footprint,
+#if APP_STATIC_MEMORY
+    &app_memory_ram_footprint,
+#endif
+};
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_memory_count_buffer(bool success);
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_memory_heap_init
+
+ Function Description:
+ @brief  Prepares the FreeRTOS heap. Only heap_5 needs this, and it must be
+         done before the first pvPortMalloc(), i.e. before the BT stack is
+         initialized.
+
+ @param void
+
+ @return void
+ */
+void app_memory_heap_init(void)
+{
+#if (configHEAP_ALLOCATION_SCHEME == HEAP_ALLOCATION_TYPE5)
+    vPortDefineHeapRegions(app_heap_regions);
+#endif
+}
+
+/*
+ Function Name:
+ app_memory_init
+
+ Function Description:
+ @brief  Resets the buffer pool and the post boot heap counters.
+
+ @param void
+
+ @return void
+ */
+void app_memory_init(void)
+{
+#if APP_STATIC_MEMORY
+    app_gatt_buf_used_mask = 0;
+#endif
+    app_memory_boot_complete = false;
+    app_memory_post_boot_allocs = 0;
+    app_memory_post_boot_bytes = 0;
+}
+
+/*
+ Function Name:
+ app_memory_alloc_buffer
+
+ Function Description:
+ @brief  Allocates a GATT response buffer. In static memory mode the buffer
+         is taken from a fixed pool, otherwise from the FreeRTOS heap. Called
+         from both the stack thread and the GATT worker.
+
+ @param len  Number of bytes needed
+
+ @return void*  Pointer to the buffer, or NULL if none is available
+ */
+void *app_memory_alloc_buffer(size_t len)
+{
+#if APP_STATIC_MEMORY
+    void *p_buf = NULL;
+    uint32_t i;
+
+    if (APP_GATT_BUF_SIZE < len)
+    {
+        return NULL;
+    }
+
+    taskENTER_CRITICAL();
+    for (i = 0; i < APP_GATT_BUF_COUNT; i++)
+    {
+        if (0 == (app_gatt_buf_used_mask & (1u << i)))
+        {
+            app_gatt_buf_used_mask |= (1u << i);
+            p_buf = app_gatt_buf_pool[i];
+            break;
+        }
+    }
+    app_memory_count_buffer(NULL != p_buf);
+    taskEXIT_CRITICAL();
+
+    return p_buf;
+#else
+    void *p_buf = pvPortMalloc(len);
+
+    taskENTER_CRITICAL();
+    app_memory_count_buffer(NULL != p_buf);
+    taskEXIT_CRITICAL();
+
+    return p_buf;
+#endif
+}
+
+/*
+ Function Name:
+ app_memory_free_buffer
+
+ Function Description:
+ @brief  Releases a buffer allocated with app_memory_alloc_buffer().
+
+ @param p_buf  Pointer to the buffer
+
+ @return void
+ */
+void app_memory_free_buffer(void *p_buf)
+{
+#if APP_STATIC_MEMORY
+    uint32_t i = ((uint8_t *)p_buf - &app_gatt_buf_pool[0][0]) / APP_GATT_BUF_SIZE;
+
+    CY_ASSERT(APP_GATT_BUF_COUNT > i);
+
+    taskENTER_CRITICAL();
+    app_gatt_buf_used_mask &= ~(1u << i);
+    app_memory_buffer_stats.in_use--;
+    taskEXIT_CRITICAL();
+#else
+    vPortFree(p_buf);
+
+    taskENTER_CRITICAL();
+    app_memory_buffer_stats.in_use--;
+    taskEXIT_CRITICAL();
+#endif
+}
+
+/*
+ Function Name:
+ app_memory_get_buffer_stats
+
+ Function Description:
+ @brief  Reads the usage of the GATT response buffers.
+
+ @param p_stats     Receives the buffers in use, the most in use at once and
+                    the failed allocations
+ @param reset_peak  Restart the peak from the buffers in use
+
+ @return void
+ */
+void app_memory_get_buffer_stats(app_memory_buffer_stats_t *p_stats, bool reset_peak)
+{
+    taskENTER_CRITICAL();
+    *p_stats = app_memory_buffer_stats;
+    if (reset_peak)
+    {
+        app_memory_buffer_stats.peak = app_memory_buffer_stats.in_use;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_memory_count_buffer
+
+ Function Description:
+ @brief  Accounts an allocation attempt of a GATT response buffer. Called in
+         a critical section.
+
+ @param success  The allocation succeeded
+
+ @return void
+ */
+static void app_memory_count_buffer(bool success)
+{
+    if (!success)
+    {
+        app_memory_buffer_stats.fails++;
+        return;
+    }
+
+    app_memory_buffer_stats.in_use++;
+    if (app_memory_buffer_stats.peak < app_memory_buffer_stats.in_use)
+    {
+        app_memory_buffer_stats.peak = app_memory_buffer_stats.in_use;
+    }
+}
+
+/*
+ Function Name:
+ app_memory_boot_done
+
+ Function Description:
+ @brief  Marks the end of the application initialization. From here on, heap
+         allocations are counted and logged.
+
+ @param void
+
+ @return void
+ */
+void app_memory_boot_done(void)
+{
+    app_memory_boot_complete = true;
+}
+
+/*
+ Function Name:
+ app_memory_print_footprint
+
+ Function Description:
+ @brief  Prints the size of the statically allocated objects of every module
+         and the total.
+
+ @param void
+
+ @return void
+ */
+void app_memory_print_footprint(void)
+{
+    uint32_t total = 0;
+    uint32_t i;
+
+    printf("Application RAM footprint (%s memory mode)\n",
+           APP_STATIC_MEMORY ? "static" : "dynamic");
+    for (i = 0; i < (sizeof(app_memory_footprints) / sizeof(app_memory_footprints[0])); i++)
+    {
+        printf("  %-32s %6lu bytes\n", app_memory_footprints[i]->p_name,
+               (unsigned long)app_memory_footprints[i]->size);
+        total += app_memory_footprints[i]->size;
+    }
+    printf("  %-32s %6lu bytes\n", "total", (unsigned long)total);
+    app_memory_print_post_boot_allocs();
+}
+
+/*
+ Function Name:
+ app_memory_print_post_boot_allocs
+
+ Function Description:
+ @brief  Prints the number of heap allocations after boot and the last
+         APP_MEMORY_POST_BOOT_LOG of them, oldest first, with the task that
+         made them. In static memory mode each one is reported as an error:
+         the application does not use the heap, so they come from the BT
+         stack or the RTOS, and configTOTAL_HEAP_SIZE must cover them.
+
+ @param void
+
+ @return void
+ */
+void app_memory_print_post_boot_allocs(void)
+{
+    app_memory_alloc_rec_t rec;
+    uint32_t count = app_memory_post_boot_allocs;
+    uint32_t first = (APP_MEMORY_POST_BOOT_LOG < count) ? (count - APP_MEMORY_POST_BOOT_LOG) : 0;
+    uint32_t i;
+
+    printf("  heap allocations after boot: %lu (%lu bytes)\n",
+           (unsigned long)count, (unsigned long)app_memory_post_boot_bytes);
+
+    for (i = first; i < count; i++)
+    {
+        vTaskSuspendAll();
+        rec = app_memory_post_boot_log[i % APP_MEMORY_POST_BOOT_LOG];
+        (void)xTaskResumeAll();
+
+        printf("  %s#%lu: %lu bytes by %s at tick %lu\n",
+               APP_STATIC_MEMORY ? "ERROR " : "", (unsigned long)i,
+               (unsigned long)rec.size, rec.task_name, (unsigned long)rec.tick);
+    }
+}
+
+/*
+ Function Name:
+ app_memory_trace_malloc
+
+ Function Description:
+ @brief  Called by the FreeRTOS traceMALLOC hook for every pvPortMalloc(),
+         with the scheduler suspended. Allocations after boot are counted
+         and logged with their size and the allocating task; the hook runs
+         inside the allocator, so the task stands for the caller. Every
+         pvPortMalloc() user goes through here, including the BT stack, the
+         kernel and the RTOS abstraction, so the hook only records: see
+         app_memory_print_post_boot_allocs().
+
+ @param p_addr  Address returned by the allocator
+ @param size    Number of bytes requested
+
+ @return void
+ */
+void app_memory_trace_malloc(void *p_addr, size_t size)
+{
+    app_memory_alloc_rec_t *p_rec;
+
+    if (!app_memory_boot_complete)
+    {
+        return;
+    }
+
+    p_rec = &app_memory_post_boot_log[app_memory_post_boot_allocs % APP_MEMORY_POST_BOOT_LOG];
+    strncpy(p_rec->task_name, pcTaskGetName(NULL), sizeof(p_rec->task_name) - 1u);
+    p_rec->task_name[sizeof(p_rec->task_name) - 1u] = '\0';
+    p_rec->size = (uint32_t)size;
+    p_rec->tick = xTaskGetTickCount();
+
+    app_memory_post_boot_allocs++;
+    app_memory_post_boot_bytes += size;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,132 @@
+/*******************************************************************************
+* File Name: app_memory.h
+*
+* Description: This file contains the memory configuration of the application:
+*              sizes of the statically allocated objects, the static memory
+*              build option and the footprint report.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_MEMORY_H__
+#define __APP_MEMORY_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <FreeRTOS.h>
+#include "GeneratedSource/cycfg_gap.h"
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_STATIC_MEMORY=1 in the Makefile. When enabled, every
+ * task, queue and buffer owned by the application is allocated statically and
+ * heap allocations after boot, which can then only come from the BT stack or
+ * the RTOS, are logged.
+ */
+#ifndef APP_STATIC_MEMORY
+#define APP_STATIC_MEMORY                (0u)
+#endif
+
+/* Size of one GATT response buffer. A response never exceeds the MTU */
+#ifndef APP_GATT_BUF_SIZE
+#define APP_GATT_BUF_SIZE                (CY_BT_MTU_SIZE)
+#endif
+
+/* Number of GATT response buffers in static memory mode. The stack holds a
+ * buffer until it is transmitted, so this bounds the responses in flight.
+ */
+#ifndef APP_GATT_BUF_COUNT
+#define APP_GATT_BUF_COUNT               (4u)
+#endif
+
+/* Number of heap allocations after boot kept with their size and task */
+#ifndef APP_MEMORY_POST_BOOT_LOG
+#define APP_MEMORY_POST_BOOT_LOG         (8u)
+#endif
+
+/* ESS task stack size, in words */
+#define APP_ESS_TASK_STACK_SIZE          (configMINIMAL_STACK_SIZE * 4)
+
+/* Declares an entry of the RAM footprint report. The entry holds the size of
+ * the statically allocated objects of one module.
+ */
+#define APP_MEMORY_FOOTPRINT(name, size) \
+            const app_memory_footprint_t name = { #name, (uint32_t)(size) }
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+typedef struct
+{
+    const char  *p_name;
+    uint32_t    size;
+} app_memory_footprint_t;
+
+/* Usage of the GATT response buffers */
+typedef struct
+{
+    uint32_t    in_use;
+    uint32_t    peak;
+    uint32_t    fails;
+} app_memory_buffer_stats_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_memory_heap_init(void);
+
+void app_memory_init(void);
+
+void *app_memory_alloc_buffer(size_t len);
+
+void app_memory_free_buffer(void *p_buf);
+
+void app_memory_get_buffer_stats(app_memory_buffer_stats_t *p_stats, bool reset_peak);
+
+void app_memory_boot_done(void);
+
+void app_memory_print_footprint(void);
+
+void app_memory_print_post_boot_allocs(void);
+
+void app_memory_trace_malloc(void *p_addr, size_t size);
+
+#endif      /* __APP_MEMORY_H__ */
+
+/* [] END OF FILE */
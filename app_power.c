@@ -0,0 +1,435 @@
+/*******************************************************************************
+* File Name: app_power.c
+*
+* Description: This file contains the sleep accounting. The tickless idle hook
+*              is routed through app_power_sleep() to count sleep entries and
+*              residency per sleep mode and to attribute every wake-up to its
+*              source.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_power.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_trace.h"
+#include "cyhal.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+/* Wake-up source of the current active period, not yet claimed */
+#define APP_POWER_WAKE_UNCLAIMED         (APP_POWER_WAKE_COUNT)
+
+/* No sleep transition happened, the idle period was aborted */
+#define APP_POWER_MODE_NONE              (APP_POWER_MODE_COUNT)
+
+/* Tick counts are converted in 64 bits, the window can last for days */
+#define APP_POWER_TICKS_TO_MS(ticks)     \
+            ((uint32_t)(((uint64_t)(ticks) * 1000u) / configTICK_RATE_HZ))
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t    entries[APP_POWER_MODE_COUNT];
+    uint32_t    residency_ticks[APP_POWER_MODE_COUNT];
+    uint32_t    max_residency_ticks[APP_POWER_MODE_COUNT];
+    uint32_t    aborted;
+    uint32_t    wakes[APP_POWER_WAKE_COUNT];
+    TickType_t  start_tick;
+} app_power_stats_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static app_power_stats_t            app_power_stats;
+
+/* Mode of the last sleep transition, set by the system power callback */
+static volatile uint8_t             app_power_sleep_mode;
+
+/* Claims are accepted from sleep entry until the next sleep entry, the
+ * first one wins.
+ */
+static volatile bool                app_power_claim_open;
+static volatile uint8_t             app_power_wake_src;
+
+/* Set when the last sleep ended before the expected idle time */
+static bool                         app_power_early_wake;
+
+static cyhal_syspm_callback_data_t  app_power_syspm_cb_data;
+
+static const char * const app_power_mode_names[APP_POWER_MODE_COUNT] =
+{
+    "sleep", "deepsleep"
+};
+
+static const char * const app_power_wake_names[APP_POWER_WAKE_COUNT] =
+{
+    "rtos", "timer", "bt", "uart", "other"
+};
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+/* Tickless idle implementation of the RTOS abstraction library */
+extern void vApplicationSleep(TickType_t xExpectedIdleTime);
+
+static bool app_power_syspm_callback(cyhal_syspm_callback_state_t state,
+                                     cyhal_syspm_callback_mode_t mode,
+                                     void *callback_arg);
+
+static void app_power_hci_trace(wiced_bt_hci_trace_type_t type,
+                                uint16_t length, uint8_t *p_data);
+
+static void app_power_close_wake(void);
+
+static void app_power_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_power_console_cmd =
+{
+    "power", "Sleep residency and wake-up sources; 'power reset' to restart",
+    app_power_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_power_init
+
+ Function Description:
+ @brief  Registers the system power callback that reports the sleep mode,
+         and the HCI trace observer that attributes wake-ups to Bluetooth.
+
+ @param void
+
+ @return void
+ */
+void app_power_init(void)
+{
+    app_power_reset_stats();
+
+    app_power_syspm_cb_data.callback = app_power_syspm_callback;
+    app_power_syspm_cb_data.states = (cyhal_syspm_callback_state_t)
+                                     (CYHAL_SYSPM_CB_CPU_SLEEP | CYHAL_SYSPM_CB_CPU_DEEPSLEEP);
+    app_power_syspm_cb_data.ignore_modes = (cyhal_syspm_callback_mode_t)
+                                           (CYHAL_SYSPM_CHECK_READY | CYHAL_SYSPM_CHECK_FAIL |
+                                            CYHAL_SYSPM_AFTER_TRANSITION);
+    app_power_syspm_cb_data.args = NULL;
+    app_power_syspm_cb_data.next = NULL;
+    cyhal_syspm_register_callback(&app_power_syspm_cb_data);
+
+    app_bt_hci_trace_register(app_power_hci_trace);
+
+    app_console_register_command(&app_power_console_cmd);
+}
+
+/*
+ Function Name:
+ app_power_reset_stats
+
+ Function Description:
+ @brief  Clears the counters and starts a new measurement window.
+
+ @param void
+
+ @return void
+ */
+void app_power_reset_stats(void)
+{
+    uint32_t saved_intr = cyhal_system_critical_section_enter();
+
+    memset(&app_power_stats, 0, sizeof(app_power_stats));
+    app_power_stats.start_tick = xTaskGetTickCount();
+    app_power_early_wake = false;
+    app_power_claim_open = false;
+    cyhal_system_critical_section_exit(saved_intr);
+}
+
+/*
+ Function Name:
+ app_power_sleep
+
+ Function Description:
+ @brief  portSUPPRESS_TICKS_AND_SLEEP() hook, called by the idle task with
+         the scheduler suspended. Closes the attribution of the previous
+         wake-up, sleeps through vApplicationSleep() and accounts the sleep.
+         The tick count is stepped by vApplicationSleep(), so the residency
+         is the tick difference around the call.
+
+ @param expected_idle_ticks  Ticks until the next RTOS timeout
+
+ @return void
+ */
+void app_power_sleep(uint32_t expected_idle_ticks)
+{
+    TickType_t start_tick;
+    uint32_t slept_ticks;
+    uint8_t mode;
+
+    app_power_close_wake();
+
+    app_power_sleep_mode = APP_POWER_MODE_NONE;
+    app_power_wake_src = APP_POWER_WAKE_UNCLAIMED;
+    app_power_claim_open = true;
+
+    start_tick = xTaskGetTickCount();
+    vApplicationSleep(expected_idle_ticks);
+    slept_ticks = xTaskGetTickCount() - start_tick;
+    app_trace_sleep(slept_ticks);
+
+    mode = app_power_sleep_mode;
+    if (APP_POWER_MODE_NONE == mode)
+    {
+        /* An interrupt was pending or the idle time was too short */
+        app_power_stats.aborted++;
+        app_power_claim_open = false;
+        return;
+    }
+
+    app_power_stats.entries[mode]++;
+    app_power_stats.residency_ticks[mode] += slept_ticks;
+    if (slept_ticks > app_power_stats.max_residency_ticks[mode])
+    {
+        app_power_stats.max_residency_ticks[mode] = slept_ticks;
+    }
+
+    if (slept_ticks >= expected_idle_ticks)
+    {
+        app_power_stats.wakes[APP_POWER_WAKE_RTOS]++;
+        app_power_claim_open = false;
+    }
+    else
+    {
+        /* Woken by an interrupt. Its handler, or the Bluetooth stack thread
+         * for controller traffic, claims the wake-up before the next sleep.
+         */
+        app_power_early_wake = true;
+    }
+}
+
+/*
+ Function Name:
+ app_power_close_wake
+
+ Function Description:
+ @brief  Counts the early wake-up of the last sleep against the source that
+         claimed it.
+
+ @param void
+
+ @return void
+ */
+static void app_power_close_wake(void)
+{
+    uint8_t src = app_power_wake_src;
+
+    if (!app_power_early_wake)
+    {
+        return;
+    }
+
+    app_power_stats.wakes[(APP_POWER_WAKE_UNCLAIMED == src) ? APP_POWER_WAKE_OTHER : src]++;
+    app_power_early_wake = false;
+    app_power_claim_open = false;
+}
+
+/*
+ Function Name:
+ app_power_wake_claim
+
+ Function Description:
+ @brief  Attributes the current wake-up to a source, if no other source did
+         so first. Called from interrupt handlers and callbacks; cheap enough
+         to be called on every event.
+
+ @param src  Wake-up source
+
+ @return void
+ */
+void app_power_wake_claim(app_power_wake_src_t src)
+{
+    if (app_power_claim_open && (APP_POWER_WAKE_UNCLAIMED == app_power_wake_src))
+    {
+        app_power_wake_src = (uint8_t)src;
+    }
+}
+
+/*
+ Function Name:
+ app_power_syspm_callback
+
+ Function Description:
+ @brief  System power callback, records the mode of the sleep transition.
+
+ @param state         Sleep mode being entered
+ @param mode          Transition phase, only BEFORE_TRANSITION is received
+ @param callback_arg  Not used
+
+ @return bool  Always allows the transition
+ */
+static bool app_power_syspm_callback(cyhal_syspm_callback_state_t state,
+                                     cyhal_syspm_callback_mode_t mode,
+                                     void *callback_arg)
+{
+    app_power_sleep_mode = (CYHAL_SYSPM_CB_CPU_DEEPSLEEP == state) ?
+                           APP_POWER_MODE_DEEPSLEEP : APP_POWER_MODE_SLEEP;
+    return true;
+}
+
+/*
+ Function Name:
+ app_power_hci_trace
+
+ Function Description:
+ @brief  HCI trace observer. Any HCI traffic after a wake-up means the
+         Bluetooth controller woke the CPU.
+
+ @param type    HCI packet type
+ @param length  Packet length
+ @param p_data  Packet
+
+ @return void
+ */
+static void app_power_hci_trace(wiced_bt_hci_trace_type_t type,
+                                uint16_t length, uint8_t *p_data)
+{
+    if ((HCI_TRACE_EVENT == type) || (HCI_TRACE_INCOMING_ACL_DATA == type))
+    {
+        app_power_wake_claim(APP_POWER_WAKE_BT);
+    }
+}
+
+/*
+ Function Name:
+ app_power_print_stats
+
+ Function Description:
+ @brief  Prints the residency per mode and the wake-up sources, followed by
+         a POWER line read by tools/energy_estimate.py.
+
+ @param void
+
+ @return void
+ */
+void app_power_print_stats(void)
+{
+    app_power_stats_t stats;
+    uint32_t window_ticks;
+    uint32_t sleep_ticks = 0;
+    uint32_t saved_intr;
+    uint32_t i;
+
+    saved_intr = cyhal_system_critical_section_enter();
+    stats = app_power_stats;
+    cyhal_system_critical_section_exit(saved_intr);
+
+    window_ticks = xTaskGetTickCount() - stats.start_tick;
+
+    printf("Sleep accounting over %lu ms (tickless idle %s)\n",
+           (unsigned long)APP_POWER_TICKS_TO_MS(window_ticks),
+           (0 != configUSE_TICKLESS_IDLE) ? "on" : "off");
+    for (i = 0; i < APP_POWER_MODE_COUNT; i++)
+    {
+        sleep_ticks += stats.residency_ticks[i];
+        printf("  %-10s %8lu entries %10lu ms, longest %lu ms\n", app_power_mode_names[i],
+               (unsigned long)stats.entries[i],
+               (unsigned long)APP_POWER_TICKS_TO_MS(stats.residency_ticks[i]),
+               (unsigned long)APP_POWER_TICKS_TO_MS(stats.max_residency_ticks[i]));
+    }
+    printf("  %-10s %8lu aborted %10lu ms\n", "active", (unsigned long)stats.aborted,
+           (unsigned long)APP_POWER_TICKS_TO_MS(window_ticks - sleep_ticks));
+    printf("  wake-ups:");
+    for (i = 0; i < APP_POWER_WAKE_COUNT; i++)
+    {
+        printf(" %s %lu", app_power_wake_names[i], (unsigned long)stats.wakes[i]);
+    }
+    printf("\n");
+
+    printf("POWER window_ms=%lu", (unsigned long)APP_POWER_TICKS_TO_MS(window_ticks));
+    for (i = 0; i < APP_POWER_MODE_COUNT; i++)
+    {
+        printf(" %s_n=%lu %s_ms=%lu", app_power_mode_names[i], (unsigned long)stats.entries[i],
+               app_power_mode_names[i],
+               (unsigned long)APP_POWER_TICKS_TO_MS(stats.residency_ticks[i]));
+    }
+    printf(" aborted=%lu", (unsigned long)stats.aborted);
+    for (i = 0; i < APP_POWER_WAKE_COUNT; i++)
+    {
+        printf(" wake_%s=%lu", app_power_wake_names[i], (unsigned long)stats.wakes[i]);
+    }
+    printf("\n");
+}
+
+/*
+ Function Name:
+ app_power_cmd
+
+ Function Description:
+ @brief  "power" console command.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_power_cmd(uint32_t argc, char *argv[])
+{
+    if ((1 < argc) && (0 == strcmp(argv[1], "reset")))
+    {
+        app_power_reset_stats();
+        printf("Sleep accounting reset\n");
+    }
+    else
+    {
+        app_power_print_stats();
+    }
+}
+
+/* [] END OF FILE */
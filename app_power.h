@@ -0,0 +1,92 @@
+/*******************************************************************************
+* File Name: app_power.h
+*
+* Description: This file contains the interface of the sleep accounting: sleep
+*              entries, residency per sleep mode and wake-up source
+*              attribution.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_POWER_H__
+#define __APP_POWER_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Sleep modes entered by the tickless idle */
+typedef enum
+{
+    APP_POWER_MODE_SLEEP,
+    APP_POWER_MODE_DEEPSLEEP,
+    APP_POWER_MODE_COUNT
+} app_power_mode_t;
+
+/* Wake-up sources. APP_POWER_WAKE_RTOS is the end of the expected idle time,
+ * the others are claimed by the interrupt or callback that follows the wake.
+ */
+typedef enum
+{
+    APP_POWER_WAKE_RTOS,
+    APP_POWER_WAKE_TIMER,
+    APP_POWER_WAKE_BT,
+    APP_POWER_WAKE_UART,
+    APP_POWER_WAKE_OTHER,
+    APP_POWER_WAKE_COUNT
+} app_power_wake_src_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_power_init(void);
+
+void app_power_sleep(uint32_t expected_idle_ticks);
+
+void app_power_wake_claim(app_power_wake_src_t src);
+
+void app_power_reset_stats(void);
+
+void app_power_print_stats(void);
+
+#endif      /* __APP_POWER_H__ */
+
+/* [] END OF FILE */
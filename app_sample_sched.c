@@ -0,0 +1,495 @@
+/*******************************************************************************
+* File Name: app_sample_sched.c
+*
+* Description: This file contains the sensor sample scheduler. While connected,
+*              the sample timer is phase-locked to the connection events so
+*              that a sample is taken just before the anchor that transmits it.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_sample_sched.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_power.h"
+#include "app_trace.h"
+#include "wiced_bt_ble.h"
+#include "cyhal.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+/* Connection interval unit of the Bluetooth specification, 1.25 ms */
+#define APP_SAMPLE_SCHED_CONN_UNIT_US    (1250u)
+
+#define APP_SAMPLE_SCHED_US_PER_TICK     (1000000u / APP_SAMPLE_SCHED_TIMER_HZ)
+
+/* HCI Number Of Completed Packets event code. The controller reports it
+ * right after the connection event in which a packet was acknowledged.
+ */
+#define APP_SAMPLE_SCHED_HCI_NOCP_EVT    (0x13u)
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t    samples;
+    uint32_t    aligned_samples;
+    uint32_t    measured_samples;
+    uint32_t    age_max_us;
+    uint64_t    age_total_us;
+    int32_t     last_error_us;
+    uint32_t    timer_restarts;
+} app_sample_sched_stats_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static cyhal_timer_t            app_sample_timer_obj;
+
+static cyhal_timer_cfg_t        app_sample_timer_cfg =
+{
+    .compare_value = 0,                 /* Timer compare value, not used */
+    .period = 0,                        /* Set from the sampling period */
+    .direction = CYHAL_TIMER_DIR_UP,    /* Timer counts up */
+    .is_compare = false,                /* Don't use compare mode */
+    .is_continuous = true,              /* Run timer indefinitely */
+    .value = 0                          /* Initial value of counter */
+};
+
+/* Task notified on every sample time */
+static TaskHandle_t             app_sample_task_handle;
+
+/* Requested sampling period */
+static uint32_t                 app_sample_period_us;
+
+/* Connection interval, 0 while not connected */
+static volatile uint32_t        app_sample_conn_interval_us;
+
+/* Set when a sample is taken, cleared by the first connection event after
+ * it. app_sample_age_us then holds the time between the two.
+ */
+static volatile bool            app_sample_pending;
+static volatile bool            app_sample_age_valid;
+static volatile uint32_t        app_sample_age_us;
+
+/* Period correction applied when the current sample timer was started */
+static int32_t                  app_sample_adjust_us;
+
+/* Set while the sample timer runs with a connection aligned period */
+static bool                     app_sample_timer_aligned;
+
+static app_sample_sched_stats_t app_sample_sched_stats;
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_sample_timer_callback(void *callback_arg, cyhal_timer_event_t event);
+
+static void app_sample_sched_hci_trace(wiced_bt_hci_trace_type_t type,
+                                       uint16_t length, uint8_t *p_data);
+
+static void app_sample_timer_restart(uint32_t period_us);
+
+static void app_sample_sched_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_sample_sched_console_cmd =
+{
+    "sched", "Sample scheduler phase and sample age statistics",
+    app_sample_sched_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_sample_sched_init
+
+ Function Description:
+ @brief  Starts the sample timer in free running mode and, when alignment is
+         enabled, registers for the HCI trace to observe connection events.
+         A connection interval recorded before, by
+         app_sample_sched_connected(), is kept and aligns the next sample.
+
+ @param task_handle  Task notified on every sample time
+ @param period_ms    Sampling period
+
+ @return void
+ */
+void app_sample_sched_init(TaskHandle_t task_handle, uint32_t period_ms)
+{
+    cy_rslt_t rslt;
+
+    app_sample_task_handle = task_handle;
+    app_sample_period_us = period_ms * 1000u;
+    /* The connection interval is kept: the scheduler starts after
+     * advertising, and a central may already have connected */
+    app_sample_pending = false;
+    app_sample_age_valid = false;
+    app_sample_adjust_us = 0;
+    app_sample_timer_aligned = false;
+    memset(&app_sample_sched_stats, 0, sizeof(app_sample_sched_stats));
+
+    rslt = cyhal_timer_init(&app_sample_timer_obj, NC, NULL);
+    if (CY_RSLT_SUCCESS != rslt)
+    {
+        printf("Sample timer init failed !\n");
+    }
+    app_sample_timer_cfg.period = (app_sample_period_us / APP_SAMPLE_SCHED_US_PER_TICK) - 1u;
+    cyhal_timer_configure(&app_sample_timer_obj, &app_sample_timer_cfg);
+    rslt = cyhal_timer_set_frequency(&app_sample_timer_obj, APP_SAMPLE_SCHED_TIMER_HZ);
+    if (CY_RSLT_SUCCESS != rslt)
+    {
+        printf("Sample timer set freq failed !\n");
+    }
+    /* Register for a callback whenever timer reaches terminal count */
+    cyhal_timer_register_callback(&app_sample_timer_obj, app_sample_timer_callback, NULL);
+    cyhal_timer_enable_event(&app_sample_timer_obj, CYHAL_TIMER_IRQ_TERMINAL_COUNT, 3, true);
+
+    if (CY_RSLT_SUCCESS != cyhal_timer_start(&app_sample_timer_obj))
+    {
+        printf("Sample timer start failed !\n");
+    }
+
+#if APP_SAMPLE_SCHED_ALIGN
+    app_bt_hci_trace_register(app_sample_sched_hci_trace);
+#endif
+
+    app_console_register_command(&app_sample_sched_console_cmd);
+}
+
+/*
+ Function Name:
+ app_sample_timer_callback
+
+ Function Description:
+ @brief  Sample timer terminal count. Wakes the sampling task.
+
+ @param callback_arg  Not used
+ @param event         Not used
+
+ @return void
+ */
+static void app_sample_timer_callback(void *callback_arg, cyhal_timer_event_t event)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    app_power_wake_claim(APP_POWER_WAKE_TIMER);
+    app_trace_isr_enter(APP_TRACE_ISR_SAMPLE_TIMER);
+    vTaskNotifyGiveFromISR(app_sample_task_handle, &xHigherPriorityTaskWoken);
+    app_trace_isr_exit(APP_TRACE_ISR_SAMPLE_TIMER);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/*
+ Function Name:
+ app_sample_sched_on_sample
+
+ Function Description:
+ @brief  Called by the sampling task when it wakes up, before it reads the
+         sensor. While connected, restarts the sample timer so that the next
+         sample falls APP_SAMPLE_SCHED_LEAD_US before a connection event.
+
+         Sample k is taken at s(k) and its first connection event is seen at
+         s(k) + age(k). The period is a whole number of connection intervals
+         plus a correction, and age(k + 1) = age(k) - correction(k), modulo
+         the interval. The age of the previous sample is only known once this
+         sample is due, so the phase of this sample is predicted from it and
+         half of the remaining error is corrected in the next period.
+
+ @param void
+
+ @return void
+ */
+void app_sample_sched_on_sample(void)
+{
+    uint32_t interval_us = app_sample_conn_interval_us;
+    uint32_t intervals;
+    uint32_t saved_intr;
+    int32_t error_us;
+    uint32_t age_us;
+    bool age_valid;
+
+    app_sample_sched_stats.samples++;
+
+    saved_intr = cyhal_system_critical_section_enter();
+    age_valid = app_sample_age_valid;
+    age_us = app_sample_age_us;
+    app_sample_age_valid = false;
+    app_sample_pending = APP_SAMPLE_SCHED_ALIGN && (0 != interval_us);
+    cyhal_system_critical_section_exit(saved_intr);
+
+    if ((!APP_SAMPLE_SCHED_ALIGN) || (0 == interval_us))
+    {
+        if (app_sample_timer_aligned)
+        {
+            /* Disconnected, back to the requested period */
+            app_sample_adjust_us = 0;
+            app_sample_timer_aligned = false;
+            app_sample_timer_restart(app_sample_period_us);
+        }
+        return;
+    }
+
+    app_sample_sched_stats.aligned_samples++;
+
+    if (age_valid)
+    {
+        app_sample_sched_stats.measured_samples++;
+        app_sample_sched_stats.age_total_us += age_us;
+        if (age_us > app_sample_sched_stats.age_max_us)
+        {
+            app_sample_sched_stats.age_max_us = age_us;
+        }
+
+        /* Predicted phase of this sample, wrapped to (-interval/2, interval/2] */
+        error_us = (int32_t)age_us - app_sample_adjust_us - (int32_t)APP_SAMPLE_SCHED_LEAD_US;
+        error_us %= (int32_t)interval_us;
+        if (error_us > (int32_t)(interval_us / 2u))
+        {
+            error_us -= (int32_t)interval_us;
+        }
+        else if (error_us <= -(int32_t)(interval_us / 2u))
+        {
+            error_us += (int32_t)interval_us;
+        }
+
+        app_sample_sched_stats.last_error_us = error_us;
+        app_sample_adjust_us = error_us / 2;
+    }
+    else
+    {
+        /* The sample was not sent or not observed; keep the phase */
+        app_sample_adjust_us = 0;
+    }
+
+    intervals = (app_sample_period_us + (interval_us / 2u)) / interval_us;
+    if (0 == intervals)
+    {
+        intervals = 1;
+    }
+
+    app_sample_timer_restart((intervals * interval_us) + app_sample_adjust_us);
+    app_sample_timer_aligned = true;
+}
+
+/*
+ Function Name:
+ app_sample_timer_restart
+
+ Function Description:
+ @brief  Restarts the sample timer from zero with a new period. Only
+         called from the sampling task.
+
+ @param period_us  Time to the next sample
+
+ @return void
+ */
+static void app_sample_timer_restart(uint32_t period_us)
+{
+    uint32_t ticks = period_us / APP_SAMPLE_SCHED_US_PER_TICK;
+
+    app_sample_timer_cfg.period = (0u < ticks) ? (ticks - 1u) : 0u;
+    app_sample_timer_cfg.value = 0;
+
+    cyhal_timer_stop(&app_sample_timer_obj);
+    cyhal_timer_configure(&app_sample_timer_obj, &app_sample_timer_cfg);
+    cyhal_timer_start(&app_sample_timer_obj);
+
+    app_sample_sched_stats.timer_restarts++;
+}
+
+/*
+ Function Name:
+ app_sample_sched_hci_trace
+
+ Function Description:
+ @brief  HCI trace callback, runs in the Bluetooth stack thread. The first
+         completed packet or received ACL packet after a sample marks the
+         connection event that carried it.
+
+ @param type    HCI packet type
+ @param length  Packet length
+ @param p_data  Packet
+
+ @return void
+ */
+static void app_sample_sched_hci_trace(wiced_bt_hci_trace_type_t type,
+                                       uint16_t length, uint8_t *p_data)
+{
+    uint32_t saved_intr;
+
+    if (!app_sample_pending)
+    {
+        return;
+    }
+
+    if (!(((HCI_TRACE_EVENT == type) && (0 < length) &&
+           (APP_SAMPLE_SCHED_HCI_NOCP_EVT == p_data[0])) ||
+          (HCI_TRACE_INCOMING_ACL_DATA == type)))
+    {
+        return;
+    }
+
+    saved_intr = cyhal_system_critical_section_enter();
+    app_sample_age_us = cyhal_timer_read(&app_sample_timer_obj) * APP_SAMPLE_SCHED_US_PER_TICK;
+    app_sample_age_valid = true;
+    app_sample_pending = false;
+    cyhal_system_critical_section_exit(saved_intr);
+}
+
+/*
+ Function Name:
+ app_sample_sched_connected
+
+ Function Description:
+ @brief  Starts phase-locking to the connection events of a new connection.
+
+ @param bd_addr  Peer address
+
+ @return void
+ */
+void app_sample_sched_connected(wiced_bt_device_address_t bd_addr)
+{
+    wiced_bt_ble_conn_params_t conn_params;
+
+    if (WICED_BT_SUCCESS == wiced_bt_ble_get_connection_parameters(bd_addr, &conn_params))
+    {
+        app_sample_sched_set_conn_params(conn_params.conn_interval,
+                                         conn_params.conn_latency);
+    }
+}
+
+/*
+ Function Name:
+ app_sample_sched_disconnected
+
+ Function Description:
+ @brief  Returns to free running sampling with the requested period. The
+         sample timer is restarted by the sampling task on its next sample,
+         so that only that task reconfigures the timer.
+
+ @param void
+
+ @return void
+ */
+void app_sample_sched_disconnected(void)
+{
+    app_sample_conn_interval_us = 0;
+    app_sample_pending = false;
+}
+
+/*
+ Function Name:
+ app_sample_sched_set_conn_params
+
+ Function Description:
+ @brief  Updates the connection interval, on connection and on connection
+         parameter update. The peripheral latency does not matter: with a
+         notification queued the device transmits at the next event anyway.
+
+ @param conn_interval  Connection interval in 1.25 ms units
+ @param conn_latency   Peripheral latency in connection events
+
+ @return void
+ */
+void app_sample_sched_set_conn_params(uint16_t conn_interval, uint16_t conn_latency)
+{
+    app_sample_conn_interval_us = (uint32_t)conn_interval * APP_SAMPLE_SCHED_CONN_UNIT_US;
+
+    printf("Sample scheduler: connection interval %lu us, latency %u\n",
+           (unsigned long)app_sample_conn_interval_us, conn_latency);
+}
+
+/*
+ Function Name:
+ app_sample_sched_print_stats
+
+ Function Description:
+ @brief  Prints the sample age and phase statistics.
+
+ @param void
+
+ @return void
+ */
+void app_sample_sched_print_stats(void)
+{
+    app_sample_sched_stats_t *p_stats = &app_sample_sched_stats;
+    int32_t error_us = p_stats->last_error_us;
+
+    printf("Sample scheduler (%s)\n", APP_SAMPLE_SCHED_ALIGN ? "aligned" : "free running");
+    printf("  samples %lu, aligned %lu, observed on air %lu, timer restarts %lu\n",
+           (unsigned long)p_stats->samples, (unsigned long)p_stats->aligned_samples,
+           (unsigned long)p_stats->measured_samples,
+           (unsigned long)p_stats->timer_restarts);
+    if (0 != p_stats->measured_samples)
+    {
+        printf("  sample age avg %lu us, max %lu us, phase error %ld us (%s)\n",
+               (unsigned long)(p_stats->age_total_us / p_stats->measured_samples),
+               (unsigned long)p_stats->age_max_us, (long)error_us,
+               (((error_us < 0) ? -error_us : error_us) < (int32_t)APP_SAMPLE_SCHED_LOCK_US)
+               ? "locked" : "tracking");
+    }
+}
+
+/*
+ Function Name:
+ app_sample_sched_cmd
+
+ Function Description:
+ @brief  "sched" console command.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_sample_sched_cmd(uint32_t argc, char *argv[])
+{
+    app_sample_sched_print_stats();
+}
+
+/* [] END OF FILE */
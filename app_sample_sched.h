@@ -0,0 +1,91 @@
+/*******************************************************************************
+* File Name: app_sample_sched.h
+*
+* Description: This file contains the interface of the sensor sample scheduler,
+*              which can phase-lock sampling to the connection events.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_SAMPLE_SCHED_H__
+#define __APP_SAMPLE_SCHED_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "wiced_bt_dev.h"
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Set to 0 to sample on a free running timer also while connected */
+#ifndef APP_SAMPLE_SCHED_ALIGN
+#define APP_SAMPLE_SCHED_ALIGN           (1u)
+#endif
+
+/* Sample timer clock. One tick is 100 us */
+#define APP_SAMPLE_SCHED_TIMER_HZ        (10000u)
+
+/* Time between a sample and the connection event that carries it. It covers
+ * the sensor read and the notification path down to the controller.
+ */
+#ifndef APP_SAMPLE_SCHED_LEAD_US
+#define APP_SAMPLE_SCHED_LEAD_US         (3000u)
+#endif
+
+/* Phase error under which the scheduler is reported as locked */
+#define APP_SAMPLE_SCHED_LOCK_US         (1000u)
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_sample_sched_init(TaskHandle_t task_handle, uint32_t period_ms);
+
+void app_sample_sched_on_sample(void);
+
+void app_sample_sched_connected(wiced_bt_device_address_t bd_addr);
+
+void app_sample_sched_disconnected(void);
+
+void app_sample_sched_set_conn_params(uint16_t conn_interval, uint16_t conn_latency);
+
+void app_sample_sched_print_stats(void);
+
+#endif      /* __APP_SAMPLE_SCHED_H__ */
+
+/* [] END OF FILE */
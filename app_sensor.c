@@ -0,0 +1,314 @@
+/*******************************************************************************
+* File Name: app_sensor.c
+*
+* Description: This file contains the temperature sampling front end and the
+*              simulated and replay sensor backends.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_sensor.h"
+#include "app_thermistor.h"
+#include "app_memory.h"
+#include <task.h>
+#include <semphr.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+/* Temperature sweep of the simulated backend */
+#define APP_SENSOR_SIM_DEFAULT           (2500)
+#define APP_SENSOR_SIM_MAX               (3000)
+#define APP_SENSOR_SIM_MIN               (2000)
+#define APP_SENSOR_SIM_DELTA             (100)
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Recorded samples of the replay backend, in hundredths of a degree */
+extern const int16_t  app_sensor_replay_samples[];
+extern const uint32_t app_sensor_replay_sample_count;
+
+/* Given when an acquisition completes */
+static SemaphoreHandle_t        app_sensor_done_sem;
+
+#if APP_STATIC_MEMORY
+static StaticSemaphore_t        app_sensor_done_sem_cb;
+#endif
+
+static const app_sensor_backend_t *p_app_sensor_backend;
+
+/* State of the simulated and replay backends */
+static int16_t                  app_sensor_sim_value = APP_SENSOR_SIM_DEFAULT;
+static int16_t                  app_sensor_sim_delta = APP_SENSOR_SIM_DELTA;
+static uint32_t                 app_sensor_replay_index;
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static bool app_sensor_sim_init(void);
+static bool app_sensor_sim_start(void);
+static bool app_sensor_sim_convert(int16_t *p_centi_celsius);
+
+static bool app_sensor_replay_start(void);
+static bool app_sensor_replay_convert(int16_t *p_centi_celsius);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_sensor_backend_t app_sensor_sim_backend =
+{
+    "simulated", app_sensor_sim_init, app_sensor_sim_start, app_sensor_sim_convert
+};
+
+static const app_sensor_backend_t app_sensor_replay_backend =
+{
+    "replay", app_sensor_sim_init, app_sensor_replay_start, app_sensor_replay_convert
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_sensor_init
+
+ Function Description:
+ @brief  Initializes the backend selected with APP_SENSOR_BACKEND. The
+         simulated backend takes over if the thermistor can't be initialized,
+         e.g. on a board without the thermistor circuit.
+
+ @param void
+
+ @return void
+ */
+void app_sensor_init(void)
+{
+#if APP_STATIC_MEMORY
+    app_sensor_done_sem = xSemaphoreCreateBinaryStatic(&app_sensor_done_sem_cb);
+#else
+    app_sensor_done_sem = xSemaphoreCreateBinary();
+#endif
+    vQueueAddToRegistry(app_sensor_done_sem, "Sensor done");
+
+#if (APP_SENSOR_BACKEND == APP_SENSOR_BACKEND_THERMISTOR)
+    p_app_sensor_backend = &app_thermistor_backend;
+#elif (APP_SENSOR_BACKEND == APP_SENSOR_BACKEND_REPLAY)
+    p_app_sensor_backend = &app_sensor_replay_backend;
+#else
+    p_app_sensor_backend = &app_sensor_sim_backend;
+#endif
+
+    if (!p_app_sensor_backend->p_init())
+    {
+        printf("Sensor backend %s init failed, using simulated values\n",
+               p_app_sensor_backend->p_name);
+        p_app_sensor_backend = &app_sensor_sim_backend;
+        p_app_sensor_backend->p_init();
+    }
+
+    printf("Sensor backend: %s\n", p_app_sensor_backend->p_name);
+}
+
+/*
+ Function Name:
+ app_sensor_sample
+
+ Function Description:
+ @brief  Takes one temperature sample: starts an acquisition, waits for it
+         to complete and converts it.
+
+ @param p_centi_celsius  Temperature in hundredths of a degree Celsius
+
+ @return bool  false if the acquisition failed or timed out
+ */
+bool app_sensor_sample(int16_t *p_centi_celsius)
+{
+    /* Drop a completion left over from an acquisition that timed out */
+    xSemaphoreTake(app_sensor_done_sem, 0);
+
+    if (!p_app_sensor_backend->p_start())
+    {
+        return false;
+    }
+
+    if (pdTRUE != xSemaphoreTake(app_sensor_done_sem, pdMS_TO_TICKS(APP_SENSOR_TIMEOUT_MS)))
+    {
+        printf("Sensor acquisition timed out\n");
+        return false;
+    }
+
+    return p_app_sensor_backend->p_convert(p_centi_celsius);
+}
+
+/*
+ Function Name:
+ app_sensor_acquisition_done
+
+ Function Description:
+ @brief  Reports the completion of an acquisition from task context.
+
+ @param void
+
+ @return void
+ */
+void app_sensor_acquisition_done(void)
+{
+    xSemaphoreGive(app_sensor_done_sem);
+}
+
+/*
+ Function Name:
+ app_sensor_acquisition_done_from_isr
+
+ Function Description:
+ @brief  Reports the completion of an acquisition from an interrupt.
+
+ @param p_higher_priority_task_woken  Set if a context switch is needed
+
+ @return void
+ */
+void app_sensor_acquisition_done_from_isr(BaseType_t *p_higher_priority_task_woken)
+{
+    xSemaphoreGiveFromISR(app_sensor_done_sem, p_higher_priority_task_woken);
+}
+
+/*
+ Function Name:
+ app_sensor_sim_init
+
+ Function Description:
+ @brief  Initializes the simulated and replay backends.
+
+ @param void
+
+ @return bool  Always true
+ */
+static bool app_sensor_sim_init(void)
+{
+    app_sensor_sim_value = APP_SENSOR_SIM_DEFAULT;
+    app_sensor_sim_delta = APP_SENSOR_SIM_DELTA;
+    app_sensor_replay_index = 0;
+    return true;
+}
+
+/*
+ Function Name:
+ app_sensor_sim_start
+
+ Function Description:
+ @brief  Steps the simulated temperature by APP_SENSOR_SIM_DELTA between
+         APP_SENSOR_SIM_MIN and APP_SENSOR_SIM_MAX.
+
+ @param void
+
+ @return bool  Always true
+ */
+static bool app_sensor_sim_start(void)
+{
+    app_sensor_sim_value += app_sensor_sim_delta;
+    if ((APP_SENSOR_SIM_MAX <= app_sensor_sim_value) ||
+        (APP_SENSOR_SIM_MIN >= app_sensor_sim_value))
+    {
+        app_sensor_sim_delta = -app_sensor_sim_delta;
+    }
+
+    app_sensor_acquisition_done();
+    return true;
+}
+
+/*
+ Function Name:
+ app_sensor_sim_convert
+
+ Function Description:
+ @brief  Returns the simulated temperature.
+
+ @param p_centi_celsius  Temperature in hundredths of a degree Celsius
+
+ @return bool  Always true
+ */
+static bool app_sensor_sim_convert(int16_t *p_centi_celsius)
+{
+    *p_centi_celsius = app_sensor_sim_value;
+    return true;
+}
+
+/*
+ Function Name:
+ app_sensor_replay_start
+
+ Function Description:
+ @brief  Advances to the next recorded sample, wrapping at the end.
+
+ @param void
+
+ @return bool  false if no samples are recorded
+ */
+static bool app_sensor_replay_start(void)
+{
+    if (0 == app_sensor_replay_sample_count)
+    {
+        return false;
+    }
+
+    app_sensor_replay_index = (app_sensor_replay_index + 1u) % app_sensor_replay_sample_count;
+    app_sensor_acquisition_done();
+    return true;
+}
+
+/*
+ Function Name:
+ app_sensor_replay_convert
+
+ Function Description:
+ @brief  Returns the current recorded sample.
+
+ @param p_centi_celsius  Temperature in hundredths of a degree Celsius
+
+ @return bool  Always true
+ */
+static bool app_sensor_replay_convert(int16_t *p_centi_celsius)
+{
+    *p_centi_celsius = app_sensor_replay_samples[app_sensor_replay_index];
+    return true;
+}
+
+/* [] END OF FILE */
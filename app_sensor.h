@@ -0,0 +1,99 @@
+/*******************************************************************************
+* File Name: app_sensor.h
+*
+* Description: This file contains the temperature sensor interface: the backend
+*              descriptor and the sampling front end used by the ESS task.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_SENSOR_H__
+#define __APP_SENSOR_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Sensor backends */
+#define APP_SENSOR_BACKEND_THERMISTOR    (0u)   /* ADC with DMA, see app_thermistor.c */
+#define APP_SENSOR_BACKEND_SIM           (1u)   /* Temperature sweep, no hardware */
+#define APP_SENSOR_BACKEND_REPLAY        (2u)   /* Recorded samples, see app_sensor_replay_data.c */
+
+/* Build option, set APP_SENSOR_BACKEND in the Makefile */
+#ifndef APP_SENSOR_BACKEND
+#define APP_SENSOR_BACKEND               (APP_SENSOR_BACKEND_THERMISTOR)
+#endif
+
+/* Longest time to wait for an acquisition to complete */
+#define APP_SENSOR_TIMEOUT_MS            (20u)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* A sensor backend. An acquisition is started with p_start and reported
+ * complete with app_sensor_acquisition_done(), from an interrupt or from
+ * p_start itself. p_convert then turns the completed acquisition into a
+ * temperature in hundredths of a degree Celsius; it only runs after an
+ * acquisition completed, in the context of the sampling task.
+ */
+typedef struct
+{
+    const char  *p_name;
+    bool        (*p_init)(void);
+    bool        (*p_start)(void);
+    bool        (*p_convert)(int16_t *p_centi_celsius);
+} app_sensor_backend_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_sensor_init(void);
+
+bool app_sensor_sample(int16_t *p_centi_celsius);
+
+void app_sensor_acquisition_done(void);
+
+void app_sensor_acquisition_done_from_isr(BaseType_t *p_higher_priority_task_woken);
+
+#endif      /* __APP_SENSOR_H__ */
+
+/* [] END OF FILE */
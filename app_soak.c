@@ -0,0 +1,730 @@
+/*******************************************************************************
+* File Name: app_soak.c
+*
+* Description: This file contains the soak mode. The soak console command
+*              replays days of sampling, advertising and connections of a
+*              simulated central on a virtual clock that advances as fast as
+*              the CPU runs the application code. Runs with the same seed give
+*              the same sequence of events, and end with a report of the memory
+*              and latency statistics.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_soak.h"
+#include "app_bt_gatt_handler.h"
+#include "app_bt_gatt_tx.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_ess.h"
+#include "app_heap_trace.h"
+#include "app_memory.h"
+#include "app_stats.h"
+#include "app_time.h"
+#include "GeneratedSource/cycfg_gatt_db.h"
+#include "cyhal.h"
+#include "wiced_bt_gatt.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if APP_SOAK
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* Event kinds, hashed with the virtual time to fingerprint a run */
+#define APP_SOAK_EVT_SAMPLE              (1u)
+#define APP_SOAK_EVT_CONNECT             (2u)
+#define APP_SOAK_EVT_READ                (3u)
+#define APP_SOAK_EVT_DISCONNECT          (4u)
+#define APP_SOAK_EVT_RESPONSE            (5u)
+#define APP_SOAK_EVT_NOTIFICATION        (6u)
+
+#define APP_SOAK_FNV_OFFSET              (2166136261u)
+#define APP_SOAK_FNV_PRIME               (16777619u)
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t    samples;
+    uint32_t    sessions;
+    uint32_t    requests;
+    uint32_t    failed;
+    uint32_t    notifications;
+    uint32_t    sample_max_cycles;
+    uint64_t    sample_total_cycles;
+    uint32_t    request_max_cycles;
+    uint64_t    request_total_cycles;
+    uint32_t    hash;
+} app_soak_stats_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static uint32_t                 app_soak_sample_period_ms;
+
+/* Run requested by the console and taken by the ESS task */
+static volatile bool            app_soak_requested;
+static volatile bool            app_soak_running;
+static uint32_t                 app_soak_days;
+static uint32_t                 app_soak_seed;
+
+/* Virtual clock, in milliseconds since the scheduler started */
+static volatile uint64_t        app_soak_now_ms;
+
+static uint32_t                 app_soak_random;
+static app_soak_stats_t         app_soak_stats;
+
+/* Outstanding request of the simulated central */
+static volatile bool            app_soak_pending;
+static volatile wiced_bt_gatt_status_t app_soak_status;
+
+/* Value of the CCCD write, enables notifications */
+static uint8_t                  app_soak_cccd_value[] = { 0x01, 0x00 };
+
+static const uint8_t            app_soak_bd_addr[] = { 0x00, 0xA0, 0x50, 0x50, 0x4B, 0x01 };
+
+APP_MEMORY_FOOTPRINT(app_soak_ram_footprint, sizeof(app_soak_stats));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_soak_run(void);
+
+static uint64_t app_soak_clock(void);
+
+static uint32_t app_soak_span_ms(uint32_t mean_s);
+
+static void app_soak_hash(uint32_t kind, uint32_t value);
+
+static void app_soak_sample(bool connected);
+
+static bool app_soak_connect(bool connected);
+
+static void app_soak_request(wiced_bt_gatt_opcode_t opcode, uint16_t handle);
+
+static bool app_soak_owns(uint16_t conn_id);
+
+static void app_soak_complete(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                              wiced_bt_gatt_status_t status);
+
+static void app_soak_report(uint32_t wall_ms);
+
+static void app_soak_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_gatt_tx_sink_t app_soak_sink =
+{
+    app_soak_owns, app_soak_complete
+};
+
+static const app_console_cmd_t app_soak_console_cmd =
+{
+    "soak", "Virtual time soak: soak <days> [seed]", app_soak_cmd
+};
+
+#else
+
+APP_MEMORY_FOOTPRINT(app_soak_ram_footprint, 0);
+
+#endif /* APP_SOAK */
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_soak_init
+
+ Function Description:
+ @brief  Registers the soak console command. Does nothing unless built with
+         APP_SOAK=1.
+
+ @param sample_period_ms  Sample period of the ESS task
+
+ @return void
+ */
+void app_soak_init(uint32_t sample_period_ms)
+{
+#if APP_SOAK
+    app_soak_sample_period_ms = sample_period_ms;
+    app_console_register_command(&app_soak_console_cmd);
+#endif
+}
+
+/*
+ Function Name:
+ app_soak_poll
+
+ Function Description:
+ @brief  Called by the ESS task when it wakes up. Runs a requested soak to
+         the end in place of the sample. The sample timer keeps running, its
+         wake-ups during the run are merged into one.
+
+ @param void
+
+ @return bool  true if a soak ran and the sample must be skipped
+ */
+bool app_soak_poll(void)
+{
+#if APP_SOAK
+    if (app_soak_requested)
+    {
+        app_soak_run();
+        app_soak_requested = false;
+        return true;
+    }
+#endif
+    return false;
+}
+
+/*
+ Function Name:
+ app_soak_is_running
+
+ Function Description:
+ @brief  Tells whether a soak runs, e.g. to keep the per sample log quiet.
+
+ @param void
+
+ @return bool  true while a soak runs
+ */
+bool app_soak_is_running(void)
+{
+#if APP_SOAK
+    return app_soak_running;
+#else
+    return false;
+#endif
+}
+
+#if APP_SOAK
+
+/*
+ Function Name:
+ app_soak_run
+
+ Function Description:
+ @brief  Replays the requested number of days. Samples are due every sample
+         period; the central connects after a random time advertising,
+         subscribes, sets the time, reads now and then and disconnects after
+         a random time connected. Both streams are merged in virtual time
+         order, a sample first when they meet.
+
+ @param void
+
+ @return void
+ */
+static void app_soak_run(void)
+{
+    uint64_t end_ms;
+    uint64_t next_sample_ms;
+    uint64_t next_read_ms = 0;
+    uint64_t session_end_ms = 0;
+    uint64_t next_radio_ms;
+    uint32_t start_tick;
+    bool connected = false;
+    app_memory_buffer_stats_t buffer_stats;
+
+    memset(&app_soak_stats, 0, sizeof(app_soak_stats));
+    app_soak_stats.hash = APP_SOAK_FNV_OFFSET;
+    app_soak_random = (0 != app_soak_seed) ? app_soak_seed : 1u;
+
+    app_memory_get_buffer_stats(&buffer_stats, true);
+    app_heap_trace_reset_peak();
+
+    printf("Soak: %lu days, seed %lu, sample period %lu ms\n",
+           (unsigned long)app_soak_days, (unsigned long)app_soak_seed,
+           (unsigned long)app_soak_sample_period_ms);
+
+    app_soak_now_ms = app_uptime_ms_get();
+    end_ms = app_soak_now_ms + ((uint64_t)app_soak_days * 24u * 3600u * 1000u);
+    next_sample_ms = app_soak_now_ms + app_soak_sample_period_ms;
+    next_radio_ms = app_soak_now_ms + app_soak_span_ms(APP_SOAK_ADV_MEAN_S);
+
+    start_tick = xTaskGetTickCount();
+    app_soak_running = true;
+    app_gatt_tx_set_sink(&app_soak_sink);
+    app_uptime_set_source(app_soak_clock);
+
+    while (app_soak_now_ms < end_ms)
+    {
+        if (next_sample_ms <= next_radio_ms)
+        {
+            app_soak_now_ms = next_sample_ms;
+            app_soak_sample(connected);
+            next_sample_ms += app_soak_sample_period_ms;
+            continue;
+        }
+
+        app_soak_now_ms = next_radio_ms;
+        if (!connected)
+        {
+            if (!app_soak_connect(true))
+            {
+                printf("Soak aborted, a central connected\n");
+                break;
+            }
+            connected = true;
+            session_end_ms = app_soak_now_ms + app_soak_span_ms(APP_SOAK_CONN_MEAN_S);
+            next_read_ms = app_soak_now_ms + app_soak_span_ms(APP_SOAK_READ_MEAN_S);
+        }
+        else if (app_soak_now_ms == session_end_ms)
+        {
+            app_soak_connect(false);
+            connected = false;
+        }
+        else
+        {
+            app_soak_hash(APP_SOAK_EVT_READ, (uint32_t)(app_soak_now_ms / 1000u));
+            app_soak_request(GATT_REQ_READ, HDLC_ESS_TEMPERATURE_VALUE);
+            next_read_ms = app_soak_now_ms + app_soak_span_ms(APP_SOAK_READ_MEAN_S);
+        }
+
+        if (connected)
+        {
+            next_radio_ms = (next_read_ms < session_end_ms) ? next_read_ms : session_end_ms;
+        }
+        else
+        {
+            next_radio_ms = app_soak_now_ms + app_soak_span_ms(APP_SOAK_ADV_MEAN_S);
+        }
+    }
+
+    if (connected)
+    {
+        app_soak_connect(false);
+    }
+
+    app_uptime_set_source(NULL);
+    app_gatt_tx_set_sink(NULL);
+    app_soak_running = false;
+
+    app_soak_report((uint32_t)(((uint64_t)(xTaskGetTickCount() - start_tick) * 1000u) /
+                               configTICK_RATE_HZ));
+}
+
+/*
+ Function Name:
+ app_soak_clock
+
+ Function Description:
+ @brief  Time source of app_uptime_ms_get() during a run.
+
+ @param void
+
+ @return uint64_t  Virtual time in milliseconds
+ */
+static uint64_t app_soak_clock(void)
+{
+    return app_soak_now_ms;
+}
+
+/*
+ Function Name:
+ app_soak_span_ms
+
+ Function Description:
+ @brief  Draws a time uniformly between half and one and a half times the
+         mean, from the seeded generator.
+
+ @param mean_s  Mean time in seconds
+
+ @return uint32_t  Time in milliseconds, at least 1
+ */
+static uint32_t app_soak_span_ms(uint32_t mean_s)
+{
+    /* xorshift32 */
+    app_soak_random ^= app_soak_random << 13;
+    app_soak_random ^= app_soak_random >> 17;
+    app_soak_random ^= app_soak_random << 5;
+
+    return (mean_s * 500u) + (app_soak_random % (mean_s * 1000u + 1u)) + 1u;
+}
+
+/*
+ Function Name:
+ app_soak_hash
+
+ Function Description:
+ @brief  Adds an event to the fingerprint of the run (FNV-1a). Two runs with
+         the same seed and build must give the same fingerprint.
+
+ @param kind   APP_SOAK_EVT_xxx
+ @param value  Value of the event
+
+ @return void
+ */
+static void app_soak_hash(uint32_t kind, uint32_t value)
+{
+    uint32_t hash = app_soak_stats.hash;
+    uint32_t i;
+
+    hash = (hash ^ kind) * APP_SOAK_FNV_PRIME;
+    for (i = 0; i < 4u; i++)
+    {
+        hash = (hash ^ ((value >> (8u * i)) & 0xFFu)) * APP_SOAK_FNV_PRIME;
+    }
+    app_soak_stats.hash = hash;
+}
+
+/*
+ Function Name:
+ app_soak_sample
+
+ Function Description:
+ @brief  Runs one sample period of the ESS task and records its cost. The
+         published temperature enters the fingerprint.
+
+ @param connected  The simulated central is connected
+
+ @return void
+ */
+static void app_soak_sample(bool connected)
+{
+    uint32_t start_cycles = app_cycle_counter_get();
+    uint32_t cycles;
+
+    app_ess_sample(connected ? APP_SOAK_CONN_ID : 0u);
+
+    cycles = app_cycle_counter_get() - start_cycles;
+    app_soak_stats.samples++;
+    app_soak_stats.sample_total_cycles += cycles;
+    if (app_soak_stats.sample_max_cycles < cycles)
+    {
+        app_soak_stats.sample_max_cycles = cycles;
+    }
+
+    app_soak_hash(APP_SOAK_EVT_SAMPLE, ((uint32_t)app_ess_temperature[1] << 8) |
+                                       app_ess_temperature[0]);
+}
+
+/*
+ Function Name:
+ app_soak_connect
+
+ Function Description:
+ @brief  Connects or disconnects the simulated central. After connecting, it
+         exchanges the MTU, subscribes to the temperature and sets the time.
+
+ @param connected  Connection or disconnection
+
+ @return bool  false if a real central holds the connection
+ */
+static bool app_soak_connect(bool connected)
+{
+    wiced_bt_gatt_event_data_t event_data;
+    uint64_t epoch_ms;
+
+    if (connected && (0 != app_bt_conn_id))
+    {
+        return false;
+    }
+
+    app_soak_hash(connected ? APP_SOAK_EVT_CONNECT : APP_SOAK_EVT_DISCONNECT,
+                  (uint32_t)(app_soak_now_ms / 1000u));
+
+    memset(&event_data, 0, sizeof(event_data));
+    event_data.connection_status.bd_addr = (uint8_t *)app_soak_bd_addr;
+    event_data.connection_status.conn_id = APP_SOAK_CONN_ID;
+    event_data.connection_status.connected = connected ? WICED_TRUE : WICED_FALSE;
+    event_data.connection_status.reason = connected ? 0 : GATT_CONN_TERMINATE_PEER_USER;
+    app_bt_gatt_event_callback(GATT_CONNECTION_STATUS_EVT, &event_data);
+
+    if (!connected)
+    {
+        return true;
+    }
+
+    app_soak_stats.sessions++;
+    app_soak_request(GATT_REQ_MTU, 0);
+    app_soak_request(GATT_REQ_WRITE, HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG);
+
+    /* The central's clock runs from APP_SOAK_EPOCH_S at the start of the run */
+    epoch_ms = ((uint64_t)APP_SOAK_EPOCH_S * 1000u) +
+               (app_soak_now_ms - (app_soak_now_ms % 1000u));
+    app_time_sync(epoch_ms, APP_TIME_ADJUST_EXTERNAL);
+
+    return true;
+}
+
+/*
+ Function Name:
+ app_soak_request
+
+ Function Description:
+ @brief  Sends a request of the simulated central through the GATT event
+         callback and waits for its response. The GATT worker runs above the
+         ESS task, so a deferred request is normally answered before the
+         callback returns.
+
+ @param opcode  GATT_REQ_MTU, GATT_REQ_READ or GATT_REQ_WRITE (CCCD value)
+ @param handle  Handle to read or write
+
+ @return void
+ */
+static void app_soak_request(wiced_bt_gatt_opcode_t opcode, uint16_t handle)
+{
+    wiced_bt_gatt_event_data_t event_data;
+    wiced_bt_gatt_attribute_request_t *p_attr_req = &event_data.attribute_request;
+    uint32_t start_cycles;
+    uint32_t cycles;
+    uint32_t waited_ms = 0;
+
+    memset(&event_data, 0, sizeof(event_data));
+    p_attr_req->conn_id = APP_SOAK_CONN_ID;
+    p_attr_req->opcode = opcode;
+    p_attr_req->len_requested = CY_BT_MTU_SIZE;
+    if (GATT_REQ_MTU == opcode)
+    {
+        p_attr_req->data.remote_mtu = CY_BT_MTU_SIZE;
+    }
+    else if (GATT_REQ_READ == opcode)
+    {
+        p_attr_req->data.read_req.handle = handle;
+    }
+    else
+    {
+        p_attr_req->data.write_req.handle = handle;
+        p_attr_req->data.write_req.val_len = sizeof(app_soak_cccd_value);
+        p_attr_req->data.write_req.p_val = app_soak_cccd_value;
+    }
+
+    app_soak_pending = true;
+    app_soak_stats.requests++;
+    start_cycles = app_cycle_counter_get();
+
+    app_bt_gatt_event_callback(GATT_ATTRIBUTE_REQUEST_EVT, &event_data);
+    while (app_soak_pending && (APP_SOAK_RESPONSE_TIMEOUT_MS > waited_ms))
+    {
+        vTaskDelay(pdMS_TO_TICKS(1));
+        waited_ms++;
+    }
+
+    cycles = app_cycle_counter_get() - start_cycles;
+    app_soak_stats.request_total_cycles += cycles;
+    if (app_soak_stats.request_max_cycles < cycles)
+    {
+        app_soak_stats.request_max_cycles = cycles;
+    }
+
+    if (app_soak_pending)
+    {
+        app_soak_pending = false;
+        app_soak_stats.failed++;
+        app_soak_hash(APP_SOAK_EVT_RESPONSE, 0xFFFFFFFFu);
+    }
+    else
+    {
+        if (WICED_BT_GATT_SUCCESS != app_soak_status)
+        {
+            app_soak_stats.failed++;
+        }
+        app_soak_hash(APP_SOAK_EVT_RESPONSE, ((uint32_t)opcode << 16) | app_soak_status);
+    }
+}
+
+/*
+ Function Name:
+ app_soak_owns
+
+ Function Description:
+ @brief  Sink callback, claims the connection of the simulated central.
+
+ @param conn_id  Connection ID
+
+ @return bool  true for the simulated central during a run
+ */
+static bool app_soak_owns(uint16_t conn_id)
+{
+    return app_soak_running && (APP_SOAK_CONN_ID == conn_id);
+}
+
+/*
+ Function Name:
+ app_soak_complete
+
+ Function Description:
+ @brief  Sink callback, receives the responses and notifications sent to the
+         simulated central.
+
+ @param conn_id  Connection ID
+ @param opcode   Opcode of the request, GATT_HANDLE_VALUE_NOTIF for a
+                 notification
+ @param status   Status of the response
+
+ @return void
+ */
+static void app_soak_complete(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+                              wiced_bt_gatt_status_t status)
+{
+    if (GATT_HANDLE_VALUE_NOTIF == opcode)
+    {
+        /* Sent from app_ess_sample() in the ESS task itself */
+        app_soak_stats.notifications++;
+        app_soak_hash(APP_SOAK_EVT_NOTIFICATION, (uint32_t)(app_soak_now_ms / 1000u));
+        return;
+    }
+
+    app_soak_status = status;
+    app_soak_pending = false;
+}
+
+/*
+ Function Name:
+ app_soak_report
+
+ Function Description:
+ @brief  Prints the outcome of a run: the event counts and fingerprint, the
+         speed-up over real time, the cost of a sample and of a request, the
+         buffer and heap peaks, and the temperature statistics.
+
+ @param wall_ms  Real duration of the run
+
+ @return void
+ */
+static void app_soak_report(uint32_t wall_ms)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    app_memory_buffer_stats_t buffer_stats;
+    uint32_t virtual_s = (uint32_t)(((uint64_t)app_soak_stats.samples *
+                                     app_soak_sample_period_ms) / 1000u);
+
+    wall_ms = (0u == wall_ms) ? 1u : wall_ms;
+
+    printf("SOAK seed=%lu samples=%lu sessions=%lu requests=%lu failed=%lu "
+           "notifications=%lu hash=%08lx\n",
+           (unsigned long)app_soak_seed, (unsigned long)app_soak_stats.samples,
+           (unsigned long)app_soak_stats.sessions, (unsigned long)app_soak_stats.requests,
+           (unsigned long)app_soak_stats.failed,
+           (unsigned long)app_soak_stats.notifications,
+           (unsigned long)app_soak_stats.hash);
+    printf("  %lu s of virtual time in %lu ms, %lux real time\n",
+           (unsigned long)virtual_s, (unsigned long)wall_ms,
+           (unsigned long)(((uint64_t)virtual_s * 1000u) / wall_ms));
+    if (0u != app_soak_stats.samples)
+    {
+        printf("  sample: avg %lu us, max %lu us\n",
+               (unsigned long)((app_soak_stats.sample_total_cycles /
+                                app_soak_stats.samples) / cycles_per_us),
+               (unsigned long)(app_soak_stats.sample_max_cycles / cycles_per_us));
+    }
+    if (0u != app_soak_stats.requests)
+    {
+        printf("  request: avg %lu us, max %lu us\n",
+               (unsigned long)((app_soak_stats.request_total_cycles /
+                                app_soak_stats.requests) / cycles_per_us),
+               (unsigned long)(app_soak_stats.request_max_cycles / cycles_per_us));
+    }
+
+    app_memory_get_buffer_stats(&buffer_stats, false);
+    printf("  response buffers: peak %lu in use, %lu allocation failures\n",
+           (unsigned long)buffer_stats.peak, (unsigned long)buffer_stats.fails);
+#if APP_HEAP_TRACE
+    {
+        app_heap_trace_stats_t heap_stats;
+
+        app_heap_trace_get_stats(&heap_stats);
+        printf("  heap: peak %lu bytes in %lu blocks, %lu live, %lu failed allocations\n",
+               (unsigned long)heap_stats.peak_bytes, (unsigned long)heap_stats.peak_blocks,
+               (unsigned long)heap_stats.live_bytes, (unsigned long)heap_stats.fail_count);
+    }
+#endif
+    app_stats_print();
+    printf("  The clock is back on real time; reset the board before relying on the "
+           "history, log and statistics\n");
+}
+
+/*
+ Function Name:
+ app_soak_cmd
+
+ Function Description:
+ @brief  Console command requesting a soak run. The ESS task starts it at
+         its next wake-up. The run needs the server idle, so it is refused
+         while a central is connected.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_soak_cmd(uint32_t argc, char *argv[])
+{
+    uint32_t days;
+
+    if (app_soak_requested)
+    {
+        printf("Soak already requested\n");
+        return;
+    }
+    if (0 != app_bt_conn_id)
+    {
+        printf("Disconnect the central first\n");
+        return;
+    }
+    if (2 > argc)
+    {
+        printf("Usage: soak <days> [seed]\n");
+        return;
+    }
+
+    days = strtoul(argv[1], NULL, 0);
+    if ((0 == days) || (APP_SOAK_MAX_DAYS < days))
+    {
+        printf("Days 1..%u\n", (unsigned)APP_SOAK_MAX_DAYS);
+        return;
+    }
+
+    app_soak_days = days;
+    app_soak_seed = (2 < argc) ? strtoul(argv[2], NULL, 0) : 1u;
+    app_soak_requested = true;
+    printf("Soak starts with the next sample\n");
+}
+
+#endif /* APP_SOAK */
+
+/* [] END OF FILE */
@@ -0,0 +1,101 @@
+/*******************************************************************************
+* File Name: app_soak.h
+*
+* Description: This file contains the definitions of the soak mode, which
+*              replays days of sampling and connections on a virtual clock.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_SOAK_H__
+#define __APP_SOAK_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_SOAK=1 in the Makefile to add the soak console
+ * command. The Makefile then selects the simulated sensor and the RAM flash
+ * log, so a run neither waits for the ADC nor wears the flash.
+ */
+#ifndef APP_SOAK
+#define APP_SOAK                         (0u)
+#endif
+
+/* Connection ID of the simulated central, outside the range of the stack */
+#define APP_SOAK_CONN_ID                 (0x5000u)
+
+/* Mean time spent advertising between two connections */
+#ifndef APP_SOAK_ADV_MEAN_S
+#define APP_SOAK_ADV_MEAN_S              (900u)
+#endif
+
+/* Mean length of a connection */
+#ifndef APP_SOAK_CONN_MEAN_S
+#define APP_SOAK_CONN_MEAN_S             (3600u)
+#endif
+
+/* Mean time between two reads of the temperature by the central */
+#ifndef APP_SOAK_READ_MEAN_S
+#define APP_SOAK_READ_MEAN_S             (600u)
+#endif
+
+/* Time the central writes at the start of the run, 2026-01-01 00:00 UTC */
+#define APP_SOAK_EPOCH_S                 (1767225600u)
+
+/* Longest run, in days */
+#define APP_SOAK_MAX_DAYS                (366u)
+
+/* A request not answered within this wall clock time counts as failed */
+#define APP_SOAK_RESPONSE_TIMEOUT_MS     (100u)
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_soak_init(uint32_t sample_period_ms);
+
+bool app_soak_poll(void);
+
+bool app_soak_is_running(void);
+
+#endif      /* __APP_SOAK_H__ */
+
+/* [] END OF FILE */
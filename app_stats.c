@@ -0,0 +1,578 @@
+/*******************************************************************************
+* File Name: app_stats.c
+*
+* Description: This file contains the windowed temperature statistics. Minimum,
+*              maximum, mean and variance over sliding windows are kept up to
+*              date in constant time per sample and served by a GATT
+*              characteristic.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_stats.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+#define APP_STATS_SUMMARY_LEN            (APP_STATS_NUM_WINDOWS * APP_STATS_RECORD_LEN)
+
+/* Slot of a bucket in the ring of its window */
+#define APP_STATS_SLOT(id)               ((id) % APP_STATS_BUCKETS)
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* Samples of one bucket. Sums are exact integers, so a bucket leaving the
+ * window is removed from the window totals without rounding error. */
+typedef struct
+{
+    int64_t     sum_sq;
+    int32_t     sum;
+    uint16_t    count;
+    int16_t     min;
+    int16_t     max;
+} app_stats_bucket_t;
+
+/* Monotonic deque of bucket numbers: the minimum (maximum) of the window is
+ * the bucket at the head, later buckets with a smaller (larger) extreme
+ * follow in order. */
+typedef struct
+{
+    uint32_t    ids[APP_STATS_BUCKETS];
+    uint8_t     head;
+    uint8_t     len;
+} app_stats_deque_t;
+
+typedef struct
+{
+    app_stats_bucket_t  buckets[APP_STATS_BUCKETS];
+    uint32_t            cur_id;     /* Bucket number, time / bucket span */
+    bool                started;
+    int64_t             sum_sq;
+    int64_t             sum;
+    uint32_t            count;
+    app_stats_deque_t   min_q;
+    app_stats_deque_t   max_q;
+} app_stats_window_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static const uint32_t   app_stats_window_span_s[APP_STATS_NUM_WINDOWS] = APP_STATS_WINDOWS_S;
+
+/* Zero initialized windows are empty and valid, samples can be added
+ * before app_stats_init() */
+static app_stats_window_t app_stats_windows[APP_STATS_NUM_WINDOWS];
+
+/* Time base of the windows, in seconds since the first sample */
+static uint64_t         app_stats_last_ms;
+static uint32_t         app_stats_time_ms;
+static uint32_t         app_stats_time_s;
+static bool             app_stats_time_started;
+
+/* Value of the summary characteristic */
+static uint8_t          app_stats_summary[APP_STATS_SUMMARY_LEN];
+
+static gatt_db_lookup_table_t app_stats_attrs[] =
+{
+    { HDLC_APP_STATS_SUMMARY_VALUE, APP_STATS_SUMMARY_LEN, APP_STATS_SUMMARY_LEN,
+      app_stats_summary },
+};
+
+/* Attribute types of app_stats_attrs */
+static const wiced_bt_uuid_t app_stats_types[] =
+{
+    { LEN_UUID_128, { .uuid128 = { APP_STATS_UUID_SUMMARY } } },
+};
+
+APP_MEMORY_FOOTPRINT(app_stats_ram_footprint,
+                     sizeof(app_stats_windows) + sizeof(app_stats_summary));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static void app_stats_advance(app_stats_window_t *p_win, uint32_t id);
+
+static void app_stats_deque_push(app_stats_window_t *p_win, app_stats_deque_t *p_q,
+                                 uint32_t id, bool is_min);
+
+static void app_stats_deque_expire(app_stats_deque_t *p_q, uint32_t oldest_id);
+
+static void app_stats_encode(const app_stats_window_t *p_win, uint32_t span_s,
+                             uint8_t *p_record);
+
+static uint32_t app_stats_isqrt(uint32_t value);
+
+static wiced_bt_gatt_status_t app_stats_add_service(void);
+
+static void app_stats_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const uint8_t app_stats_gatt_db[] =
+{
+    PRIMARY_SERVICE_UUID128(HDLS_APP_STATS, APP_STATS_UUID_SERVICE),
+        CHARACTERISTIC_UUID128(HDLC_APP_STATS_SUMMARY, HDLC_APP_STATS_SUMMARY_VALUE,
+                               APP_STATS_UUID_SUMMARY, GATTDB_CHAR_PROP_READ,
+                               GATTDB_PERM_READABLE),
+};
+
+static const app_console_cmd_t app_stats_console_cmd =
+{
+    "stats", "Temperature statistics of the sliding windows; 'stats service on|off'",
+    app_stats_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_stats_init
+
+ Function Description:
+ @brief  Adds the statistics service to the GATT database. Must be called
+         after wiced_bt_gatt_db_init().
+
+ @param void
+
+ @return void
+ */
+void app_stats_init(void)
+{
+    wiced_bt_gatt_status_t gatt_status;
+    uint32_t i;
+
+    for (i = 0; i < APP_STATS_NUM_WINDOWS; i++)
+    {
+        app_stats_encode(&app_stats_windows[i], app_stats_window_span_s[i],
+                         &app_stats_summary[i * APP_STATS_RECORD_LEN]);
+    }
+
+    gatt_status = app_stats_add_service();
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Statistics service not added, err 0x%x\n", gatt_status);
+    }
+
+    app_console_register_command(&app_stats_console_cmd);
+}
+
+/*
+ Function Name:
+ app_stats_add_sample
+
+ Function Description:
+ @brief  Adds a sample to every window and updates the characteristic
+         value. Constant time: bucket expiry and the deque updates are
+         amortized over the samples.
+
+ @param value  Temperature in hundredths of a degree Celsius
+
+ @return void
+ */
+void app_stats_add_sample(int16_t value)
+{
+    uint8_t summary[APP_STATS_SUMMARY_LEN];
+    app_stats_window_t *p_win;
+    app_stats_bucket_t *p_bucket;
+    uint64_t now_ms = app_uptime_ms_get();
+    uint32_t i;
+
+    if (app_stats_time_started)
+    {
+        app_stats_time_ms += (uint32_t)(now_ms - app_stats_last_ms);
+        app_stats_time_s += app_stats_time_ms / 1000u;
+        app_stats_time_ms %= 1000u;
+    }
+    app_stats_last_ms = now_ms;
+    app_stats_time_started = true;
+
+    for (i = 0; i < APP_STATS_NUM_WINDOWS; i++)
+    {
+        p_win = &app_stats_windows[i];
+        app_stats_advance(p_win,
+                          app_stats_time_s / (app_stats_window_span_s[i] / APP_STATS_BUCKETS));
+
+        p_bucket = &p_win->buckets[APP_STATS_SLOT(p_win->cur_id)];
+        if (0 == p_bucket->count)
+        {
+            p_bucket->min = value;
+            p_bucket->max = value;
+        }
+        else
+        {
+            p_bucket->min = (value < p_bucket->min) ? value : p_bucket->min;
+            p_bucket->max = (value > p_bucket->max) ? value : p_bucket->max;
+        }
+        p_bucket->count++;
+        p_bucket->sum += value;
+        p_bucket->sum_sq += (int32_t)value * value;
+
+        p_win->count++;
+        p_win->sum += value;
+        p_win->sum_sq += (int32_t)value * value;
+
+        app_stats_deque_push(p_win, &p_win->min_q, p_win->cur_id, true);
+        app_stats_deque_push(p_win, &p_win->max_q, p_win->cur_id, false);
+
+        app_stats_encode(p_win, app_stats_window_span_s[i],
+                         &summary[i * APP_STATS_RECORD_LEN]);
+    }
+
+    /* The Bluetooth stack task reads the value, update it in one piece */
+    taskENTER_CRITICAL();
+    memcpy(app_stats_summary, summary, sizeof(app_stats_summary));
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_stats_advance
+
+ Function Description:
+ @brief  Moves the current bucket of a window forward to bucket number id.
+         The buckets falling out of the window are subtracted from the
+         totals and dropped from the deques.
+
+ @param p_win  Window
+ @param id     Bucket number of the new sample
+
+ @return void
+ */
+static void app_stats_advance(app_stats_window_t *p_win, uint32_t id)
+{
+    app_stats_bucket_t *p_bucket;
+
+    if (!p_win->started || ((p_win->cur_id + APP_STATS_BUCKETS) <= id))
+    {
+        /* First sample or the whole window expired */
+        memset(p_win, 0, sizeof(*p_win));
+        p_win->cur_id = id;
+        p_win->started = true;
+        return;
+    }
+
+    while (p_win->cur_id < id)
+    {
+        /* The slot of the next bucket holds the oldest one */
+        p_win->cur_id++;
+        p_bucket = &p_win->buckets[APP_STATS_SLOT(p_win->cur_id)];
+        p_win->count -= p_bucket->count;
+        p_win->sum -= p_bucket->sum;
+        p_win->sum_sq -= p_bucket->sum_sq;
+        memset(p_bucket, 0, sizeof(*p_bucket));
+    }
+
+    if (APP_STATS_BUCKETS <= id)
+    {
+        app_stats_deque_expire(&p_win->min_q, id - APP_STATS_BUCKETS + 1u);
+        app_stats_deque_expire(&p_win->max_q, id - APP_STATS_BUCKETS + 1u);
+    }
+}
+
+/*
+ Function Name:
+ app_stats_deque_push
+
+ Function Description:
+ @brief  Enters the current bucket at the tail of a deque after its
+         extreme changed. Buckets at the tail that can no longer be the
+         extreme of the window are removed first; this includes the current
+         bucket itself when it was already queued.
+
+ @param p_win   Window
+ @param p_q     Minimum or maximum deque
+ @param id      Bucket number of the current bucket
+ @param is_min  true for the minimum deque
+
+ @return void
+ */
+static void app_stats_deque_push(app_stats_window_t *p_win, app_stats_deque_t *p_q,
+                                 uint32_t id, bool is_min)
+{
+    const app_stats_bucket_t *p_cur = &p_win->buckets[APP_STATS_SLOT(id)];
+    const app_stats_bucket_t *p_tail;
+
+    while (0 < p_q->len)
+    {
+        p_tail = &p_win->buckets[APP_STATS_SLOT(
+                     p_q->ids[(p_q->head + p_q->len - 1u) % APP_STATS_BUCKETS])];
+        if (is_min ? (p_tail->min < p_cur->min) : (p_tail->max > p_cur->max))
+        {
+            break;
+        }
+        p_q->len--;
+    }
+
+    p_q->ids[(p_q->head + p_q->len) % APP_STATS_BUCKETS] = id;
+    p_q->len++;
+}
+
+/*
+ Function Name:
+ app_stats_deque_expire
+
+ Function Description:
+ @brief  Removes the buckets older than oldest_id from the head of a deque.
+
+ @param p_q        Deque
+ @param oldest_id  Number of the oldest bucket in the window
+
+ @return void
+ */
+static void app_stats_deque_expire(app_stats_deque_t *p_q, uint32_t oldest_id)
+{
+    while ((0 < p_q->len) && (p_q->ids[p_q->head] < oldest_id))
+    {
+        p_q->head = (uint8_t)((p_q->head + 1u) % APP_STATS_BUCKETS);
+        p_q->len--;
+    }
+}
+
+/*
+ Function Name:
+ app_stats_encode
+
+ Function Description:
+ @brief  Writes the record of a window in the characteristic format.
+
+ @param p_win     Window
+ @param span_s    Span of the window
+ @param p_record  Output, APP_STATS_RECORD_LEN bytes
+
+ @return void
+ */
+static void app_stats_encode(const app_stats_window_t *p_win, uint32_t span_s,
+                             uint8_t *p_record)
+{
+    int16_t min = APP_STATS_UNKNOWN;
+    int16_t max = APP_STATS_UNKNOWN;
+    int16_t mean = APP_STATS_UNKNOWN;
+    uint64_t variance = 0;
+    uint64_t n = p_win->count;
+    int64_t half = (int64_t)(n / 2u);
+
+    if (0 != n)
+    {
+        min = p_win->buckets[APP_STATS_SLOT(p_win->min_q.ids[p_win->min_q.head])].min;
+        max = p_win->buckets[APP_STATS_SLOT(p_win->max_q.ids[p_win->max_q.head])].max;
+        mean = (int16_t)(((0 <= p_win->sum) ? (p_win->sum + half) : (p_win->sum - half)) /
+                         (int64_t)n);
+        /* n * sum(x^2) - sum(x)^2 is exact and not negative; unsigned keeps
+         * a day of samples at full scale from overflowing */
+        variance = ((n * (uint64_t)p_win->sum_sq) -
+                    ((uint64_t)((p_win->sum < 0) ? -p_win->sum : p_win->sum) *
+                     (uint64_t)((p_win->sum < 0) ? -p_win->sum : p_win->sum))) / n / n;
+        variance = (UINT32_MAX < variance) ? UINT32_MAX : variance;
+    }
+
+    p_record[0] = (uint8_t)span_s;
+    p_record[1] = (uint8_t)(span_s >> 8);
+    p_record[2] = (uint8_t)(span_s >> 16);
+    p_record[3] = (uint8_t)(span_s >> 24);
+    p_record[4] = (uint8_t)n;
+    p_record[5] = (uint8_t)(n >> 8);
+    p_record[6] = (uint8_t)(n >> 16);
+    p_record[7] = (uint8_t)(n >> 24);
+    p_record[8] = (uint8_t)min;
+    p_record[9] = (uint8_t)((uint16_t)min >> 8);
+    p_record[10] = (uint8_t)max;
+    p_record[11] = (uint8_t)((uint16_t)max >> 8);
+    p_record[12] = (uint8_t)mean;
+    p_record[13] = (uint8_t)((uint16_t)mean >> 8);
+    p_record[14] = (uint8_t)variance;
+    p_record[15] = (uint8_t)(variance >> 8);
+    p_record[16] = (uint8_t)(variance >> 16);
+    p_record[17] = (uint8_t)(variance >> 24);
+}
+
+/*
+ Function Name:
+ app_stats_isqrt
+
+ Function Description:
+ @brief  Integer square root, rounded down.
+
+ @param value  Value
+
+ @return uint32_t  floor(sqrt(value))
+ */
+static uint32_t app_stats_isqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (0 != bit)
+    {
+        if (value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+/*
+ Function Name:
+ app_stats_print
+
+ Function Description:
+ @brief  Prints the statistics as served by the characteristic.
+
+ @param void
+
+ @return void
+ */
+void app_stats_print(void)
+{
+    uint8_t summary[APP_STATS_SUMMARY_LEN];
+    const uint8_t *p_rec;
+    uint32_t span_s, count, variance, stddev;
+    int16_t min, max, mean;
+    uint32_t i;
+
+    taskENTER_CRITICAL();
+    memcpy(summary, app_stats_summary, sizeof(summary));
+    taskEXIT_CRITICAL();
+
+    printf("Temperature statistics (0.01 C), %lu s of samples\n",
+           (unsigned long)app_stats_time_s);
+    for (i = 0; i < APP_STATS_NUM_WINDOWS; i++)
+    {
+        p_rec = &summary[i * APP_STATS_RECORD_LEN];
+        span_s = p_rec[0] | (p_rec[1] << 8) | (p_rec[2] << 16) | ((uint32_t)p_rec[3] << 24);
+        count = p_rec[4] | (p_rec[5] << 8) | (p_rec[6] << 16) | ((uint32_t)p_rec[7] << 24);
+        min = (int16_t)(p_rec[8] | (p_rec[9] << 8));
+        max = (int16_t)(p_rec[10] | (p_rec[11] << 8));
+        mean = (int16_t)(p_rec[12] | (p_rec[13] << 8));
+        variance = p_rec[14] | (p_rec[15] << 8) | (p_rec[16] << 16) |
+                   ((uint32_t)p_rec[17] << 24);
+        stddev = app_stats_isqrt(variance);
+
+        if (0 == count)
+        {
+            printf("  %6lu s: no samples\n", (unsigned long)span_s);
+            continue;
+        }
+        printf("  %6lu s: n %lu, min %d, max %d, mean %d, variance %lu, stddev %lu\n",
+               (unsigned long)span_s, (unsigned long)count, min, max, mean,
+               (unsigned long)variance, (unsigned long)stddev);
+    }
+}
+
+/*
+ Function Name:
+ app_stats_add_service
+
+ Function Description:
+ @brief  Adds the statistics service to the GATT database.
+
+ @param void
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t app_stats_add_service(void)
+{
+    return app_gatt_add_service(app_stats_gatt_db, sizeof(app_stats_gatt_db),
+                                app_stats_attrs, app_stats_types,
+                                sizeof(app_stats_attrs) / sizeof(app_stats_attrs[0]),
+                                NULL);
+}
+
+/*
+ Function Name:
+ app_stats_cmd
+
+ Function Description:
+ @brief  "stats" console command. "stats service on|off" adds or removes
+         the statistics service at run time.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_stats_cmd(uint32_t argc, char *argv[])
+{
+    wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_SUCCESS;
+
+    /* The service is a diagnostic: it can be taken out of the database and
+     * put back without a reset, the client is told with Service Changed */
+    if ((3 <= argc) && (0 == strcmp(argv[1], "service")) && (0 == strcmp(argv[2], "on")))
+    {
+        gatt_status = app_stats_add_service();
+    }
+    else if ((3 <= argc) && (0 == strcmp(argv[1], "service")) &&
+             (0 == strcmp(argv[2], "off")))
+    {
+        gatt_status = app_gatt_remove_service(HDLS_APP_STATS);
+    }
+    else
+    {
+        app_stats_print();
+        return;
+    }
+
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Statistics service not changed, err 0x%x\n", gatt_status);
+    }
+}
+
+/* [] END OF FILE */
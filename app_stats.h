@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name: app_stats.h
+*
+* Description: This file contains the interface of the windowed temperature
+*              statistics and of the GATT service that reports them.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_STATS_H__
+#define __APP_STATS_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_handler.h"
+#include <stdint.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Sliding windows, in seconds. Every span must be a multiple of
+ * APP_STATS_BUCKETS seconds. */
+#define APP_STATS_WINDOWS_S              { 60u, 3600u, 86400u }
+#define APP_STATS_NUM_WINDOWS            (3u)
+
+/* Buckets per window. The window slides by span / APP_STATS_BUCKETS, so
+ * the statistics cover between (APP_STATS_BUCKETS - 1) and APP_STATS_BUCKETS
+ * buckets of the past. */
+#define APP_STATS_BUCKETS                (20u)
+
+/* Characteristic value: one record per window, little endian
+ *   uint32 span (s), uint32 count, sint16 min, sint16 max, sint16 mean,
+ *   uint32 variance
+ * Temperatures are in hundredths of a degree Celsius, the variance in
+ * (hundredths of a degree)^2. An empty window reports count 0 and
+ * APP_STATS_UNKNOWN for min, max and mean. */
+#define APP_STATS_RECORD_LEN             (18u)
+#define APP_STATS_UNKNOWN                (INT16_MIN)
+
+/* Temperature statistics service, vendor specific */
+#define APP_STATS_UUID_SERVICE           0x10, 0x0e, 0x1d, 0x4c, 0x7f, 0x2b, 0x1f, 0x9c, \
+                                         0x2a, 0x4d, 0x6b, 0x8e, 0x01, 0x00, 0x3e, 0x5a
+#define APP_STATS_UUID_SUMMARY           0x10, 0x0e, 0x1d, 0x4c, 0x7f, 0x2b, 0x1f, 0x9c, \
+                                         0x2a, 0x4d, 0x6b, 0x8e, 0x02, 0x00, 0x3e, 0x5a
+
+#define HDLS_APP_STATS                   (APP_GATT_APP_HANDLE_BASE)
+#define HDLC_APP_STATS_SUMMARY           (APP_GATT_APP_HANDLE_BASE + 1u)
+#define HDLC_APP_STATS_SUMMARY_VALUE     (APP_GATT_APP_HANDLE_BASE + 2u)
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_stats_init(void);
+
+void app_stats_add_sample(int16_t value);
+
+void app_stats_print(void);
+
+#endif      /* __APP_STATS_H__ */
+
+/* [] END OF FILE */
@@ -0,0 +1,663 @@
+/*******************************************************************************
+* File Name: app_stream.c
+*
+* Description: This file contains the streaming ingress. Write commands to the
+*              stream data characteristic are taken in the Bluetooth stack
+*              thread and appended to a ring of pooled slots, without the
+*              attribute lookup and value copy of other writes; a task hands
+*              the payload to the consumer in order.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_stream.h"
+#include "app_bt_gatt_dispatch.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include "cyhal.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if APP_STREAM
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* A write command, header included */
+typedef struct
+{
+    uint16_t    len;
+    uint8_t     data[APP_STREAM_SLOT_SIZE];
+} app_stream_slot_t;
+
+/* Counters of the current transfer */
+typedef struct
+{
+    uint32_t    writes;
+    uint32_t    bytes;
+    uint32_t    gaps;
+    uint32_t    overflows;
+    uint32_t    malformed;
+    uint32_t    consumed;
+    uint32_t    checksum;
+    uint64_t    first_ms;
+    uint64_t    last_ms;
+} app_stream_stats_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Receive ring. The stack thread is the only writer of the head and the
+ * stream task the only writer of the tail; both run free, the slot of an
+ * index is index % APP_STREAM_SLOTS. Each side publishes its index only
+ * after a barrier, once it is done with the slot. */
+static app_stream_slot_t            app_stream_slots[APP_STREAM_SLOTS];
+static volatile uint32_t            app_stream_head;
+static volatile uint32_t            app_stream_tail;
+
+/* Sequence number expected next, none before the first write */
+static uint16_t                     app_stream_next_seq;
+static bool                         app_stream_started;
+
+static app_stream_stats_t           app_stream_stats;
+static app_stream_consumer_t        p_app_stream_consumer;
+
+/* Handler of the write commands to other characteristics */
+static app_gatt_opcode_handler_t    p_app_stream_next_handler;
+
+static TaskHandle_t                 app_stream_task_handle;
+
+static uint8_t                      app_stream_status[APP_STREAM_STATUS_LEN];
+
+static gatt_db_lookup_table_t app_stream_attrs[] =
+{
+    /* Never read or written through the GATT DB */
+    { HDLC_APP_STREAM_DATA_VALUE, 0, 0, NULL },
+    { HDLC_APP_STREAM_STATUS_VALUE, APP_STREAM_STATUS_LEN, APP_STREAM_STATUS_LEN,
+      app_stream_status },
+};
+
+#if APP_STATIC_MEMORY
+/* Task stack and control block in static memory mode */
+static StackType_t  app_stream_stack[APP_STREAM_STACK_SIZE];
+static StaticTask_t app_stream_tcb;
+
+APP_MEMORY_FOOTPRINT(app_stream_ram_footprint,
+                     sizeof(app_stream_slots) + sizeof(app_stream_status) +
+                     sizeof(app_stream_stack) + sizeof(app_stream_tcb));
+#else
+APP_MEMORY_FOOTPRINT(app_stream_ram_footprint,
+                     sizeof(app_stream_slots) + sizeof(app_stream_status));
+#endif
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static wiced_bt_gatt_status_t
+app_stream_cmd_write_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                             uint16_t *p_error_handle);
+
+static void app_stream_ingress(const uint8_t *p_val, uint16_t len);
+
+static void app_stream_task(void *pvParam);
+
+static void app_stream_checksum(const uint8_t *p_data, uint16_t len);
+
+static void app_stream_reset(void);
+
+static uint32_t app_stream_kbps(void);
+
+static void app_stream_bench(uint32_t writes, uint32_t gap_every);
+
+static void app_stream_read_cb(uint16_t attr_handle);
+
+static wiced_bt_gatt_status_t app_stream_write_cb(uint16_t attr_handle, uint16_t offset,
+                                                  const uint8_t *p_val, uint16_t len);
+
+static void app_stream_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const uint8_t app_stream_gatt_db[] =
+{
+    PRIMARY_SERVICE_UUID128(HDLS_APP_STREAM, APP_STREAM_UUID_SERVICE),
+        CHARACTERISTIC_UUID128(HDLC_APP_STREAM_DATA, HDLC_APP_STREAM_DATA_VALUE,
+                               APP_STREAM_UUID_DATA, GATTDB_CHAR_PROP_WRITE_NO_RESPONSE,
+                               GATTDB_PERM_WRITE_CMD | GATTDB_PERM_VARIABLE_LENGTH),
+        CHARACTERISTIC_UUID128(HDLC_APP_STREAM_STATUS, HDLC_APP_STREAM_STATUS_VALUE,
+                               APP_STREAM_UUID_STATUS,
+                               GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_WRITE,
+                               GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+};
+
+static const wiced_bt_uuid_t app_stream_types[] =
+{
+    { LEN_UUID_128, { .uuid128 = { APP_STREAM_UUID_DATA } } },
+    { LEN_UUID_128, { .uuid128 = { APP_STREAM_UUID_STATUS } } },
+};
+
+static const app_gatt_service_cbs_t app_stream_gatt_cbs =
+{
+    app_stream_read_cb, app_stream_write_cb
+};
+
+static const app_console_cmd_t app_stream_console_cmd =
+{
+    "stream", "Stream ingress counters; 'stream reset', 'stream bench <writes> [gap every]'",
+    app_stream_cmd
+};
+
+#else
+
+APP_MEMORY_FOOTPRINT(app_stream_ram_footprint, 0);
+
+#endif /* APP_STREAM */
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_stream_init
+
+ Function Description:
+ @brief  Adds the stream service, takes over the write commands and creates
+         the stream task. Must be called after app_bt_gatt_handler_init()
+         and wiced_bt_gatt_db_init(). Does nothing unless built with
+         APP_STREAM=1.
+
+ @param void
+
+ @return void
+ */
+void app_stream_init(void)
+{
+#if APP_STREAM
+    wiced_bt_gatt_status_t gatt_status;
+    BaseType_t rtos_result;
+
+    if (NULL == p_app_stream_consumer)
+    {
+        p_app_stream_consumer = app_stream_checksum;
+    }
+    app_stream_reset();
+
+#if APP_STATIC_MEMORY
+    app_stream_task_handle = xTaskCreateStatic(app_stream_task, APP_STREAM_TASK_NAME,
+                                               APP_STREAM_STACK_SIZE, NULL,
+                                               APP_STREAM_PRIORITY,
+                                               app_stream_stack, &app_stream_tcb);
+    rtos_result = (NULL != app_stream_task_handle) ? pdPASS : pdFAIL;
+#else
+    rtos_result = xTaskCreate(app_stream_task, APP_STREAM_TASK_NAME, APP_STREAM_STACK_SIZE,
+                              NULL, APP_STREAM_PRIORITY, &app_stream_task_handle);
+#endif
+    if (pdPASS != rtos_result)
+    {
+        printf("Stream task creation failed\n");
+        return;
+    }
+
+    gatt_status = app_gatt_add_service(app_stream_gatt_db, sizeof(app_stream_gatt_db),
+                                       app_stream_attrs, app_stream_types,
+                                       sizeof(app_stream_attrs) / sizeof(app_stream_attrs[0]),
+                                       &app_stream_gatt_cbs);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Stream service not added, err 0x%x\n", gatt_status);
+        return;
+    }
+
+    /* Write commands are taken in the stack thread; those to other
+     * characteristics go on to the handler registered before */
+    p_app_stream_next_handler = app_gatt_get_opcode_handler(GATT_CMD_WRITE);
+    app_gatt_register_opcode_handler(GATT_CMD_WRITE, app_stream_cmd_write_handler);
+
+    app_console_register_command(&app_stream_console_cmd);
+#endif
+}
+
+/*
+ Function Name:
+ app_stream_set_consumer
+
+ Function Description:
+ @brief  Sets the consumer of the stream payload, e.g. a configuration table
+         or firmware image writer. The default consumer only checksums the
+         payload. Set it before the transfer starts.
+
+ @param p_consumer  Consumer, NULL for the default
+
+ @return void
+ */
+void app_stream_set_consumer(app_stream_consumer_t p_consumer)
+{
+#if APP_STREAM
+    p_app_stream_consumer = (NULL != p_consumer) ? p_consumer : app_stream_checksum;
+#endif
+}
+
+#if APP_STREAM
+
+/*
+ Function Name:
+ app_stream_cmd_write_handler
+
+ Function Description:
+ @brief  Opcode handler for GATT_CMD_WRITE, in the Bluetooth stack thread.
+         Writes to the data characteristic are recognized by their handle
+         and go to the ring; the others are passed on.
+
+ @param p_attr_req      Pointer to GATT attribute request
+ @param p_error_handle  Handle to be reported in the error response
+
+ @return wiced_bt_gatt_status_t  Bluetooth LE GATT status
+ */
+static wiced_bt_gatt_status_t
+app_stream_cmd_write_handler(wiced_bt_gatt_attribute_request_t *p_attr_req,
+                             uint16_t *p_error_handle)
+{
+    wiced_bt_gatt_write_req_t *p_write = &p_attr_req->data.write_req;
+
+    if (HDLC_APP_STREAM_DATA_VALUE == p_write->handle)
+    {
+        /* A write command has no response, not even an error */
+        app_stream_ingress(p_write->p_val, p_write->val_len);
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    if (NULL == p_app_stream_next_handler)
+    {
+        return WICED_BT_GATT_REQ_NOT_SUPPORTED;
+    }
+    return p_app_stream_next_handler(p_attr_req, p_error_handle);
+}
+
+/*
+ Function Name:
+ app_stream_ingress
+
+ Function Description:
+ @brief  Checks the sequence number of a write command and copies it into
+         the next free slot. The stack buffer is only valid during the
+         callback, so this is the one copy of the payload. The stream task
+         is woken when the ring was empty; otherwise it is still draining
+         and picks the slot up without a wake-up.
+
+ @param p_val  Write command value, header included
+ @param len    Length of the value
+
+ @return void
+ */
+static void app_stream_ingress(const uint8_t *p_val, uint16_t len)
+{
+    uint32_t head = app_stream_head;
+    uint16_t seq;
+
+    if ((APP_STREAM_HEADER_LEN > len) || (APP_STREAM_SLOT_SIZE < len))
+    {
+        app_stream_stats.malformed++;
+        return;
+    }
+
+    seq = (uint16_t)(p_val[0] | (p_val[1] << 8));
+    if (app_stream_started && (seq != app_stream_next_seq))
+    {
+        app_stream_stats.gaps += (uint16_t)(seq - app_stream_next_seq);
+    }
+    if (!app_stream_started)
+    {
+        app_stream_started = true;
+        app_stream_stats.first_ms = app_uptime_ms_get();
+    }
+    app_stream_next_seq = seq + 1u;
+    app_stream_stats.writes++;
+    app_stream_stats.bytes += len - APP_STREAM_HEADER_LEN;
+    app_stream_stats.last_ms = app_uptime_ms_get();
+
+    if (APP_STREAM_SLOTS <= (head - app_stream_tail))
+    {
+        app_stream_stats.overflows++;
+        return;
+    }
+
+    app_stream_slots[head % APP_STREAM_SLOTS].len = len;
+    memcpy(app_stream_slots[head % APP_STREAM_SLOTS].data, p_val, len);
+    __DMB();
+    app_stream_head = head + 1u;
+
+    if (head == app_stream_tail)
+    {
+        xTaskNotifyGive(app_stream_task_handle);
+    }
+}
+
+/*
+ Function Name:
+ app_stream_task
+
+ Function Description:
+ @brief  Stream task. Hands the slots to the consumer in order and frees
+         them, then sleeps until the ring receives a write.
+
+ @param pvParam  Not used
+
+ @return void
+ */
+static void app_stream_task(void *pvParam)
+{
+    app_stream_slot_t *p_slot;
+
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (app_stream_tail != app_stream_head)
+        {
+            /* The slot is read only after the head that published it */
+            __DMB();
+            p_slot = &app_stream_slots[app_stream_tail % APP_STREAM_SLOTS];
+            p_app_stream_consumer(&p_slot->data[APP_STREAM_HEADER_LEN],
+                                  (uint16_t)(p_slot->len - APP_STREAM_HEADER_LEN));
+            app_stream_stats.consumed++;
+            __DMB();
+            app_stream_tail++;
+        }
+    }
+}
+
+/*
+ Function Name:
+ app_stream_checksum
+
+ Function Description:
+ @brief  Default consumer: folds the payload into a 32-bit FNV-1a checksum,
+         which the sender compares with its own to verify the transfer.
+
+ @param p_data  Payload
+ @param len     Length of the payload
+
+ @return void
+ */
+static void app_stream_checksum(const uint8_t *p_data, uint16_t len)
+{
+    uint32_t checksum = app_stream_stats.checksum;
+    uint16_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        checksum = (checksum ^ p_data[i]) * 16777619u;
+    }
+    app_stream_stats.checksum = checksum;
+}
+
+/*
+ Function Name:
+ app_stream_reset
+
+ Function Description:
+ @brief  Restarts the counters for a new transfer. Slots not consumed yet
+         are still handed to the consumer.
+
+ @param void
+
+ @return void
+ */
+static void app_stream_reset(void)
+{
+    taskENTER_CRITICAL();
+    memset(&app_stream_stats, 0, sizeof(app_stream_stats));
+    app_stream_stats.checksum = 2166136261u;
+    app_stream_started = false;
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_stream_kbps
+
+ Function Description:
+ @brief  Returns the sustained payload rate of the transfer, from its first
+         to its last write.
+
+ @param void
+
+ @return uint32_t  Rate in kbit/s, 0 before the second write
+ */
+static uint32_t app_stream_kbps(void)
+{
+    uint64_t elapsed_ms = app_stream_stats.last_ms - app_stream_stats.first_ms;
+
+    if (0 == elapsed_ms)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(((uint64_t)app_stream_stats.bytes * 8u) / elapsed_ms);
+}
+
+/*
+ Function Name:
+ app_stream_bench
+
+ Function Description:
+ @brief  Benchmark of the ingress path. Injects full size write commands
+         into the GATT event callback as fast as the consumer frees slots,
+         then prints the CPU cost of a write in the stack callback and the
+         sustained rate up to the last slot consumed, which bounds what the
+         path can take from the radio.
+
+ @param writes     Number of writes
+ @param gap_every  Skip a sequence number every gap_every writes, 0 for none
+
+ @return void
+ */
+static void app_stream_bench(uint32_t writes, uint32_t gap_every)
+{
+    static uint8_t value[APP_STREAM_SLOT_SIZE];
+    wiced_bt_gatt_event_data_t event_data;
+    wiced_bt_gatt_attribute_request_t *p_attr_req = &event_data.attribute_request;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    uint64_t callback_cycles = 0;
+    uint32_t start_cycles;
+    uint32_t cycles;
+    uint32_t elapsed_us;
+    uint32_t seq = 0;
+    uint32_t i;
+
+    for (i = APP_STREAM_HEADER_LEN; i < sizeof(value); i++)
+    {
+        value[i] = (uint8_t)i;
+    }
+
+    app_stream_reset();
+    start_cycles = app_cycle_counter_get();
+
+    for (i = 0; i < writes; i++)
+    {
+        /* Pace on the consumer, overflows would only measure the drop path */
+        while (APP_STREAM_SLOTS <= (app_stream_head - app_stream_tail))
+        {
+            taskYIELD();
+        }
+
+        if ((0 != gap_every) && (0 != i) && (0 == (i % gap_every)))
+        {
+            seq++;
+        }
+        value[0] = (uint8_t)seq;
+        value[1] = (uint8_t)(seq >> 8);
+        seq++;
+
+        memset(&event_data, 0, sizeof(event_data));
+        p_attr_req->conn_id = APP_STREAM_BENCH_CONN_ID;
+        p_attr_req->opcode = GATT_CMD_WRITE;
+        p_attr_req->data.write_req.handle = HDLC_APP_STREAM_DATA_VALUE;
+        p_attr_req->data.write_req.val_len = sizeof(value);
+        p_attr_req->data.write_req.p_val = value;
+
+        cycles = app_cycle_counter_get();
+        app_bt_gatt_event_callback(GATT_ATTRIBUTE_REQUEST_EVT, &event_data);
+        callback_cycles += app_cycle_counter_get() - cycles;
+    }
+
+    while (app_stream_tail != app_stream_head)
+    {
+        taskYIELD();
+    }
+    elapsed_us = (app_cycle_counter_get() - start_cycles) / cycles_per_us;
+
+    printf("STREAM BENCH writes=%lu bytes=%lu gaps=%lu overflows=%lu "
+           "cycles_per_write=%lu kbps=%lu checksum=0x%08lx\n",
+           (unsigned long)app_stream_stats.writes, (unsigned long)app_stream_stats.bytes,
+           (unsigned long)app_stream_stats.gaps, (unsigned long)app_stream_stats.overflows,
+           (unsigned long)((0 != writes) ? (callback_cycles / writes) : 0),
+           (unsigned long)((0 != elapsed_us)
+                           ? (((uint64_t)app_stream_stats.bytes * 8000u) / elapsed_us) : 0),
+           (unsigned long)app_stream_stats.checksum);
+}
+
+/*
+ Function Name:
+ app_stream_read_cb
+
+ Function Description:
+ @brief  Refreshes the status characteristic before it is read.
+
+ @param attr_handle  GATT attribute handle
+
+ @return void
+ */
+static void app_stream_read_cb(uint16_t attr_handle)
+{
+    const uint32_t values[APP_STREAM_STATUS_LEN / sizeof(uint32_t)] =
+    {
+        app_stream_stats.writes, app_stream_stats.bytes, app_stream_stats.gaps,
+        app_stream_stats.overflows, app_stream_kbps(), app_stream_stats.checksum
+    };
+    uint32_t i;
+
+    if (HDLC_APP_STREAM_STATUS_VALUE != attr_handle)
+    {
+        return;
+    }
+
+    for (i = 0; i < (sizeof(values) / sizeof(values[0])); i++)
+    {
+        app_stream_status[(4u * i) + 0u] = (uint8_t)values[i];
+        app_stream_status[(4u * i) + 1u] = (uint8_t)(values[i] >> 8);
+        app_stream_status[(4u * i) + 2u] = (uint8_t)(values[i] >> 16);
+        app_stream_status[(4u * i) + 3u] = (uint8_t)(values[i] >> 24);
+    }
+}
+
+/*
+ Function Name:
+ app_stream_write_cb
+
+ Function Description:
+ @brief  A write of the status characteristic restarts the counters. The
+         value written is not stored.
+
+ @param attr_handle  GATT attribute handle
+ @param offset       Offset of the write
+ @param p_val        Value written
+ @param len          Length of the value
+
+ @return wiced_bt_gatt_status_t  WICED_BT_GATT_WRITE_NOT_PERMIT for the
+                                 data characteristic, which only takes write
+                                 commands
+ */
+static wiced_bt_gatt_status_t app_stream_write_cb(uint16_t attr_handle, uint16_t offset,
+                                                  const uint8_t *p_val, uint16_t len)
+{
+    if (HDLC_APP_STREAM_STATUS_VALUE != attr_handle)
+    {
+        return WICED_BT_GATT_WRITE_NOT_PERMIT;
+    }
+
+    app_stream_reset();
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_stream_cmd
+
+ Function Description:
+ @brief  "stream" console command. Prints the counters of the transfer;
+         "stream reset" restarts them and "stream bench <writes> [gap every]"
+         runs the ingress benchmark.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_stream_cmd(uint32_t argc, char *argv[])
+{
+    if ((2 <= argc) && (0 == strcmp(argv[1], "reset")))
+    {
+        app_stream_reset();
+        return;
+    }
+    if ((3 <= argc) && (0 == strcmp(argv[1], "bench")))
+    {
+        app_stream_bench(strtoul(argv[2], NULL, 0),
+                         (4 <= argc) ? strtoul(argv[3], NULL, 0) : 0);
+        return;
+    }
+
+    printf("Stream: %lu writes, %lu bytes, %lu gaps, %lu overflows, %lu malformed, "
+           "%lu consumed, %lu kbit/s, checksum 0x%08lx, %lu of %u slots in use\n",
+           (unsigned long)app_stream_stats.writes, (unsigned long)app_stream_stats.bytes,
+           (unsigned long)app_stream_stats.gaps, (unsigned long)app_stream_stats.overflows,
+           (unsigned long)app_stream_stats.malformed, (unsigned long)app_stream_stats.consumed,
+           (unsigned long)app_stream_kbps(), (unsigned long)app_stream_stats.checksum,
+           (unsigned long)(app_stream_head - app_stream_tail), (unsigned)APP_STREAM_SLOTS);
+}
+
+#endif /* APP_STREAM */
+
+/* [] END OF FILE */
@@ -0,0 +1,125 @@
+/*******************************************************************************
+* File Name: app_stream.h
+*
+* Description: This file contains the constants and function declarations of
+*              the streaming ingress, which takes bulk data written with Write
+*              Without Response into a receive ring.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_STREAM_H__
+#define __APP_STREAM_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_handler.h"
+#include "cycfg_bt_settings.h"
+#include "wiced_bt_gatt.h"
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_STREAM=1 in the Makefile to add the stream service
+ * for bulk data such as configuration tables, calibration or firmware.
+ */
+#ifndef APP_STREAM
+#define APP_STREAM                       (0u)
+#endif
+
+/* Slots of the receive ring, one per write command. Writes arriving while
+ * all slots wait for the consumer are dropped and counted.
+ */
+#ifndef APP_STREAM_SLOTS
+#define APP_STREAM_SLOTS                 (16u)
+#endif
+
+/* Data characteristic. Each write command is a 16-bit little endian
+ * sequence number, incremented by the sender for every write, followed by
+ * the payload. A write fills at most the MTU.
+ */
+#define APP_STREAM_HEADER_LEN            (2u)
+#define APP_STREAM_SLOT_SIZE             (CY_BT_MTU_SIZE - 3u)
+
+/* Status characteristic, little endian uint32 values: writes, payload
+ * bytes, sequence gaps (writes missing), writes dropped on a full ring,
+ * sustained rate in kbit/s and FNV-1a checksum of the payload consumed.
+ * Writing any value restarts the counters for a new transfer.
+ */
+#define APP_STREAM_STATUS_LEN            (24u)
+
+/* Connection ID of the benchmark writes, outside the range of the stack */
+#define APP_STREAM_BENCH_CONN_ID         (0x7000u)
+
+/* Stream service, vendor specific */
+#define APP_STREAM_UUID_SERVICE          0x10, 0x0e, 0x1d, 0x4c, 0x7f, 0x2b, 0x1f, 0x9c, \
+                                         0x2a, 0x4d, 0x6b, 0x8e, 0x06, 0x00, 0x3e, 0x5a
+#define APP_STREAM_UUID_DATA             0x10, 0x0e, 0x1d, 0x4c, 0x7f, 0x2b, 0x1f, 0x9c, \
+                                         0x2a, 0x4d, 0x6b, 0x8e, 0x07, 0x00, 0x3e, 0x5a
+#define APP_STREAM_UUID_STATUS           0x10, 0x0e, 0x1d, 0x4c, 0x7f, 0x2b, 0x1f, 0x9c, \
+                                         0x2a, 0x4d, 0x6b, 0x8e, 0x08, 0x00, 0x3e, 0x5a
+
+#define HDLS_APP_STREAM                  (APP_GATT_APP_HANDLE_BASE + 0x40u)
+#define HDLC_APP_STREAM_DATA             (HDLS_APP_STREAM + 1u)
+#define HDLC_APP_STREAM_DATA_VALUE       (HDLS_APP_STREAM + 2u)
+#define HDLC_APP_STREAM_STATUS           (HDLS_APP_STREAM + 3u)
+#define HDLC_APP_STREAM_STATUS_VALUE     (HDLS_APP_STREAM + 4u)
+
+#define APP_STREAM_TASK_NAME             "Stream"
+#define APP_STREAM_STACK_SIZE            (configMINIMAL_STACK_SIZE * 2)
+#define APP_STREAM_PRIORITY              (configMAX_PRIORITIES - 3)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Consumer of the stream payload, called in the stream task in sequence
+ * order with the payload in its ring slot; the slot is reused on return. */
+typedef void (*app_stream_consumer_t)(const uint8_t *p_data, uint16_t len);
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_stream_init(void);
+
+void app_stream_set_consumer(app_stream_consumer_t p_consumer);
+
+#endif      /* __APP_STREAM_H__ */
+
+/* [] END OF FILE */
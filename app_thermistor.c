@@ -0,0 +1,346 @@
+/*******************************************************************************
+* File Name: app_thermistor.c
+*
+* Description: This file contains the thermistor sensor backend. ADC scans are
+*              captured by DMA into ping-pong buffers and converted from
+*              resistance to temperature with a lookup table and fixed-point
+*              interpolation.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_thermistor.h"
+#include "app_memory.h"
+#include "app_trace.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+#define APP_THERMISTOR_BUF_LEN           (APP_THERMISTOR_SCANS * APP_THERMISTOR_CHANNELS)
+
+/* Interrupt priority of the ADC completion */
+#define APP_THERMISTOR_ADC_IRQ_PRIORITY  (3u)
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+static cyhal_adc_t              app_thermistor_adc;
+static cyhal_adc_channel_t      app_thermistor_vref_chan;
+static cyhal_adc_channel_t      app_thermistor_vth_chan;
+
+/* Ping-pong buffers. DMA fills one while the other is converted, so an
+ * acquisition started before the previous conversion ended is safe.
+ */
+static int32_t                  app_thermistor_buf[2][APP_THERMISTOR_BUF_LEN];
+static volatile uint8_t         app_thermistor_fill_index;
+static volatile uint8_t         app_thermistor_ready_index;
+
+APP_MEMORY_FOOTPRINT(app_thermistor_ram_footprint, sizeof(app_thermistor_buf));
+
+/* Thermistor resistance in ohms at APP_THERMISTOR_LUT_MIN_C and every
+ * APP_THERMISTOR_LUT_STEP_C above, for a 10 kOhm NTC with B25/50 = 3380 K
+ * (e.g. NCP18XH103F03RB). Replace with the datasheet table of another part.
+ */
+static const uint32_t app_thermistor_lut[APP_THERMISTOR_LUT_SIZE] =
+{
+     235831u,  173946u,  129917u,   98180u,   75022u,   57926u,
+      45168u,   35548u,   28224u,   22595u,   18231u,   14820u,
+      12133u,   10000u,    8295u,    6922u,    5810u,    4903u,
+       4160u,    3547u,    3039u,    2616u,    2261u,    1963u,
+       1711u,    1497u,    1315u,    1158u,    1024u,     909u,
+        809u,     722u,     646u,     580u,
+};
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static bool app_thermistor_init(void);
+
+static bool app_thermistor_start(void);
+
+static bool app_thermistor_convert(int16_t *p_centi_celsius);
+
+static void app_thermistor_adc_callback(void *callback_arg, cyhal_adc_event_t event);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+const app_sensor_backend_t app_thermistor_backend =
+{
+    "thermistor", app_thermistor_init, app_thermistor_start, app_thermistor_convert
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_thermistor_init
+
+ Function Description:
+ @brief  Configures the divider supply pin, the ADC with hardware averaging,
+         the two channels and DMA transfers of the results.
+
+ @param void
+
+ @return bool  false if a resource is not available
+ */
+static bool app_thermistor_init(void)
+{
+    const cyhal_adc_channel_config_t chan_cfg =
+    {
+        .enabled = true,
+        .enable_averaging = true,
+        .min_acquisition_ns = 1000u,
+    };
+    cyhal_adc_config_t adc_cfg;
+    cy_rslt_t rslt;
+
+    rslt = cyhal_gpio_init(APP_THERMISTOR_VDD_PIN, CYHAL_GPIO_DIR_OUTPUT,
+                           CYHAL_GPIO_DRIVE_STRONG, false);
+    if (CY_RSLT_SUCCESS != rslt)
+    {
+        return false;
+    }
+
+    rslt = cyhal_adc_init(&app_thermistor_adc, APP_THERMISTOR_VTH_PIN, NULL);
+    if (CY_RSLT_SUCCESS != rslt)
+    {
+        cyhal_gpio_free(APP_THERMISTOR_VDD_PIN);
+        return false;
+    }
+
+    memset(&adc_cfg, 0, sizeof(adc_cfg));
+    adc_cfg.continuous_scanning = false;
+    adc_cfg.average_count = APP_THERMISTOR_HW_AVERAGE;
+    adc_cfg.average_mode_flags = CYHAL_ADC_AVG_MODE_AVERAGE;
+    adc_cfg.vneg = CYHAL_ADC_VNEG_VSSA;
+    adc_cfg.vref = CYHAL_ADC_REF_VDDA;
+    adc_cfg.ext_vref = NC;
+    adc_cfg.bypass_pin = NC;
+    adc_cfg.resolution = 12u;
+
+    if ((CY_RSLT_SUCCESS != cyhal_adc_configure(&app_thermistor_adc, &adc_cfg)) ||
+        (CY_RSLT_SUCCESS != cyhal_adc_channel_init_diff(&app_thermistor_vref_chan,
+                                                        &app_thermistor_adc,
+                                                        APP_THERMISTOR_VREF_PIN,
+                                                        CYHAL_ADC_VNEG, &chan_cfg)) ||
+        (CY_RSLT_SUCCESS != cyhal_adc_channel_init_diff(&app_thermistor_vth_chan,
+                                                        &app_thermistor_adc,
+                                                        APP_THERMISTOR_VTH_PIN,
+                                                        CYHAL_ADC_VNEG, &chan_cfg)) ||
+        (CY_RSLT_SUCCESS != cyhal_adc_set_async_mode(&app_thermistor_adc, CYHAL_ASYNC_DMA,
+                                                     CYHAL_DMA_PRIORITY_DEFAULT)))
+    {
+        cyhal_adc_free(&app_thermistor_adc);
+        cyhal_gpio_free(APP_THERMISTOR_VDD_PIN);
+        return false;
+    }
+
+    cyhal_adc_register_callback(&app_thermistor_adc, app_thermistor_adc_callback, NULL);
+    cyhal_adc_enable_event(&app_thermistor_adc, CYHAL_ADC_ASYNC_READ_COMPLETE,
+                           APP_THERMISTOR_ADC_IRQ_PRIORITY, true);
+
+    app_thermistor_fill_index = 0;
+    app_thermistor_ready_index = 1;
+
+    return true;
+}
+
+/*
+ Function Name:
+ app_thermistor_start
+
+ Function Description:
+ @brief  Powers the divider and starts APP_THERMISTOR_SCANS scans, transferred
+         by DMA into the fill buffer.
+
+ @param void
+
+ @return bool  false if the ADC is busy
+ */
+static bool app_thermistor_start(void)
+{
+    cyhal_gpio_write(APP_THERMISTOR_VDD_PIN, true);
+
+    if (CY_RSLT_SUCCESS != cyhal_adc_read_async(&app_thermistor_adc, APP_THERMISTOR_SCANS,
+                                                app_thermistor_buf[app_thermistor_fill_index]))
+    {
+        cyhal_gpio_write(APP_THERMISTOR_VDD_PIN, false);
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ Function Name:
+ app_thermistor_adc_callback
+
+ Function Description:
+ @brief  ADC interrupt. On completion of the DMA transfer, powers down the
+         divider, swaps the ping-pong buffers and wakes the sampling task.
+
+ @param callback_arg  Not used
+ @param event         ADC event
+
+ @return void
+ */
+static void app_thermistor_adc_callback(void *callback_arg, cyhal_adc_event_t event)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+
+    if (0 == (event & CYHAL_ADC_ASYNC_READ_COMPLETE))
+    {
+        return;
+    }
+
+    app_trace_isr_enter(APP_TRACE_ISR_ADC);
+    cyhal_gpio_write(APP_THERMISTOR_VDD_PIN, false);
+
+    app_thermistor_ready_index = app_thermistor_fill_index;
+    app_thermistor_fill_index ^= 1u;
+
+    app_sensor_acquisition_done_from_isr(&higher_priority_task_woken);
+    app_trace_isr_exit(APP_TRACE_ISR_ADC);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/*
+ Function Name:
+ app_thermistor_convert
+
+ Function Description:
+ @brief  Sums the scans of the ready buffer and converts the ratio of the two
+         nodes to a resistance, then to a temperature. The sums keep the
+         oversampling gain, so the ratio has more resolution than one result.
+
+ @param p_centi_celsius  Temperature in hundredths of a degree Celsius
+
+ @return bool  false if the divider reading is out of range
+ */
+static bool app_thermistor_convert(int16_t *p_centi_celsius)
+{
+    const int32_t *p_buf = app_thermistor_buf[app_thermistor_ready_index];
+    int64_t vref_sum = 0;
+    int64_t vth_sum = 0;
+    uint64_t resistance;
+    uint32_t i;
+
+    /* Results are interleaved in channel order: VREF, VTH, VREF, ... */
+    for (i = 0; i < APP_THERMISTOR_BUF_LEN; i += APP_THERMISTOR_CHANNELS)
+    {
+        vref_sum += p_buf[i];
+        vth_sum += p_buf[i + 1u];
+    }
+
+    if ((0 >= vth_sum) || (vth_sum >= vref_sum))
+    {
+        /* Open or shorted thermistor */
+        return false;
+    }
+
+    /* R_th = R_ref * V_th / (V_ref - V_th) */
+    resistance = ((uint64_t)APP_THERMISTOR_R_REF * (uint64_t)vth_sum) /
+                 (uint64_t)(vref_sum - vth_sum);
+    if (UINT32_MAX < resistance)
+    {
+        resistance = UINT32_MAX;
+    }
+
+    *p_centi_celsius = app_thermistor_resistance_to_centi_celsius((uint32_t)resistance);
+    return true;
+}
+
+/*
+ Function Name:
+ app_thermistor_resistance_to_centi_celsius
+
+ Function Description:
+ @brief  Looks up the resistance in the table, which falls with temperature,
+         with a binary search and interpolates linearly between the two
+         neighbouring entries. Out of range values are clamped to the ends of
+         the table.
+
+ @param resistance  Thermistor resistance in ohms
+
+ @return int16_t  Temperature in hundredths of a degree Celsius
+ */
+int16_t app_thermistor_resistance_to_centi_celsius(uint32_t resistance)
+{
+    uint32_t lo = 0;
+    uint32_t hi = APP_THERMISTOR_LUT_SIZE - 1u;
+    uint32_t mid;
+    int32_t centi;
+
+    if (resistance >= app_thermistor_lut[0])
+    {
+        return (int16_t)(APP_THERMISTOR_LUT_MIN_C * 100);
+    }
+    if (resistance <= app_thermistor_lut[APP_THERMISTOR_LUT_SIZE - 1u])
+    {
+        return (int16_t)((APP_THERMISTOR_LUT_MIN_C +
+                          (int32_t)(APP_THERMISTOR_LUT_SIZE - 1u) * APP_THERMISTOR_LUT_STEP_C) * 100);
+    }
+
+    /* Find lo such that lut[lo] > resistance >= lut[lo + 1] */
+    while ((hi - lo) > 1u)
+    {
+        mid = (lo + hi) / 2u;
+        if (app_thermistor_lut[mid] > resistance)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    centi = (APP_THERMISTOR_LUT_MIN_C + (int32_t)lo * APP_THERMISTOR_LUT_STEP_C) * 100;
+    centi += (int32_t)(((app_thermistor_lut[lo] - resistance) *
+                        (uint32_t)(APP_THERMISTOR_LUT_STEP_C * 100)) /
+                       (app_thermistor_lut[lo] - app_thermistor_lut[lo + 1u]));
+
+    return (int16_t)centi;
+}
+
+/* [] END OF FILE */
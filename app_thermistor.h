@@ -0,0 +1,108 @@
+/*******************************************************************************
+* File Name: app_thermistor.h
+*
+* Description: This file contains the configuration of the thermistor sensor
+*              backend: divider circuit, pins, oversampling and the resistance
+*              lookup table.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_THERMISTOR_H__
+#define __APP_THERMISTOR_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_sensor.h"
+#include "cyhal.h"
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Divider circuit, powered only during an acquisition:
+ *
+ *   VDD_PIN ---+--- R_REF ---+--- R_THERMISTOR --- GND
+ *              |             |
+ *          VREF_PIN       VTH_PIN
+ *
+ * Both nodes are measured in the same scan so the result is independent of
+ * the supply voltage. Change the pins to match the board.
+ */
+#ifndef APP_THERMISTOR_VDD_PIN
+#define APP_THERMISTOR_VDD_PIN           (CYBSP_A0)
+#endif
+#ifndef APP_THERMISTOR_VREF_PIN
+#define APP_THERMISTOR_VREF_PIN          (CYBSP_A1)
+#endif
+#ifndef APP_THERMISTOR_VTH_PIN
+#define APP_THERMISTOR_VTH_PIN           (CYBSP_A2)
+#endif
+
+/* Reference resistor, in ohms */
+#define APP_THERMISTOR_R_REF             (10000u)
+
+/* Conversions averaged by the ADC hardware for each result */
+#define APP_THERMISTOR_HW_AVERAGE        (16u)
+
+/* Scans per acquisition, summed in software. Together with the hardware
+ * averaging this oversamples each node 256 times.
+ */
+#define APP_THERMISTOR_SCANS             (16u)
+
+/* Channels in a scan: VREF and VTH */
+#define APP_THERMISTOR_CHANNELS          (2u)
+
+/* Lookup table: resistance from APP_THERMISTOR_LUT_MIN_C in steps of
+ * APP_THERMISTOR_LUT_STEP_C degrees.
+ */
+#define APP_THERMISTOR_LUT_MIN_C         (-40)
+#define APP_THERMISTOR_LUT_STEP_C        (5)
+#define APP_THERMISTOR_LUT_SIZE          (34u)
+
+/* *****************************************************************************
+ *                              VARIABLE DECLARATIONS
+ * ****************************************************************************/
+extern const app_sensor_backend_t app_thermistor_backend;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+int16_t app_thermistor_resistance_to_centi_celsius(uint32_t resistance);
+
+#endif      /* __APP_THERMISTOR_H__ */
+
+/* [] END OF FILE */
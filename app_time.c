@@ -0,0 +1,491 @@
+/*******************************************************************************
+* File Name: app_time.c
+*
+* Description: This file contains the absolute time base. The Current Time
+*              Service sets an epoch offset on the monotonic uptime clock;
+*              syncs far enough apart also estimate the drift of the local
+*              clock, which is corrected from then on.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_time.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              MACROS
+ ******************************************************************************/
+#define APP_TIME_MS_PER_DAY              (86400000u)
+#define APP_TIME_PPB                     (1000000000)
+
+/* Gregorian leap year: 2000 is one, 2100 is not */
+#define APP_TIME_IS_LEAP_YEAR(year)      \
+    ((0u == ((year) % 4u)) && ((0u != ((year) % 100u)) || (0u == ((year) % 400u))))
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Epoch time at app_time_sync_uptime_ms, updated by every sync */
+static bool             app_time_set;
+static uint64_t         app_time_sync_uptime_ms;
+static uint64_t         app_time_sync_epoch_ms;
+
+/* Reference point of the drift estimate, moved at most once per
+ * APP_TIME_DRIFT_MIN_INTERVAL_MS */
+static uint64_t         app_time_ref_uptime_ms;
+static uint64_t         app_time_ref_epoch_ms;
+
+/* Rate of the local clock relative to the reference, in parts per billion:
+ * epoch time advances by (1 + rate) ms per uptime ms */
+static int32_t          app_time_rate_ppb;
+static uint32_t         app_time_rate_estimates;
+
+static uint32_t         app_time_syncs;
+static uint8_t          app_time_adjust_reason;
+
+/* Value of the Current Time characteristic, refreshed on every read */
+static uint8_t          app_time_current[APP_TIME_CURRENT_TIME_LEN];
+
+static gatt_db_lookup_table_t app_time_attrs[] =
+{
+    { HDLC_APP_TIME_CURRENT_VALUE, APP_TIME_CURRENT_TIME_LEN, APP_TIME_CURRENT_TIME_LEN,
+      app_time_current },
+};
+
+/* Attribute types of app_time_attrs */
+static const wiced_bt_uuid_t app_time_types[] =
+{
+    { LEN_UUID_16, { .uuid16 = APP_TIME_UUID_CURRENT_TIME } },
+};
+
+APP_MEMORY_FOOTPRINT(app_time_ram_footprint, sizeof(app_time_current));
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+static uint64_t app_time_at(uint64_t uptime_ms);
+
+static int32_t app_time_days_from_civil(int32_t year, uint32_t month, uint32_t day);
+
+static void app_time_civil_from_days(int32_t days, int32_t *p_year, uint32_t *p_month,
+                                     uint32_t *p_day);
+
+static void app_time_read_cb(uint16_t attr_handle);
+
+static wiced_bt_gatt_status_t app_time_write_cb(uint16_t attr_handle, uint16_t offset,
+                                                const uint8_t *p_val, uint16_t len);
+
+static void app_time_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const uint8_t app_time_gatt_db[] =
+{
+    PRIMARY_SERVICE_UUID16(HDLS_APP_TIME, APP_TIME_UUID_SERVICE),
+        CHARACTERISTIC_UUID16(HDLC_APP_TIME_CURRENT, HDLC_APP_TIME_CURRENT_VALUE,
+                              APP_TIME_UUID_CURRENT_TIME,
+                              GATTDB_CHAR_PROP_READ | GATTDB_CHAR_PROP_WRITE,
+                              GATTDB_PERM_READABLE | GATTDB_PERM_WRITE_REQ),
+};
+
+static const app_gatt_service_cbs_t app_time_gatt_cbs =
+{
+    app_time_read_cb, app_time_write_cb
+};
+
+static const app_console_cmd_t app_time_console_cmd =
+{
+    "time", "Absolute time and drift; 'time set <epoch s>' sets it",
+    app_time_cmd
+};
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_time_init
+
+ Function Description:
+ @brief  Adds the Current Time Service to the GATT database. Must be called
+         after wiced_bt_gatt_db_init().
+
+ @param void
+
+ @return void
+ */
+void app_time_init(void)
+{
+    wiced_bt_gatt_status_t gatt_status;
+
+    gatt_status = app_gatt_add_service(app_time_gatt_db, sizeof(app_time_gatt_db),
+                                       app_time_attrs, app_time_types,
+                                       sizeof(app_time_attrs) / sizeof(app_time_attrs[0]),
+                                       &app_time_gatt_cbs);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Current Time Service not added, err 0x%x\n", gatt_status);
+    }
+
+    app_console_register_command(&app_time_console_cmd);
+}
+
+/*
+ Function Name:
+ app_time_now_ms
+
+ Function Description:
+ @brief  Returns the time in milliseconds since 1970-01-01 UTC, or since boot
+         while the time is not set. Task context only.
+
+ @param void
+
+ @return uint64_t  Time in milliseconds
+ */
+uint64_t app_time_now_ms(void)
+{
+    uint64_t uptime_ms = app_uptime_ms_get();
+    uint64_t now_ms;
+
+    taskENTER_CRITICAL();
+    now_ms = app_time_at(uptime_ms);
+    taskEXIT_CRITICAL();
+
+    return now_ms;
+}
+
+/*
+ Function Name:
+ app_time_now_s
+
+ Function Description:
+ @brief  Time stamp of the sample records: seconds since 1970-01-01 UTC, or
+         since boot, below APP_TIME_EPOCH_MIN_S, while the time is not set.
+
+ @param void
+
+ @return uint32_t  Time in seconds
+ */
+uint32_t app_time_now_s(void)
+{
+    return (uint32_t)(app_time_now_ms() / 1000u);
+}
+
+/*
+ Function Name:
+ app_time_is_set
+
+ Function Description:
+ @brief  Returns true once the time has been set.
+
+ @param void
+
+ @return bool  true if app_time_now_ms() returns epoch time
+ */
+bool app_time_is_set(void)
+{
+    return app_time_set;
+}
+
+/*
+ Function Name:
+ app_time_sync
+
+ Function Description:
+ @brief  Sets the time. The offset is corrected on every sync. If the last
+         drift reference is at least APP_TIME_DRIFT_MIN_INTERVAL_MS old, the
+         rate of the local clock is measured against it and averaged into
+         the drift estimate; a rate beyond APP_TIME_MAX_DRIFT_PPB is a step
+         of the reference clock and restarts the measurement. Task context
+         only.
+
+ @param epoch_ms  Time in milliseconds since 1970-01-01 UTC
+ @param reason    APP_TIME_ADJUST_xxx
+
+ @return void
+ */
+void app_time_sync(uint64_t epoch_ms, uint8_t reason)
+{
+    uint64_t uptime_ms = app_uptime_ms_get();
+    uint64_t elapsed_ms;
+    int64_t measured_ppb;
+
+    taskENTER_CRITICAL();
+
+    elapsed_ms = uptime_ms - app_time_ref_uptime_ms;
+    if (!app_time_set)
+    {
+        app_time_ref_uptime_ms = uptime_ms;
+        app_time_ref_epoch_ms = epoch_ms;
+    }
+    else if (APP_TIME_DRIFT_MIN_INTERVAL_MS <= elapsed_ms)
+    {
+        measured_ppb = ((((int64_t)epoch_ms - (int64_t)app_time_ref_epoch_ms) -
+                         (int64_t)elapsed_ms) * APP_TIME_PPB) / (int64_t)elapsed_ms;
+        if ((APP_TIME_MAX_DRIFT_PPB >= measured_ppb) && (-APP_TIME_MAX_DRIFT_PPB <= measured_ppb))
+        {
+            /* The first estimate is taken as is, later ones are averaged */
+            app_time_rate_ppb = (0 == app_time_rate_estimates)
+                                ? (int32_t)measured_ppb
+                                : (int32_t)((app_time_rate_ppb + measured_ppb) / 2);
+            app_time_rate_estimates++;
+        }
+        app_time_ref_uptime_ms = uptime_ms;
+        app_time_ref_epoch_ms = epoch_ms;
+    }
+
+    app_time_sync_uptime_ms = uptime_ms;
+    app_time_sync_epoch_ms = epoch_ms;
+    app_time_set = true;
+    app_time_syncs++;
+    app_time_adjust_reason = reason;
+
+    taskEXIT_CRITICAL();
+}
+
+/*
+ Function Name:
+ app_time_at
+
+ Function Description:
+ @brief  Converts an uptime into epoch time with the offset and the drift
+         correction of the last sync. Called in a critical section.
+
+ @param uptime_ms  Uptime in milliseconds
+
+ @return uint64_t  Epoch time in milliseconds, the uptime if the time is not set
+ */
+static uint64_t app_time_at(uint64_t uptime_ms)
+{
+    uint64_t elapsed_ms;
+
+    if (!app_time_set)
+    {
+        return uptime_ms;
+    }
+
+    elapsed_ms = uptime_ms - app_time_sync_uptime_ms;
+    return app_time_sync_epoch_ms + elapsed_ms +
+           (uint64_t)(((int64_t)elapsed_ms * app_time_rate_ppb) / APP_TIME_PPB);
+}
+
+/*
+ Function Name:
+ app_time_days_from_civil
+
+ Function Description:
+ @brief  Days since 1970-01-01 of a Gregorian date, for years from 1970.
+
+ @param year   Year
+ @param month  Month, 1..12
+ @param day    Day of the month, 1..31
+
+ @return int32_t  Days since 1970-01-01
+ */
+static int32_t app_time_days_from_civil(int32_t year, uint32_t month, uint32_t day)
+{
+    uint32_t year_of_era, day_of_year, day_of_era;
+    int32_t era;
+
+    /* Years start in March, so the leap day is the last day of the year */
+    year -= (month <= 2u) ? 1 : 0;
+    era = year / 400;
+    year_of_era = (uint32_t)(year - (era * 400));
+    day_of_year = (((153u * ((month > 2u) ? (month - 3u) : (month + 9u))) + 2u) / 5u) + day - 1u;
+    day_of_era = (year_of_era * 365u) + (year_of_era / 4u) - (year_of_era / 100u) + day_of_year;
+
+    return (era * 146097) + (int32_t)day_of_era - 719468;
+}
+
+/*
+ Function Name:
+ app_time_civil_from_days
+
+ Function Description:
+ @brief  Gregorian date of a day since 1970-01-01.
+
+ @param days     Days since 1970-01-01
+ @param p_year   Year
+ @param p_month  Month, 1..12
+ @param p_day    Day of the month, 1..31
+
+ @return void
+ */
+static void app_time_civil_from_days(int32_t days, int32_t *p_year, uint32_t *p_month,
+                                     uint32_t *p_day)
+{
+    uint32_t day_of_era, year_of_era, day_of_year, month_index;
+    int32_t era;
+
+    days += 719468;
+    era = days / 146097;
+    day_of_era = (uint32_t)(days - (era * 146097));
+    year_of_era = (day_of_era - (day_of_era / 1460u) + (day_of_era / 36524u) -
+                   (day_of_era / 146096u)) / 365u;
+    day_of_year = day_of_era - ((365u * year_of_era) + (year_of_era / 4u) - (year_of_era / 100u));
+    month_index = ((5u * day_of_year) + 2u) / 153u;
+
+    *p_day = day_of_year - (((153u * month_index) + 2u) / 5u) + 1u;
+    *p_month = (month_index < 10u) ? (month_index + 3u) : (month_index - 9u);
+    *p_year = (int32_t)year_of_era + (era * 400) + ((*p_month <= 2u) ? 1 : 0);
+}
+
+/*
+ Function Name:
+ app_time_read_cb
+
+ Function Description:
+ @brief  Encodes the current time into the Current Time characteristic
+         before it is read. Before the time is set the date is 1970-01-01
+         plus the uptime.
+
+ @param attr_handle  GATT attribute handle
+
+ @return void
+ */
+static void app_time_read_cb(uint16_t attr_handle)
+{
+    uint64_t now_ms = app_time_now_ms();
+    uint32_t ms_of_day = (uint32_t)(now_ms % APP_TIME_MS_PER_DAY);
+    int32_t days = (int32_t)(now_ms / APP_TIME_MS_PER_DAY);
+    uint32_t month, day;
+    int32_t year;
+
+    app_time_civil_from_days(days, &year, &month, &day);
+
+    app_time_current[0] = (uint8_t)year;
+    app_time_current[1] = (uint8_t)(year >> 8);
+    app_time_current[2] = (uint8_t)month;
+    app_time_current[3] = (uint8_t)day;
+    app_time_current[4] = (uint8_t)(ms_of_day / 3600000u);
+    app_time_current[5] = (uint8_t)((ms_of_day / 60000u) % 60u);
+    app_time_current[6] = (uint8_t)((ms_of_day / 1000u) % 60u);
+    /* 1970-01-01 was a Thursday */
+    app_time_current[7] = (uint8_t)(((days + 3) % 7) + 1);
+    app_time_current[8] = (uint8_t)(((ms_of_day % 1000u) * 256u) / 1000u);
+    app_time_current[9] = app_time_adjust_reason;
+}
+
+/*
+ Function Name:
+ app_time_write_cb
+
+ Function Description:
+ @brief  Sets the time from a write of the complete Current Time
+         characteristic. The day of week and the adjust reason are ignored.
+
+ @param attr_handle  GATT attribute handle
+ @param offset       Offset of the first byte
+ @param p_val        Value
+ @param len          Length of the value
+
+ @return wiced_bt_gatt_status_t  APP_TIME_ERR_DATA_FIELD_IGNORED if the
+                                 date is invalid
+ */
+static wiced_bt_gatt_status_t app_time_write_cb(uint16_t attr_handle, uint16_t offset,
+                                                const uint8_t *p_val, uint16_t len)
+{
+    static const uint8_t days_in_month[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    uint32_t year, month, day;
+    uint64_t epoch_ms;
+
+    if ((0 != offset) || (APP_TIME_CURRENT_TIME_LEN != len))
+    {
+        return WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+
+    year = (uint32_t)p_val[0] | ((uint32_t)p_val[1] << 8);
+    month = p_val[2];
+    day = p_val[3];
+    if ((2000u > year) || (2105u < year) || (0 == month) || (12u < month) ||
+        (0 == day) || (days_in_month[month - 1u] < day) ||
+        ((2u == month) && (29u == day) && !APP_TIME_IS_LEAP_YEAR(year)) ||
+        (23u < p_val[4]) || (59u < p_val[5]) || (59u < p_val[6]))
+    {
+        return APP_TIME_ERR_DATA_FIELD_IGNORED;
+    }
+
+    epoch_ms = ((uint64_t)app_time_days_from_civil((int32_t)year, month, day) *
+                APP_TIME_MS_PER_DAY) +
+               ((((uint64_t)p_val[4] * 3600u) + ((uint64_t)p_val[5] * 60u) + p_val[6]) * 1000u) +
+               (((uint64_t)p_val[8] * 1000u) / 256u);
+    app_time_sync(epoch_ms, APP_TIME_ADJUST_EXTERNAL);
+
+    printf("Time set by the client, drift %ld ppb\n", (long)app_time_rate_ppb);
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/*
+ Function Name:
+ app_time_cmd
+
+ Function Description:
+ @brief  "time" console command. Prints the time and the drift estimate, or
+         with "set <seconds since 1970>" sets the time.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_time_cmd(uint32_t argc, char *argv[])
+{
+    uint64_t now_ms;
+
+    if ((2 < argc) && (0 == strcmp(argv[1], "set")))
+    {
+        app_time_sync((uint64_t)strtoul(argv[2], NULL, 10) * 1000u, APP_TIME_ADJUST_MANUAL);
+    }
+
+    now_ms = app_time_now_ms();
+    printf("TIME now_ms=%llu set=%u syncs=%lu drift_ppb=%ld drift_estimates=%lu\n",
+           (unsigned long long)now_ms, app_time_set ? 1u : 0u, (unsigned long)app_time_syncs,
+           (long)app_time_rate_ppb, (unsigned long)app_time_rate_estimates);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,103 @@
+/*******************************************************************************
+* File Name: app_time.h
+*
+* Description: This file contains the definitions of the absolute time base: an
+*              epoch offset on the monotonic uptime clock, set through the
+*              Current Time Service, with drift correction.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_TIME_H__
+#define __APP_TIME_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_bt_gatt_handler.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Time stamps are seconds since 1970-01-01 UTC once the time is set. Before
+ * that they are seconds since boot, which are all below this value
+ * (2000-01-01), so a collector can tell them apart. */
+#define APP_TIME_EPOCH_MIN_S             (946684800u)
+
+/* Drift is estimated from syncs at least this far apart; closer syncs only
+ * correct the offset. Sync jitter of 100 ms is 28 ppm over an hour. */
+#define APP_TIME_DRIFT_MIN_INTERVAL_MS   (3600u * 1000u)
+
+/* Larger rate errors are taken as a step of the reference clock, not as
+ * drift of the local clock */
+#define APP_TIME_MAX_DRIFT_PPB           (500000)
+
+/* Adjust reasons of the Current Time characteristic */
+#define APP_TIME_ADJUST_MANUAL           (0x01u)
+#define APP_TIME_ADJUST_EXTERNAL         (0x02u)
+
+/* Current Time Service. Characteristic value, little endian:
+ *   uint16 year, uint8 month, day, hours, minutes, seconds, day of week
+ *   (1 Monday .. 7 Sunday), uint8 fractions256, uint8 adjust reason */
+#define APP_TIME_UUID_SERVICE            (0x1805u)
+#define APP_TIME_UUID_CURRENT_TIME       (0x2A2Bu)
+#define APP_TIME_CURRENT_TIME_LEN        (10u)
+
+/* Current Time Service error: the written time was not applied */
+#define APP_TIME_ERR_DATA_FIELD_IGNORED  ((wiced_bt_gatt_status_t)0x80)
+
+#define HDLS_APP_TIME                    (APP_GATT_APP_HANDLE_BASE + 0x10u)
+#define HDLC_APP_TIME_CURRENT            (APP_GATT_APP_HANDLE_BASE + 0x11u)
+#define HDLC_APP_TIME_CURRENT_VALUE      (APP_GATT_APP_HANDLE_BASE + 0x12u)
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_time_init(void);
+
+uint64_t app_time_now_ms(void);
+
+uint32_t app_time_now_s(void);
+
+bool app_time_is_set(void);
+
+void app_time_sync(uint64_t epoch_ms, uint8_t reason);
+
+#endif      /* __APP_TIME_H__ */
+
+/* [] END OF FILE */
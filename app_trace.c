@@ -0,0 +1,672 @@
+/*******************************************************************************
+* File Name: app_trace.c
+*
+* Description: This file contains the FreeRTOS trace recorder. The kernel trace
+*              macros and the application call it to record task switches,
+*              interrupts, queue operations and code sections as fixed size
+*              events with a cycle counter timestamp. The trace console command
+*              dumps the ring for tools/rtos_trace_json.py, which converts it
+*              to a Chrome trace.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_trace.h"
+#include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_memory.h"
+#include "cyhal.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* Id of the tasks and queues beyond the tables */
+#define APP_TRACE_ID_OTHER               (0xFFu)
+
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+typedef enum
+{
+    APP_TRACE_EVT_TASK_IN,
+    APP_TRACE_EVT_TASK_OUT,
+    APP_TRACE_EVT_ISR_ENTER,
+    APP_TRACE_EVT_ISR_EXIT,
+    APP_TRACE_EVT_QUEUE_SEND,
+    APP_TRACE_EVT_QUEUE_RECEIVE,
+    APP_TRACE_EVT_QUEUE_BLOCK_SEND,
+    APP_TRACE_EVT_QUEUE_BLOCK_RECEIVE,
+    APP_TRACE_EVT_SPAN_BEGIN,
+    APP_TRACE_EVT_SPAN_END,
+    APP_TRACE_EVT_SLEEP,
+    APP_TRACE_EVT_COUNT
+} app_trace_evt_type_t;
+
+#if APP_TRACE
+/* One event of the ring */
+typedef struct
+{
+    uint32_t    cycles;
+    uint8_t     type;
+    uint8_t     id;
+    uint16_t    arg;
+} app_trace_event_t;
+
+typedef struct
+{
+    void        *p_handle;
+    char        name[configMAX_TASK_NAME_LEN];
+} app_trace_task_t;
+#endif
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+#if APP_TRACE
+static app_trace_event_t    app_trace_ring[APP_TRACE_RING_SIZE];
+
+/* Free running count of recorded events */
+static uint32_t             app_trace_head;
+
+/* Events not recorded while frozen for a dump */
+static uint32_t             app_trace_missed;
+
+static app_trace_task_t     app_trace_tasks[APP_TRACE_MAX_TASKS];
+static uint32_t             app_trace_task_count;
+
+static void                 *app_trace_queues[APP_TRACE_MAX_QUEUES];
+static uint32_t             app_trace_queue_count;
+
+/* Classes recorded, 0 when the recorder is off */
+static volatile uint8_t     app_trace_mask = APP_TRACE_CLASS_ALL;
+static uint8_t              app_trace_on_mask = APP_TRACE_CLASS_ALL;
+
+static volatile bool        app_trace_frozen;
+
+APP_MEMORY_FOOTPRINT(app_trace_ram_footprint,
+                     sizeof(app_trace_ring) + sizeof(app_trace_tasks) +
+                     sizeof(app_trace_queues));
+#else
+APP_MEMORY_FOOTPRINT(app_trace_ram_footprint, 0);
+#endif
+
+/*******************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ******************************************************************************/
+#if APP_TRACE
+static void app_trace_put(uint8_t type, uint8_t id, uint16_t arg);
+
+static void app_trace_record(uint8_t class_mask, uint8_t type, uint8_t id, uint16_t arg);
+
+static void app_trace_task_event(uint8_t type, void *p_tcb);
+
+static void app_trace_queue_event(uint8_t type, void *p_queue);
+#endif
+
+static void app_trace_cmd(uint32_t argc, char *argv[]);
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+static const app_console_cmd_t app_trace_console_cmd =
+{
+    "trace", "RTOS trace; 'trace dump' for the events, 'trace on|off|clear|mask <hex>'",
+    app_trace_cmd
+};
+
+#if APP_TRACE
+/* Event names of the dump, indexed by app_trace_evt_type_t */
+static const char * const app_trace_evt_names[APP_TRACE_EVT_COUNT] =
+{
+    "in", "out", "isr", "isr_end", "send", "recv", "wait_send", "wait_recv",
+    "begin", "end", "sleep"
+};
+
+static const char * const app_trace_isr_names[APP_TRACE_ISR_COUNT] =
+{
+    "UART", "Sample timer", "ADC"
+};
+
+static const char * const app_trace_span_names[APP_TRACE_SPAN_COUNT] =
+{
+    "GATT callback", "ESS iteration", "Notification"
+};
+#endif
+
+/* *****************************************************************************
+ *                              FUNCTION DEFINITIONS
+ * ****************************************************************************/
+/*
+ Function Name:
+ app_trace_init
+
+ Function Description:
+ @brief  Registers the trace console command. The recorder itself runs from
+         the first kernel call, so the tasks created before are named.
+
+ @param void
+
+ @return void
+ */
+void app_trace_init(void)
+{
+#if APP_TRACE
+    CY_ASSERT(0 == (APP_TRACE_RING_SIZE & (APP_TRACE_RING_SIZE - 1u)));
+#endif
+    app_console_register_command(&app_trace_console_cmd);
+}
+
+/*
+ Function Name:
+ app_trace_isr_enter
+
+ Function Description:
+ @brief  Marks the start of an interrupt handler of the application.
+
+ @param isr  Interrupt handler
+
+ @return void
+ */
+void app_trace_isr_enter(app_trace_isr_t isr)
+{
+#if APP_TRACE
+    app_trace_record(APP_TRACE_CLASS_ISR, APP_TRACE_EVT_ISR_ENTER, (uint8_t)isr, 0);
+#endif
+}
+
+/*
+ Function Name:
+ app_trace_isr_exit
+
+ Function Description:
+ @brief  Marks the end of an interrupt handler of the application.
+
+ @param isr  Interrupt handler
+
+ @return void
+ */
+void app_trace_isr_exit(app_trace_isr_t isr)
+{
+#if APP_TRACE
+    app_trace_record(APP_TRACE_CLASS_ISR, APP_TRACE_EVT_ISR_EXIT, (uint8_t)isr, 0);
+#endif
+}
+
+/*
+ Function Name:
+ app_trace_span_begin
+
+ Function Description:
+ @brief  Marks the start of a code section, in the task running it.
+
+ @param span  Code section
+
+ @return void
+ */
+void app_trace_span_begin(app_trace_span_t span)
+{
+#if APP_TRACE
+    app_trace_record(APP_TRACE_CLASS_SPAN, APP_TRACE_EVT_SPAN_BEGIN, (uint8_t)span, 0);
+#endif
+}
+
+/*
+ Function Name:
+ app_trace_span_end
+
+ Function Description:
+ @brief  Marks the end of a code section.
+
+ @param span  Code section
+
+ @return void
+ */
+void app_trace_span_end(app_trace_span_t span)
+{
+#if APP_TRACE
+    app_trace_record(APP_TRACE_CLASS_SPAN, APP_TRACE_EVT_SPAN_END, (uint8_t)span, 0);
+#endif
+}
+
+/*
+ Function Name:
+ app_trace_sleep
+
+ Function Description:
+ @brief  Records the end of a tickless sleep. The cycle counter does not run
+         while the CPU sleeps, the converter adds the slept time instead.
+
+ @param slept_ticks  RTOS ticks spent in sleep
+
+ @return void
+ */
+void app_trace_sleep(uint32_t slept_ticks)
+{
+#if APP_TRACE
+    app_trace_record(APP_TRACE_CLASS_TASK, APP_TRACE_EVT_SLEEP, 0,
+                     (uint16_t)((UINT16_MAX < slept_ticks) ? UINT16_MAX : slept_ticks));
+#endif
+}
+
+#if APP_TRACE
+/*
+ Function Name:
+ app_trace_task_create
+
+ Function Description:
+ @brief  traceTASK_CREATE hook. Gives the task its id in the trace and keeps
+         its name for the dump.
+
+ @param p_tcb  Task created
+
+ @return void
+ */
+void app_trace_task_create(void *p_tcb)
+{
+    uint32_t saved_intr = cyhal_system_critical_section_enter();
+    app_trace_task_t *p_task;
+
+    if (APP_TRACE_MAX_TASKS > app_trace_task_count)
+    {
+        p_task = &app_trace_tasks[app_trace_task_count++];
+        p_task->p_handle = p_tcb;
+        strncpy(p_task->name, pcTaskGetName((TaskHandle_t)p_tcb), sizeof(p_task->name) - 1u);
+        vTaskSetTaskNumber((TaskHandle_t)p_tcb, app_trace_task_count);
+    }
+    else
+    {
+        vTaskSetTaskNumber((TaskHandle_t)p_tcb, APP_TRACE_ID_OTHER);
+    }
+    cyhal_system_critical_section_exit(saved_intr);
+}
+
+/*
+ Function Name:
+ app_trace_task_switched_in
+
+ Function Description:
+ @brief  traceTASK_SWITCHED_IN hook.
+
+ @param p_tcb  Task that runs next
+
+ @return void
+ */
+void app_trace_task_switched_in(void *p_tcb)
+{
+    app_trace_task_event(APP_TRACE_EVT_TASK_IN, p_tcb);
+}
+
+/*
+ Function Name:
+ app_trace_task_switched_out
+
+ Function Description:
+ @brief  traceTASK_SWITCHED_OUT hook.
+
+ @param p_tcb  Task that stops running
+
+ @return void
+ */
+void app_trace_task_switched_out(void *p_tcb)
+{
+    app_trace_task_event(APP_TRACE_EVT_TASK_OUT, p_tcb);
+}
+
+/*
+ Function Name:
+ app_trace_queue_send
+
+ Function Description:
+ @brief  traceQUEUE_SEND and traceQUEUE_SEND_FROM_ISR hook. Semaphore gives
+         and mutex releases are queue sends too.
+
+ @param p_queue  Queue
+
+ @return void
+ */
+void app_trace_queue_send(void *p_queue)
+{
+    app_trace_queue_event(APP_TRACE_EVT_QUEUE_SEND, p_queue);
+}
+
+/*
+ Function Name:
+ app_trace_queue_receive
+
+ Function Description:
+ @brief  traceQUEUE_RECEIVE and traceQUEUE_RECEIVE_FROM_ISR hook. Semaphore
+         takes and mutex locks are queue receives too.
+
+ @param p_queue  Queue
+
+ @return void
+ */
+void app_trace_queue_receive(void *p_queue)
+{
+    app_trace_queue_event(APP_TRACE_EVT_QUEUE_RECEIVE, p_queue);
+}
+
+/*
+ Function Name:
+ app_trace_queue_block_send
+
+ Function Description:
+ @brief  traceBLOCKING_ON_QUEUE_SEND hook, the running task waits for room
+         in the queue.
+
+ @param p_queue  Queue
+
+ @return void
+ */
+void app_trace_queue_block_send(void *p_queue)
+{
+    app_trace_queue_event(APP_TRACE_EVT_QUEUE_BLOCK_SEND, p_queue);
+}
+
+/*
+ Function Name:
+ app_trace_queue_block_receive
+
+ Function Description:
+ @brief  traceBLOCKING_ON_QUEUE_RECEIVE hook, the running task waits for an
+         item, a semaphore or a mutex.
+
+ @param p_queue  Queue
+
+ @return void
+ */
+void app_trace_queue_block_receive(void *p_queue)
+{
+    app_trace_queue_event(APP_TRACE_EVT_QUEUE_BLOCK_RECEIVE, p_queue);
+}
+
+/*
+ Function Name:
+ app_trace_put
+
+ Function Description:
+ @brief  Writes an event to the ring, overwriting the oldest one if it is
+         full. Must be called in a critical section.
+
+ @param type  Event type
+ @param id    Task, queue, interrupt or span id
+ @param arg   Event argument
+
+ @return void
+ */
+static void app_trace_put(uint8_t type, uint8_t id, uint16_t arg)
+{
+    app_trace_event_t *p_evt;
+
+    if (app_trace_frozen)
+    {
+        app_trace_missed++;
+        return;
+    }
+
+    p_evt = &app_trace_ring[app_trace_head & (APP_TRACE_RING_SIZE - 1u)];
+    p_evt->cycles = app_cycle_counter_get();
+    p_evt->type = type;
+    p_evt->id = id;
+    p_evt->arg = arg;
+    app_trace_head++;
+}
+
+/*
+ Function Name:
+ app_trace_record
+
+ Function Description:
+ @brief  Records an event of a class if the class is enabled. Can be called
+         from tasks and interrupts.
+
+ @param class_mask  Event class
+ @param type        Event type
+ @param id          Interrupt or span id
+ @param arg         Event argument
+
+ @return void
+ */
+static void app_trace_record(uint8_t class_mask, uint8_t type, uint8_t id, uint16_t arg)
+{
+    uint32_t saved_intr;
+
+    if (0 == (app_trace_mask & class_mask))
+    {
+        return;
+    }
+
+    saved_intr = cyhal_system_critical_section_enter();
+    app_trace_put(type, id, arg);
+    cyhal_system_critical_section_exit(saved_intr);
+}
+
+/*
+ Function Name:
+ app_trace_task_event
+
+ Function Description:
+ @brief  Records a task switch with the id given at task creation.
+
+ @param type   APP_TRACE_EVT_TASK_IN or APP_TRACE_EVT_TASK_OUT
+ @param p_tcb  Task
+
+ @return void
+ */
+static void app_trace_task_event(uint8_t type, void *p_tcb)
+{
+    app_trace_record(APP_TRACE_CLASS_TASK, type,
+                     (uint8_t)uxTaskGetTaskNumber((TaskHandle_t)p_tcb), 0);
+}
+
+/*
+ Function Name:
+ app_trace_queue_event
+
+ Function Description:
+ @brief  Records a queue operation. A queue gets its id on its first
+         operation; the argument is the number of items in the queue.
+
+ @param type     Queue event type
+ @param p_queue  Queue
+
+ @return void
+ */
+static void app_trace_queue_event(uint8_t type, void *p_queue)
+{
+    uint32_t saved_intr;
+    UBaseType_t id;
+
+    if (0 == (app_trace_mask & APP_TRACE_CLASS_QUEUE))
+    {
+        return;
+    }
+
+    saved_intr = cyhal_system_critical_section_enter();
+    id = uxQueueGetQueueNumber((QueueHandle_t)p_queue);
+    if (0 == id)
+    {
+        if (APP_TRACE_MAX_QUEUES > app_trace_queue_count)
+        {
+            app_trace_queues[app_trace_queue_count++] = p_queue;
+            id = app_trace_queue_count;
+        }
+        else
+        {
+            id = APP_TRACE_ID_OTHER;
+        }
+        vQueueSetQueueNumber((QueueHandle_t)p_queue, id);
+    }
+    app_trace_put(type, (uint8_t)id, 0);
+    cyhal_system_critical_section_exit(saved_intr);
+}
+#endif /* APP_TRACE */
+
+/*
+ Function Name:
+ app_trace_dump
+
+ Function Description:
+ @brief  Prints the names of the tasks, queues, interrupts and spans, then the
+         events in the ring, oldest first, as RTRACE lines. The recording is
+         paused during the dump.
+
+ @param void
+
+ @return void
+ */
+void app_trace_dump(void)
+{
+#if APP_TRACE
+    app_trace_event_t evt;
+    const char *p_name;
+    uint32_t first;
+    uint32_t head;
+    uint32_t i;
+
+    app_trace_frozen = true;
+    head = app_trace_head;
+    first = (APP_TRACE_RING_SIZE < head) ? (head - APP_TRACE_RING_SIZE) : 0u;
+
+    printf("RTRACE BEGIN hz=%lu tick_hz=%lu events=%lu lost=%lu missed=%lu\n",
+           (unsigned long)SystemCoreClock, (unsigned long)configTICK_RATE_HZ,
+           (unsigned long)(head - first), (unsigned long)first,
+           (unsigned long)app_trace_missed);
+
+    for (i = 0; i < app_trace_task_count; i++)
+    {
+        printf("RTRACE T %lu %s\n", (unsigned long)(i + 1u), app_trace_tasks[i].name);
+    }
+    for (i = 0; i < app_trace_queue_count; i++)
+    {
+        p_name = pcQueueGetName((QueueHandle_t)app_trace_queues[i]);
+        if (NULL != p_name)
+        {
+            printf("RTRACE Q %lu %s\n", (unsigned long)(i + 1u), p_name);
+        }
+        else
+        {
+            printf("RTRACE Q %lu 0x%08lx\n", (unsigned long)(i + 1u),
+                   (unsigned long)(uintptr_t)app_trace_queues[i]);
+        }
+    }
+    for (i = 0; i < APP_TRACE_ISR_COUNT; i++)
+    {
+        printf("RTRACE I %lu %s\n", (unsigned long)i, app_trace_isr_names[i]);
+    }
+    for (i = 0; i < APP_TRACE_SPAN_COUNT; i++)
+    {
+        printf("RTRACE S %lu %s\n", (unsigned long)i, app_trace_span_names[i]);
+    }
+
+    for (i = first; i != head; i++)
+    {
+        evt = app_trace_ring[i & (APP_TRACE_RING_SIZE - 1u)];
+        printf("RTRACE E %lu %s %u %u\n", (unsigned long)evt.cycles,
+               app_trace_evt_names[evt.type], evt.id, evt.arg);
+    }
+
+    printf("RTRACE END\n");
+    app_trace_frozen = false;
+#else
+    printf("RTOS trace is disabled, build with APP_TRACE=1\n");
+#endif
+}
+
+/*
+ Function Name:
+ app_trace_cmd
+
+ Function Description:
+ @brief  "trace" console command.
+
+ @param argc  Number of words
+ @param argv  Words of the command line
+
+ @return void
+ */
+static void app_trace_cmd(uint32_t argc, char *argv[])
+{
+#if APP_TRACE
+    uint32_t saved_intr;
+
+    if ((2 <= argc) && (0 == strcmp(argv[1], "dump")))
+    {
+        app_trace_dump();
+        return;
+    }
+    if ((2 <= argc) && (0 == strcmp(argv[1], "on")))
+    {
+        app_trace_mask = app_trace_on_mask;
+    }
+    else if ((2 <= argc) && (0 == strcmp(argv[1], "off")))
+    {
+        app_trace_mask = 0;
+    }
+    else if ((2 <= argc) && (0 == strcmp(argv[1], "clear")))
+    {
+        saved_intr = cyhal_system_critical_section_enter();
+        app_trace_head = 0;
+        app_trace_missed = 0;
+        cyhal_system_critical_section_exit(saved_intr);
+    }
+    else if ((3 <= argc) && (0 == strcmp(argv[1], "mask")))
+    {
+        app_trace_on_mask = (uint8_t)(strtoul(argv[2], NULL, 16) & APP_TRACE_CLASS_ALL);
+        app_trace_mask = app_trace_on_mask;
+    }
+
+    printf("RTOS trace %s, mask 0x%02x: %lu events recorded, ring of %u, "
+           "%lu tasks, %lu queues\n", (0 != app_trace_mask) ? "on" : "off",
+           app_trace_on_mask, (unsigned long)app_trace_head,
+           (unsigned)APP_TRACE_RING_SIZE, (unsigned long)app_trace_task_count,
+           (unsigned long)app_trace_queue_count);
+#else
+    app_trace_dump();
+#endif
+}
+
+/* [] END OF FILE */
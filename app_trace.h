@@ -0,0 +1,137 @@
+/*******************************************************************************
+* File Name: app_trace.h
+*
+* Description: This file contains the FreeRTOS trace recorder interface. Task
+*              switches, application interrupts, queue operations and
+*              application spans are recorded as fixed size events in a RAM
+*              ring.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef __APP_TRACE_H__
+#define __APP_TRACE_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <stdint.h>
+
+/* *****************************************************************************
+ *                              CONSTANTS
+ * ****************************************************************************/
+/* Build option, set APP_TRACE=1 in the Makefile. FreeRTOSConfig.h then routes
+ * the kernel trace macros to this module. 'trace dump' prints the ring for
+ * tools/rtos_trace_json.py, which writes a Chrome/Perfetto timeline.
+ */
+#ifndef APP_TRACE
+#define APP_TRACE                        (0u)
+#endif
+
+/* Number of events in the ring, a power of two. The oldest events are
+ * overwritten when it is full; 'trace off' keeps the window before it.
+ */
+#ifndef APP_TRACE_RING_SIZE
+#define APP_TRACE_RING_SIZE              (1024u)
+#endif
+
+/* Tasks and queues given an id in the trace, the others share one id */
+#define APP_TRACE_MAX_TASKS              (16u)
+#define APP_TRACE_MAX_QUEUES             (32u)
+
+/* Event classes, 'trace mask <hex>' selects the classes recorded */
+#define APP_TRACE_CLASS_TASK             (0x01u)
+#define APP_TRACE_CLASS_ISR              (0x02u)
+#define APP_TRACE_CLASS_QUEUE            (0x04u)
+#define APP_TRACE_CLASS_SPAN             (0x08u)
+#define APP_TRACE_CLASS_ALL              (0x0Fu)
+
+/* *****************************************************************************
+ *                              TYPEDEFS
+ * ****************************************************************************/
+/* Interrupt handlers of the application */
+typedef enum
+{
+    APP_TRACE_ISR_UART,
+    APP_TRACE_ISR_SAMPLE_TIMER,
+    APP_TRACE_ISR_ADC,
+    APP_TRACE_ISR_COUNT
+} app_trace_isr_t;
+
+/* Code sections of the application */
+typedef enum
+{
+    APP_TRACE_SPAN_GATT_CALLBACK,
+    APP_TRACE_SPAN_ESS_ITERATION,
+    APP_TRACE_SPAN_NOTIFICATION,
+    APP_TRACE_SPAN_COUNT
+} app_trace_span_t;
+
+/* *****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ * ****************************************************************************/
+void app_trace_init(void);
+
+void app_trace_isr_enter(app_trace_isr_t isr);
+
+void app_trace_isr_exit(app_trace_isr_t isr);
+
+void app_trace_span_begin(app_trace_span_t span);
+
+void app_trace_span_end(app_trace_span_t span);
+
+void app_trace_sleep(uint32_t slept_ticks);
+
+void app_trace_dump(void);
+
+/* Kernel hooks, called through the trace macros of FreeRTOSConfig.h */
+void app_trace_task_create(void *p_tcb);
+
+void app_trace_task_switched_in(void *p_tcb);
+
+void app_trace_task_switched_out(void *p_tcb);
+
+void app_trace_queue_send(void *p_queue);
+
+void app_trace_queue_receive(void *p_queue);
+
+void app_trace_queue_block_send(void *p_queue);
+
+void app_trace_queue_block_receive(void *p_queue);
+
+#endif      /* __APP_TRACE_H__ */
+
+/* [] END OF FILE */
@@ -80,9 +80,50 @@
 /* Memory allocation related definitions. */
 #define configSUPPORT_STATIC_ALLOCATION         1
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
+/* heap_3 uses the newlib heap and ignores configTOTAL_HEAP_SIZE. heap_4 and
+ * heap_5 need room for the BT stack, set APP_HEAP_SIZE in the Makefile.
+ */
+#if defined(APP_HEAP_SIZE)
+#define configTOTAL_HEAP_SIZE                   (APP_HEAP_SIZE)
+#else
 #define configTOTAL_HEAP_SIZE                   10240
+#endif
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
+/* Heap allocation hook of the application, see app_memory.c. Allocations made
+ * after boot are counted and the last ones logged with the allocating task.
+ * With APP_STATIC_MEMORY=1 the application itself never uses the heap, so
+ * configTOTAL_HEAP_SIZE only needs to cover the BT stack and the RTOS.
+ */
+#if !defined(__ASSEMBLER__) && !defined(__IAR_SYSTEMS_ASM__)
+#include <stddef.h>
+extern void app_memory_trace_malloc(void *p_addr, size_t size);
+#define traceMALLOC( pvAddress, uiSize )    app_memory_trace_malloc( ( pvAddress ), ( uiSize ) )
+#endif
+
+/* Trace recorder of the application, see app_trace.c. Only built with
+ * APP_TRACE=1; the macros then record task switches and queue operations.
+ */
+#if defined(APP_TRACE) && (APP_TRACE != 0) && \
+    !defined(__ASSEMBLER__) && !defined(__IAR_SYSTEMS_ASM__)
+extern void app_trace_task_create(void *p_tcb);
+extern void app_trace_task_switched_in(void *p_tcb);
+extern void app_trace_task_switched_out(void *p_tcb);
+extern void app_trace_queue_send(void *p_queue);
+extern void app_trace_queue_receive(void *p_queue);
+extern void app_trace_queue_block_send(void *p_queue);
+extern void app_trace_queue_block_receive(void *p_queue);
+#define traceTASK_CREATE( pxNewTCB )            app_trace_task_create( pxNewTCB )
+#define traceTASK_SWITCHED_IN()                 app_trace_task_switched_in( pxCurrentTCB )
+#define traceTASK_SWITCHED_OUT()                app_trace_task_switched_out( pxCurrentTCB )
+#define traceQUEUE_SEND( pxQueue )              app_trace_queue_send( pxQueue )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )     app_trace_queue_send( pxQueue )
+#define traceQUEUE_RECEIVE( pxQueue )           app_trace_queue_receive( pxQueue )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )  app_trace_queue_receive( pxQueue )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )  app_trace_queue_block_send( pxQueue )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue ) app_trace_queue_block_receive( pxQueue )
+#endif
+
 /* Hook function related definitions. */
 #define configUSE_IDLE_HOOK                     0
 #define configUSE_TICK_HOOK                     0
@@ -192,7 +233,15 @@ standard names - or at least those used in the unmodified vector table. */
 #define HEAP_ALLOCATION_TYPE5                   (5)     /* heap_5.c*/
 #define NO_HEAP_ALLOCATION                      (0)
 
+/* APP_HEAP_SCHEME in the Makefile selects the heap scheme, to compare the
+ * schemes on the same workload with APP_HEAP_TRACE=1. heap_5 gets a single
+ * region of configTOTAL_HEAP_SIZE bytes, see app_memory_heap_init().
+ */
+#if defined(APP_HEAP_SCHEME)
+#define configHEAP_ALLOCATION_SCHEME            (APP_HEAP_SCHEME)
+#else
 #define configHEAP_ALLOCATION_SCHEME            (HEAP_ALLOCATION_TYPE3)
+#endif
 
 /* Check if the ModusToolbox Device Configurator Power personality parameter
  * "System Idle Power Mode" is set to either "CPU Sleep" or "System Deep Sleep".
@@ -209,7 +258,11 @@ standard names - or at least those used in the unmodified vector table. */
  * https://github.com/Infineon/lpa
  */
 extern void vApplicationSleep( uint32_t xExpectedIdleTime );
-#define portSUPPRESS_TICKS_AND_SLEEP( xIdleTime ) vApplicationSleep( xIdleTime )
+/* The application wraps vApplicationSleep to account sleep residency and
+ * wake-up sources, see app_power.c.
+ */
+extern void app_power_sleep( uint32_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xIdleTime ) app_power_sleep( xIdleTime )
 #define configUSE_TICKLESS_IDLE                 2
 
 #else
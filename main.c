@@ -57,8 +57,28 @@
 #include <string.h>
 #include <timers.h>
 #include "GeneratedSource/cycfg_gatt_db.h"
+#include "app_agg.h"
+#include "app_boot.h"
 #include "app_bt_gatt_handler.h"
 #include "app_bt_utils.h"
+#include "app_console.h"
+#include "app_ess.h"
+#include "app_filter.h"
+#include "app_flash_log.h"
+#include "app_gatt_gen.h"
+#include "app_gatt_loadgen.h"
+#include "app_hci_snoop.h"
+#include "app_heap_trace.h"
+#include "app_history.h"
+#include "app_memory.h"
+#include "app_power.h"
+#include "app_sample_sched.h"
+#include "app_sensor.h"
+#include "app_soak.h"
+#include "app_stats.h"
+#include "app_stream.h"
+#include "app_time.h"
+#include "app_trace.h"
 #include "wiced_bt_ble.h"
 #include "wiced_bt_uuid.h"
 #include "wiced_memory.h"
@@ -72,25 +92,24 @@
 
 /* This is the temperature measurement interval which is same as configured in
  * the BT Configurator - The variable represents interval in milliseconds.
+ * While connected the sample scheduler rounds it to whole connection
+ * intervals.
  */
-#define POLL_TIMER_IN_MSEC              (49999u)
-#define POLL_TIMER_FREQ                 (10000)
-/* Temperature Simulation Constants */
-#define DEFAULT_TEMPERATURE             (2500u)
-#define MAX_TEMPERATURE_LIMIT           (3000u)
-#define MIN_TEMPERATURE_LIMIT           (2000u)
-#define DELTA_TEMPERATURE               (100u)
-
-/* Number of advertisment packet */
-#define NUM_ADV_PACKETS                 (3u)
+#define POLL_TIMER_IN_MSEC              (5000u)
 
 /* Absolute value of an integer. The absolute value is always positive. */
 #ifndef ABS
 #define ABS(N) ((N<0) ? (-N) : (N))
 #endif
 
-/* Check if notification is enabled for a valid connection ID */
-#define IS_NOTIFIABLE(conn_id, cccd) (((conn_id)!= 0)? (cccd) & GATT_CLIENT_CONFIG_NOTIFICATION: 0)
+#if APP_ESS_EXTRA_SENSORS
+/* Simulated sensors, in a second Environmental Sensing Service added by the
+ * application. Each sensor takes APP_ESS_SENSOR_HANDLES handles. */
+#define HDLS_APP_ESS_EXTRA              (APP_GATT_APP_HANDLE_BASE + 0x20u)
+#define HDLC_APP_ESS_HUMIDITY           (HDLS_APP_ESS_EXTRA + 1u)
+#define HDLC_APP_ESS_PRESSURE           (HDLC_APP_ESS_HUMIDITY + APP_ESS_SENSOR_HANDLES)
+#define HDLC_APP_ESS_OUTDOOR            (HDLC_APP_ESS_PRESSURE + APP_ESS_SENSOR_HANDLES)
+#endif
 
 /******************************************************************************
  *                                 TYPEDEFS
@@ -105,29 +124,77 @@ volatile int uxTopUsedPriority;
 /* Manages runtime configuration of Bluetooth stack */
 extern const wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 
-/* FreeRTOS variable to store handle of task created to update and send dummy
+/* FreeRTOS variable to store handle of task created to sample and send
    values of temperature */
 TaskHandle_t ess_task_handle;
 
+/* Filter between the sensor and the published temperature: the median of 3
+ * rejects single sample glitches, the IIR smooths the noise */
+static const app_filter_stage_cfg_t app_ess_filter_cfg[] =
+{
+    { APP_FILTER_MEDIAN, 3 },
+    { APP_FILTER_IIR,    2 },
+};
+
+static app_filter_t app_ess_filter;
+
+#if APP_STATIC_MEMORY
+/* ESS task stack and control block in static memory mode */
+static StackType_t ess_task_stack[APP_ESS_TASK_STACK_SIZE];
+static StaticTask_t ess_task_tcb;
+
+APP_MEMORY_FOOTPRINT(app_ess_task_ram_footprint,
+                     sizeof(ess_task_stack) + sizeof(ess_task_tcb) +
+                     sizeof(app_ess_filter));
+#else
+APP_MEMORY_FOOTPRINT(app_ess_task_ram_footprint, sizeof(app_ess_filter));
+#endif
+
 /* Status variable for connection ID */
 uint16_t app_bt_conn_id;
 
-/* Dummy Room Temperature */
-int16_t temperature = DEFAULT_TEMPERATURE;
-uint8_t alternating_flag = 0;
+#if APP_ESS_EXTRA_SENSORS
+/* Characteristic values, CCCDs and user descriptions of the simulated
+ * sensors */
+static uint8_t app_ess_humidity[2];
+static uint8_t app_ess_humidity_cccd[2];
+static char app_ess_humidity_desc[] = "Humidity";
+static uint8_t app_ess_pressure[4];
+static uint8_t app_ess_pressure_cccd[2];
+static char app_ess_pressure_desc[] = "Pressure";
+static uint8_t app_ess_outdoor[2];
+static uint8_t app_ess_outdoor_cccd[2];
+static char app_ess_outdoor_desc[] = "Outdoor temperature";
+
+static gatt_db_lookup_table_t app_ess_extra_attrs[] =
+{
+    APP_ESS_SENSOR_ATTRS(HDLC_APP_ESS_HUMIDITY, app_ess_humidity, app_ess_humidity_cccd,
+                         app_ess_humidity_desc),
+    APP_ESS_SENSOR_ATTRS(HDLC_APP_ESS_PRESSURE, app_ess_pressure, app_ess_pressure_cccd,
+                         app_ess_pressure_desc),
+    APP_ESS_SENSOR_ATTRS(HDLC_APP_ESS_OUTDOOR, app_ess_outdoor, app_ess_outdoor_cccd,
+                         app_ess_outdoor_desc),
+};
 
-/* Variable for 5 sec timer object */
-static cyhal_timer_t ess_timer_obj;
-/* Configure timer for 5 sec */
-const cyhal_timer_cfg_t ess_timer_cfg =
-    {
-        .compare_value = 0,                    /* Timer compare value, not used */
-        .period = POLL_TIMER_IN_MSEC, /* Defines the timer period */
-        .direction = CYHAL_TIMER_DIR_UP,       /* Timer counts up */
-        .is_compare = false,                   /* Don't use compare mode */
-        .is_continuous = true,                 /* Run timer indefinitely */
-        .value = 0                             /* Initial value of counter */
+static const wiced_bt_uuid_t app_ess_extra_types[] =
+{
+    APP_ESS_SENSOR_TYPES(APP_ESS_UUID_HUMIDITY),
+    APP_ESS_SENSOR_TYPES(APP_ESS_UUID_PRESSURE),
+    APP_ESS_SENSOR_TYPES(APP_ESS_UUID_TEMPERATURE),
+};
+
+static const uint8_t app_ess_extra_gatt_db[] =
+{
+    PRIMARY_SERVICE_UUID16(HDLS_APP_ESS_EXTRA, APP_ESS_UUID_SERVICE),
+        APP_ESS_SENSOR_GATT_DB(HDLC_APP_ESS_HUMIDITY, APP_ESS_UUID_HUMIDITY),
+        APP_ESS_SENSOR_GATT_DB(HDLC_APP_ESS_PRESSURE, APP_ESS_UUID_PRESSURE),
+        APP_ESS_SENSOR_GATT_DB(HDLC_APP_ESS_OUTDOOR, APP_ESS_UUID_TEMPERATURE),
 };
+#endif
+
+/* Room temperature in hundredths of a degree Celsius */
+int16_t temperature;
+
 /*******************************************************************************
  *        Function Prototypes
  *******************************************************************************/
@@ -143,13 +210,52 @@ static wiced_result_t app_bt_set_advertisement_data(void);
 /* This function initializes the required BLE ESS & thermistor */
 static void bt_app_init(void);
 
-/* Task to send notifications with dummy temperature values */
+/* Peripheral and tool setup deferred until advertising runs */
+static void app_deferred_init(void);
+
+static void app_start_deferred_init(void);
+
+/* Task to sample the sensors and send their notifications */
 void ess_task(void *pvParam);
-/* HAL timer callback registered when timer reaches terminal count */
-void ess_timer_callb(void *callback_arg, cyhal_timer_event_t event);
 
 /* This function starts the advertisements */
-static void app_start_advertisement(void);
+static wiced_result_t app_start_advertisement(void);
+
+/* Sampling functions of the sensors */
+static bool app_ess_temperature_sample(int32_t *p_reading);
+
+#if APP_ESS_EXTRA_SENSORS
+static bool app_ess_humidity_sample(int32_t *p_reading);
+
+static bool app_ess_pressure_sample(int32_t *p_reading);
+
+static bool app_ess_outdoor_sample(int32_t *p_reading);
+#endif
+
+/*******************************************************************************
+ *        Sensor Table
+ *******************************************************************************/
+/* Sensors published by the ESS task. The period is in sample periods of
+ * POLL_TIMER_IN_MSEC. A new sensor needs an entry here and, outside the
+ * database generated from design.cybt, its characteristic in a service
+ * added with app_gatt_add_service(). */
+static const app_ess_sensor_t app_ess_sensors[] =
+{
+    { "temperature", HDLC_ESS_TEMPERATURE_VALUE, HDLD_ESS_TEMPERATURE_CLIENT_CHAR_CONFIG,
+      app_ess_temperature, app_ess_temperature_client_char_config, 2u, 1u,
+      app_ess_temperature_sample, NULL },
+#if APP_ESS_EXTRA_SENSORS
+    { "humidity", HDLC_APP_ESS_HUMIDITY + 1u, HDLC_APP_ESS_HUMIDITY + 2u,
+      app_ess_humidity, app_ess_humidity_cccd, sizeof(app_ess_humidity), 2u,
+      app_ess_humidity_sample, NULL },
+    { "pressure", HDLC_APP_ESS_PRESSURE + 1u, HDLC_APP_ESS_PRESSURE + 2u,
+      app_ess_pressure, app_ess_pressure_cccd, sizeof(app_ess_pressure), 6u,
+      app_ess_pressure_sample, NULL },
+    { "outdoor", HDLC_APP_ESS_OUTDOOR + 1u, HDLC_APP_ESS_OUTDOOR + 2u,
+      app_ess_outdoor, app_ess_outdoor_cccd, sizeof(app_ess_outdoor), 1u,
+      app_ess_outdoor_sample, NULL },
+#endif
+};
 
 /******************************************************************************
  *                          Function Definitions
@@ -166,8 +272,15 @@ int main(void)
     wiced_result_t wiced_result;
     BaseType_t rtos_result;
 
+    /* The boot milestones count from here */
+    app_boot_init();
+
     /* Initialize and Verify the BSP initialization */
     CY_ASSERT(CY_RSLT_SUCCESS == cybsp_init());
+    app_boot_milestone(APP_BOOT_BSP);
+
+    /* Prepare the heap before the first allocation */
+    app_memory_heap_init();
 
     /* Enable global interrupts */
     __enable_irq();
@@ -176,37 +289,54 @@ int main(void)
     cy_retarget_io_init(CYBSP_DEBUG_UART_TX,
                         CYBSP_DEBUG_UART_RX,
                         CY_RETARGET_IO_BAUDRATE);
+    app_boot_milestone(APP_BOOT_RETARGET);
 
     /* Initialising the HCI UART for Host contol */
     cybt_platform_config_init(&cybsp_bt_platform_cfg);
+    app_boot_milestone(APP_BOOT_BT_PLATFORM);
 
-    /* Debug logs on UART port */
+    /* Debug logs on UART port. Each character blocks for the UART, so until
+     * advertising runs only errors are printed; the banner follows the BOOT
+     * line, see app_deferred_init() */
 
-    printf("****** Environmental Sensing Service ******\n");
-
-    /* Register call back and configuration with stack */
+    /* Register call back and configuration with stack. The aggregator mode
+     * adds the central and observer settings to the configuration */
     wiced_result = wiced_bt_stack_init(app_bt_management_callback,
-                                 &wiced_bt_cfg_settings);
+                                 app_agg_bt_cfg(&wiced_bt_cfg_settings));
+    app_boot_milestone(APP_BOOT_STACK_INIT);
 
     /* Check if stack initialization was successful */
-    if (WICED_BT_SUCCESS == wiced_result) {
-        printf("Bluetooth Stack Initialization Successful \n");
-    } else {
+    if (WICED_BT_SUCCESS != wiced_result) {
         printf("Bluetooth Stack Initialization failed!!\n");
     }
 
-    rtos_result = xTaskCreate(ess_task, "ESS Task", (configMINIMAL_STACK_SIZE * 4),
+    app_memory_init();
+
+    /* Debug console, used by the modules to dump their state on demand */
+    app_heap_trace_init();
+    app_trace_init();
+    app_boot_register_console();
+    app_console_init();
+
+    /* Count sleep entries, residency and wake-up sources */
+    app_power_init();
+
+#if APP_STATIC_MEMORY
+    ess_task_handle = xTaskCreateStatic(ess_task, "ESS Task", APP_ESS_TASK_STACK_SIZE,
+                                        NULL, (configMAX_PRIORITIES - 3),
+                                        ess_task_stack, &ess_task_tcb);
+    rtos_result = (NULL != ess_task_handle) ? pdPASS : pdFAIL;
+#else
+    rtos_result = xTaskCreate(ess_task, "ESS Task", APP_ESS_TASK_STACK_SIZE,
                                         NULL, (configMAX_PRIORITIES - 3), &ess_task_handle);
-    if(pdPASS == rtos_result)
-    {
-        printf("ESS task created successfully\n");
-    }
-    else
+#endif
+    if(pdPASS != rtos_result)
     {
         printf("ESS task creation failed\n");
     }
 
     /* Start the FreeRTOS scheduler */
+    app_boot_milestone(APP_BOOT_SCHEDULER);
     vTaskStartScheduler();
 
     /* Should never get here */
@@ -238,20 +368,10 @@ app_bt_management_callback(wiced_bt_management_evt_t event,
 
     case BTM_ENABLED_EVT:
     {
-        printf("\nThis application implements Bluetooth LE Environmental Sensing\n"
-                "Service and sends dummy temperature values in Celsius\n"
-                "every %d milliseconds over Bluetooth\n", (POLL_TIMER_IN_MSEC));
-
-        printf("Discover this device with the name:%s\n", app_gap_device_name);
-
-        print_local_bd_address();
+        app_boot_milestone(APP_BOOT_BT_ENABLED);
 
-        printf("\n");
-        printf("Bluetooth Management Event: \t");
-        printf("%s", get_btm_event_name(event));
-        printf("\n");
-
-        /* Perform application-specific initialization */
+        /* Perform application-specific initialization. The banner is
+         * printed by app_deferred_init() once advertising runs */
         bt_app_init();
     }break;
 
@@ -267,6 +387,14 @@ app_bt_management_callback(wiced_bt_management_evt_t event,
     case BTM_BLE_ADVERT_STATE_CHANGED_EVT:
     {
         wiced_bt_ble_advert_mode_t *p_adv_mode = &p_event_data->ble_advert_state_changed;
+
+        /* The first advertisement ends the critical boot path */
+        if (BTM_BLE_ADVERT_OFF != *p_adv_mode)
+        {
+            app_boot_milestone(APP_BOOT_ADV_ON);
+            app_start_deferred_init();
+        }
+
         /* Advertisement State Changed */
         printf("\n");
         printf("Bluetooth Management Event: \t");
@@ -278,6 +406,24 @@ app_bt_management_callback(wiced_bt_management_evt_t event,
         printf("\n");
     }break;
 
+    case BTM_BLE_CONNECTION_PARAM_UPDATE:
+    {
+        wiced_bt_ble_connection_param_update_t *p_param_update =
+            &p_event_data->ble_connection_param_update;
+
+        if (WICED_BT_SUCCESS == p_param_update->status)
+        {
+            app_sample_sched_set_conn_params(p_param_update->conn_interval,
+                                             p_param_update->conn_latency);
+        }
+        status = WICED_BT_SUCCESS;
+    }break;
+
+    case BTM_BLE_SCAN_STATE_CHANGED_EVT:
+        /* Only the aggregator mode scans */
+        app_agg_scan_state(p_event_data->ble_scan_state_changed);
+        break;
+
     default:
         printf("\nUnhandled Bluetooth Management Event: %d %s\n",
                 event,
@@ -294,7 +440,11 @@ app_bt_management_callback(wiced_bt_management_evt_t event,
 
  Function Description:
  @brief    This function is executed if BTM_ENABLED_EVT event occurs in
-           Bluetooth management callback.
+           Bluetooth management callback. It does only what a central needs
+           to find and use the device: the GATT server and its database are
+           registered and advertising is started. The peripherals, the
+           persistent log and the tools are set up by app_deferred_init()
+           once the controller advertises.
 
  @param    void
 
@@ -303,58 +453,151 @@ app_bt_management_callback(wiced_bt_management_evt_t event,
 static void bt_app_init(void)
 {
     wiced_bt_gatt_status_t gatt_status = WICED_BT_GATT_ERROR;
-    cy_rslt_t rslt;
+
+    /* Capture the HCI traffic from here on, only with APP_HCI_SNOOP=1 */
+    app_hci_snoop_init();
+
+    /* Build the GATT dispatch tables before events can arrive */
+    app_bt_gatt_handler_init();
 
     /* Register with stack to receive GATT callback */
     gatt_status = wiced_bt_gatt_register(app_bt_gatt_event_callback);
-    printf("\n gatt_register status:\t%s\n",get_gatt_status_name(gatt_status));
+    if (WICED_BT_GATT_SUCCESS != gatt_status) {
+        printf("\n gatt_register status:\t%s\n",get_gatt_status_name(gatt_status));
+    }
+
+    /* The sensor table only, the sensors are initialized later. Until the
+     * first sample the characteristics read as 0 */
+    app_ess_init(app_ess_sensors, sizeof(app_ess_sensors) / sizeof(app_ess_sensors[0]));
+
+    /* Initialize GATT Database */
+    gatt_status = wiced_bt_gatt_db_init(gatt_database, gatt_database_len, NULL);
+    if (WICED_BT_GATT_SUCCESS != gatt_status) {
+        printf("\n GATT DB Initialization not successful err 0x%x\n", gatt_status);
+    }
 
-    /* Initialize the User LED */
+    /* Add the services of the application modules */
+    app_stats_init();
+    app_time_init();
+    app_agg_init();
+    app_stream_init();
+#if APP_ESS_EXTRA_SENSORS
+    gatt_status = app_gatt_add_service(app_ess_extra_gatt_db, sizeof(app_ess_extra_gatt_db),
+                                       app_ess_extra_attrs, app_ess_extra_types,
+                                       sizeof(app_ess_extra_attrs) / sizeof(app_ess_extra_attrs[0]),
+                                       &app_ess_gatt_cbs);
+    if (WICED_BT_GATT_SUCCESS != gatt_status)
+    {
+        printf("Extra sensor service not added, err 0x%x\n", gatt_status);
+    }
+#endif
+    app_boot_milestone(APP_BOOT_GATT_DB);
+
+    /* Initialize the User LED before a central can connect, the connection
+     * handler drives it */
     cyhal_gpio_init(CONNECTION_LED,
                     CYHAL_GPIO_DIR_OUTPUT,
                     CYHAL_GPIO_DRIVE_STRONG,
                     CYBSP_LED_STATE_OFF);
 
-    /* Initialize the HAL timer used to count 5 seconds */
-    rslt = cyhal_timer_init(&ess_timer_obj, NC, NULL);
-    if (CY_RSLT_SUCCESS != rslt)
+    /* Start Bluetooth LE advertisements. The deferred init follows the
+     * advertising state change, or runs now if advertising failed */
+    if (WICED_SUCCESS != app_start_advertisement())
     {
-        printf("ESS timer init failed !\n");
+        app_start_deferred_init();
     }
-    /* Configure the timer for 5 seconds */
-    cyhal_timer_configure(&ess_timer_obj, &ess_timer_cfg);
-    rslt = cyhal_timer_set_frequency(&ess_timer_obj, POLL_TIMER_FREQ);
-    if (CY_RSLT_SUCCESS != rslt)
+    app_boot_milestone(APP_BOOT_ADV_START);
+}
+
+/*
+ Function name:
+ app_start_deferred_init
+
+ Function Description:
+ @brief    Lets the ESS task run app_deferred_init(), once.
+
+ @param    void
+
+ @return    void
+ */
+static void app_start_deferred_init(void)
+{
+    static bool started;
+
+    if (!started)
     {
-        printf("ESS timer set freq failed !\n");
+        started = true;
+        xTaskNotifyGive(ess_task_handle);
     }
-    /* Register for a callback whenever timer reaches terminal count */
-    cyhal_timer_register_callback(&ess_timer_obj, ess_timer_callb, NULL);
-    cyhal_timer_enable_event(&ess_timer_obj, CYHAL_TIMER_IRQ_TERMINAL_COUNT, 3, true);
+}
+
+/*
+ Function name:
+ app_deferred_init
+
+ Function Description:
+ @brief    Second half of the startup, run by the ESS task after advertising
+           has started: prints the banner, sets up the sensor and its filter,
+           recovers the persistent log and starts sampling.
+
+ @param    void
+
+ @return    void
+ */
+static void app_deferred_init(void)
+{
+    printf("****** Environmental Sensing Service ******\n");
+    printf("\nThis application implements Bluetooth LE Environmental Sensing\n"
+            "Service and sends temperature values in Celsius\n"
+            "every %d milliseconds over Bluetooth\n", (POLL_TIMER_IN_MSEC));
+
+    printf("Discover this device with the name:%s\n", app_gap_device_name);
 
-    /* Start the timer */
-    if (CY_RSLT_SUCCESS != cyhal_timer_start(&ess_timer_obj))
+    print_local_bd_address();
+    printf("\n");
+
+    /* Initialize the temperature sensor */
+    app_sensor_init();
+    if (!app_filter_init(&app_ess_filter, app_ess_filter_cfg,
+                         sizeof(app_ess_filter_cfg) / sizeof(app_ess_filter_cfg[0])))
     {
-        printf("ESS timer start failed !");
+        printf("Invalid temperature filter configuration, filter disabled\n");
     }
+    app_filter_register_console();
+    app_history_init();
 
-    /* Initialize GATT Database */
-    gatt_status = wiced_bt_gatt_db_init(gatt_database, gatt_database_len, NULL);
-    if (WICED_BT_GATT_SUCCESS != gatt_status) {
-        printf("\n GATT DB Initialization not successful err 0x%x\n", gatt_status);
+    /* Recover the persistent log; publish the last reading until the first
+     * sample is taken */
+    app_flash_log_init();
+    if (app_flash_log_last_reading(&temperature))
+    {
+        app_ess_temperature[0] = (uint8_t)(temperature & 0xff);
+        app_ess_temperature[1] = (uint8_t)((temperature >> 8) & 0xff);
     }
 
-    /* Start Bluetooth LE advertisements */
-    app_start_advertisement();
+    /* Start sampling. The scheduler wakes the ESS task every sample period */
+    app_sample_sched_init(ess_task_handle, POLL_TIMER_IN_MSEC);
+
+    /* Console driven load generator and soak mode, only with APP_GATT_LOADGEN=1
+     * and APP_SOAK=1, and the aggregator, only with APP_AGGREGATOR=1 */
+    app_gatt_loadgen_init();
+    app_soak_init(POLL_TIMER_IN_MSEC);
+    app_agg_start();
 
+    /* The application is up, report its memory usage */
+    app_memory_boot_done();
+    app_boot_milestone(APP_BOOT_DEFERRED);
+    app_memory_print_footprint();
 }
 
 
 /**
  * @brief This function starts the Blueooth LE advertisements and describes
  *        the pairing support
+ *
+ * @return wiced_result_t WICED_SUCCESS if advertising was started
  */
-static void app_start_advertisement(void)
+static wiced_result_t app_start_advertisement(void)
 {
     wiced_result_t wiced_status;
 
@@ -376,6 +619,8 @@ static void app_start_advertisement(void)
         printf( "Starting undirected Bluetooth LE advertisements"
                 "Failed err 0x%x\n", wiced_status);
     }
+
+    return wiced_status;
 }
 
 /*
@@ -393,39 +638,121 @@ static wiced_result_t app_bt_set_advertisement_data(void)
 {
 
     wiced_result_t wiced_result = WICED_SUCCESS;
-    wiced_result = wiced_bt_ble_set_raw_advertisement_data( NUM_ADV_PACKETS,
-                                                            cy_bt_adv_packet_data);
+    /* Payload prebuilt from design.cybt, the stack copies it */
+    wiced_result = wiced_bt_ble_set_raw_advertisement_data(
+                       APP_GATT_GEN_ADV_NUM_ELEMS,
+                       (wiced_bt_ble_advert_elem_t *)app_gatt_gen_adv_elems);
 
     return (wiced_result);
 }
 
 /*
  Function name:
- ess_timer_callb
+ app_ess_temperature_sample
 
  Function Description:
- @brief  This callback function is invoked on timeout of 5 seconds timer.
+ @brief  Sampling function of the room temperature sensor. The sample is
+         filtered, then added to the statistics, the history and the
+         persistent log. On a failed acquisition the last value is published
+         again.
 
- @param  void*: unused
- @param cyhal_timer_event_t: unused
+ @param p_reading  Temperature in hundredths of a degree Celsius
 
- @return void
+ @return bool  false if the sample was dropped by decimation
  */
-void ess_timer_callb(void *callback_arg, cyhal_timer_event_t event)
+static bool app_ess_temperature_sample(int32_t *p_reading)
 {
-    BaseType_t xHigherPriorityTaskWoken;
-    xHigherPriorityTaskWoken = pdFALSE;
-    vTaskNotifyGiveFromISR(ess_task_handle, &xHigherPriorityTaskWoken);
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    int16_t raw_sample;
+    uint32_t time_s;
+
+    /* Acquire and convert a sample; keep the last value on failure */
+    if (!app_sensor_sample(&raw_sample))
+    {
+        printf("Temperature sample failed\n");
+    }
+    else if (!app_filter_process(&app_ess_filter, raw_sample, &temperature))
+    {
+        /* Dropped by decimation, nothing to publish */
+        return false;
+    }
+    else
+    {
+        /* Records carry absolute time once a client has set it */
+        time_s = app_time_now_s();
+        app_stats_add_sample(temperature);
+        app_history_append(time_s, temperature);
+        app_flash_log_append_reading(time_s, temperature);
+    }
+
+    if (!app_soak_is_running())
+    {
+        printf("\nTemperature (in degree Celsius) \t\t%s%d.%02d\n",
+                (temperature < 0) ? "-" : "",
+                ABS(temperature / 100), ABS(temperature % 100));
+    }
+
+    *p_reading = temperature;
+    return true;
 }
 
+#if APP_ESS_EXTRA_SENSORS
+/*
+ Function name:
+ app_ess_sim_sample
+
+ Function Description:
+ @brief  Slow triangle wave of 64 samples around a base value, the stand-in
+         for the sensors the kit does not have.
+
+ @param p_count    Sample counter of the sensor
+ @param base       Base value
+ @param amplitude  Peak deviation from the base
+
+ @return int32_t  Simulated reading
+ */
+static int32_t app_ess_sim_sample(uint32_t *p_count, int32_t base, int32_t amplitude)
+{
+    int32_t step = (int32_t)((*p_count)++ % 64u);
+
+    step = (32 > step) ? step : (64 - step);
+    return base - amplitude + ((2 * amplitude * step) / 32);
+}
+
+/* Sampling functions of the simulated sensors */
+static bool app_ess_humidity_sample(int32_t *p_reading)
+{
+    static uint32_t count;
+
+    *p_reading = app_ess_sim_sample(&count, 4500, 1500);
+    return true;
+}
+
+static bool app_ess_pressure_sample(int32_t *p_reading)
+{
+    static uint32_t count;
+
+    *p_reading = app_ess_sim_sample(&count, 1013250, 2000);
+    return true;
+}
+
+static bool app_ess_outdoor_sample(int32_t *p_reading)
+{
+    static uint32_t count;
+
+    *p_reading = app_ess_sim_sample(&count, 1200, 800);
+    return true;
+}
+#endif
+
 /*
  Function name:
  ess_task
 
  Function Description:
- @brief  This task updates dummy temperature value every time it is notified
-         and sends a notification to the connected peer
+ @brief  This task first runs the deferred part of the startup, when
+         advertising has started. Then it runs every time it is notified by
+         the sample scheduler and lets the sensor registry sample the sensors
+         due in this period and send their notifications to the connected peer
 
  @param  void*: unused
 
@@ -433,70 +760,28 @@ void ess_timer_callb(void *callback_arg, cyhal_timer_event_t event)
  */
 void ess_task(void *pvParam)
 {
+    /* Wait for advertising to start, then finish the startup */
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    app_deferred_init();
+
     while(true)
     {
         ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        /* Varying temperature by 1 degree on every timeout for simulation */
-        if (0 == alternating_flag)
-        {
-            temperature += DELTA_TEMPERATURE;
-            if (MAX_TEMPERATURE_LIMIT <= temperature)
-            {
-                alternating_flag = 1;
-            }
-        }
-        else if ((1 == alternating_flag))
-        {
-            temperature -= DELTA_TEMPERATURE;
-            if (MIN_TEMPERATURE_LIMIT >= temperature)
-            {
-                alternating_flag = 0;
-            }
-        }
-
-        printf("\nTemperature (in degree Celsius) \t\t%d.%02d\n",
-                (temperature / 100), ABS(temperature % 100));
-
-        /*
-        * app_ess_temperature value is set both for read operation and
-        * notify operation.
-        */
-        app_ess_temperature[0] = (uint8_t)(temperature & 0xff);
-        app_ess_temperature[1] = (uint8_t)((temperature >> 8) & 0xff);
-
-        /* To check that connection is up and
-        * client is registered to receive notifications
-        * to send temperature data in Little Endian Format
-        * as per BT SIG's ESS Specification
-        */
 
-        if (IS_NOTIFIABLE (app_bt_conn_id, app_ess_temperature_client_char_config[0]) == 0)
+        /* A soak run replaces this sample and returns when it is done */
+        if (app_soak_poll())
         {
-            if(!app_bt_conn_id)
-            {
-                printf("This device is not connected to a central device\n");
-            }else{
-                printf("This device is connected to a central device but\n"
-                        "GATT client notifications are not enabled\n");
-            }
+            continue;
         }
-        else
-        {
-            wiced_bt_gatt_status_t gatt_status;
 
-            /*
-            * Sending notification, set the pv_app_context to NULL, since the
-            * data 'app_ess_temperature' is not to be freed
-            */
-            gatt_status = wiced_bt_gatt_server_send_notification(app_bt_conn_id,
-                                                                    HDLC_ESS_TEMPERATURE_VALUE,
-                                                                    app_ess_temperature_len,
-                                                                    app_ess_temperature,
-                                                                    NULL);
+        app_trace_span_begin(APP_TRACE_SPAN_ESS_ITERATION);
 
-            printf("Sent notification status 0x%x\n", gatt_status);
+        /* Schedule the next sample before taking this one */
+        app_sample_sched_on_sample();
 
-        }
+        app_ess_sample(app_bt_conn_id);
+
+        app_trace_span_end(APP_TRACE_SPAN_ESS_ITERATION);
     }
 }
 
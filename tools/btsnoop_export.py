@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Convert an HCI snoop dump of the ESS application to a btsnoop file.
+
+Reads a UART log that contains the output of the "snoop dump" console
+command (built with APP_HCI_SNOOP=1) and writes the packets of the last
+complete dump to a btsnoop file (datalink H4) that Wireshark, Frontline
+and other analyzers open.
+
+Packets are captured truncated to the snap length of the build; the
+original length is kept in the file so analyzers show them as truncated.
+The timestamps have the millisecond resolution of the RTOS tick. They are
+absolute if the time was set, e.g. by the Current Time Service, when the
+dump was taken, otherwise they count from 2000-01-01 plus the uptime.
+
+Usage:
+  btsnoop_export.py log [-o capture.btsnoop]
+"""
+
+import argparse
+import struct
+import sys
+
+# Microseconds from 0000-01-01 to 1970-01-01, the btsnoop time origin
+BTSNOOP_EPOCH_DELTA_US = 0x00dcddb30f2f8000
+# Uptime origin when the time was not set: 2000-01-01
+DEFAULT_EPOCH_MS = 946684800000
+DATALINK_H4 = 1002
+
+H4_COMMAND = 1
+H4_EVENT = 4
+
+
+def parse_kv(words):
+    return dict(w.split("=", 1) for w in words if "=" in w)
+
+
+def parse_log(path):
+    """Returns (header, packets) of the last complete dump, or None."""
+    dump = None
+    current = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            pos = line.find("SNOOP ")
+            if pos < 0:
+                continue
+            words = line[pos:].split()
+            tag = words[1] if len(words) > 1 else ""
+            if tag == "BEGIN":
+                current = ({k: int(v) for k, v in parse_kv(words[2:]).items()}, [])
+            elif current is None:
+                continue
+            elif tag == "P" and len(words) >= 6:
+                data = bytes.fromhex(words[6]) if len(words) > 6 else b""
+                current[1].append((int(words[2]), int(words[3]), int(words[4]),
+                                   int(words[5]), data))
+            elif tag == "END":
+                current[0].update({k: int(v) for k, v in parse_kv(words[2:]).items()})
+                dump = current
+                current = None
+    return dump
+
+
+def write_btsnoop(path, header, packets):
+    now_ms = header.get("now_ms", 0)
+    epoch_ms = header.get("epoch_ms", 0)
+    # Wall clock time of boot
+    boot_ms = (epoch_ms - now_ms) if epoch_ms else DEFAULT_EPOCH_MS
+    drops = header.get("overwritten", 0)
+
+    with open(path, "wb") as f:
+        f.write(b"btsnoop\0" + struct.pack(">II", 1, DATALINK_H4))
+        for time_ms, h4_type, received, orig_len, data in packets:
+            flags = (1 if received else 0) | (
+                2 if h4_type in (H4_COMMAND, H4_EVENT) else 0)
+            ts = (boot_ms + time_ms) * 1000 + BTSNOOP_EPOCH_DELTA_US
+            # The H4 packet type byte is part of the record
+            f.write(struct.pack(">IIIIQ", orig_len + 1, len(data) + 1, flags,
+                                drops, ts))
+            f.write(bytes([h4_type]) + data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("log", help="UART log with the output of 'snoop dump'")
+    parser.add_argument("-o", "--output", default="capture.btsnoop")
+    args = parser.parse_args()
+
+    dump = parse_log(args.log)
+    if dump is None:
+        print("%s: no complete snoop dump found" % args.log, file=sys.stderr)
+        return 1
+    header, packets = dump
+
+    write_btsnoop(args.output, header, packets)
+    truncated = sum(1 for p in packets if len(p[4]) < p[3])
+    print("%d packets written to %s, %d truncated to %d bytes" %
+          (len(packets), args.output, truncated, header.get("snap", 0)))
+    if header.get("overwritten", 0) or header.get("missed", 0):
+        print("%d older packets were overwritten, %d missed during dumps or "
+              "while off" % (header.get("overwritten", 0), header.get("missed", 0)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
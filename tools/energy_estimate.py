@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Energy estimator for the ESS application.
+
+Reads the POWER line printed by the "power" console command and projects
+the average current for a sampling and advertising configuration.
+
+The CPU part of the model comes from the measured counters:
+  - the active time per wake-up, from the active time and wake-up count,
+  - the share of the idle time spent in deep sleep,
+  - the Bluetooth and other wake-ups per sample.
+The projected configuration scales the wake-up rate with the sampling
+period. The idle time keeps the measured sleep/deep sleep split.
+
+The radio part is a charge per advertising event and per connection event
+for the Bluetooth subsystem. The currents and charges default to rough
+CYW20829 figures. Replace them with datasheet or measured values for your
+board; the estimate is only as good as these numbers.
+
+Usage:
+  energy_estimate.py log [--sample-ms 5000] [--adv-interval-ms 100]
+                         [--conn-interval-ms 50] [--connected 1.0] ...
+"""
+
+import argparse
+import sys
+
+
+def parse_power(path):
+    counters = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            pos = line.find("POWER ")
+            if pos < 0:
+                continue
+            counters = {}
+            for word in line[pos + 6:].split():
+                if "=" in word:
+                    key, value = word.split("=", 1)
+                    counters[key] = int(value)
+    return counters
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    p.add_argument("log", help="UART log with the output of 'power'")
+    # Configuration to project
+    p.add_argument("--sample-ms", type=float, default=5000.0,
+                   help="sampling period")
+    p.add_argument("--measured-sample-ms", type=float, default=5000.0,
+                   help="sampling period of the measured run")
+    p.add_argument("--adv-interval-ms", type=float, default=100.0,
+                   help="advertising interval while not connected")
+    p.add_argument("--conn-interval-ms", type=float, default=50.0,
+                   help="connection interval")
+    p.add_argument("--latency", type=int, default=0,
+                   help="peripheral latency in connection events")
+    p.add_argument("--connected", type=float, default=1.0,
+                   help="fraction of the time spent connected, 0..1")
+    # Electrical model
+    p.add_argument("--i-active-ma", type=float, default=2.5,
+                   help="CPU active current")
+    p.add_argument("--i-sleep-ma", type=float, default=0.9,
+                   help="CPU sleep current")
+    p.add_argument("--i-deepsleep-ua", type=float, default=6.0,
+                   help="system deep sleep current")
+    p.add_argument("--q-adv-uc", type=float, default=12.0,
+                   help="charge of one advertising event on 3 channels")
+    p.add_argument("--q-conn-uc", type=float, default=4.0,
+                   help="charge of one empty connection event")
+    p.add_argument("--q-notify-uc", type=float, default=1.5,
+                   help="extra charge of a connection event with a notification")
+    p.add_argument("--battery-mah", type=float, default=230.0,
+                   help="battery capacity, CR2032 by default")
+    args = p.parse_args()
+
+    c = parse_power(args.log)
+    if not c:
+        print("%s: no POWER line found" % args.log, file=sys.stderr)
+        return 1
+
+    window = float(c["window_ms"])
+    sleep_ms = c.get("sleep_ms", 0)
+    deep_ms = c.get("deepsleep_ms", 0)
+    active_ms = max(0.0, window - sleep_ms - deep_ms)
+    wakes = sum(v for k, v in c.items() if k.startswith("wake_"))
+    if window <= 0:
+        print("empty measurement window", file=sys.stderr)
+        return 1
+
+    print("Measured over %.1f s" % (window / 1000.0))
+    print("  active %.2f%%, sleep %.2f%%, deep sleep %.2f%%" %
+          (100 * active_ms / window, 100 * sleep_ms / window,
+           100 * deep_ms / window))
+    print("  %d wake-ups: %s" % (wakes, ", ".join(
+        "%s %d" % (k[5:], v) for k, v in sorted(c.items()) if k.startswith("wake_"))))
+
+    i_deep_ma = args.i_deepsleep_ua / 1000.0
+    measured_ma = (active_ms * args.i_active_ma + sleep_ms * args.i_sleep_ma +
+                   deep_ms * i_deep_ma) / window
+    print("  CPU average current %.1f uA" % (measured_ma * 1000.0))
+
+    # Projection: the timer wake-ups follow the sampling period; Bluetooth
+    # and other wake-ups keep their measured ratio to the samples.
+    hour_ms = 3600.0 * 1000.0
+    active_per_wake = active_ms / wakes if wakes else 0.0
+    measured_samples = window / args.measured_sample_ms
+    other_per_sample = ((wakes - c.get("wake_timer", 0)) / measured_samples
+                        if measured_samples else 0.0)
+    samples_h = hour_ms / args.sample_ms
+    wakes_h = samples_h * (1.0 + other_per_sample)
+    active_h = min(hour_ms, wakes_h * active_per_wake)
+    idle_h = hour_ms - active_h
+    deep_share = deep_ms / float(sleep_ms + deep_ms) if (sleep_ms + deep_ms) else 0.0
+
+    cpu_mc = (active_h * args.i_active_ma +
+              idle_h * (1.0 - deep_share) * args.i_sleep_ma +
+              idle_h * deep_share * i_deep_ma) / 1000.0
+
+    conn_events_h = args.connected * hour_ms / (args.conn_interval_ms * (1 + args.latency))
+    adv_events_h = (1.0 - args.connected) * hour_ms / args.adv_interval_ms
+    radio_mc = (conn_events_h * args.q_conn_uc + adv_events_h * args.q_adv_uc +
+                args.connected * samples_h * args.q_notify_uc) / 1000.0
+
+    total_mah = (cpu_mc + radio_mc) / 3600.0
+    print("\nProjection: sample every %.0f ms, %.0f%% connected "
+          "(interval %.1f ms, latency %d), advertising every %.0f ms" %
+          (args.sample_ms, 100 * args.connected, args.conn_interval_ms,
+           args.latency, args.adv_interval_ms))
+    print("  wake-ups per hour     %10.0f (%.2f ms active each)" %
+          (wakes_h, active_per_wake))
+    print("  CPU                   %10.3f mAh/h" % (cpu_mc / 3600.0))
+    print("  radio                 %10.3f mAh/h (%d connection, %d advertising events)" %
+          (radio_mc / 3600.0, conn_events_h, adv_events_h))
+    print("  total                 %10.3f mAh/h = %.1f uA average" %
+          (total_mah, total_mah * 1000.0))
+    if total_mah > 0:
+        print("  battery life          %10.1f days on %.0f mAh" %
+              (args.battery_mah / total_mah / 24.0, args.battery_mah))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
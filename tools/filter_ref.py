@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""Reference model of the fixed-point filters in app_filter.c.
+
+Runs the benchmark filters of the "filter" console command on the same
+input and prints the expected output checksums. With a UART log of the
+command, it compares the checksums printed by the device and reports the
+cycles per sample. Matching checksums show that the filter build on the
+device, the DSP intrinsic path included, is bit-exact with the scalar
+integer arithmetic modelled here.
+
+The model also filters a recording, e.g. tools/data/sim_sweep.txt, to try
+a pipeline before changing the configuration in main.c.
+
+Usage:
+  filter_ref.py [log]
+  filter_ref.py --filter median:3,iir:2 recording.txt [--centi]
+"""
+
+import argparse
+import re
+import sys
+
+INT16_MIN, INT16_MAX = -32768, 32767
+INT32_MIN, INT32_MAX = -(1 << 31), (1 << 31) - 1
+
+IIR_FRAC_BITS = 8
+BENCH_LEN = 256
+BENCH_SEED = 0x12345678
+
+# Same list as app_filter_benches[] in app_filter.c
+BENCHES = [
+    ("avg8", [("avg", 8)]),
+    ("iir3", [("iir", 3)]),
+    ("median3", [("median", 3)]),
+    ("median7", [("median", 7)]),
+    ("decim4", [("decim", 4)]),
+    ("pipeline", [("median", 5), ("avg", 4), ("decim", 2)]),
+]
+
+
+def sat16(x):
+    return max(INT16_MIN, min(INT16_MAX, x))
+
+
+def sat32(x):
+    return max(INT32_MIN, min(INT32_MAX, x))
+
+
+class Stage:
+    def __init__(self, kind, param):
+        self.kind = kind
+        self.param = param
+        self.primed = False
+        self.state = 0
+        self.index = 0
+        self.window = []
+
+    def process(self, x):
+        """Returns the output sample or None when the sample is dropped."""
+        n = self.param
+        if self.kind == "avg":
+            shift = n.bit_length() - 1
+            if not self.primed:
+                self.window = [x] * n
+                self.state = x * n
+                self.index = 0
+                self.primed = True
+            self.state = sat32(self.state + sat32(x - self.window[self.index]))
+            self.window[self.index] = x
+            self.index = (self.index + 1) & (n - 1)
+            return sat16(sat32(self.state + ((1 << shift) >> 1)) >> shift)
+        if self.kind == "iir":
+            if not self.primed:
+                self.state = x << IIR_FRAC_BITS
+                self.primed = True
+            self.state = sat32(self.state +
+                               (sat32((x << IIR_FRAC_BITS) - self.state) >> n))
+            return sat16(sat32(self.state + (1 << (IIR_FRAC_BITS - 1))) >> IIR_FRAC_BITS)
+        if self.kind == "median":
+            if not self.primed:
+                self.window = [x] * n
+                self.index = 0
+                self.primed = True
+            self.window[self.index] = x
+            self.index = self.index + 1 if self.index + 1 < n else 0
+            return sorted(self.window)[n // 2]
+        if self.kind == "decim":
+            if not self.primed:
+                self.state = 0
+                self.primed = True
+            if self.state != 0:
+                self.state = self.state + 1 if self.state + 1 < n else 0
+                return None
+            self.state = 1 if n > 1 else 0
+            return x
+        raise ValueError("unknown stage %s" % self.kind)
+
+
+def check_stage(kind, n):
+    if kind == "avg":
+        return 0 < n <= 16 and (n & (n - 1)) == 0
+    if kind == "iir":
+        return 1 <= n <= 8
+    if kind == "median":
+        return n % 2 == 1 and n < 16
+    if kind == "decim":
+        return n > 0
+    return False
+
+
+def run(stages, samples):
+    pipeline = [Stage(kind, n) for kind, n in stages]
+    out = []
+    for x in samples:
+        for stage in pipeline:
+            x = stage.process(x)
+            if x is None:
+                break
+        if x is not None:
+            out.append(x)
+    return out
+
+
+def bench_input():
+    seed = BENCH_SEED
+    samples = []
+    for i in range(BENCH_LEN):
+        seed = (seed * 1664525 + 1013904223) & 0xFFFFFFFF
+        base = 2000 if i < BENCH_LEN // 2 else 2500
+        samples.append(base + ((seed >> 24) & 0x3F) - 32 + (3000 if i % 37 == 0 else 0))
+    return samples
+
+
+def fnv1a(samples):
+    crc = 2166136261
+    for x in samples:
+        u = x & 0xFFFF
+        crc = ((crc ^ (u & 0xFF)) * 16777619) & 0xFFFFFFFF
+        crc = ((crc ^ (u >> 8)) * 16777619) & 0xFFFFFFFF
+    return crc
+
+
+def parse_log(path):
+    results = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = re.search(r"FILTER (\S+) cycles_per_sample=(\S+) outputs=(\d+) crc=0x([0-9a-fA-F]+)",
+                          line)
+            if m:
+                results[m.group(1)] = (m.group(2), int(m.group(3)), int(m.group(4), 16))
+    return results
+
+
+def bench(log):
+    samples = bench_input()
+    device = parse_log(log) if log else {}
+    mismatches = 0
+    print("  %-10s %8s %10s %10s %14s" %
+          ("filter", "outputs", "expected", "device", "cycles/sample"))
+    for name, stages in BENCHES:
+        out = run(stages, samples)
+        crc = fnv1a(out)
+        if name in device:
+            cycles, outputs, dev_crc = device[name]
+            ok = dev_crc == crc and outputs == len(out)
+            mismatches += 0 if ok else 1
+            print("  %-10s %8d 0x%08x 0x%08x %14s %s" %
+                  (name, len(out), crc, dev_crc, cycles, "ok" if ok else "MISMATCH"))
+        else:
+            print("  %-10s %8d 0x%08x %10s %14s" % (name, len(out), crc, "-", "-"))
+    if log and not device:
+        print("%s: no FILTER lines found" % log, file=sys.stderr)
+        return 1
+    return 1 if mismatches else 0
+
+
+def parse_pipeline(text):
+    stages = []
+    for item in text.split(","):
+        kind, _, n = item.partition(":")
+        if not check_stage(kind, int(n or 0)):
+            raise argparse.ArgumentTypeError("invalid stage %s" % item)
+        stages.append((kind, int(n)))
+    return stages
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("input", nargs="?",
+                        help="UART log of 'filter', or a recording with --filter")
+    parser.add_argument("--filter", type=parse_pipeline,
+                        help="pipeline to apply to a recording, stages "
+                             "avg:N, iir:K, median:N, decim:N")
+    parser.add_argument("--centi", action="store_true",
+                        help="recording values are in hundredths of a degree")
+    args = parser.parse_args()
+
+    if args.filter is None:
+        return bench(args.input)
+
+    if not args.input:
+        parser.error("--filter needs a recording")
+    samples = []
+    with open(args.input, errors="replace") as f:
+        for line in f:
+            fields = [x for x in re.split(r"[,;\s]+", line.strip()) if x]
+            try:
+                value = float(fields[-1])
+            except (ValueError, IndexError):
+                continue
+            samples.append(sat16(int(round(value if args.centi else value * 100.0))))
+    for x in run(args.filter, samples):
+        print("%d.%02d" % (x // 100, x % 100) if x >= 0 else "-%d.%02d" % (-x // 100, -x % 100))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,480 @@
+#!/usr/bin/env python3
+"""Generate app_gatt_gen.c and app_gatt_gen.h from design.cybt.
+
+The Bluetooth configurator generates the GATT database and the attribute
+value table in GeneratedSource. This step adds the tables the application
+uses to find attributes without searching at run time:
+
+  - the attribute handles, numbered the way the configurator numbers them,
+  - a dense handle index giving the position of each handle in
+    app_gatt_db_ext_attr_tbl,
+  - the handles of each attribute type (UUID), in ascending order,
+  - the advertising payload, already encoded, with the 16-bit UUIDs of the
+    services listed in the ServiceUuids property of the packet.
+
+The generated source checks at compile time that the handles match
+GeneratedSource, that they are ascending and below the handles of the
+services added at run time, that the advertising data fits in 31 bytes
+and that notified and indicated values fit the MTU.
+
+Run it again after editing design.cybt in the configurator:
+  make gatt_gen
+
+Usage:
+  gatt_db_gen.py [design.cybt] [-o app_gatt_gen]
+"""
+
+import argparse
+import sys
+import xml.etree.ElementTree as ET
+
+HEADER = """/*******************************************************************************
+* File Name: {name}
+*
+* Description: {desc}
+*              Generated by tools/gatt_db_gen.py from {source}, do not edit.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+"""
+
+# Configurator type -> (short name used in the handle macros, 16-bit UUID)
+SERVICES = {
+    "org.bluetooth.service.generic_access": ("GAP", 0x1800),
+    "org.bluetooth.service.generic_attribute": ("GATT", 0x1801),
+    "org.bluetooth.service.device_information": ("DIS", 0x180A),
+    "org.bluetooth.service.battery_service": ("BAS", 0x180F),
+    "org.bluetooth.service.environmental_sensing": ("ESS", 0x181A),
+}
+CHARACTERISTICS = {
+    "org.bluetooth.characteristic.gap.device_name": ("DEVICE_NAME", 0x2A00),
+    "org.bluetooth.characteristic.gap.appearance": ("APPEARANCE", 0x2A01),
+    "org.bluetooth.characteristic.gatt.service_changed": ("SERVICE_CHANGED", 0x2A05),
+    "org.bluetooth.characteristic.battery_level": ("BATTERY_LEVEL", 0x2A19),
+    "org.bluetooth.characteristic.temperature": ("TEMPERATURE", 0x2A6E),
+    "org.bluetooth.characteristic.humidity": ("HUMIDITY", 0x2A6F),
+}
+DESCRIPTORS = {
+    "org.bluetooth.descriptor.gatt.characteristic_user_description":
+        ("CHAR_USER_DESCRIPTION", 0x2901),
+    "org.bluetooth.descriptor.gatt.client_characteristic_configuration":
+        ("CLIENT_CHAR_CONFIG", 0x2902),
+    "org.bluetooth.descriptor.valid_range": ("VALID_RANGE", 0x2906),
+    "org.bluetooth.descriptor.es_measurement": ("ES_MEASUREMENT", 0x290C),
+    "org.bluetooth.descriptor.es_trigger_setting": ("ES_TRIGGER_SETTING", 0x290D),
+}
+FORMAT_SIZE = {
+    "f_boolean": 1, "f_2bit": 1, "f_4bit": 1, "f_8bit": 1,
+    "f_uint8": 1, "f_sint8": 1, "f_16bit": 2, "f_uint16": 2, "f_sint16": 2,
+    "f_uint24": 3, "f_sint24": 3, "f_32bit": 4, "f_uint32": 4, "f_sint32": 4,
+    "f_uint48": 6, "f_uint64": 8, "f_sint64": 8, "f_float32": 4, "f_float64": 8,
+}
+
+UUID_PRIMARY_SERVICE = 0x2800
+UUID_SECONDARY_SERVICE = 0x2801
+UUID_CHARACTERISTIC = 0x2803
+
+# Advertising data types and flags, as in wiced_bt_ble.h
+ADV_FLAGS = 0x01
+ADV_16SRV_COMPLETE = 0x03
+ADV_NAME_SHORT = 0x08
+ADV_NAME_COMPLETE = 0x09
+ADV_APPEARANCE = 0x19
+ADV_FLAG_LIMITED = 0x01
+ADV_FLAG_GENERAL = 0x02
+ADV_FLAG_BREDR_NOT_SUPPORTED = 0x04
+
+
+class Attr:
+    def __init__(self, handle, uuid, name, value_len=None, notify=False):
+        self.handle = handle
+        self.uuid = uuid
+        self.name = name            # handle macro without the prefix
+        self.value_len = value_len  # None for declarations
+        self.notify = notify        # notified or indicated
+
+
+def strip_ns(root):
+    for el in root.iter():
+        if "}" in el.tag:
+            el.tag = el.tag.split("}", 1)[1]
+
+
+def props(el, path):
+    node = el.find(path)
+    if node is None:
+        return {}
+    return {p.get("id"): p.get("value") for p in node.findall("Property")}
+
+
+def lookup(table, kind, type_name):
+    if type_name not in table:
+        sys.exit("%s %s is not known to gatt_db_gen.py, add it to %s" %
+                 (kind, type_name, kind.upper() + "S"))
+    return table[type_name]
+
+
+def value_len(el):
+    length = 0
+    for field in el.findall("Fields/Field"):
+        p = props(field, "FieldProperties")
+        fmt = p.get("Format", "")
+        if "ByteLength" in p:
+            length += int(p["ByteLength"])
+        elif fmt in FORMAT_SIZE:
+            length += FORMAT_SIZE[fmt]
+        else:
+            sys.exit("field format %s has no fixed size, set ByteLength" % fmt)
+    return length
+
+
+def ble_properties(el):
+    present = set()
+    for bp in el.findall("Properties/BleProperty"):
+        p = {x.get("id"): x.get("value") for x in bp.findall("Property")}
+        if p.get("Present") == "true":
+            present.add(p.get("PropertyType"))
+    return present
+
+
+def read_design(path):
+    root = ET.parse(path).getroot()
+    strip_ns(root)
+    general = props(root, "GeneralProperties")
+
+    attrs = []
+    handle = 1
+    for svc in root.iter("Service"):
+        svc_name, svc_uuid = lookup(SERVICES, "service", svc.get("type"))
+        decl = props(svc, "ServiceProperties").get("ServiceDeclaration", "Primary")
+        attrs.append(Attr(handle, UUID_PRIMARY_SERVICE if decl == "Primary"
+                          else UUID_SECONDARY_SERVICE, "HDLS_" + svc_name))
+        handle += 1
+        for char in svc.findall("Characteristics/Characteristic"):
+            char_name, char_uuid = lookup(CHARACTERISTICS, "characteristic",
+                                          char.get("type"))
+            base = "%s_%s" % (svc_name, char_name)
+            present = ble_properties(char)
+            attrs.append(Attr(handle, UUID_CHARACTERISTIC, "HDLC_" + base))
+            attrs.append(Attr(handle + 1, char_uuid, "HDLC_%s_VALUE" % base,
+                              value_len(char),
+                              bool(present & {"Notify", "Indicate"})))
+            handle += 2
+            for desc in char.findall("Descriptors/Descriptor"):
+                desc_name, desc_uuid = lookup(DESCRIPTORS, "descriptor",
+                                              desc.get("type"))
+                attrs.append(Attr(handle, desc_uuid,
+                                  "HDLD_%s_%s" % (base, desc_name),
+                                  value_len(desc)))
+                handle += 1
+
+    gap = props(root, "GAP/General")
+    adv = props(root, "GAP/PeripheralConfigurations/PeripheralConfiguration/"
+                      "AdvertisementPacket")
+    elems = []
+    if adv.get("AdFlags") == "true":
+        mode = (ADV_FLAG_LIMITED if adv.get("DiscoveryMode") == "Limited"
+                else ADV_FLAG_GENERAL)
+        elems.append(("BTM_BLE_ADVERT_TYPE_FLAG", ADV_FLAGS,
+                      [mode | ADV_FLAG_BREDR_NOT_SUPPORTED]))
+    if adv.get("AdServiceUuids") == "true":
+        # Comma separated configurator service types, as 16-bit UUIDs
+        data = []
+        for svc_type in adv.get("ServiceUuids", "").split(","):
+            _, svc_uuid = lookup(SERVICES, "service", svc_type.strip())
+            data += [svc_uuid & 0xFF, svc_uuid >> 8]
+        elems.append(("BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE", ADV_16SRV_COMPLETE,
+                      data))
+    if adv.get("AdLocalName") == "true":
+        complete = adv.get("LocalNameType", "Complete") == "Complete"
+        elems.append(("BTM_BLE_ADVERT_TYPE_NAME_COMPLETE" if complete
+                      else "BTM_BLE_ADVERT_TYPE_NAME_SHORT",
+                      ADV_NAME_COMPLETE if complete else ADV_NAME_SHORT,
+                      list(gap.get("DeviceName", "").encode("utf-8"))))
+    if adv.get("AdAppearance") == "true":
+        appearance = int(gap.get("Appearance", "0"))
+        elems.append(("BTM_BLE_ADVERT_TYPE_APPEARANCE", ADV_APPEARANCE,
+                      [appearance & 0xFF, appearance >> 8]))
+
+    return (attrs, elems, int(general.get("MtuSize", "23")),
+            int(general.get("MaxAttrLength", "512")))
+
+
+def emit_header(attrs, elems, mtu, max_attr_len, source):
+    values = [a for a in attrs if a.value_len is not None]
+    uuids = sorted(set(a.uuid for a in attrs))
+    adv_len = sum(2 + len(data) for _, _, data in elems)
+    width = max(len(a.name) for a in attrs) + len("APP_GATT_GEN__LEN") + 2
+
+    out = [HEADER.format(name="app_gatt_gen.h", source=source,
+                         desc="This file contains the GATT handle index and the\n"
+                              "*              advertising payload built from the "
+                              "Bluetooth configuration.")]
+    out.append("""
+#ifndef __APP_GATT_GEN_H__
+#define __APP_GATT_GEN_H__
+
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "wiced_bt_ble.h"
+#include <stdint.h>
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* Attribute handles, checked against GeneratedSource/cycfg_gatt_db.h */
+""")
+    for a in attrs:
+        out.append("#define %-*s(0x%04Xu)\n" % (width, "APP_GATT_GEN_" + a.name, a.handle))
+    out.append("\n/* Highest handle of the configured database */\n")
+    out.append("#define %-*s(0x%04Xu)\n" % (width, "APP_GATT_GEN_MAX_HANDLE",
+                                            attrs[-1].handle))
+    out.append("""
+/* Attributes with a value in app_gatt_db_ext_attr_tbl */
+#define %-*s(%du)
+
+/* Index of a handle without an application managed value */
+#define %-*s(0xFFu)
+
+/* Attribute types and handles in the per-UUID lists */
+#define %-*s(%du)
+#define %-*s(%du)
+
+/* Configured ATT MTU and attribute length limit */
+#define %-*s(%du)
+#define %-*s(%du)
+
+/* Advertising elements and encoded length of the payload */
+#define %-*s(%du)
+#define %-*s(%du)
+""" % (width, "APP_GATT_GEN_NUM_ATTRS", len(values),
+       width, "APP_GATT_GEN_NO_ATTR",
+       width, "APP_GATT_GEN_NUM_UUIDS", len(uuids),
+       width, "APP_GATT_GEN_NUM_HANDLES", len(attrs),
+       width, "APP_GATT_GEN_MTU", mtu,
+       width, "APP_GATT_GEN_MAX_ATTR_LEN", max_attr_len,
+       width, "APP_GATT_GEN_ADV_NUM_ELEMS", len(elems),
+       width, "APP_GATT_GEN_ADV_LEN", adv_len))
+    out.append("\n/* Length of the attribute values */\n")
+    for a in values:
+        out.append("#define %-*s(%du)\n" % (width, "APP_GATT_GEN_%s_LEN" % a.name,
+                                            a.value_len))
+    out.append("""
+/*******************************************************************************
+ *                              TYPEDEFS
+ ******************************************************************************/
+/* Handles of one attribute type, app_gatt_gen_uuid_handles[first..first+count) */
+typedef struct
+{
+    uint16_t    uuid;
+    uint8_t     first;
+    uint8_t     count;
+} app_gatt_gen_uuid_t;
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Index in app_gatt_db_ext_attr_tbl of each handle, APP_GATT_GEN_NO_ATTR if none */
+extern const uint8_t app_gatt_gen_attr_index[APP_GATT_GEN_MAX_HANDLE + 1u];
+
+/* Handle of each entry of app_gatt_db_ext_attr_tbl */
+extern const uint16_t app_gatt_gen_attr_handles[APP_GATT_GEN_NUM_ATTRS];
+
+/* Attribute types sorted by UUID and their handles in ascending order */
+extern const app_gatt_gen_uuid_t app_gatt_gen_uuids[APP_GATT_GEN_NUM_UUIDS];
+extern const uint16_t app_gatt_gen_uuid_handles[APP_GATT_GEN_NUM_HANDLES];
+
+/* Advertising payload, as sent over the air, and its elements */
+extern const uint8_t app_gatt_gen_adv_payload[APP_GATT_GEN_ADV_LEN];
+extern const wiced_bt_ble_advert_elem_t app_gatt_gen_adv_elems[APP_GATT_GEN_ADV_NUM_ELEMS];
+
+#endif      /* __APP_GATT_GEN_H__ */
+
+/* [] END OF FILE */
+""")
+    return "".join(out)
+
+
+def emit_source(attrs, elems, mtu, max_attr_len, source):
+    values = [a for a in attrs if a.value_len is not None]
+    uuids = sorted(set(a.uuid for a in attrs))
+    value_index = {a.handle: i for i, a in enumerate(values)}
+
+    out = [HEADER.format(name="app_gatt_gen.c", source=source,
+                         desc="This file contains the GATT handle index and the\n"
+                              "*              advertising payload built from the "
+                              "Bluetooth configuration.")]
+    out.append("""
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include "app_gatt_gen.h"
+#include "app_bt_gatt_handler.h"
+#include "GeneratedSource/cycfg_gatt_db.h"
+
+/*******************************************************************************
+ *                              CONSTANTS
+ ******************************************************************************/
+/* The configurator output must match design.cybt as seen by the generator */
+""")
+    for a in attrs:
+        out.append("_Static_assert(%s == APP_GATT_GEN_%s,\n"
+                   "               \"%s differs from design.cybt, "
+                   "run make gatt_gen\");\n" % (a.name, a.name, a.name))
+    out.append("\n/* Handles are ascending and below the services added at run time */\n")
+    for prev, cur in zip(attrs, attrs[1:]):
+        out.append("_Static_assert(APP_GATT_GEN_%s < APP_GATT_GEN_%s, \"handle order\");\n"
+                   % (prev.name, cur.name))
+    out.append("_Static_assert(APP_GATT_APP_HANDLE_BASE > APP_GATT_GEN_MAX_HANDLE,\n"
+               "               \"configured handles overlap APP_GATT_APP_HANDLE_BASE\");\n")
+    out.append("_Static_assert(APP_GATT_GEN_NO_ATTR > APP_GATT_GEN_NUM_ATTRS,\n"
+               "               \"attribute index does not fit in 8 bits\");\n")
+    out.append("_Static_assert(0xFFu >= APP_GATT_GEN_NUM_HANDLES, "
+               "\"handle list index does not fit in 8 bits\");\n")
+
+    out.append("\n/* Values fit the attribute length limit, notified values fit the MTU */\n")
+    for a in values:
+        out.append("_Static_assert(APP_GATT_GEN_MAX_ATTR_LEN >= APP_GATT_GEN_%s_LEN,\n"
+                   "               \"%s longer than MaxAttrLength\");\n" % (a.name, a.name))
+        if a.notify:
+            out.append("_Static_assert((APP_GATT_GEN_MTU - 3u) >= APP_GATT_GEN_%s_LEN,\n"
+                       "               \"%s does not fit a notification\");\n"
+                       % (a.name, a.name))
+
+    out.append("\n/* The payload fits a legacy advertising PDU */\n")
+    out.append("_Static_assert(31u >= APP_GATT_GEN_ADV_LEN, "
+               "\"advertising data longer than 31 bytes\");\n")
+    out.append("""
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+const uint8_t app_gatt_gen_attr_index[APP_GATT_GEN_MAX_HANDLE + 1u] =
+{
+    APP_GATT_GEN_NO_ATTR,
+""")
+    for a in attrs:
+        if a.handle in value_index:
+            out.append("    %-23s/* %s */\n" % ("%u," % value_index[a.handle], a.name))
+        else:
+            out.append("    %-23s/* %s */\n" % ("APP_GATT_GEN_NO_ATTR,", a.name))
+    out.append("""};
+
+const uint16_t app_gatt_gen_attr_handles[APP_GATT_GEN_NUM_ATTRS] =
+{
+""")
+    for a in values:
+        out.append("    APP_GATT_GEN_%s,\n" % a.name)
+    out.append("""};
+
+const app_gatt_gen_uuid_t app_gatt_gen_uuids[APP_GATT_GEN_NUM_UUIDS] =
+{
+""")
+    first = 0
+    for uuid in uuids:
+        count = len([a for a in attrs if a.uuid == uuid])
+        out.append("    { 0x%04X, %2d, %2d },\n" % (uuid, first, count))
+        first += count
+    out.append("""};
+
+const uint16_t app_gatt_gen_uuid_handles[APP_GATT_GEN_NUM_HANDLES] =
+{
+""")
+    for uuid in uuids:
+        out.append("    /* 0x%04X */\n" % uuid)
+        for a in attrs:
+            if a.uuid == uuid:
+                out.append("    APP_GATT_GEN_%s,\n" % a.name)
+    out.append("""};
+
+const uint8_t app_gatt_gen_adv_payload[APP_GATT_GEN_ADV_LEN] =
+{
+""")
+    offsets = []
+    pos = 0
+    for type_macro, ad_type, data in elems:
+        offsets.append(pos + 2)
+        pos += 2 + len(data)
+        out.append("    /* %s */\n" % type_macro)
+        line = ["0x%02X" % (len(data) + 1), "0x%02X" % ad_type] + \
+               ["0x%02X" % b for b in data]
+        for i in range(0, len(line), 12):
+            out.append("    " + ", ".join(line[i:i + 12]) + ",\n")
+    out.append("""};
+
+/* The stack copies the elements into its own buffer, the data stays in flash */
+const wiced_bt_ble_advert_elem_t app_gatt_gen_adv_elems[APP_GATT_GEN_ADV_NUM_ELEMS] =
+{
+""")
+    for (type_macro, _, data), offset in zip(elems, offsets):
+        out.append("    {\n"
+                   "        .advert_type = %s,\n"
+                   "        .len         = %d,\n"
+                   "        .p_data      = (uint8_t *)&app_gatt_gen_adv_payload[%d],\n"
+                   "    },\n" % (type_macro, len(data), offset))
+    out.append("""};
+
+/* [] END OF FILE */
+""")
+    return "".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("design", nargs="?", default="design.cybt",
+                        help="Bluetooth configuration")
+    parser.add_argument("-o", "--output", default="app_gatt_gen",
+                        help="output path without the .c/.h extension")
+    args = parser.parse_args()
+
+    attrs, elems, mtu, max_attr_len = read_design(args.design)
+    if not attrs:
+        print("%s: no GATT services found" % args.design, file=sys.stderr)
+        return 1
+
+    source = args.design.replace("\\", "/").split("/")[-1]
+    with open(args.output + ".h", "w") as f:
+        f.write(emit_header(attrs, elems, mtu, max_attr_len, source))
+    with open(args.output + ".c", "w") as f:
+        f.write(emit_source(attrs, elems, mtu, max_attr_len, source))
+    print("%d handles, %d values, %d advertising bytes written to %s.c/.h" %
+          (len(attrs), len([a for a in attrs if a.value_len is not None]),
+           sum(2 + len(d) for _, _, d in elems), args.output))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+"""Heap trace report for the ESS application.
+
+Reads UART logs that contain the output of the "heap dump" console command
+(built with APP_HEAP_TRACE=1) and prints:
+
+  - a size-class histogram of the traced allocations,
+  - the allocation sites with their counts and block lifetimes,
+  - a leak report of the blocks still allocated, grouped by call site,
+  - with several logs, a side by side comparison, e.g. of heap_3, heap_4
+    and heap_5 running the same workload.
+
+Call sites are return addresses. Pass --elf to resolve them to functions
+with addr2line.
+
+Usage:
+  heap_report.py [--elf app.elf] [--min-age SEC] log [log ...]
+"""
+
+import argparse
+import collections
+import shutil
+import subprocess
+import sys
+
+
+class HeapDump:
+    """The last complete dump found in one log."""
+
+    def __init__(self, name):
+        self.name = name
+        self.header = {}
+        self.stats = {}
+        self.heap = {}
+        self.records = []   # (kind, seq, site, addr, size, tick)
+        self.live = []      # (site, addr, size, tick)
+        self.now = 0
+
+
+def parse_kv(words):
+    return dict(w.split("=", 1) for w in words if "=" in w)
+
+
+def parse_log(path):
+    dump = None
+    current = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            pos = line.find("HEAP ")
+            if pos < 0:
+                continue
+            words = line[pos:].split()
+            tag = words[1] if len(words) > 1 else ""
+            if tag == "BEGIN":
+                current = HeapDump(path)
+                current.header = {k: int(v) for k, v in parse_kv(words[2:]).items()}
+            elif current is None:
+                continue
+            elif tag == "S":
+                current.stats = {k: int(v) for k, v in parse_kv(words[2:]).items()}
+            elif tag == "H":
+                current.heap = {k: int(v) for k, v in parse_kv(words[2:]).items()}
+            elif tag in ("A", "F", "X"):
+                current.records.append((tag, int(words[2]), int(words[3], 16),
+                                        int(words[4], 16), int(words[5]),
+                                        int(words[6])))
+            elif tag == "L":
+                current.live.append((int(words[2], 16), int(words[3], 16),
+                                     int(words[4]), int(words[5])))
+            elif tag == "END":
+                current.now = int(parse_kv(words[2:]).get("now", 0))
+                dump = current
+                current = None
+    return dump
+
+
+class Symbolizer:
+    def __init__(self, elf, tool):
+        self.elf = elf
+        self.tool = tool
+        self.cache = {}
+
+    def __call__(self, addr):
+        if not self.elf:
+            return "0x%08x" % addr
+        if addr not in self.cache:
+            try:
+                out = subprocess.run([self.tool, "-f", "-s", "-e", self.elf,
+                                      "0x%x" % addr], capture_output=True,
+                                     text=True, check=True).stdout.split("\n")
+                self.cache[addr] = "%s (%s)" % (out[0], out[1])
+            except (OSError, subprocess.CalledProcessError, IndexError):
+                self.cache[addr] = "0x%08x" % addr
+        return self.cache[addr]
+
+
+def size_class(size):
+    upper = 8
+    while upper < size:
+        upper *= 2
+    return upper
+
+
+def fragmentation(dump):
+    free = dump.heap.get("free", 0)
+    largest = dump.heap.get("largest", 0)
+    if free == 0 or largest == 0:
+        return None
+    return 100.0 * (1.0 - float(largest) / free)
+
+
+def report(dump, sym, min_age):
+    hz = dump.header.get("tick_hz", 1000)
+    s = dump.stats
+    print("== %s (heap_%d) ==" % (dump.name, dump.header.get("scheme", 0)))
+    print("live %d bytes / %d blocks, peak %d bytes / %d blocks" %
+          (s.get("live", 0), s.get("live_blocks", 0), s.get("peak", 0),
+           s.get("peak_blocks", 0)))
+    print("allocs %d, frees %d, failed %d, untracked frees %d" %
+          (s.get("allocs", 0), s.get("frees", 0), s.get("fails", 0),
+           s.get("untracked", 0)))
+    frag = fragmentation(dump)
+    print("free %d bytes in %d blocks, largest %s, fragmentation %s" %
+          (dump.heap.get("free", 0), dump.heap.get("free_blocks", 0),
+           dump.heap.get("largest", 0) or "n/a",
+           "n/a" if frag is None else "%.1f%%" % frag))
+    print("trace holds %d of %d records" %
+          (len(dump.records), dump.header.get("records", 0)))
+
+    print("\nSize classes (traced allocations)")
+    classes = collections.Counter()
+    class_bytes = collections.Counter()
+    for kind, _, _, _, size, _ in dump.records:
+        if kind == "A":
+            classes[size_class(size)] += 1
+            class_bytes[size_class(size)] += size
+    peak = max(classes.values()) if classes else 1
+    for upper in sorted(classes):
+        print("  <=%6d  %5d allocs %8d bytes  %s" %
+              (upper, classes[upper], class_bytes[upper],
+               "#" * max(1, 40 * classes[upper] // peak)))
+
+    # Pair frees with allocations of the same address seen earlier in the
+    # trace to attribute lifetimes to the allocation site.
+    site_stats = collections.defaultdict(lambda: [0, 0, 0, 0, 0])
+    open_blocks = {}
+    for kind, _, site, addr, size, tick in dump.records:
+        if kind == "A":
+            st = site_stats[site]
+            st[0] += 1
+            st[1] += size
+            open_blocks[addr] = site
+        elif kind == "X":
+            site_stats[site][4] += 1
+        elif kind == "F" and addr in open_blocks:
+            st = site_stats[open_blocks.pop(addr)]
+            st[2] += 1
+            st[3] += tick
+
+    print("\nAllocation sites")
+    print("  %-40s %7s %9s %7s %12s %6s" %
+          ("site", "allocs", "bytes", "freed", "avg life ms", "fails"))
+    for site, st in sorted(site_stats.items(), key=lambda i: -i[1][1]):
+        life = "-" if st[2] == 0 else "%.1f" % (1000.0 * st[3] / st[2] / hz)
+        print("  %-40s %7d %9d %7d %12s %6d" %
+              (sym(site), st[0], st[1], st[2], life, st[4]))
+
+    print("\nLeak report (blocks alive for at least %.1f s)" % min_age)
+    leaks = collections.defaultdict(lambda: [0, 0, 0])
+    for site, _, size, tick in dump.live:
+        age = (dump.now - tick) / float(hz)
+        if age >= min_age:
+            st = leaks[site]
+            st[0] += 1
+            st[1] += size
+            st[2] = max(st[2], age)
+    if not leaks:
+        print("  none")
+    for site, st in sorted(leaks.items(), key=lambda i: -i[1][1]):
+        print("  %-40s %5d blocks %8d bytes, oldest %.1f s" %
+              (sym(site), st[0], st[1], st[2]))
+    print()
+
+
+def compare(dumps):
+    print("== Comparison ==")
+    print("  %-24s %6s %8s %8s %8s %8s %6s %6s" %
+          ("log", "scheme", "peak", "live", "free", "largest", "frag", "fails"))
+    for d in dumps:
+        frag = fragmentation(d)
+        print("  %-24s %6s %8d %8d %8d %8d %6s %6d" %
+              (d.name[-24:], "heap_%d" % d.header.get("scheme", 0),
+               d.stats.get("peak", 0), d.stats.get("live", 0),
+               d.heap.get("free", 0), d.heap.get("largest", 0),
+               "-" if frag is None else "%.1f%%" % frag,
+               d.stats.get("fails", 0)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("logs", nargs="+", help="UART logs with a heap dump")
+    parser.add_argument("--elf", help="application ELF to resolve call sites")
+    parser.add_argument("--addr2line", default="arm-none-eabi-addr2line")
+    parser.add_argument("--min-age", type=float, default=0.0,
+                        help="only report live blocks older than this (s)")
+    args = parser.parse_args()
+
+    if args.elf and not shutil.which(args.addr2line):
+        print("warning: %s not found, sites are not resolved" % args.addr2line,
+              file=sys.stderr)
+        args.elf = None
+    sym = Symbolizer(args.elf, args.addr2line)
+
+    dumps = []
+    for path in args.logs:
+        dump = parse_log(path)
+        if dump is None:
+            print("%s: no complete heap dump found" % path, file=sys.stderr)
+            continue
+        dumps.append(dump)
+        report(dump, sym, args.min_age)
+
+    if len(dumps) > 1:
+        compare(dumps)
+
+    return 0 if dumps else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+"""Compression benchmark of the temperature history format of app_history.c.
+
+Encodes recorded traces with the block format of the device history and
+reports, per trace:
+  - the compression ratio against 6 byte raw readings (sint16 value and
+    uint32 time) and the bytes per reading,
+  - how many readings fit in the RAM of the device history,
+  - the encode and decode throughput of this Python model.
+Every trace is decoded again and compared with the input.
+
+The throughput figures are for the host model and only compare traces and
+block sizes. The device cost in cycles per reading is printed by the
+"history" console command.
+
+Traces are text files. Lines with two numbers are time in seconds and
+temperature; lines with one number are temperatures sampled every
+--period seconds. "HIST <time> <value>" lines of the "history dump"
+console command are read as well. Temperatures are in degrees Celsius, or
+in hundredths with --centi; HIST lines are always in hundredths.
+
+Usage:
+  history_bench.py trace [trace ...] [--period 5] [--centi]
+                   [--block-size 64] [--blocks 32] [--repeat N]
+"""
+
+import argparse
+import re
+import sys
+import time
+
+HEADER_SIZE = 8       # uint32 time, sint16 value, uint8 count, uint8 used
+RAW_RECORD = 6
+MAX_STEP = 65535      # larger time steps start a new block
+
+
+def zigzag(n):
+    return ((n << 1) ^ (n >> 31)) & 0xFFFFFFFF
+
+
+def unzigzag(u):
+    return (u >> 1) ^ -(u & 1)
+
+
+def put_varint(out, value):
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def get_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def s32(n):
+    n &= 0xFFFFFFFF
+    return n - (1 << 32) if n & 0x80000000 else n
+
+
+def s16(n):
+    n &= 0xFFFF
+    return n - (1 << 16) if n & 0x8000 else n
+
+
+class Block:
+    def __init__(self, t, v):
+        self.time = t
+        self.value = v
+        self.count = 1
+        self.data = bytearray()
+
+
+def encode(readings, payload_size):
+    """Same rules as app_history_append()."""
+    blocks = []
+    last_t = last_v = last_delta = 0
+    for t, v in readings:
+        block = blocks[-1] if blocks else None
+        if block is not None:
+            delta = s32(t - last_t)
+            record = bytearray()
+            put_varint(record, zigzag(s32(delta - last_delta)))
+            put_varint(record, zigzag(v - last_v))
+            if (len(block.data) + len(record) > payload_size or block.count == 255 or
+                    abs(delta) > MAX_STEP):
+                block = None
+        if block is None:
+            blocks.append(Block(t, v))
+            last_delta = 0
+        else:
+            block.data += record
+            block.count += 1
+            last_delta = delta
+        last_t, last_v = t, v
+    return blocks
+
+
+def decode(blocks):
+    """Same rules as app_history_read()."""
+    out = []
+    for block in blocks:
+        t, v, delta, pos = block.time, block.value, 0, 0
+        out.append((t, v))
+        for _ in range(block.count - 1):
+            dod, pos = get_varint(block.data, pos)
+            dv, pos = get_varint(block.data, pos)
+            delta = s32(delta + unzigzag(dod))
+            t = (t + delta) & 0xFFFFFFFF
+            v = s16(v + unzigzag(dv))
+            out.append((t, v))
+    return out
+
+
+def read_trace(path, period, centi):
+    readings = []
+    t = 0
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = re.search(r"HIST (\d+) (-?\d+)", line)
+            if m:
+                readings.append((int(m.group(1)), int(m.group(2))))
+                continue
+            fields = [x for x in re.split(r"[,;\s]+", line.strip()) if x]
+            try:
+                numbers = [float(x) for x in fields]
+            except ValueError:
+                continue
+            if not numbers:
+                continue
+            value = numbers[-1] if centi else numbers[-1] * 100.0
+            if len(numbers) >= 2:
+                t = int(numbers[0])
+            readings.append((t, max(-32768, min(32767, int(round(value))))))
+            t += period
+    return readings
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("traces", nargs="+", help="recorded traces")
+    parser.add_argument("--period", type=int, default=5,
+                        help="sampling period of single column traces, seconds")
+    parser.add_argument("--centi", action="store_true",
+                        help="temperatures are in hundredths of a degree")
+    parser.add_argument("--block-size", type=int, default=64,
+                        help="APP_HISTORY_BLOCK_SIZE")
+    parser.add_argument("--blocks", type=int, default=32, help="APP_HISTORY_BLOCKS")
+    parser.add_argument("--repeat", type=int, default=1,
+                        help="concatenate a short trace N times")
+    args = parser.parse_args()
+
+    payload = args.block_size - HEADER_SIZE
+    if not 1 <= payload <= 255:
+        parser.error("block size must be between %d and %d" %
+                     (HEADER_SIZE + 1, HEADER_SIZE + 255))
+
+    print("%-24s %8s %8s %7s %9s %10s %10s %10s" %
+          ("trace", "readings", "bytes", "ratio", "B/reading", "fit in RAM",
+           "enc/s", "dec/s"))
+    status = 0
+    for path in args.traces:
+        base = read_trace(path, args.period, args.centi)
+        if not base:
+            print("%s: no readings" % path, file=sys.stderr)
+            status = 1
+            continue
+        readings = list(base)
+        span = base[-1][0] - base[0][0] + args.period
+        for i in range(1, args.repeat):
+            readings += [((t + i * span) & 0xFFFFFFFF, v) for t, v in base]
+
+        start = time.perf_counter()
+        blocks = encode(readings, payload)
+        enc_s = time.perf_counter() - start
+        start = time.perf_counter()
+        decoded = decode(blocks)
+        dec_s = time.perf_counter() - start
+
+        if decoded != [(t & 0xFFFFFFFF, v) for t, v in readings]:
+            print("%s: decoded readings differ" % path, file=sys.stderr)
+            status = 1
+
+        used = sum(HEADER_SIZE + len(b.data) for b in blocks)
+        per_reading = float(used) / len(readings)
+        fit = int(args.blocks * args.block_size / per_reading)
+        print("%-24s %8d %8d %7.2f %9.2f %10d %10.0f %10.0f" %
+              (path[-24:], len(readings), used,
+               float(len(readings) * RAW_RECORD) / used, per_reading, fit,
+               len(readings) / max(enc_s, 1e-9), len(readings) / max(dec_s, 1e-9)))
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
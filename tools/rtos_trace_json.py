@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Convert an RTOS trace dump of the ESS application to a Chrome trace.
+
+Reads a UART log that contains the output of the "trace dump" console
+command (built with APP_TRACE=1) and writes the last complete dump as
+Chrome trace JSON, which chrome://tracing and https://ui.perfetto.dev
+open. The timeline has one track per task with:
+
+  - the slices in which the task runs,
+  - "wait <queue>" slices while the task is blocked on a queue, semaphore
+    or mutex, from the blocking call until it runs again,
+  - instant events for the queue sends and receives,
+
+a spans track per task for the application spans (GATT callback, ESS
+iteration, notification), an interrupt track for the application
+interrupt handlers and a sleep track for the tickless idle periods.
+
+Timestamps come from the CPU cycle counter, which stops while the CPU
+sleeps; the slept time recorded at each wake-up is added instead.
+
+Usage:
+  rtos_trace_json.py log [-o trace.json]
+"""
+
+import argparse
+import json
+import sys
+
+PID = 1
+TID_ISR = 1000
+TID_SLEEP = 1001
+# Spans may cross task switches, so they get a track next to their task
+TID_SPANS = 100
+
+
+class TraceDump:
+    """The last complete dump found in one log."""
+
+    def __init__(self):
+        self.header = {}
+        self.tasks = {}
+        self.queues = {}
+        self.isrs = {}
+        self.spans = {}
+        self.events = []    # (cycles, kind, id, arg)
+
+
+def parse_kv(words):
+    return dict(w.split("=", 1) for w in words if "=" in w)
+
+
+def parse_log(path):
+    dump = None
+    current = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            pos = line.find("RTRACE ")
+            if pos < 0:
+                continue
+            text = line[pos:].rstrip("\r\n")
+            words = text.split()
+            tag = words[1] if len(words) > 1 else ""
+            if tag == "BEGIN":
+                current = TraceDump()
+                current.header = {k: int(v) for k, v in parse_kv(words[2:]).items()}
+            elif current is None:
+                continue
+            elif tag in ("T", "Q", "I", "S") and len(words) >= 4:
+                # Names may contain spaces
+                name = text.split(None, 3)[3]
+                table = {"T": current.tasks, "Q": current.queues,
+                         "I": current.isrs, "S": current.spans}[tag]
+                table[int(words[2])] = name
+            elif tag == "E" and len(words) >= 6:
+                current.events.append((int(words[2]), words[3], int(words[4]),
+                                       int(words[5])))
+            elif tag == "END":
+                dump = current
+                current = None
+    return dump
+
+
+def convert(dump):
+    mhz = dump.header.get("hz", 96000000) / 1e6
+    tick_us = 1e6 / dump.header.get("tick_hz", 1000)
+
+    def task_name(tid):
+        return dump.tasks.get(tid, "task %d" % tid)
+
+    def queue_name(qid):
+        return dump.queues.get(qid, "queue %d" % qid)
+
+    out = [{"ph": "M", "pid": PID, "name": "process_name", "args": {"name": "CPU"}},
+           {"ph": "M", "pid": PID, "tid": TID_ISR, "name": "thread_name",
+            "args": {"name": "Interrupts"}},
+           {"ph": "M", "pid": PID, "tid": TID_SLEEP, "name": "thread_name",
+            "args": {"name": "Sleep"}}]
+    for tid, name in sorted(dump.tasks.items()):
+        out.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_name",
+                    "args": {"name": name}})
+        out.append({"ph": "M", "pid": PID, "tid": TID_SPANS + tid, "name": "thread_name",
+                    "args": {"name": name + " spans"}})
+
+    def slice_(name, tid, start, end, cat, args=None):
+        evt = {"ph": "X", "pid": PID, "tid": tid, "name": name, "cat": cat,
+               "ts": round(start, 3), "dur": round(max(0.0, end - start), 3)}
+        if args:
+            evt["args"] = args
+        out.append(evt)
+
+    t = 0.0
+    prev = None
+    current = None          # running task
+    run_start = {}          # task -> start of its running slice
+    waits = {}              # task -> (queue, start)
+    isr_stack = []          # (isr, start)
+    span_stack = {}         # span -> [(task, start)]
+
+    for cycles, kind, ident, arg in dump.events:
+        if prev is not None:
+            dt = ((cycles - prev) & 0xFFFFFFFF) / mhz
+            if kind == "sleep":
+                dt = max(dt, arg * tick_us)
+            t += dt
+        prev = cycles
+
+        if kind == "in":
+            current = ident
+            run_start[ident] = t
+            if ident in waits:
+                qid, start = waits.pop(ident)
+                slice_("wait " + queue_name(qid), ident, start, t, "wait")
+        elif kind == "out":
+            slice_(task_name(ident), ident, run_start.pop(ident, 0.0), t, "run")
+            current = None
+        elif kind == "isr":
+            isr_stack.append((ident, t))
+        elif kind == "isr_end":
+            if isr_stack:
+                isr, start = isr_stack.pop()
+                slice_(dump.isrs.get(isr, "isr %d" % isr), TID_ISR, start, t, "isr")
+        elif kind in ("send", "recv"):
+            tid = TID_ISR if isr_stack else (current or TID_ISR)
+            out.append({"ph": "i", "s": "t", "pid": PID, "tid": tid,
+                        "name": "%s %s" % (kind, queue_name(ident)),
+                        "cat": "queue", "ts": round(t, 3)})
+        elif kind in ("wait_send", "wait_recv"):
+            if current is not None:
+                waits[current] = (ident, t)
+        elif kind == "begin":
+            tid = (TID_SPANS + current) if current else TID_ISR
+            span_stack.setdefault(ident, []).append((tid, t))
+        elif kind == "end":
+            if span_stack.get(ident):
+                tid, start = span_stack[ident].pop()
+                slice_(dump.spans.get(ident, "span %d" % ident), tid, start, t, "span")
+        elif kind == "sleep":
+            slice_("sleep", TID_SLEEP, t - arg * tick_us, t, "sleep",
+                   {"ticks": arg})
+
+    # Close what is still open at the end of the dump
+    for tid, start in run_start.items():
+        slice_(task_name(tid), tid, start, t, "run")
+    return {"traceEvents": out, "displayTimeUnit": "ns"}, t
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("log", help="UART log with the output of 'trace dump'")
+    parser.add_argument("-o", "--output", default="trace.json")
+    args = parser.parse_args()
+
+    dump = parse_log(args.log)
+    if dump is None:
+        print("%s: no complete trace dump found" % args.log, file=sys.stderr)
+        return 1
+
+    trace, span_us = convert(dump)
+    with open(args.output, "w") as f:
+        json.dump(trace, f)
+    print("%d events over %.1f ms written to %s" %
+          (len(dump.events), span_us / 1000.0, args.output))
+    if dump.header.get("lost", 0):
+        print("%d older events were overwritten, the trace starts mid-flight" %
+              dump.header["lost"])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Generate app_sensor_replay_data.c from recorded temperature data.
+
+The replay sensor backend (APP_SENSOR_BACKEND=2) plays back a table of
+samples so that the filter, statistics and history code can run on
+recorded data without the thermistor.
+
+Input is a CSV or whitespace separated text file. The temperature is
+read from the last column, in degrees Celsius. Use --centi if it is in
+hundredths of a degree. Lines that do not parse, such as a header, are
+skipped.
+
+Usage:
+  sensor_replay_gen.py recording.csv [-o app_sensor_replay_data.c]
+                       [--centi] [--max-samples N]
+"""
+
+import argparse
+import re
+import sys
+
+HEADER = """/*******************************************************************************
+* File Name: app_sensor_replay_data.c
+*
+* Description: This file contains the recorded samples played back by the
+*              replay sensor backend. Generated by tools/sensor_replay_gen.py
+*              from {source}, do not edit.
+*
+* Related Document: See README.md
+*
+*
+*********************************************************************************
+ Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+ an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+
+ This software, including source code, documentation and related
+ materials ("Software") is owned by Cypress Semiconductor Corporation
+ or one of its affiliates ("Cypress") and is protected by and subject to
+ worldwide patent protection (United States and foreign),
+ United States copyright laws and international treaty provisions.
+ Therefore, you may use this Software only as provided in the license
+ agreement accompanying the software package from which you
+ obtained this Software ("EULA").
+ If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ non-transferable license to copy, modify, and compile the Software
+ source code solely for use in connection with Cypress's
+ integrated circuit products.  Any reproduction, modification, translation,
+ compilation, or representation of this Software except as specified
+ above is prohibited without the express written permission of Cypress.
+
+ Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ reserves the right to make changes to the Software without notice. Cypress
+ does not assume any liability arising out of the application or use of the
+ Software or any product or circuit described in the Software. Cypress does
+ not authorize its products for use in any products where a malfunction or
+ failure of the Cypress product may reasonably be expected to result in
+ significant property damage, injury or death ("High Risk Product"). By
+ including Cypress's product in a High Risk Product, the manufacturer
+ of such system or application assumes all risk of such use and in doing
+ so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+"""
+
+
+def read_samples(path, centi):
+    samples = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            fields = [x for x in re.split(r"[,;\s]+", line.strip()) if x]
+            if not fields:
+                continue
+            try:
+                value = float(fields[-1])
+            except ValueError:
+                continue
+            samples.append(int(round(value if centi else value * 100.0)))
+    return samples
+
+
+def emit(samples, source):
+    out = [HEADER.format(source=source)]
+    out.append("""
+/* *****************************************************************************
+ *                              INCLUDES
+ * ****************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ *                              VARIABLE DEFINITIONS
+ ******************************************************************************/
+/* Temperature in hundredths of a degree Celsius */
+const int16_t app_sensor_replay_samples[] =
+{
+""")
+    for i in range(0, len(samples), 10):
+        out.append("    " + " ".join("%6d," % v for v in samples[i:i + 10]) + "\n")
+    out.append("""};
+
+const uint32_t app_sensor_replay_sample_count =
+    sizeof(app_sensor_replay_samples) / sizeof(app_sensor_replay_samples[0]);
+
+/* [] END OF FILE */
+""")
+    return "".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("recording", help="recorded temperature data")
+    parser.add_argument("-o", "--output", default="app_sensor_replay_data.c")
+    parser.add_argument("--centi", action="store_true",
+                        help="values are in hundredths of a degree")
+    parser.add_argument("--max-samples", type=int, default=4096,
+                        help="truncate to this many samples, the table is in flash")
+    args = parser.parse_args()
+
+    samples = read_samples(args.recording, args.centi)[:args.max_samples]
+    if not samples:
+        print("%s: no samples found" % args.recording, file=sys.stderr)
+        return 1
+    if any(v < -32768 or v > 32767 for v in samples):
+        print("%s: values out of int16 range, check --centi" % args.recording,
+              file=sys.stderr)
+        return 1
+
+    with open(args.output, "w") as f:
+        f.write(emit(samples, args.recording.replace("\\", "/").split("/")[-1]))
+    print("%d samples written to %s" % (len(samples), args.output))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())